@@ -0,0 +1,88 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <arrayfire.h>
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace bench {
+
+using benchmark::State;
+using benchmark::internal::Benchmark;
+
+/// Element counts of the one dimensional benchmarks: 4K to 16M
+inline void elementCounts(Benchmark *b) {
+    b->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Side lengths of the square matrices and images: 128 to 2048
+inline void squareSizes(Benchmark *b) {
+    b->RangeMultiplier(4)->Range(128, 2048);
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+template<typename T>
+af::dtype dtypeOf() {
+    return static_cast<af::dtype>(af::dtype_traits<T>::af_type);
+}
+
+/// Skips the benchmark when the active device does not support \p type.
+/// Returns true when it can run.
+inline bool supported(State &state, af::dtype type) {
+    int device = af::getDevice();
+    if ((type == f64 || type == c64) && !af::isDoubleAvailable(device)) {
+        state.SkipWithError("double precision is not supported");
+        return false;
+    }
+    if (type == f16 && !af::isHalfAvailable(device)) {
+        state.SkipWithError("half precision is not supported");
+        return false;
+    }
+    return true;
+}
+
+/// Random values of \p type. Integers are in [0, 100) so that sorts and
+/// reductions see repeated keys and u8 does not overflow.
+inline af::array randomArray(const af::dim4 &dims, af::dtype type) {
+    switch (type) {
+        case f32:
+        case f64:
+        case c32:
+        case c64:
+        case f16: return af::randu(dims, type);
+        default: return (af::randu(dims) * 100).as(type);
+    }
+}
+
+/// Times \p fn, which returns the array to evaluate. The first call is not
+/// timed so that kernel compilation and the first allocations are excluded.
+template<typename Func>
+void run(State &state, Func &&fn) {
+    try {
+        fn().eval();
+        af::sync();
+        for (auto _ : state) {
+            af::array out = fn();
+            out.eval();
+            af::sync();
+        }
+    } catch (const af::exception &ex) { state.SkipWithError(ex.what()); }
+}
+
+/// Reports \p bytes read by every iteration, shown as a throughput
+inline void setBytesProcessed(State &state, size_t bytes) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(bytes));
+}
+
+}  // namespace bench
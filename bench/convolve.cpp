@@ -0,0 +1,155 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <bench_helpers.hpp>
+
+using af::array;
+using af::dim4;
+using bench::State;
+
+namespace {
+
+/// Images of 128 to 2048 pixels square with filters of 3 to 27 taps
+void imageArgs(bench::Benchmark *b) {
+    b->ArgsProduct({benchmark::CreateRange(128, 2048, 4), {3, 5, 9, 15, 27}});
+    b->ArgNames({"side", "filter"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Signals of 64K to 16M samples with filters of 3 to 1023 taps
+void signalArgs(bench::Benchmark *b) {
+    b->ArgsProduct({benchmark::CreateRange(1 << 16, 1 << 24, 16),
+                    benchmark::CreateRange(3, 1023, 7)});
+    b->ArgNames({"elements", "filter"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Volumes of 32 to 128 voxels a side with filters of 3 to 7 taps
+void volumeArgs(bench::Benchmark *b) {
+    b->ArgsProduct({{32, 64, 128}, {3, 5, 7}});
+    b->ArgNames({"side", "filter"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Batches of 8 images of 32 to 256 pixels square with 3 to 64 channels
+void networkArgs(bench::Benchmark *b) {
+    b->ArgsProduct({{32, 64, 128, 256}, {3, 16, 64}});
+    b->ArgNames({"side", "channels"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+template<typename T>
+void BM_Convolve1(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    array signal = bench::randomArray(state.range(0), type);
+    array filter = bench::randomArray(state.range(1), type);
+
+    bench::run(state, [&] {
+        return af::convolve1(signal, filter, AF_CONV_DEFAULT, AF_CONV_SPATIAL);
+    });
+    bench::setBytesProcessed(state, signal.bytes());
+}
+
+template<typename T>
+void BM_Convolve2(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side = state.range(0);
+    const dim_t taps = state.range(1);
+    array image      = bench::randomArray(dim4(side, side), type);
+    array filter     = bench::randomArray(dim4(taps, taps), type);
+
+    bench::run(state, [&] {
+        return af::convolve2(image, filter, AF_CONV_DEFAULT, AF_CONV_SPATIAL);
+    });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+/// Separable filter applied as a column and a row filter
+template<typename T>
+void BM_Convolve2Separable(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side = state.range(0);
+    const dim_t taps = state.range(1);
+    array image      = bench::randomArray(dim4(side, side), type);
+    array col        = bench::randomArray(taps, type);
+    array row        = bench::randomArray(taps, type);
+
+    bench::run(state, [&] { return af::convolve(col, row, image); });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+/// Convolution through the frequency domain, which does not depend on the
+/// filter size
+template<typename T>
+void BM_FFTConvolve2(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side = state.range(0);
+    const dim_t taps = state.range(1);
+    array image      = bench::randomArray(dim4(side, side), type);
+    array filter     = bench::randomArray(dim4(taps, taps), type);
+
+    bench::run(state, [&] { return af::fftConvolve2(image, filter); });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+template<typename T>
+void BM_Convolve3(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side = state.range(0);
+    const dim_t taps = state.range(1);
+    array volume     = bench::randomArray(dim4(side, side, side), type);
+    array filter     = bench::randomArray(dim4(taps, taps, taps), type);
+
+    bench::run(state, [&] {
+        return af::convolve3(volume, filter, AF_CONV_DEFAULT, AF_CONV_SPATIAL);
+    });
+    bench::setBytesProcessed(state, volume.bytes());
+}
+
+/// Layer of a convolutional network: 32 filters of 3 x 3 over all the
+/// channels of each image, padded to keep the image size
+template<typename T>
+void BM_Convolve2NN(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side     = state.range(0);
+    const dim_t channels = state.range(1);
+
+    array images = bench::randomArray(dim4(side, side, channels, 8), type);
+    array filter = bench::randomArray(dim4(3, 3, channels, 32), type);
+
+    bench::run(state, [&] {
+        return af::convolve2NN(images, filter, dim4(1, 1), dim4(1, 1),
+                               dim4(1, 1));
+    });
+    bench::setBytesProcessed(state, images.bytes());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Convolve1, float)->Apply(signalArgs);
+BENCHMARK_TEMPLATE(BM_Convolve1, double)->Apply(signalArgs);
+BENCHMARK_TEMPLATE(BM_Convolve2, float)->Apply(imageArgs);
+BENCHMARK_TEMPLATE(BM_Convolve2, double)->Apply(imageArgs);
+BENCHMARK_TEMPLATE(BM_Convolve2, unsigned char)->Apply(imageArgs);
+BENCHMARK_TEMPLATE(BM_Convolve2Separable, float)->Apply(imageArgs);
+BENCHMARK_TEMPLATE(BM_FFTConvolve2, float)->Apply(imageArgs);
+BENCHMARK_TEMPLATE(BM_Convolve3, float)->Apply(volumeArgs);
+BENCHMARK_TEMPLATE(BM_Convolve2NN, float)->Apply(networkArgs);
@@ -0,0 +1,111 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <bench_helpers.hpp>
+
+using af::array;
+using af::dim4;
+using bench::State;
+
+namespace {
+
+/// Powers of two next to lengths with large prime factors, which take the
+/// slower paths of the FFT libraries
+void lengthArgs(bench::Benchmark *b) {
+    for (int64_t length : {1 << 10, 1000, 1 << 16, 65521, 1 << 20, 1000003}) {
+        b->Arg(length);
+    }
+    b->ArgName("length");
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Same for the sides of square inputs and the lengths of batched inputs
+void sizeArgs(bench::Benchmark *b) {
+    for (int64_t size : {128, 127, 512, 509, 2048, 2039}) { b->Arg(size); }
+    b->ArgName("size");
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Complex transform of a real input of type T
+template<typename T>
+void BM_FFT(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    array a = bench::randomArray(state.range(0), type);
+
+    bench::run(state, [&] { return af::fft(a); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// 256 transforms of the same length in one call
+template<typename T>
+void BM_FFTBatched(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    array a = bench::randomArray(dim4(state.range(0), 256), type);
+
+    bench::run(state, [&] { return af::fft(a); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+template<typename T>
+void BM_FFT2(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side = state.range(0);
+    array a          = bench::randomArray(dim4(side, side), type);
+
+    bench::run(state, [&] { return af::fft2(a); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// Real to complex transform, which computes only half of the spectrum
+template<typename T>
+void BM_FFT2R2C(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side = state.range(0);
+    array a          = bench::randomArray(dim4(side, side), type);
+
+    bench::run(state, [&] { return af::fftR2C<2>(a); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// Forward and inverse transform in place of a complex input of type T. The
+/// round trip keeps the values from drifting over the iterations.
+template<typename T>
+void BM_FFT2RoundTripInPlace(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side = state.range(0);
+    array a          = bench::randomArray(dim4(side, side), type);
+
+    bench::run(state, [&] {
+        af::fft2InPlace(a);
+        af::ifft2InPlace(a);
+        return a;
+    });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_FFT, float)->Apply(lengthArgs);
+BENCHMARK_TEMPLATE(BM_FFT, double)->Apply(lengthArgs);
+BENCHMARK_TEMPLATE(BM_FFT, af::cfloat)->Apply(lengthArgs);
+BENCHMARK_TEMPLATE(BM_FFTBatched, float)->Apply(sizeArgs);
+BENCHMARK_TEMPLATE(BM_FFT2, float)->Apply(sizeArgs);
+BENCHMARK_TEMPLATE(BM_FFT2, af::cdouble)->Apply(sizeArgs);
+BENCHMARK_TEMPLATE(BM_FFT2R2C, float)->Apply(sizeArgs);
+BENCHMARK_TEMPLATE(BM_FFT2RoundTripInPlace, af::cfloat)->Apply(sizeArgs);
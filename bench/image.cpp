@@ -0,0 +1,293 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <bench_helpers.hpp>
+
+using af::array;
+using af::dim4;
+using bench::State;
+
+namespace {
+
+/// Square images with windows of 3 to 15 pixels a side
+void windowArgs(bench::Benchmark *b) {
+    b->ArgsProduct({benchmark::CreateRange(128, 2048, 4), {3, 5, 9, 15}});
+    b->ArgNames({"side", "window"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Square images resized by each interpolation method
+void resizeArgs(bench::Benchmark *b) {
+    b->ArgsProduct({benchmark::CreateRange(128, 2048, 4),
+                    {AF_INTERP_NEAREST, AF_INTERP_BILINEAR, AF_INTERP_BICUBIC}});
+    b->ArgNames({"side", "method"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Upsamples by a factor of two
+template<typename T>
+void BM_Resize(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side  = state.range(0);
+    const auto method = static_cast<af::interpType>(state.range(1));
+    array image       = bench::randomArray(dim4(side, side), type);
+
+    bench::run(state, [&] { return af::resize(2.0f, image, method); });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+template<typename T>
+void BM_Dilate(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side   = state.range(0);
+    const dim_t window = state.range(1);
+    array image        = bench::randomArray(dim4(side, side), type);
+    array mask         = af::constant(1, dim4(window, window));
+
+    bench::run(state, [&] { return af::dilate(image, mask); });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+template<typename T>
+void BM_Erode(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side   = state.range(0);
+    const dim_t window = state.range(1);
+    array image        = bench::randomArray(dim4(side, side), type);
+    array mask         = af::constant(1, dim4(window, window));
+
+    bench::run(state, [&] { return af::erode(image, mask); });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+template<typename T>
+void BM_MedFilt(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side   = state.range(0);
+    const dim_t window = state.range(1);
+    array image        = bench::randomArray(dim4(side, side), type);
+
+    bench::run(state, [&] { return af::medfilt2(image, window, window); });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+/// Square images filtered with spatial sigmas of 2 to 8 pixels
+void bilateralArgs(bench::Benchmark *b) {
+    b->ArgsProduct({benchmark::CreateRange(128, 2048, 4), {2, 4, 8}});
+    b->ArgNames({"side", "sigma"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+template<af_bilateral_mode Mode>
+void BM_Bilateral(State &state) {
+    const dim_t side    = state.range(0);
+    const float s_sigma = static_cast<float>(state.range(1));
+    array image         = bench::randomArray(dim4(side, side), f32);
+
+    bench::run(state, [&] {
+        return af::bilateral(image, s_sigma, 20.f, false, Mode);
+    });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+/// Square images searched for square templates of 8 and 32 pixels a side
+void matchArgs(bench::Benchmark *b) {
+    b->ArgsProduct({{512, 2048}, {8, 32}});
+    b->ArgNames({"side", "template"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Adds templates of up to 256 pixels a side for the squared differences,
+/// which the CPU backend correlates with FFTs
+void squaredMatchArgs(bench::Benchmark *b) {
+    b->ArgsProduct({{512, 2048}, {8, 32, 128, 256}});
+    b->ArgNames({"side", "template"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+template<af_match_type Type>
+void BM_MatchTemplate(State &state) {
+    const dim_t side = state.range(0);
+    const dim_t tsz  = state.range(1);
+    array image      = bench::randomArray(dim4(side, side), f32);
+    array tmpl       = image(af::seq(tsz), af::seq(tsz)).copy();
+
+    bench::run(state, [&] { return af::matchTemplate(image, tmpl, Type); });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+/// Labels the connected components of a thresholded noise image, which
+/// has many small regions, with 4 and 8 connectivity
+template<af_connectivity Connectivity>
+void BM_Regions(State &state) {
+    const dim_t side = state.range(0);
+    array binary     = af::randu(dim4(side, side)) > 0.6f;
+
+    bench::run(state, [&] { return af::regions(binary, Connectivity); });
+    bench::setBytesProcessed(state, binary.bytes());
+}
+
+/// Square images searched for corners on arcs of 9 and 12 pixels
+void fastArgs(bench::Benchmark *b) {
+    b->ArgsProduct({benchmark::CreateRange(128, 2048, 4), {9, 12}});
+    b->ArgNames({"side", "arc"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Detects FAST corners in a noise image, which has corners everywhere
+void BM_Fast(State &state) {
+    const dim_t side = state.range(0);
+    const auto arc   = static_cast<unsigned>(state.range(1));
+    array image      = bench::randomArray(dim4(side, side), f32);
+
+    bench::run(state, [&] {
+        return af::fast(image, 0.2f, arc, true, 0.05f).getScore();
+    });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+/// Computes the ORB features and descriptors of a noise image over 4
+/// pyramid levels
+void BM_Orb(State &state) {
+    const dim_t side = state.range(0);
+    array image      = bench::randomArray(dim4(side, side), f32);
+
+    bench::run(state, [&] {
+        af::features feat;
+        array desc;
+        af::orb(feat, desc, image, 0.2f, 1000);
+        return desc;
+    });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+/// Runs 20 iterations of the diffusion on square images
+template<af_diffusion_eq Eq>
+void BM_AnisotropicDiffusion(State &state) {
+    const dim_t side = state.range(0);
+    array image      = bench::randomArray(dim4(side, side), f32);
+
+    bench::run(state, [&] {
+        return af::anisotropicDiffusion(image, 0.125f, 1.0f, 20,
+                                        AF_FLUX_EXPONENTIAL, Eq);
+    });
+    bench::setBytesProcessed(state, 20 * image.bytes());
+}
+
+/// Runs 50 iterations of the deconvolution on square images blurred by a
+/// 13 x 13 Gaussian
+template<af_iterative_deconv_algo Algo>
+void BM_IterativeDeconv(State &state) {
+    const dim_t side = state.range(0);
+    array kernel     = af::gaussianKernel(13, 13, 2.25, 2.25);
+    array image      = af::convolve(
+        bench::randomArray(dim4(side, side), f32) + 0.1f, kernel);
+
+    bench::run(state, [&] {
+        return af::iterativeDeconv(image, kernel, 50, 0.05f, Algo);
+    });
+    bench::setBytesProcessed(state, 50 * image.bytes());
+}
+
+/// Detects the edges of a smoothed noise image with a 3 x 3 Sobel filter
+template<af_canny_threshold Threshold>
+void BM_Canny(State &state) {
+    const dim_t side = state.range(0);
+    array image      = af::convolve(bench::randomArray(dim4(side, side), f32),
+                                    af::gaussianKernel(5, 5));
+
+    bench::run(state,
+               [&] { return af::canny(image, Threshold, 0.1f, 0.3f); });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+/// Finds the 500 strongest Harris corners of a noise image, with a 7 x 7
+/// box window or a Gaussian one of sigma 1
+template<unsigned BlockSize>
+void BM_Harris(State &state) {
+    const dim_t side = state.range(0);
+    array image      = bench::randomArray(dim4(side, side), f32);
+
+    bench::run(state, [&] {
+        return af::harris(image, 500, 1e5f, 1.0f, BlockSize).getScore();
+    });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+/// Finds the SUSAN corners of a noise image with a mask of radius 3
+template<typename T>
+void BM_Susan(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side = state.range(0);
+    array image      = bench::randomArray(dim4(side, side), type);
+
+    bench::run(state, [&] {
+        return af::susan(image, 3, 32.0f, 10.0f, 0.05f, 3).getScore();
+    });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+/// Runs 5 mean shift iterations on a colour image of noisy flat tiles
+void BM_MeanShift(State &state) {
+    const dim_t side = state.range(0);
+    array tiles      = af::resize(
+        bench::randomArray(dim4(side / 32, side / 32, 3), f32), side, side);
+    array image =
+        tiles * 200.f + bench::randomArray(dim4(side, side, 3), f32) * 20.f;
+
+    bench::run(state,
+               [&] { return af::meanShift(image, 5.f, 30.f, 5, true); });
+    bench::setBytesProcessed(state, image.bytes());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Resize, float)->Apply(resizeArgs);
+BENCHMARK_TEMPLATE(BM_Resize, unsigned char)->Apply(resizeArgs);
+BENCHMARK_TEMPLATE(BM_Dilate, float)->Apply(windowArgs);
+BENCHMARK_TEMPLATE(BM_Dilate, unsigned char)->Apply(windowArgs);
+BENCHMARK_TEMPLATE(BM_Erode, float)->Apply(windowArgs);
+BENCHMARK_TEMPLATE(BM_MedFilt, float)->Apply(windowArgs);
+BENCHMARK_TEMPLATE(BM_MedFilt, unsigned char)->Apply(windowArgs);
+BENCHMARK_TEMPLATE(BM_Bilateral, AF_BILATERAL_EXACT)->Apply(bilateralArgs);
+BENCHMARK_TEMPLATE(BM_Bilateral, AF_BILATERAL_GRID)->Apply(bilateralArgs);
+BENCHMARK_TEMPLATE(BM_MatchTemplate, AF_SAD)->Apply(matchArgs);
+BENCHMARK_TEMPLATE(BM_MatchTemplate, AF_SSD)->Apply(squaredMatchArgs);
+BENCHMARK_TEMPLATE(BM_MatchTemplate, AF_ZSSD)->Apply(squaredMatchArgs);
+BENCHMARK_TEMPLATE(BM_Regions, AF_CONNECTIVITY_4)->Apply(bench::squareSizes);
+BENCHMARK_TEMPLATE(BM_Regions, AF_CONNECTIVITY_8)->Apply(bench::squareSizes);
+BENCHMARK(BM_Fast)->Apply(fastArgs);
+BENCHMARK(BM_Orb)->Apply(bench::squareSizes);
+BENCHMARK_TEMPLATE(BM_AnisotropicDiffusion, AF_DIFFUSION_GRAD)
+    ->Apply(bench::squareSizes);
+BENCHMARK_TEMPLATE(BM_AnisotropicDiffusion, AF_DIFFUSION_MCDE)
+    ->Apply(bench::squareSizes);
+BENCHMARK_TEMPLATE(BM_IterativeDeconv, AF_ITERATIVE_DECONV_LANDWEBER)
+    ->Apply(bench::squareSizes);
+BENCHMARK_TEMPLATE(BM_IterativeDeconv, AF_ITERATIVE_DECONV_RICHARDSONLUCY)
+    ->Apply(bench::squareSizes);
+BENCHMARK_TEMPLATE(BM_Canny, AF_CANNY_THRESHOLD_MANUAL)
+    ->Apply(bench::squareSizes);
+BENCHMARK_TEMPLATE(BM_Canny, AF_CANNY_THRESHOLD_AUTO_OTSU)
+    ->Apply(bench::squareSizes);
+BENCHMARK_TEMPLATE(BM_Harris, 0)->Apply(bench::squareSizes);
+BENCHMARK_TEMPLATE(BM_Harris, 7)->Apply(bench::squareSizes);
+BENCHMARK_TEMPLATE(BM_Susan, float)->Apply(bench::squareSizes);
+BENCHMARK_TEMPLATE(BM_Susan, unsigned char)->Apply(bench::squareSizes);
+BENCHMARK(BM_MeanShift)->Apply(bench::squareSizes);
@@ -0,0 +1,107 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <bench_helpers.hpp>
+
+#include <vector>
+
+using af::array;
+using bench::State;
+
+namespace {
+
+/// Elementwise chains of 1 to 64 operations over 4K to 16M elements
+void chainArgs(bench::Benchmark *b) {
+    b->ArgsProduct({benchmark::CreateRange(1 << 12, 1 << 24, 16),
+                    benchmark::CreateRange(1, 64, 4)});
+    b->ArgNames({"elements", "ops"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// 2 to 32 inputs of 4K to 4M elements; kept smaller than chainArgs as every
+/// input is a separate buffer
+void inputArgs(bench::Benchmark *b) {
+    b->ArgsProduct({benchmark::CreateRange(1 << 12, 1 << 22, 16),
+                    benchmark::CreateRange(2, 32, 4)});
+    b->ArgNames({"elements", "inputs"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Multiply-add chain: arithmetic only, one kernel with two inputs
+template<typename T>
+void BM_JITArithmeticChain(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t elements = state.range(0);
+    const int ops        = static_cast<int>(state.range(1));
+    array a              = bench::randomArray(elements, type);
+    array b              = bench::randomArray(elements, type);
+
+    bench::run(state, [&] {
+        array out = a;
+        for (int i = 0; i < ops; i++) { out = out * 0.5 + b; }
+        return out;
+    });
+    bench::setBytesProcessed(state, a.bytes() + b.bytes());
+}
+
+/// Chain of transcendental functions, bound by compute rather than memory
+template<typename T>
+void BM_JITTranscendentalChain(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t elements = state.range(0);
+    const int ops        = static_cast<int>(state.range(1));
+    array a              = bench::randomArray(elements, type);
+
+    bench::run(state, [&] {
+        array out = a;
+        for (int i = 0; i < ops; i++) {
+            out = (i % 2) ? af::sin(out) : af::exp(-out);
+        }
+        return out;
+    });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// Sum of many distinct inputs, which stresses the kernel parameter limits
+/// and the number of buffers read per element
+template<typename T>
+void BM_JITManyInputs(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t elements = state.range(0);
+    const int count      = static_cast<int>(state.range(1));
+    std::vector<array> inputs;
+    size_t bytes = 0;
+    for (int i = 0; i < count; i++) {
+        inputs.push_back(bench::randomArray(elements, type));
+        bytes += inputs.back().bytes();
+    }
+
+    bench::run(state, [&] {
+        array out = inputs[0];
+        for (int i = 1; i < count; i++) { out = out + inputs[i]; }
+        return out;
+    });
+    bench::setBytesProcessed(state, bytes);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_JITArithmeticChain, float)->Apply(chainArgs);
+BENCHMARK_TEMPLATE(BM_JITArithmeticChain, double)->Apply(chainArgs);
+BENCHMARK_TEMPLATE(BM_JITArithmeticChain, af::half)->Apply(chainArgs);
+BENCHMARK_TEMPLATE(BM_JITTranscendentalChain, float)->Apply(chainArgs);
+BENCHMARK_TEMPLATE(BM_JITTranscendentalChain, double)->Apply(chainArgs);
+BENCHMARK_TEMPLATE(BM_JITManyInputs, float)->Apply(inputArgs);
+BENCHMARK_TEMPLATE(BM_JITManyInputs, int)->Apply(inputArgs);
@@ -0,0 +1,62 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+const char *backendName(af::Backend backend) {
+    switch (backend) {
+        case AF_BACKEND_CPU: return "cpu";
+        case AF_BACKEND_CUDA: return "cuda";
+        case AF_BACKEND_OPENCL: return "opencl";
+        default: return "unknown";
+    }
+}
+
+/// Records the library version and the device in the context section of the
+/// reports, so that JSON outputs from different machines can be told apart
+void addContext() {
+    int major = 0, minor = 0, patch = 0;
+    af_get_version(&major, &minor, &patch);
+    benchmark::AddCustomContext(
+        "arrayfire_version", std::to_string(major) + "." +
+                                 std::to_string(minor) + "." +
+                                 std::to_string(patch) + " (" +
+                                 af_get_revision() + ")");
+    benchmark::AddCustomContext("arrayfire_backend",
+                                backendName(af::getActiveBackend()));
+
+    char name[64], platform[64], toolkit[64], compute[64];
+    af::deviceInfo(name, platform, toolkit, compute);
+    benchmark::AddCustomContext("arrayfire_device", name);
+    benchmark::AddCustomContext("arrayfire_platform", platform);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) { return 1; }
+
+    try {
+        addContext();
+    } catch (const af::exception &ex) {
+        fprintf(stderr, "%s\n", ex.what());
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
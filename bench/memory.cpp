@@ -0,0 +1,93 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <bench_helpers.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using af::array;
+using bench::State;
+
+namespace {
+
+/// Buffers of 1KB to 64MB
+void byteArgs(bench::Benchmark *b) {
+    b->RangeMultiplier(32)->Range(1 << 10, 1 << 26);
+    b->ArgName("bytes");
+    b->UseRealTime()->Unit(benchmark::kNanosecond);
+}
+
+/// Allocates and releases one buffer, which the memory manager serves from
+/// its cache after the first iteration
+void BM_AllocRelease(State &state) {
+    const dim_t elements = state.range(0) / 4;
+    try {
+        for (auto _ : state) {
+            array a(elements, f32);
+            benchmark::DoNotOptimize(a.get());
+        }
+    } catch (const af::exception &ex) { state.SkipWithError(ex.what()); }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// Allocates a new buffer every iteration by collecting the cache, which
+/// measures the allocations of the backend itself
+void BM_AllocReleaseCollect(State &state) {
+    const dim_t elements = state.range(0) / 4;
+    try {
+        for (auto _ : state) {
+            {
+                array a(elements, f32);
+                benchmark::DoNotOptimize(a.get());
+            }
+            af::deviceGC();
+        }
+    } catch (const af::exception &ex) { state.SkipWithError(ex.what()); }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// Keeps 16 buffers of pseudo random sizes up to the argument alive and
+/// replaces one of them every iteration, like a program holding a working
+/// set of arrays of different shapes
+void BM_AllocMixedSizes(State &state) {
+    const int64_t max_bytes = state.range(0);
+    std::vector<array> live(16);
+    uint32_t seed = 12345;
+    try {
+        for (auto _ : state) {
+            seed = seed * 1664525u + 1013904223u;
+            const dim_t bytes = 1024 + (seed >> 8) % max_bytes;
+            live[seed % live.size()] = array(bytes / 4, f32);
+        }
+    } catch (const af::exception &ex) { state.SkipWithError(ex.what()); }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// Evaluates a chain of expressions one step at a time, so every step
+/// allocates its result and releases its input
+void BM_EvaluatedTemporaries(State &state) {
+    array a = af::randu(state.range(0) / 4);
+    bench::run(state, [&] {
+        array x = a;
+        for (int i = 0; i < 16; i++) {
+            x = x * 0.5f + 1.0f;
+            x.eval();
+        }
+        return x;
+    });
+    bench::setBytesProcessed(state, 16 * a.bytes());
+}
+
+}  // namespace
+
+BENCHMARK(BM_AllocRelease)->Apply(byteArgs);
+BENCHMARK(BM_AllocReleaseCollect)->Apply(byteArgs);
+BENCHMARK(BM_AllocMixedSizes)->Apply(byteArgs);
+BENCHMARK(BM_EvaluatedTemporaries)->Apply(byteArgs);
@@ -0,0 +1,115 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <bench_helpers.hpp>
+
+using af::array;
+using af::dim4;
+using bench::State;
+
+namespace {
+
+/// Reductions over each dimension of a 4D array of 64K to 16M elements. The
+/// reduced dimension gets the largest extent so the dimensions compare at
+/// the same size.
+void dimArgs(bench::Benchmark *b) {
+    b->ArgsProduct(
+        {benchmark::CreateRange(1 << 16, 1 << 24, 16), {0, 1, 2, 3}});
+    b->ArgNames({"elements", "dim"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// Shape of \p elements values with most of them along \p dim
+dim4 reduceDims(dim_t elements, int dim) {
+    dim4 dims(4, 4, 4, 4);
+    dims[dim] = elements / 64;
+    return dims;
+}
+
+template<typename T>
+void BM_Sum(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const int dim = static_cast<int>(state.range(1));
+    array a       = bench::randomArray(reduceDims(state.range(0), dim), type);
+
+    bench::run(state, [&] { return af::sum(a, dim); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+template<typename T>
+void BM_Max(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const int dim = static_cast<int>(state.range(1));
+    array a       = bench::randomArray(reduceDims(state.range(0), dim), type);
+
+    bench::run(state, [&] { return af::max(a, dim); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// Maximum together with its location, which carries an index per element
+template<typename T>
+void BM_MaxIndexed(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const int dim = static_cast<int>(state.range(1));
+    array a       = bench::randomArray(reduceDims(state.range(0), dim), type);
+
+    bench::run(state, [&] {
+        array val, idx;
+        af::max(val, idx, a, dim);
+        af::eval(val, idx);
+        return val;
+    });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// Reduction of all elements to a scalar
+template<typename T>
+void BM_SumAll(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    array a = bench::randomArray(state.range(0), type);
+
+    bench::run(state, [&] { return af::sum(a); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// Reduction of an unevaluated expression, which can fuse with the JIT
+template<typename T>
+void BM_SumOfExpression(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const int dim   = static_cast<int>(state.range(1));
+    const dim4 dims = reduceDims(state.range(0), dim);
+    array a         = bench::randomArray(dims, type);
+    array b         = bench::randomArray(dims, type);
+
+    bench::run(state, [&] { return af::sum(a * b + 1, dim); });
+    bench::setBytesProcessed(state, a.bytes() + b.bytes());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Sum, float)->Apply(dimArgs);
+BENCHMARK_TEMPLATE(BM_Sum, double)->Apply(dimArgs);
+BENCHMARK_TEMPLATE(BM_Sum, int)->Apply(dimArgs);
+BENCHMARK_TEMPLATE(BM_Max, float)->Apply(dimArgs);
+BENCHMARK_TEMPLATE(BM_Max, unsigned char)->Apply(dimArgs);
+BENCHMARK_TEMPLATE(BM_MaxIndexed, float)->Apply(dimArgs);
+BENCHMARK_TEMPLATE(BM_SumOfExpression, float)->Apply(dimArgs);
+BENCHMARK_TEMPLATE(BM_SumAll, float)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_SumAll, double)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_SumAll, int)->Apply(bench::elementCounts);
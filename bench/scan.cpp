@@ -0,0 +1,86 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <bench_helpers.hpp>
+
+using af::array;
+using bench::State;
+
+namespace {
+
+/// Scans along the columns and along the rows of square matrices
+void dimArgs(bench::Benchmark *b) {
+    b->ArgsProduct({benchmark::CreateRange(128, 2048, 4), {0, 1}});
+    b->ArgNames({"side", "dim"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+template<typename T>
+void BM_Accum(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side = state.range(0);
+    const int dim    = static_cast<int>(state.range(1));
+    array a          = bench::randomArray(af::dim4(side, side), type);
+
+    bench::run(state, [&] { return af::accum(a, dim); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// Inclusive scan of a long vector, which the backends split into blocks
+template<typename T>
+void BM_Accum1D(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    array a = bench::randomArray(state.range(0), type);
+
+    bench::run(state, [&] { return af::accum(a); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// Exclusive scan with a multiplicative operator
+template<typename T>
+void BM_ScanProductExclusive(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t side = state.range(0);
+    const int dim    = static_cast<int>(state.range(1));
+    array a          = bench::randomArray(af::dim4(side, side), type);
+
+    bench::run(state, [&] { return af::scan(a, dim, AF_BINARY_MUL, false); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// Scan by key with runs of about 16 equal keys
+template<typename T>
+void BM_ScanByKey(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t elements = state.range(0);
+    array keys = (af::range(af::dim4(elements), 0, s32) / 16).as(s32);
+    array vals = bench::randomArray(elements, type);
+
+    bench::run(state, [&] { return af::scanByKey(keys, vals); });
+    bench::setBytesProcessed(state, keys.bytes() + vals.bytes());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Accum, float)->Apply(dimArgs);
+BENCHMARK_TEMPLATE(BM_Accum, double)->Apply(dimArgs);
+BENCHMARK_TEMPLATE(BM_Accum, int)->Apply(dimArgs);
+BENCHMARK_TEMPLATE(BM_Accum1D, float)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_Accum1D, int)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_ScanProductExclusive, float)->Apply(dimArgs);
+BENCHMARK_TEMPLATE(BM_ScanByKey, float)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_ScanByKey, int)->Apply(bench::elementCounts);
@@ -0,0 +1,105 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <bench_helpers.hpp>
+
+using af::array;
+using bench::State;
+
+namespace {
+
+/// Batches of 1 to 256 columns holding 64K elements in total, from one long
+/// vector to many short ones
+void batchArgs(bench::Benchmark *b) {
+    b->ArgsProduct({{1 << 16}, benchmark::CreateRange(1, 256, 16)});
+    b->ArgNames({"elements", "columns"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+template<typename T>
+void BM_Sort(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    array a = bench::randomArray(state.range(0), type);
+
+    bench::run(state, [&] { return af::sort(a); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+template<typename T>
+void BM_SortDescending(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    array a = bench::randomArray(state.range(0), type);
+
+    bench::run(state, [&] { return af::sort(a, 0, false); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// Sort of the columns of a matrix with the same number of elements
+template<typename T>
+void BM_SortBatched(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const dim_t columns = state.range(1);
+    array a = bench::randomArray(af::dim4(state.range(0) / columns, columns),
+                                 type);
+
+    bench::run(state, [&] { return af::sort(a); });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+template<typename T>
+void BM_SortIndex(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    array a = bench::randomArray(state.range(0), type);
+
+    bench::run(state, [&] {
+        array out, idx;
+        af::sort(out, idx, a);
+        af::eval(out, idx);
+        return out;
+    });
+    bench::setBytesProcessed(state, a.bytes());
+}
+
+/// Sort of float values by keys of type T
+template<typename T>
+void BM_SortByKey(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    array keys = bench::randomArray(state.range(0), type);
+    array vals = bench::randomArray(state.range(0), f32);
+
+    bench::run(state, [&] {
+        array out_keys, out_vals;
+        af::sort(out_keys, out_vals, keys, vals);
+        af::eval(out_keys, out_vals);
+        return out_keys;
+    });
+    bench::setBytesProcessed(state, keys.bytes() + vals.bytes());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Sort, float)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_Sort, double)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_Sort, int)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_Sort, unsigned char)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_SortDescending, float)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_SortBatched, float)->Apply(batchArgs);
+BENCHMARK_TEMPLATE(BM_SortIndex, float)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_SortByKey, float)->Apply(bench::elementCounts);
+BENCHMARK_TEMPLATE(BM_SortByKey, int)->Apply(bench::elementCounts);
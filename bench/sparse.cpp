@@ -0,0 +1,96 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <bench_helpers.hpp>
+
+#include <algorithm>
+
+using af::array;
+using af::dim4;
+using bench::State;
+
+namespace {
+
+/// Square matrices of 1K to 16K rows holding 1, 10 or 100 non zeros per
+/// thousand elements
+void matrixArgs(bench::Benchmark *b) {
+    b->ArgsProduct({{1 << 10, 1 << 12, 1 << 14}, {1, 10, 100}});
+    b->ArgNames({"rows", "permille"});
+    b->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+
+/// CSR matrix of \p rows square with the same number of non zeros in each
+/// row, spread over the columns without building the dense matrix
+array sparseMatrix(int rows, int permille, af::dtype type) {
+    const int per_row = std::max(1, rows * permille / 1000);
+    const int stride  = rows / per_row;
+
+    array row    = af::range(dim4(per_row, rows), 1, s32);
+    array slot   = af::range(dim4(per_row, rows), 0, s32);
+    array cols   = af::flat(slot * stride + (row * 7919) % stride);
+    array starts = af::range(dim4(rows + 1), 0, s32) * per_row;
+    array values = bench::randomArray(dim4(per_row * rows), type);
+
+    return af::sparse(rows, rows, values, starts, cols, AF_STORAGE_CSR);
+}
+
+/// Sparse matrix times a dense vector
+template<typename T>
+void BM_SpMV(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const int rows = static_cast<int>(state.range(0));
+    array a        = sparseMatrix(rows, static_cast<int>(state.range(1)), type);
+    array x        = bench::randomArray(rows, type);
+
+    bench::run(state, [&] { return af::matmul(a, x); });
+    bench::setBytesProcessed(
+        state, af::sparseGetValues(a).bytes() + af::sparseGetColIdx(a).bytes());
+}
+
+/// Sparse matrix times a dense matrix of 64 columns
+template<typename T>
+void BM_SpMM(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const int rows = static_cast<int>(state.range(0));
+    array a        = sparseMatrix(rows, static_cast<int>(state.range(1)), type);
+    array x        = bench::randomArray(dim4(rows, 64), type);
+
+    bench::run(state, [&] { return af::matmul(a, x); });
+    bench::setBytesProcessed(
+        state, af::sparseGetValues(a).bytes() + af::sparseGetColIdx(a).bytes());
+}
+
+/// Transposed sparse matrix times a dense vector, which scatters into the
+/// output instead of gathering from the input
+template<typename T>
+void BM_SpMVTransposed(State &state) {
+    const af::dtype type = bench::dtypeOf<T>();
+    if (!bench::supported(state, type)) { return; }
+
+    const int rows = static_cast<int>(state.range(0));
+    array a        = sparseMatrix(rows, static_cast<int>(state.range(1)), type);
+    array x        = bench::randomArray(rows, type);
+
+    bench::run(state, [&] { return af::matmul(a, x, AF_MAT_TRANS); });
+    bench::setBytesProcessed(
+        state, af::sparseGetValues(a).bytes() + af::sparseGetColIdx(a).bytes());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_SpMV, float)->Apply(matrixArgs);
+BENCHMARK_TEMPLATE(BM_SpMV, double)->Apply(matrixArgs);
+BENCHMARK_TEMPLATE(BM_SpMV, af::cfloat)->Apply(matrixArgs);
+BENCHMARK_TEMPLATE(BM_SpMM, float)->Apply(matrixArgs);
+BENCHMARK_TEMPLATE(BM_SpMM, double)->Apply(matrixArgs);
+BENCHMARK_TEMPLATE(BM_SpMVTransposed, float)->Apply(matrixArgs);
@@ -0,0 +1,145 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <af/exception.h>
+
+/// This file contain functions that apply only to the CPU backend.
+///
+/// The CPU backend runs its kernels on a worker thread fed by a queue. By
+/// default every host thread shares the same queue; streams give a host
+/// thread a queue of its own so independent pipelines do not wait on each
+/// other. Setting AF_CPU_PER_THREAD_QUEUE=1 creates one stream per host thread
+/// automatically. Arrays can be passed between streams freely and \ref
+/// af_mark_event / \ref af_enqueue_wait_event work across them.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if AF_API_VERSION >= 39
+/**
+   Create a new stream on the CPU backend
+
+   \param[out] stream the identifier of the new stream
+   \returns \ref af_err error code
+
+   \ingroup cpu_mat
+ */
+AFAPI af_err afcpu_create_stream(int *stream);
+
+/**
+   Make \p stream the stream used by the calling host thread
+
+   \param[in] stream the stream identifier. 0 selects the default stream,
+              also when AF_CPU_PER_THREAD_QUEUE=1
+   \returns \ref af_err error code
+
+   \ingroup cpu_mat
+ */
+AFAPI af_err afcpu_set_stream(int stream);
+
+/**
+   Get the stream used by the calling host thread
+
+   \param[out] stream the stream identifier. 0 is the default stream
+   \returns \ref af_err error code
+
+   \ingroup cpu_mat
+ */
+AFAPI af_err afcpu_get_stream(int *stream);
+
+/**
+   Wait for the work queued on \p stream and destroy it
+
+   Fails with \ref AF_ERR_ARG while the stream is active on another host
+   thread.
+
+   \param[in] stream the stream identifier
+   \returns \ref af_err error code
+
+   \ingroup cpu_mat
+ */
+AFAPI af_err afcpu_destroy_stream(int stream);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+namespace afcpu
+{
+
+#if AF_API_VERSION >= 39
+/**
+   Create a new stream on the CPU backend
+
+   \returns the identifier of the new stream
+
+   \ingroup cpu_mat
+ */
+static inline int createStream()
+{
+    int retVal;
+    af_err err = afcpu_create_stream(&retVal);
+    if (err!=AF_SUCCESS)
+        throw af::exception("Failed to create CPU stream");
+    return retVal;
+}
+
+/**
+   Make \p stream the stream used by the calling host thread
+
+   \param[in] stream the stream identifier. 0 selects the default stream
+
+   \ingroup cpu_mat
+ */
+static inline void setStream(int stream)
+{
+    af_err err = afcpu_set_stream(stream);
+    if (err!=AF_SUCCESS)
+        throw af::exception("Failed to set CPU stream");
+}
+
+/**
+   Get the stream used by the calling host thread
+
+   \returns the stream identifier. 0 is the default stream
+
+   \ingroup cpu_mat
+ */
+static inline int getStream()
+{
+    int retVal;
+    af_err err = afcpu_get_stream(&retVal);
+    if (err!=AF_SUCCESS)
+        throw af::exception("Failed to get CPU stream");
+    return retVal;
+}
+
+/**
+   Wait for the work queued on \p stream and destroy it
+
+   \param[in] stream the stream identifier
+
+   \ingroup cpu_mat
+ */
+static inline void destroyStream(int stream)
+{
+    af_err err = afcpu_destroy_stream(stream);
+    if (err!=AF_SUCCESS)
+        throw af::exception("Failed to destroy CPU stream");
+}
+#endif
+
+}
+#endif
@@ -546,6 +546,14 @@ typedef enum {
 } af_conv_gradient_type;
 #endif
 
+#if AF_API_VERSION >= 39
+typedef enum {
+    AF_BILATERAL_EXACT   = 1,   ///< Weighs every pixel of the spatial window
+    AF_BILATERAL_GRID    = 2,   ///< Approximates the filter on a bilateral grid, at a cost independent of the spatial sigma
+    AF_BILATERAL_DEFAULT = 0    ///< Default is AF_BILATERAL_EXACT
+} af_bilateral_mode;
+#endif
+
 #ifdef __cplusplus
 namespace af
 {
@@ -601,6 +609,9 @@ namespace af
     typedef af_inverse_deconv_algo inverseDeconvAlgo;
     typedef af_conv_gradient_type convGradientType;
 #endif
+#if AF_API_VERSION >= 39
+    typedef af_bilateral_mode bilateralMode;
+#endif
 }
 
 #endif
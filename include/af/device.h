@@ -289,6 +289,33 @@ namespace af
     ///
     /// \ingroup device_func_mem
     AFAPI size_t getMemStepSize();
+
+#if AF_API_VERSION >= 39
+    /// \brief Set the number of threads the CPU backend computes on
+    ///
+    /// Applies to the kernels as well as to the BLAS library. Waits for all
+    /// queued work before changing the pool. Throws on other backends.
+    ///
+    /// \ingroup device_func_prop
+    AFAPI void setNumThreads(const int num_threads);
+
+    /// \brief Get the number of threads the CPU backend computes on
+    ///
+    /// \ingroup device_func_prop
+    AFAPI int getNumThreads();
+
+    /// \brief Start recording a trace of the work done by ArrayFire
+    ///
+    /// See af_start_trace().
+    ///
+    /// \ingroup device_func_prop
+    AFAPI void startTrace(const char *filename);
+
+    /// \brief Stop recording the trace and write it
+    ///
+    /// \ingroup device_func_prop
+    AFAPI void stopTrace();
+#endif
 }
 #endif
 
@@ -619,6 +646,68 @@ extern "C" {
 
 #endif
 
+#if AF_API_VERSION >= 39
+    /**
+       Set the number of threads the CPU backend computes on
+
+       The kernels and the BLAS library share this setting. The default is
+       the number of logical CPUs or the value of the AF_CPU_NUM_THREADS
+       environment variable. Setting AF_CPU_THREAD_AFFINITY=1 pins each
+       thread to one CPU.
+
+       \param[in] num_threads the number of threads, including the thread
+                              issuing the work
+       \returns \ref AF_SUCCESS, \ref AF_ERR_ARG if \p num_threads is not
+                positive or \ref AF_ERR_NOT_SUPPORTED on other backends
+
+       \ingroup device_func_prop
+    */
+    AFAPI af_err af_set_num_threads(const int num_threads);
+
+    /**
+       Get the number of threads the CPU backend computes on
+
+       \param[out] num_threads the number of threads
+       \returns \ref AF_SUCCESS or \ref AF_ERR_NOT_SUPPORTED on other backends
+
+       \ingroup device_func_prop
+    */
+    AFAPI af_err af_get_num_threads(int *num_threads);
+
+    /**
+       Start recording a trace of the work done by ArrayFire
+
+       Records the C API calls, the tasks run by the CPU backend, the JIT
+       evaluations with the reason they were triggered and the allocations of
+       the default memory manager. Events of an earlier recording that was
+       not stopped are discarded. GPU work is timed on the host.
+
+       The trace is written in the Chrome trace event format, which Perfetto
+       (https://ui.perfetto.dev) and chrome://tracing can load. Setting the
+       AF_TRACE_FILE environment variable records the whole run of a program
+       to a file per backend named after it, e.g. trace.cpu.json for
+       AF_TRACE_FILE=trace.json.
+
+       \param[in] filename the file af_stop_trace() writes the trace to
+       \returns \ref AF_SUCCESS or \ref AF_ERR_ARG if \p filename is NULL
+
+       \ingroup device_func_prop
+    */
+    AFAPI af_err af_start_trace(const char *filename);
+
+    /**
+       Stop recording the trace and write it to the file given to
+       af_start_trace()
+
+       Does nothing when no trace is being recorded.
+
+       \returns \ref AF_SUCCESS
+
+       \ingroup device_func_prop
+    */
+    AFAPI af_err af_stop_trace();
+#endif
+
 #ifdef __cplusplus
 }
 #endif
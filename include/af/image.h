@@ -297,6 +297,26 @@ AFAPI array skew(const array& in, const float skew0, const float skew1, const di
 */
 AFAPI array bilateral(const array &in, const float spatial_sigma, const float chromatic_sigma, const bool is_color=false);
 
+#if AF_API_VERSION >= 39
+/**
+    C++ Interface for bilateral filter with a choice of algorithm
+
+    \ref AF_BILATERAL_GRID approximates the filter on a coarse grid over
+    space and intensity, so its cost does not grow with \p spatial_sigma.
+    It is only available on the CPU backend.
+
+    \param[in]  in array is the input image
+    \param[in]  spatial_sigma is the spatial variance parameter that decides the filter window
+    \param[in]  chromatic_sigma is the chromatic variance parameter
+    \param[in]  is_color indicates if the input \p in is color image or grayscale
+    \param[in]  mode is the algorithm used to compute the filter
+    \return     the processed image
+
+    \ingroup image_func_bilateral
+*/
+AFAPI array bilateral(const array &in, const float spatial_sigma, const float chromatic_sigma, const bool is_color, const bilateralMode mode);
+#endif
+
 /**
    C++ Interface for histogram
 
@@ -780,6 +800,38 @@ AFAPI array anisotropicDiffusion(const af::array& in, const float timestep,
 AFAPI array iterativeDeconv(const array& in, const array& ker,
                             const unsigned iterations, const float relaxFactor,
                             const iterativeDeconvAlgo algo);
+#endif
+
+#if AF_API_VERSION >= 39
+/**
+  C++ Interface for Iterative deconvolution algorithm with early stopping
+
+  \param[in] in is the blurred input image
+  \param[in] ker is the kernel(point spread function) known to have caused
+             the blur in the system
+  \param[in] iterations is the maximum number of iterations the algorithm
+             will run
+  \param[in] relaxFactor is the relaxation factor multiplied with distance
+             of estimate from observed image.
+  \param[in] algo takes value of type enum \ref af_iterative_deconv_algo
+             indicating the iterative deconvolution algorithm to be used
+  \param[in] tolerance stops the iterations once one changes the estimate
+             by at most \p tolerance times its norm. All \p iterations are
+             run when it is zero.
+  \return sharp image estimate generated from the blurred input
+
+  \note \p relaxFactor argument is ignored when
+  \ref AF_ITERATIVE_DECONV_RICHARDSONLUCY algorithm is used.
+
+  \ingroup image_func_iterative_deconv
+ */
+AFAPI array iterativeDeconv(const array& in, const array& ker,
+                            const unsigned iterations, const float relaxFactor,
+                            const iterativeDeconvAlgo algo,
+                            const float tolerance);
+#endif
+
+#if AF_API_VERSION >= 37
 
 /**
    C++ Interface for Tikhonov deconvolution algorithm
@@ -1261,6 +1313,29 @@ extern "C" {
     */
     AFAPI af_err af_bilateral(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const bool isColor);
 
+#if AF_API_VERSION >= 39
+    /**
+        C Interface for bilateral filter with a choice of algorithm
+
+        \ref AF_BILATERAL_GRID approximates the filter on a coarse grid over
+        space and intensity, so its cost does not grow with \p spatial_sigma.
+        It is only available on the CPU backend.
+
+        \param[out] out array is the processed image
+        \param[in]  in array is the input image
+        \param[in]  spatial_sigma is the spatial variance parameter that decides the filter window
+        \param[in]  chromatic_sigma is the chromatic variance parameter
+        \param[in]  isColor indicates if the input \p in is color image or grayscale
+        \param[in]  mode is the algorithm used to compute the filter
+        \return     \ref AF_SUCCESS if the filter is applied successfully,
+        \ref AF_ERR_NOT_SUPPORTED if \p mode is not available on the
+        backend, otherwise an appropriate error code is returned.
+
+        \ingroup image_func_bilateral
+    */
+    AFAPI af_err af_bilateral_v2(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const bool isColor, const af_bilateral_mode mode);
+#endif
+
     /**
         C Interface for mean shift
 
@@ -1740,6 +1815,42 @@ extern "C" {
                                      const unsigned iterations,
                                      const float relax_factor,
                                      const af_iterative_deconv_algo algo);
+#endif
+
+#if AF_API_VERSION >= 39
+    /**
+       C Interface for Iterative deconvolution algorithm with early stopping
+
+       \param[out] out is the sharp estimate generated from the blurred input
+       \param[in] in is the blurred input image
+       \param[in] ker is the kernel(point spread function) known to have caused
+                  the blur in the system
+       \param[in] iterations is the maximum number of iterations the
+                  algorithm will run
+       \param[in] relax_factor is the relaxation factor multiplied with
+                  distance of estimate from observed image.
+       \param[in] algo takes value of type enum \ref af_iterative_deconv_algo
+                  indicating the iterative deconvolution algorithm to be used
+       \param[in] tolerance stops the iterations once one changes the
+                  estimate by at most \p tolerance times its norm. All
+                  \p iterations are run when it is zero.
+       \return \ref AF_SUCCESS if the deconvolution is successful,
+       otherwise an appropriate error code is returned.
+
+       \note \p relax_factor argument is ignored when
+       \ref AF_ITERATIVE_DECONV_RICHARDSONLUCY algorithm is used.
+
+       \ingroup image_func_iterative_deconv
+     */
+    AFAPI af_err af_iterative_deconv_v2(af_array* out,
+                                        const af_array in, const af_array ker,
+                                        const unsigned iterations,
+                                        const float relax_factor,
+                                        const af_iterative_deconv_algo algo,
+                                        const float tolerance);
+#endif
+
+#if AF_API_VERSION >= 37
 
     /**
        C Interface for Tikhonov deconvolution algorithm
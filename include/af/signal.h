@@ -706,6 +706,25 @@ AFAPI array fir(const array &b, const array &x);
 */
 AFAPI array iir(const array &b, const array &a, const array &x);
 
+#if AF_API_VERSION >= 39
+/**
+   C++ Interface for infinite impulse response filter given as a cascade of
+   second order sections
+
+   Each column of \p sos holds one section as
+   `[b0, b1, b2, a0, a1, a2]`. The sections are applied one after another,
+   which is numerically better behaved than expanding a high order filter
+   into a single pair of polynomials.
+
+   \param[in] sos is a 6 x N array containing N second order sections
+   \param[in] x is the input signal to the filter
+   \returns the output signal from the filter
+
+   \ingroup signal_func_iir
+*/
+AFAPI array iirSos(const array &sos, const array &x);
+#endif
+
 /**
     C++ Interface for median filter
 
@@ -1544,6 +1563,21 @@ AFAPI af_err af_fir(af_array *y, const af_array b, const af_array x);
 */
 AFAPI af_err af_iir(af_array *y, const af_array b, const af_array a, const af_array x);
 
+#if AF_API_VERSION >= 39
+/**
+   C Interface for infinite impulse response filter given as a cascade of
+   second order sections
+
+   \param[out] y is the output signal from the filter
+   \param[in] sos is a 6 x N array, each column holding the coefficients
+              `[b0, b1, b2, a0, a1, a2]` of one second order section
+   \param[in] x is the input signal to the filter
+
+   \ingroup signal_func_iir
+*/
+AFAPI af_err af_iir_sos(af_array *y, const af_array sos, const af_array x);
+#endif
+
     /**
         C Interface for median filter
 
@@ -8,6 +8,7 @@
  ********************************************************/
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/half.hpp>
 #include <copy.hpp>
 #include <handle.hpp>
@@ -70,6 +71,7 @@ af_array createHandleFromValue(const dim4 &d, double val, af_dtype dtype) {
 }
 
 af_err af_get_data_ptr(void *data, const af_array arr) {
+    AF_PROFILE_API();
     try {
         af_dtype type = getInfo(arr).getType();
         // clang-format off
@@ -99,6 +101,7 @@ af_err af_get_data_ptr(void *data, const af_array arr) {
 af_err af_create_array(af_array *result, const void *const data,
                        const unsigned ndims, const dim_t *const dims,
                        const af_dtype type) {
+    AF_PROFILE_API();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -160,6 +163,7 @@ af_err af_create_array(af_array *result, const void *const data,
 // Strong Exception Guarantee
 af_err af_create_handle(af_array *result, const unsigned ndims,
                         const dim_t *const dims, const af_dtype type) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
 
@@ -177,6 +181,7 @@ af_err af_create_handle(af_array *result, const unsigned ndims,
 
 // Strong Exception Guarantee
 af_err af_copy_array(af_array *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info = getInfo(in, false);
         const af_dtype type   = info.getType();
@@ -226,6 +231,7 @@ af_err af_copy_array(af_array *out, const af_array in) {
 
 // Strong Exception Guarantee
 af_err af_get_data_ref_count(int *use_count, const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info = getInfo(in, false, false);
         const af_dtype type   = info.getType();
@@ -254,6 +260,7 @@ af_err af_get_data_ref_count(int *use_count, const af_array in) {
 }
 
 af_err af_release_array(af_array arr) {
+    AF_PROFILE_API();
     try {
         if (arr == 0) { return AF_SUCCESS; }
         const ArrayInfo &info = getInfo(arr, false, false);
@@ -324,6 +331,7 @@ af_array retain(const af_array in) {
 }
 
 af_err af_retain_array(af_array *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         *out = retain(in);
     }
@@ -343,6 +351,7 @@ void write_array(af_array arr, const T *const data, const size_t bytes,
 
 af_err af_write_array(af_array arr, const void *data, const size_t bytes,
                       af_source src) {
+    AF_PROFILE_API();
     if (bytes == 0) { return AF_SUCCESS; }
     try {
         af_dtype type = getInfo(arr).getType();
@@ -400,6 +409,7 @@ af_err af_write_array(af_array arr, const void *data, const size_t bytes,
 }
 
 af_err af_get_elements(dim_t *elems, const af_array arr) {
+    AF_PROFILE_API();
     try {
         // Do not check for device mismatch
         *elems = getInfo(arr, false, false).elements();
@@ -409,6 +419,7 @@ af_err af_get_elements(dim_t *elems, const af_array arr) {
 }
 
 af_err af_get_type(af_dtype *type, const af_array arr) {
+    AF_PROFILE_API();
     try {
         // Do not check for device mismatch
         *type = getInfo(arr, false, false).getType();
@@ -419,6 +430,7 @@ af_err af_get_type(af_dtype *type, const af_array arr) {
 
 af_err af_get_dims(dim_t *d0, dim_t *d1, dim_t *d2, dim_t *d3,
                    const af_array in) {
+    AF_PROFILE_API();
     try {
         // Do not check for device mismatch
         const ArrayInfo &info = getInfo(in, false, false);
@@ -432,6 +444,7 @@ af_err af_get_dims(dim_t *d0, dim_t *d1, dim_t *d2, dim_t *d3,
 }
 
 af_err af_get_numdims(unsigned *nd, const af_array in) {
+    AF_PROFILE_API();
     try {
         // Do not check for device mismatch
         const ArrayInfo &info = getInfo(in, false, false);
@@ -476,6 +489,7 @@ inline void getScalar(T *out, const af_array &arr) {
 }
 
 af_err af_get_scalar(void *output_value, const af_array arr) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(0, (output_value != NULL));
 
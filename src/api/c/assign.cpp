@@ -11,6 +11,7 @@
 #include <Array.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/complex.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
@@ -130,6 +131,7 @@ static if_real<T> assign(Array<T>& out, const vector<af_seq> iv,
 
 af_err af_assign_seq(af_array* out, const af_array lhs, const unsigned ndims,
                      const af_seq* index, const af_array rhs) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (ndims > 0 && ndims <= AF_MAX_DIMS));
         ARG_ASSERT(1, (lhs != 0));
@@ -224,6 +226,7 @@ inline void genAssign(af_array& out, const af_index_t* indexs,
 
 af_err af_assign_gen(af_array* out, const af_array lhs, const dim_t ndims,
                      const af_index_t* indexs, const af_array rhs_) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (ndims > 0 && ndims <= AF_MAX_DIMS));
         ARG_ASSERT(3, (indexs != NULL));
@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <bilateral.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <af/defines.h>
@@ -27,35 +28,68 @@ using std::is_same;
 
 template<typename T>
 inline af_array bilateral(const af_array &in, const float &sp_sig,
-                          const float &chr_sig) {
+                          const float &chr_sig, const af_bilateral_mode mode) {
     using OutType =
         typename conditional<is_same<T, double>::value, double, float>::type;
+    if (mode == AF_BILATERAL_GRID) {
+#if defined(AF_CPU)
+        return getHandle(detail::bilateralGrid<T, OutType>(getArray<T>(in),
+                                                           sp_sig, chr_sig));
+#else
+        AF_ERROR("Bilateral grid mode is only available on the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
     return getHandle(bilateral<T, OutType>(getArray<T>(in), sp_sig, chr_sig));
 }
 
+static void af_bilateral_common(af_array *out, const af_array in,
+                                const float ssigma, const float csigma,
+                                const af_bilateral_mode mode) {
+    const ArrayInfo &info = getInfo(in);
+    af_dtype type         = info.getType();
+    af::dim4 dims         = info.dims();
+
+    DIM_ASSERT(1, (dims.ndims() >= 2));
+    ARG_ASSERT(5, (mode == AF_BILATERAL_DEFAULT || mode == AF_BILATERAL_EXACT ||
+                   mode == AF_BILATERAL_GRID));
+
+    af_array output = nullptr;
+    // clang-format off
+    switch (type) {
+        case f64: output = bilateral<double>(in, ssigma, csigma, mode); break;
+        case f32: output = bilateral<float >(in, ssigma, csigma, mode); break;
+        case b8:  output = bilateral<char  >(in, ssigma, csigma, mode); break;
+        case s32: output = bilateral<int   >(in, ssigma, csigma, mode); break;
+        case u32: output = bilateral<uint  >(in, ssigma, csigma, mode); break;
+        case u8:  output = bilateral<uchar >(in, ssigma, csigma, mode); break;
+        case s16: output = bilateral<short >(in, ssigma, csigma, mode); break;
+        case u16: output = bilateral<ushort>(in, ssigma, csigma, mode); break;
+        default:  TYPE_ERROR(1, type);
+    }
+    // clang-format on
+    std::swap(*out, output);
+}
+
 af_err af_bilateral(af_array *out, const af_array in, const float ssigma,
                     const float csigma, const bool iscolor) {
+    AF_PROFILE_API();
+    UNUSED(iscolor);
+    try {
+        af_bilateral_common(out, in, ssigma, csigma, AF_BILATERAL_EXACT);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_bilateral_v2(af_array *out, const af_array in, const float ssigma,
+                       const float csigma, const bool iscolor,
+                       const af_bilateral_mode mode) {
+    AF_PROFILE_API();
     UNUSED(iscolor);
     try {
-        const ArrayInfo &info = getInfo(in);
-        af_dtype type         = info.getType();
-        af::dim4 dims         = info.dims();
-
-        DIM_ASSERT(1, (dims.ndims() >= 2));
-
-        af_array output = nullptr;
-        switch (type) {
-            case f64: output = bilateral<double>(in, ssigma, csigma); break;
-            case f32: output = bilateral<float>(in, ssigma, csigma); break;
-            case b8: output = bilateral<char>(in, ssigma, csigma); break;
-            case s32: output = bilateral<int>(in, ssigma, csigma); break;
-            case u32: output = bilateral<uint>(in, ssigma, csigma); break;
-            case u8: output = bilateral<uchar>(in, ssigma, csigma); break;
-            case s16: output = bilateral<short>(in, ssigma, csigma); break;
-            case u16: output = bilateral<ushort>(in, ssigma, csigma); break;
-            default: TYPE_ERROR(1, type);
-        }
-        std::swap(*out, output);
+        af_bilateral_common(out, in, ssigma, csigma, mode);
     }
     CATCHALL;
 
@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/moddims.hpp>
 #include <common/tile.hpp>
@@ -262,6 +263,7 @@ static af_err af_arith_sparse_dense(af_array *out, const af_array lhs,
 
 af_err af_add(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_PROFILE_API();
     // Check if inputs are sparse
     const ArrayInfo &linfo = getInfo(lhs, false, true);
     const ArrayInfo &rinfo = getInfo(rhs, false, true);
@@ -281,6 +283,7 @@ af_err af_add(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_mul(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_PROFILE_API();
     // Check if inputs are sparse
     const ArrayInfo &linfo = getInfo(lhs, false, true);
     const ArrayInfo &rinfo = getInfo(rhs, false, true);
@@ -303,6 +306,7 @@ af_err af_mul(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_sub(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_PROFILE_API();
     // Check if inputs are sparse
     const ArrayInfo &linfo = getInfo(lhs, false, true);
     const ArrayInfo &rinfo = getInfo(rhs, false, true);
@@ -322,6 +326,7 @@ af_err af_sub(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_div(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_PROFILE_API();
     // Check if inputs are sparse
     const ArrayInfo &linfo = getInfo(lhs, false, true);
     const ArrayInfo &rinfo = getInfo(rhs, false, true);
@@ -347,26 +352,31 @@ af_err af_div(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_maxof(af_array *out, const af_array lhs, const af_array rhs,
                 const bool batchMode) {
+    AF_PROFILE_API();
     return af_arith<af_max_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_minof(af_array *out, const af_array lhs, const af_array rhs,
                 const bool batchMode) {
+    AF_PROFILE_API();
     return af_arith<af_min_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_rem(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_PROFILE_API();
     return af_arith_real<af_rem_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_mod(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_PROFILE_API();
     return af_arith_real<af_mod_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_pow(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &linfo = getInfo(lhs);
         const ArrayInfo &rinfo = getInfo(rhs);
@@ -412,6 +422,7 @@ af_err af_pow(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_root(af_array *out, const af_array lhs, const af_array rhs,
                const bool batchMode) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &linfo = getInfo(lhs);
         const ArrayInfo &rinfo = getInfo(rhs);
@@ -444,6 +455,7 @@ af_err af_root(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_atan2(af_array *out, const af_array lhs, const af_array rhs,
                 const bool batchMode) {
+    AF_PROFILE_API();
     try {
         const af_dtype type = implicit(lhs, rhs);
 
@@ -472,6 +484,7 @@ af_err af_atan2(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_hypot(af_array *out, const af_array lhs, const af_array rhs,
                 const bool batchMode) {
+    AF_PROFILE_API();
     try {
         const af_dtype type = implicit(lhs, rhs);
 
@@ -543,41 +556,49 @@ static af_err af_logic(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_eq(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_PROFILE_API();
     return af_logic<af_eq_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_neq(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_PROFILE_API();
     return af_logic<af_neq_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_gt(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_PROFILE_API();
     return af_logic<af_gt_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_ge(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_PROFILE_API();
     return af_logic<af_ge_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_lt(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_PROFILE_API();
     return af_logic<af_lt_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_le(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_PROFILE_API();
     return af_logic<af_le_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_and(af_array *out, const af_array lhs, const af_array rhs,
               const bool batchMode) {
+    AF_PROFILE_API();
     return af_logic<af_and_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_or(af_array *out, const af_array lhs, const af_array rhs,
              const bool batchMode) {
+    AF_PROFILE_API();
     return af_logic<af_or_t>(out, lhs, rhs, batchMode);
 }
 
@@ -625,25 +646,30 @@ static af_err af_bitwise(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_bitand(af_array *out, const af_array lhs, const af_array rhs,
                  const bool batchMode) {
+    AF_PROFILE_API();
     return af_bitwise<af_bitand_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitor(af_array *out, const af_array lhs, const af_array rhs,
                 const bool batchMode) {
+    AF_PROFILE_API();
     return af_bitwise<af_bitor_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitxor(af_array *out, const af_array lhs, const af_array rhs,
                  const bool batchMode) {
+    AF_PROFILE_API();
     return af_bitwise<af_bitxor_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitshiftl(af_array *out, const af_array lhs, const af_array rhs,
                     const bool batchMode) {
+    AF_PROFILE_API();
     return af_bitwise<af_bitshiftl_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitshiftr(af_array *out, const af_array lhs, const af_array rhs,
                     const bool batchMode) {
+    AF_PROFILE_API();
     return af_bitwise<af_bitshiftr_t>(out, lhs, rhs, batchMode);
 }
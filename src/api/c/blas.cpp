@@ -13,6 +13,7 @@
 #include <backend.hpp>
 #include <blas.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -56,6 +57,7 @@ static inline af_array dot(const af_array lhs, const af_array rhs,
 
 af_err af_sparse_matmul(af_array *out, const af_array lhs, const af_array rhs,
                         const af_mat_prop optLhs, const af_mat_prop optRhs) {
+    AF_PROFILE_API();
     try {
         const SparseArrayBase lhsBase = getSparseArrayBase(lhs);
         const ArrayInfo &rhsInfo      = getInfo(rhs);
@@ -120,6 +122,7 @@ af_err af_sparse_matmul(af_array *out, const af_array lhs, const af_array rhs,
 af_err af_gemm(af_array *out, const af_mat_prop optLhs,
                const af_mat_prop optRhs, const void *alpha, const af_array lhs,
                const af_array rhs, const void *beta) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &lhsInfo = getInfo(lhs, false, true);
         const ArrayInfo &rhsInfo = getInfo(rhs, true, true);
@@ -213,6 +216,7 @@ af_err af_gemm(af_array *out, const af_mat_prop optLhs,
 
 af_err af_matmul(af_array *out, const af_array lhs, const af_array rhs,
                  const af_mat_prop optLhs, const af_mat_prop optRhs) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &lhsInfo = getInfo(lhs, false, true);
         const ArrayInfo &rhsInfo = getInfo(rhs, true, true);
@@ -286,6 +290,7 @@ af_err af_matmul(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_dot(af_array *out, const af_array lhs, const af_array rhs,
               const af_mat_prop optLhs, const af_mat_prop optRhs) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &lhsInfo = getInfo(lhs);
         const ArrayInfo &rhsInfo = getInfo(rhs);
@@ -338,6 +343,7 @@ static inline T dotAll(af_array out) {
 af_err af_dot_all(double *rval, double *ival, const af_array lhs,
                   const af_array rhs, const af_mat_prop optLhs,
                   const af_mat_prop optRhs) {
+    AF_PROFILE_API();
     using namespace detail;  // NOLINT needed for imag and real functions
                              // name resolution
 
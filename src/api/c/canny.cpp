@@ -12,6 +12,7 @@
 #include <Array.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <common/tile.hpp>
@@ -206,6 +207,13 @@ af_array cannyHelper(const Array<T>& in, const float t1,
     Array<float> smt =
         convolve2<float, float>(cast<float, T>(in), cFilter, rFilter, false);
 
+#if defined(AF_CPU)
+    // The CPU backend runs the rest of the pipeline in one kernel, which
+    // never writes out the derivatives and traces the edges of all rows at
+    // once
+    UNUSED(sw);
+    return getHandle(detail::cannyEdges(smt, t1, ct, t2, isf));
+#else
     auto g          = sobelDerivatives<float, float>(smt, sw);
     Array<float> gx = g.first;
     Array<float> gy = g.second;
@@ -217,11 +225,13 @@ af_array cannyHelper(const Array<T>& in, const float t1,
     auto swpair = computeCandidates(supEdges, t1, ct, t2);
 
     return getHandle(edgeTrackingByHysteresis(swpair.first, swpair.second));
+#endif
 }
 
 af_err af_canny(af_array* out, const af_array in, const af_canny_threshold ct,
                 const float t1, const float t2, const unsigned sw,
                 const bool isf) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(in);
         af::dim4 dims         = info.dims();
@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
@@ -65,6 +66,7 @@ static af_array cast(const af_array in, const af_dtype type) {
 }
 
 af_err af_cast(af_array* out, const af_array in, const af_dtype type) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(in, false, true);
 
@@ -11,6 +11,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <af/array.h>
@@ -33,12 +34,15 @@ static inline int cholesky_inplace(af_array in, const bool is_upper) {
 
 af_err af_cholesky(af_array *out, int *info, const af_array in,
                    const bool is_upper) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &i_info = getInfo(in);
 
+#if !defined(AF_CPU)
         if (i_info.ndims() > 2) {
             AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         af_dtype type = i_info.getType();
 
@@ -65,12 +69,15 @@ af_err af_cholesky(af_array *out, int *info, const af_array in,
 }
 
 af_err af_cholesky_inplace(int *info, af_array in, const bool is_upper) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &i_info = getInfo(in);
 
+#if !defined(AF_CPU)
         if (i_info.ndims() > 2) {
             AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         af_dtype type = i_info.getType();
         if (i_info.ndims() == 0) { return AF_SUCCESS; }
@@ -10,6 +10,7 @@
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -45,6 +46,7 @@ static inline af_array clampOp(const af_array in, const af_array lo,
 
 af_err af_clamp(af_array* out, const af_array in, const af_array lo,
                 const af_array hi, const bool batch) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& linfo = getInfo(lo);
         const ArrayInfo& hinfo = getInfo(hi);
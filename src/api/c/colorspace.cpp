@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <af/array.h>
 #include <af/defines.h>
@@ -57,6 +58,7 @@ static void color_space(af_array *out, const af_array image,
 
 af_err af_color_space(af_array *out, const af_array image, const af_cspace_t to,
                       const af_cspace_t from) {
+    AF_PROFILE_API();
     try {
         if (from == to) { return af_retain_array(out, image); }
 
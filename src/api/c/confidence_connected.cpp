@@ -10,6 +10,7 @@
 #include <af/image.h>
 
 #include <arith.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <flood_fill.hpp>
@@ -183,7 +184,21 @@ af_array ccHelper(const Array<T>& img, const Array<uint>& seedx,
             // If variance is close to zero, discontinue iterating.
             continueLoop = false;
         }
+#if defined(AF_CPU)
+        // Limits that contain the previous ones only add pixels around the
+        // current segmentation, which the CPU backend grows in place
+        // instead of filling again from the seeds
+        if (newLow <= lower && newHigh >= upper) {
+            segmented = detail::floodFillGrow(in, segmented, CT(1), newLow,
+                                              newHigh);
+        } else {
+            segmented = floodFill(in, seedx, seedy, CT(1), newLow, newHigh);
+        }
+#else
         segmented = floodFill(in, seedx, seedy, CT(1), newLow, newHigh);
+#endif
+        lower = newLow;
+        upper = newHigh;
     }
 
     return getHandle(labelSegmented(segmented));
@@ -193,6 +208,7 @@ af_err af_confidence_cc(af_array* out, const af_array in, const af_array seedx,
                         const af_array seedy, const unsigned radius,
                         const unsigned multiplier, const int iter,
                         const double segmented_value) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& inInfo         = getInfo(in);
         const ArrayInfo& seedxInfo      = getInfo(seedx);
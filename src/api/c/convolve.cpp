@@ -10,6 +10,7 @@
 
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
@@ -209,6 +210,7 @@ af_err convolve(af_array *out, const af_array signal, const af_array filter,
 
 af_err af_convolve1(af_array *out, const af_array signal, const af_array filter,
                     const af_conv_mode mode, af_conv_domain domain) {
+    AF_PROFILE_API();
     try {
         if (isFreqDomain(1, signal, filter, domain)) {
             return af_fft_convolve1(out, signal, filter, mode);
@@ -220,6 +222,7 @@ af_err af_convolve1(af_array *out, const af_array signal, const af_array filter,
 
 af_err af_convolve2(af_array *out, const af_array signal, const af_array filter,
                     const af_conv_mode mode, af_conv_domain domain) {
+    AF_PROFILE_API();
     try {
         if (getInfo(signal).dims().ndims() < 2 ||
             getInfo(filter).dims().ndims() < 2) {
@@ -235,6 +238,7 @@ af_err af_convolve2(af_array *out, const af_array signal, const af_array filter,
 
 af_err af_convolve3(af_array *out, const af_array signal, const af_array filter,
                     const af_conv_mode mode, af_conv_domain domain) {
+    AF_PROFILE_API();
     try {
         if (getInfo(signal).dims().ndims() < 3 ||
             getInfo(filter).dims().ndims() < 3) {
@@ -251,6 +255,7 @@ af_err af_convolve3(af_array *out, const af_array signal, const af_array filter,
 af_err af_convolve2_sep(af_array *out, const af_array col_filter,
                         const af_array row_filter, const af_array signal,
                         const af_conv_mode mode) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &sInfo = getInfo(signal);
 
@@ -335,6 +340,7 @@ af_err af_convolve2_nn(af_array *out, const af_array signal,
                        const dim_t *strides, const unsigned padding_dims,
                        const dim_t *paddings, const unsigned dilation_dims,
                        const dim_t *dilations) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &sInfo = getInfo(signal);
         const ArrayInfo &fInfo = getInfo(filter);
@@ -407,6 +413,7 @@ af_err af_convolve2_gradient_nn(
     const dim_t *strides, const unsigned padding_dims, const dim_t *paddings,
     const unsigned dilation_dims, const dim_t *dilations,
     af_conv_gradient_type grad_type) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &iinfo = getInfo(incoming_gradient);
         const af::dim4 &iDims  = iinfo.dims();
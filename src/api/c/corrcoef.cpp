@@ -9,6 +9,7 @@
 
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <copy.hpp>
@@ -64,6 +65,7 @@ static To corrcoef(const af_array& X, const af_array& Y) {
 // NOLINTNEXTLINE
 af_err af_corrcoef(double* realVal, double* imagVal, const af_array X,
                    const af_array Y) {
+    AF_PROFILE_API();
     UNUSED(imagVal);  // TODO(umar): implement for complex types
     try {
         const ArrayInfo& xInfo = getInfo(X);
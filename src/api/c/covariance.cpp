@@ -9,6 +9,7 @@
 
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <handle.hpp>
 #include <math.hpp>
@@ -66,6 +67,7 @@ static af_array cov(const af_array& X, const af_array& Y,
 
 af_err af_cov(af_array* out, const af_array X, const af_array Y,
               const bool isbiased) {
+    AF_PROFILE_API();
     const af_var_bias bias =
         (isbiased ? AF_VARIANCE_SAMPLE : AF_VARIANCE_POPULATION);
     return af_cov_v2(out, X, Y, bias);
@@ -73,6 +75,7 @@ af_err af_cov(af_array* out, const af_array X, const af_array Y,
 
 af_err af_cov_v2(af_array* out, const af_array X, const af_array Y,
                  const af_var_bias bias) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& xInfo = getInfo(X);
         const ArrayInfo& yInfo = getInfo(Y);
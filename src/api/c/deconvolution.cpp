@@ -10,11 +10,15 @@
 #include <Array.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/dispatch.hpp>
 #include <common/err_common.hpp>
 #include <complex.hpp>
 #include <copy.hpp>
+#if defined(AF_CPU)
+#include <deconvolution.hpp>
+#endif
 #include <fft_common.hpp>
 #include <fftconvolve.hpp>
 #include <handle.hpp>
@@ -40,8 +44,10 @@ using detail::cdouble;
 using detail::cfloat;
 using detail::createSubArray;
 using detail::createValueArray;
+using detail::getScalar;
 using detail::logicOp;
 using detail::padArrayBorders;
+using detail::reduce_all;
 using detail::scalar;
 using detail::select_scalar;
 using detail::shift;
@@ -73,11 +79,49 @@ Array<T> complexNorm(const Array<CT>& input) {
     return arithOp<T, af_pow_t>(mag, TWOS, input.dims());
 }
 
+/// Sum of the elements of \p in
+template<typename T>
+double total(const Array<T>& in) {
+    return getScalar<T>(reduce_all<af_add_t, T, T>(in));
+}
+
+/// Squared norm of the real image of size \p d0 along dimension 0 whose
+/// half spectrum is \p spec, up to the scale of the transform. The bins
+/// other than the first and, for even \p d0, the last along dimension 0
+/// also stand for their mirror images.
+template<typename T, typename CT>
+double spectrumNorm(const Array<CT>& spec, const dim_t d0) {
+    auto sq     = complexNorm<T, CT>(spec);
+    double norm = 2 * total(sq);
+
+    vector<af_seq> rows(4, af_span);
+    rows[0] = {0, 0, 1};
+    norm -= total(createSubArray(sq, rows));
+    if (d0 % 2 == 0) {
+        rows[0] = {double(d0 / 2), double(d0 / 2), 1};
+        norm -= total(createSubArray(sq, rows));
+    }
+    return norm;
+}
+
+/// Whether the squared norm \p change of an iteration's change is at most
+/// \p tolerance times the squared norm \p estimate of its result
+bool converged(const double change, const double estimate,
+               const float tolerance) {
+    return change <= double(tolerance) * double(tolerance) * estimate;
+}
+
+/// Pads the image and the PSF to a common size that is fast to transform.
+/// Returns the indices of the image in the padded result, and sets
+/// \p nElems to the number of elements of a padded image, which scales the
+/// inverse transforms to the same range as the input.
 std::vector<af_seq> calcPadInfo(dim4& inLPad, dim4& psfLPad, dim4& inUPad,
-                                dim4& psfUPad, dim4& odims, dim_t nElems,
+                                dim4& psfUPad, dim4& odims, dim_t& nElems,
                                 const dim4& idims, const dim4& fdims) {
     vector<af_seq> index(4);
 
+    nElems = 1;
+
     for (int d = 0; d < 4; ++d) {
         if (d < BASE_DIM) {
             dim_t pad = idims[d] + fdims[d];
@@ -111,7 +155,7 @@ template<typename T, typename CT>
 void richardsonLucy(Array<T>& currentEstimate, const Array<T>& in,
                     const Array<CT>& P, const Array<CT>& Pc,
                     const unsigned iters, const float normFactor,
-                    const dim4 odims) {
+                    const dim4 odims, const float tolerance) {
     for (unsigned i = 0; i < iters; ++i) {
         auto fft1  = fft_r2c<CT, T>(currentEstimate, BASE_DIM);
         auto cmul1 = arithOp<CT, af_mul_t>(fft1, P, P.dims());
@@ -121,8 +165,16 @@ void richardsonLucy(Array<T>& currentEstimate, const Array<T>& in,
         auto cmul2 = arithOp<CT, af_mul_t>(fft2, Pc, Pc.dims());
         auto ifft2 = fft_c2r<CT, T>(cmul2, normFactor, odims, BASE_DIM);
 
-        currentEstimate =
-            arithOp<T, af_mul_t>(currentEstimate, ifft2, ifft2.dims());
+        auto next = arithOp<T, af_mul_t>(currentEstimate, ifft2, odims);
+        bool done = false;
+        if (tolerance > 0.f) {
+            auto diff = arithOp<T, af_sub_t>(next, currentEstimate, odims);
+            auto dsq  = arithOp<T, af_mul_t>(diff, diff, odims);
+            auto nsq  = arithOp<T, af_mul_t>(next, next, odims);
+            done      = converged(total(dsq), total(nsq), tolerance);
+        }
+        currentEstimate = next;
+        if (done) { break; }
     }
 }
 
@@ -130,7 +182,7 @@ template<typename T, typename CT>
 void landweber(Array<T>& currentEstimate, const Array<T>& in,
                const Array<CT>& P, const Array<CT>& Pc, const unsigned iters,
                const float relaxFactor, const float normFactor,
-               const dim4 odims) {
+               const dim4 odims, const float tolerance) {
     const dim4& dims = P.dims();
 
     auto I        = fft_r2c<CT, T>(in, BASE_DIM);
@@ -146,23 +198,30 @@ void landweber(Array<T>& currentEstimate, const Array<T>& in,
     auto iterTemp = I;
 
     for (unsigned i = 0; i < iters; ++i) {
-        auto mul = arithOp<CT, af_mul_t>(iterTemp, lhs, dims);
-        iterTemp = arithOp<CT, af_add_t>(mul, rhs, dims);
+        auto mul  = arithOp<CT, af_mul_t>(iterTemp, lhs, dims);
+        auto next = arithOp<CT, af_add_t>(mul, rhs, dims);
+        bool done = false;
+        if (tolerance > 0.f) {
+            auto diff = arithOp<CT, af_sub_t>(next, iterTemp, dims);
+            done      = converged(spectrumNorm<T>(diff, odims[0]),
+                                  spectrumNorm<T>(next, odims[0]), tolerance);
+        }
+        iterTemp = next;
+        if (done) { break; }
     }
     currentEstimate = fft_c2r<CT, T>(iterTemp, normFactor, odims, BASE_DIM);
 }
 
 template<typename InputType, typename RealType = float>
 af_array iterDeconv(const af_array in, const af_array ker, const uint iters,
-                    const float rfactor, const af_iterative_deconv_algo algo) {
+                    const float rfactor, const af_iterative_deconv_algo algo,
+                    const float tolerance) {
     using T    = RealType;
-    using CT   = typename std::conditional<std::is_same<T, double>::value,
-                                         cdouble, cfloat>::type;
     auto input = castArray<T>(in);
     auto psf   = castArray<T>(ker);
     const dim4& idims = input.dims();
     const dim4& fdims = psf.dims();
-    dim_t nElems      = 1;
+    dim_t nElems      = 0;
 
     dim4 inUPad, psfUPad, inLPad, psfLPad, odims(1);
 
@@ -176,6 +235,15 @@ af_array iterDeconv(const af_array in, const af_array ker, const uint iters,
                                           -int(fdims[1] / 2), 0, 0};
     auto shiftedPsf                    = shift(paddedPsf, shiftDims.data());
 
+#if defined(AF_CPU)
+    // The CPU backend transforms the PSF once and runs all the iterations in
+    // one kernel on fixed buffers
+    Array<T> currentEstimate = detail::iterativeDeconv<T>(
+        paddedIn, shiftedPsf, iters, rfactor, tolerance, algo);
+#else
+    using CT = typename std::conditional<std::is_same<T, double>::value,
+                                         cdouble, cfloat>::type;
+
     auto P  = fft_r2c<CT, T>(shiftedPsf, BASE_DIM);
     auto Pc = conj(P);
 
@@ -185,52 +253,81 @@ af_array iterDeconv(const af_array in, const af_array ker, const uint iters,
     switch (algo) {
         case AF_ITERATIVE_DECONV_RICHARDSONLUCY:
             richardsonLucy(currentEstimate, paddedIn, P, Pc, iters, normFactor,
-                           odims);
+                           odims, tolerance);
             break;
         case AF_ITERATIVE_DECONV_LANDWEBER:
         default:
             landweber(currentEstimate, paddedIn, P, Pc, iters, rfactor,
-                      normFactor, odims);
+                      normFactor, odims, tolerance);
     }
+#endif
     return getHandle(createSubArray<T>(currentEstimate, index));
 }
 
+static void af_iterative_deconv_common(
+    af_array* out, const af_array in, const af_array ker,
+    const unsigned iterations, const float relax_factor,
+    const af_iterative_deconv_algo algo, const float tolerance) {
+    const ArrayInfo& inputInfo  = getInfo(in);
+    const dim4& inputDims       = inputInfo.dims();
+    const ArrayInfo& kernelInfo = getInfo(ker);
+    const dim4& kernelDims      = kernelInfo.dims();
+
+    DIM_ASSERT(2, (inputDims.ndims() == 2));
+    DIM_ASSERT(3, (kernelDims.ndims() == 2));
+    ARG_ASSERT(4, (iterations > 0));
+    ARG_ASSERT(5, std::isfinite(relax_factor));
+    ARG_ASSERT(5, (relax_factor > 0));
+    ARG_ASSERT(6, (algo == AF_ITERATIVE_DECONV_DEFAULT ||
+                   algo == AF_ITERATIVE_DECONV_LANDWEBER ||
+                   algo == AF_ITERATIVE_DECONV_RICHARDSONLUCY));
+    ARG_ASSERT(7, std::isfinite(tolerance));
+    ARG_ASSERT(7, (tolerance >= 0));
+    af_array res   = 0;
+    unsigned iters = iterations;
+    float rfac     = relax_factor;
+    float tol      = tolerance;
+
+    af_dtype inputType = inputInfo.getType();
+    switch (inputType) {
+        case f32:
+            res = iterDeconv<float>(in, ker, iters, rfac, algo, tol);
+            break;
+        case s16:
+            res = iterDeconv<short>(in, ker, iters, rfac, algo, tol);
+            break;
+        case u16:
+            res = iterDeconv<ushort>(in, ker, iters, rfac, algo, tol);
+            break;
+        case u8:
+            res = iterDeconv<uchar>(in, ker, iters, rfac, algo, tol);
+            break;
+        default: TYPE_ERROR(1, inputType);
+    }
+    std::swap(res, *out);
+}
+
 af_err af_iterative_deconv(af_array* out, const af_array in, const af_array ker,
                            const unsigned iterations, const float relax_factor,
                            const af_iterative_deconv_algo algo) {
+    AF_PROFILE_API();
     try {
-        const ArrayInfo& inputInfo  = getInfo(in);
-        const dim4& inputDims       = inputInfo.dims();
-        const ArrayInfo& kernelInfo = getInfo(ker);
-        const dim4& kernelDims      = kernelInfo.dims();
-
-        DIM_ASSERT(2, (inputDims.ndims() == 2));
-        DIM_ASSERT(3, (kernelDims.ndims() == 2));
-        ARG_ASSERT(4, (iterations > 0));
-        ARG_ASSERT(5, std::isfinite(relax_factor));
-        ARG_ASSERT(5, (relax_factor > 0));
-        ARG_ASSERT(6, (algo == AF_ITERATIVE_DECONV_DEFAULT ||
-                       algo == AF_ITERATIVE_DECONV_LANDWEBER ||
-                       algo == AF_ITERATIVE_DECONV_RICHARDSONLUCY));
-        af_array res   = 0;
-        unsigned iters = iterations;
-        float rfac     = relax_factor;
+        af_iterative_deconv_common(out, in, ker, iterations, relax_factor,
+                                   algo, 0.f);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
 
-        af_dtype inputType = inputInfo.getType();
-        switch (inputType) {
-            case f32:
-                res = iterDeconv<float>(in, ker, iters, rfac, algo);
-                break;
-            case s16:
-                res = iterDeconv<short>(in, ker, iters, rfac, algo);
-                break;
-            case u16:
-                res = iterDeconv<ushort>(in, ker, iters, rfac, algo);
-                break;
-            case u8: res = iterDeconv<uchar>(in, ker, iters, rfac, algo); break;
-            default: TYPE_ERROR(1, inputType);
-        }
-        std::swap(res, *out);
+af_err af_iterative_deconv_v2(af_array* out, const af_array in,
+                              const af_array ker, const unsigned iterations,
+                              const float relax_factor,
+                              const af_iterative_deconv_algo algo,
+                              const float tolerance) {
+    AF_PROFILE_API();
+    try {
+        af_iterative_deconv_common(out, in, ker, iterations, relax_factor,
+                                   algo, tolerance);
     }
     CATCHALL;
     return AF_SUCCESS;
@@ -271,7 +368,7 @@ af_array invDeconv(const af_array in, const af_array ker, const float gamma,
     auto psf   = castArray<T>(ker);
     const dim4& idims = input.dims();
     const dim4& fdims = psf.dims();
-    dim_t nElems      = 1;
+    dim_t nElems      = 0;
 
     dim4 inUPad, psfUPad, inLPad, psfLPad, odims(1);
 
@@ -305,6 +402,7 @@ af_array invDeconv(const af_array in, const af_array ker, const float gamma,
 
 af_err af_inverse_deconv(af_array* out, const af_array in, const af_array psf,
                          const float gamma, const af_inverse_deconv_algo algo) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& inputInfo = getInfo(in);
         const dim4& inputDims      = inputInfo.dims();
@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <copy.hpp>
 #include <diagonal.hpp>
@@ -70,11 +71,14 @@ T det(const af_array a) {
 }
 
 af_err af_det(double *real_val, double *imag_val, const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &i_info = getInfo(in);
 
+        // The determinant is returned as a single scalar, so there is no
+        // room for the results of a batch
         if (i_info.ndims() > 2) {
-            AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
+            AF_ERROR("det can not be used in batch mode", AF_ERR_BATCH);
         }
 
         af_dtype type = i_info.getType();
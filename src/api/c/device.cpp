@@ -9,6 +9,7 @@
 
 #include <Array.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <common/util.hpp>
@@ -50,6 +51,7 @@ using detail::uintl;
 using detail::ushort;
 
 af_err af_set_backend(const af_backend bknd) {
+    AF_PROFILE_API();
     try {
         if (bknd != getBackend() && bknd != AF_BACKEND_DEFAULT) {
             return AF_ERR_ARG;
@@ -61,11 +63,13 @@ af_err af_set_backend(const af_backend bknd) {
 }
 
 af_err af_get_backend_count(unsigned* num_backends) {
+    AF_PROFILE_API();
     *num_backends = 1;
     return AF_SUCCESS;
 }
 
 af_err af_get_available_backends(int* result) {
+    AF_PROFILE_API();
     try {
         *result = getBackend();
     }
@@ -74,6 +78,7 @@ af_err af_get_available_backends(int* result) {
 }
 
 af_err af_get_backend_id(af_backend* result, const af_array in) {
+    AF_PROFILE_API();
     try {
         if (in) {
             const ArrayInfo& info = getInfo(in, false, false);
@@ -87,6 +92,7 @@ af_err af_get_backend_id(af_backend* result, const af_array in) {
 }
 
 af_err af_get_device_id(int* device, const af_array in) {
+    AF_PROFILE_API();
     try {
         if (in) {
             const ArrayInfo& info = getInfo(in, false, false);
@@ -100,11 +106,13 @@ af_err af_get_device_id(int* device, const af_array in) {
 }
 
 af_err af_get_active_backend(af_backend* result) {
+    AF_PROFILE_API();
     *result = static_cast<af_backend>(getBackend());
     return AF_SUCCESS;
 }
 
 af_err af_init() {
+    AF_PROFILE_API();
     try {
         thread_local std::once_flag flag;
         std::call_once(flag, []() {
@@ -153,6 +161,7 @@ af_err af_init() {
 }
 
 af_err af_info() {
+    AF_PROFILE_API();
     try {
         printf("%s", getDeviceInfo().c_str());  // NOLINT
     }
@@ -161,6 +170,7 @@ af_err af_info() {
 }
 
 af_err af_info_string(char** str, const bool verbose) {
+    AF_PROFILE_API();
     UNUSED(verbose);  // TODO(umar): Add something useful
     try {
         std::string infoStr = getDeviceInfo();
@@ -179,6 +189,7 @@ af_err af_info_string(char** str, const bool verbose) {
 
 af_err af_device_info(char* d_name, char* d_platform, char* d_toolkit,
                       char* d_compute) {
+    AF_PROFILE_API();
     try {
         devprop(d_name, d_platform, d_toolkit, d_compute);
     }
@@ -187,6 +198,7 @@ af_err af_device_info(char* d_name, char* d_platform, char* d_toolkit,
 }
 
 af_err af_get_dbl_support(bool* available, const int device) {
+    AF_PROFILE_API();
     try {
         *available = isDoubleSupported(device);
     }
@@ -195,6 +207,7 @@ af_err af_get_dbl_support(bool* available, const int device) {
 }
 
 af_err af_get_half_support(bool* available, const int device) {
+    AF_PROFILE_API();
     try {
         *available = isHalfSupported(device);
     }
@@ -203,6 +216,7 @@ af_err af_get_half_support(bool* available, const int device) {
 }
 
 af_err af_get_device_count(int* nDevices) {
+    AF_PROFILE_API();
     try {
         *nDevices = getDeviceCount();
     }
@@ -212,6 +226,7 @@ af_err af_get_device_count(int* nDevices) {
 }
 
 af_err af_get_device(int* device) {
+    AF_PROFILE_API();
     try {
         *device = static_cast<int>(getActiveDeviceId());
     }
@@ -220,6 +235,7 @@ af_err af_get_device(int* device) {
 }
 
 af_err af_set_device(const int device) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(0, device >= 0);
         if (setDevice(device) < 0) {
@@ -246,6 +262,7 @@ af_err af_set_device(const int device) {
 }
 
 af_err af_sync(const int device) {
+    AF_PROFILE_API();
     try {
         int dev = device == -1 ? static_cast<int>(getActiveDeviceId()) : device;
         detail::sync(dev);
@@ -265,6 +282,7 @@ static inline void sparseEval(af_array arr) {
 }
 
 af_err af_eval(af_array arr) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(arr, false);
         af_dtype type         = info.getType();
@@ -314,6 +332,7 @@ static inline void evalMultiple(int num, af_array* arrayPtrs) {
 }
 
 af_err af_eval_multiple(int num, af_array* arrays) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(arrays[0]);
         af_dtype type         = info.getType();
@@ -355,6 +374,7 @@ af_err af_eval_multiple(int num, af_array* arrays) {
 }
 
 af_err af_set_manual_eval_flag(bool flag) {
+    AF_PROFILE_API();
     try {
         bool& backendFlag = evalFlag();
         backendFlag       = !flag;
@@ -364,6 +384,7 @@ af_err af_set_manual_eval_flag(bool flag) {
 }
 
 af_err af_get_manual_eval_flag(bool* flag) {
+    AF_PROFILE_API();
     try {
         bool backendFlag = evalFlag();
         *flag            = !backendFlag;
@@ -373,6 +394,7 @@ af_err af_get_manual_eval_flag(bool* flag) {
 }
 
 af_err af_get_kernel_cache_directory(size_t* length, char* path) {
+    AF_PROFILE_API();
     try {
         std::string& cache_path = getCacheDirectory();
         if (path == nullptr) {
@@ -394,7 +416,56 @@ af_err af_get_kernel_cache_directory(size_t* length, char* path) {
     return AF_SUCCESS;
 }
 
+af_err af_set_num_threads(const int num_threads) {
+    AF_PROFILE_API();
+    try {
+#if defined(AF_CPU)
+        ARG_ASSERT(0, num_threads > 0);
+        detail::setNumThreads(num_threads);
+#else
+        UNUSED(num_threads);
+        AF_ERROR("Thread count is only configurable on the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_num_threads(int* num_threads) {
+    AF_PROFILE_API();
+    try {
+        ARG_ASSERT(0, num_threads != nullptr);
+#if defined(AF_CPU)
+        *num_threads = detail::getNumThreads();
+#else
+        AF_ERROR("Thread count is only configurable on the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_start_trace(const char* filename) {
+    try {
+        ARG_ASSERT(0, filename != nullptr);
+        common::profiler::start(filename);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_stop_trace() {
+    try {
+        common::profiler::stop();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
 af_err af_set_kernel_cache_directory(const char* path, int override_env) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(path != nullptr, 1);
         if (override_env) {
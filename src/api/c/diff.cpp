@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <diff.hpp>
 #include <handle.hpp>
@@ -35,6 +36,7 @@ static inline af_array diff2(const af_array in, const int dim) {
 }
 
 af_err af_diff1(af_array* out, const af_array in, const int dim) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, ((dim >= 0) && (dim < 4)));
 
@@ -73,6 +75,7 @@ af_err af_diff1(af_array* out, const af_array in, const int dim) {
 }
 
 af_err af_diff2(af_array* out, const af_array in, const int dim) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, ((dim >= 0) && (dim < 4)));
 
@@ -10,6 +10,7 @@
 #include <Array.hpp>
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <convolve.hpp>
 #include <handle.hpp>
@@ -54,6 +55,7 @@ static af_array dog(const af_array& in, const int radius1, const int radius2) {
 
 af_err af_dog(af_array* out, const af_array in, const int radius1,
               const int radius2) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(in);
         dim4 inDims           = info.dims();
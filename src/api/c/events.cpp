@@ -10,6 +10,7 @@
 #include <events.hpp>
 
 #include <Event.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <af/device.h>
 #include <af/event.h>
@@ -33,6 +34,7 @@ const Event &getEvent(const af_event &handle) {
 af_event getHandle(Event &event) { return static_cast<af_event>(&event); }
 
 af_err af_create_event(af_event *handle) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         *handle = createEvent();
@@ -43,6 +45,7 @@ af_err af_create_event(af_event *handle) {
 }
 
 af_err af_delete_event(af_event handle) {
+    AF_PROFILE_API();
     try {
         delete &getEvent(handle);
     }
@@ -52,6 +55,7 @@ af_err af_delete_event(af_event handle) {
 }
 
 af_err af_mark_event(const af_event handle) {
+    AF_PROFILE_API();
     try {
         markEventOnActiveQueue(handle);
     }
@@ -61,6 +65,7 @@ af_err af_mark_event(const af_event handle) {
 }
 
 af_err af_enqueue_wait_event(const af_event handle) {
+    AF_PROFILE_API();
     try {
         enqueueWaitOnActiveQueue(handle);
     }
@@ -70,6 +75,7 @@ af_err af_enqueue_wait_event(const af_event handle) {
 }
 
 af_err af_block_event(const af_event handle) {
+    AF_PROFILE_API();
     try {
         block(handle);
     }
@@ -14,6 +14,7 @@
 #include <af/defines.h>  // Include this header to access any enums,
                          // #defines or constants declared
 
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>  // Header with error checking functions & macros
 
 #include <backend.hpp>  // This header make sures appropriate backend
@@ -51,6 +52,7 @@ af_array example(const af_array& a, const af_array& b,
 
 af_err af_example_function(af_array* out, const af_array a,
                            const af_someenum_t param) {
+    AF_PROFILE_API();
     try {
         af_array output = 0;
         const ArrayInfo& info =
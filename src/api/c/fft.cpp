@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <fft_common.hpp>
 #include <af/defines.h>
@@ -82,12 +83,14 @@ af_err fft(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_fft(af_array *out, const af_array in, const double norm_factor,
               const dim_t pad0) {
+    AF_PROFILE_API();
     const dim_t pad[1] = {pad0};
     return fft(out, in, norm_factor, (pad0 > 0 ? 1 : 0), pad, 1, true);
 }
 
 af_err af_fft2(af_array *out, const af_array in, const double norm_factor,
                const dim_t pad0, const dim_t pad1) {
+    AF_PROFILE_API();
     const dim_t pad[2] = {pad0, pad1};
     return fft(out, in, norm_factor, (pad0 > 0 && pad1 > 0 ? 2 : 0), pad, 2,
                true);
@@ -95,6 +98,7 @@ af_err af_fft2(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_fft3(af_array *out, const af_array in, const double norm_factor,
                const dim_t pad0, const dim_t pad1, const dim_t pad2) {
+    AF_PROFILE_API();
     const dim_t pad[3] = {pad0, pad1, pad2};
     return fft(out, in, norm_factor, (pad0 > 0 && pad1 > 0 && pad2 > 0 ? 3 : 0),
                pad, 3, true);
@@ -102,12 +106,14 @@ af_err af_fft3(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_ifft(af_array *out, const af_array in, const double norm_factor,
                const dim_t pad0) {
+    AF_PROFILE_API();
     const dim_t pad[1] = {pad0};
     return fft(out, in, norm_factor, (pad0 > 0 ? 1 : 0), pad, 1, false);
 }
 
 af_err af_ifft2(af_array *out, const af_array in, const double norm_factor,
                 const dim_t pad0, const dim_t pad1) {
+    AF_PROFILE_API();
     const dim_t pad[2] = {pad0, pad1};
     return fft(out, in, norm_factor, (pad0 > 0 && pad1 > 0 ? 2 : 0), pad, 2,
                false);
@@ -115,6 +121,7 @@ af_err af_ifft2(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_ifft3(af_array *out, const af_array in, const double norm_factor,
                 const dim_t pad0, const dim_t pad1, const dim_t pad2) {
+    AF_PROFILE_API();
     const dim_t pad[3] = {pad0, pad1, pad2};
     return fft(out, in, norm_factor, (pad0 > 0 && pad1 > 0 && pad2 > 0 ? 3 : 0),
                pad, 3, false);
@@ -154,26 +161,32 @@ af_err fft_inplace(af_array in, const double norm_factor, int rank,
 }
 
 af_err af_fft_inplace(af_array in, const double norm_factor) {
+    AF_PROFILE_API();
     return fft_inplace(in, norm_factor, 1, true);
 }
 
 af_err af_fft2_inplace(af_array in, const double norm_factor) {
+    AF_PROFILE_API();
     return fft_inplace(in, norm_factor, 2, true);
 }
 
 af_err af_fft3_inplace(af_array in, const double norm_factor) {
+    AF_PROFILE_API();
     return fft_inplace(in, norm_factor, 3, true);
 }
 
 af_err af_ifft_inplace(af_array in, const double norm_factor) {
+    AF_PROFILE_API();
     return fft_inplace(in, norm_factor, 1, false);
 }
 
 af_err af_ifft2_inplace(af_array in, const double norm_factor) {
+    AF_PROFILE_API();
     return fft_inplace(in, norm_factor, 2, false);
 }
 
 af_err af_ifft3_inplace(af_array in, const double norm_factor) {
+    AF_PROFILE_API();
     return fft_inplace(in, norm_factor, 3, false);
 }
 
@@ -217,12 +230,14 @@ af_err fft_r2c(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_fft_r2c(af_array *out, const af_array in, const double norm_factor,
                   const dim_t pad0) {
+    AF_PROFILE_API();
     const dim_t pad[1] = {pad0};
     return fft_r2c(out, in, norm_factor, (pad0 > 0 ? 1 : 0), pad, 1);
 }
 
 af_err af_fft2_r2c(af_array *out, const af_array in, const double norm_factor,
                    const dim_t pad0, const dim_t pad1) {
+    AF_PROFILE_API();
     const dim_t pad[2] = {pad0, pad1};
     return fft_r2c(out, in, norm_factor, (pad0 > 0 && pad1 > 0 ? 2 : 0), pad,
                    2);
@@ -230,6 +245,7 @@ af_err af_fft2_r2c(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_fft3_r2c(af_array *out, const af_array in, const double norm_factor,
                    const dim_t pad0, const dim_t pad1, const dim_t pad2) {
+    AF_PROFILE_API();
     const dim_t pad[3] = {pad0, pad1, pad2};
     return fft_r2c(out, in, norm_factor,
                    (pad0 > 0 && pad1 > 0 && pad2 > 0 ? 3 : 0), pad, 3);
@@ -276,20 +292,24 @@ af_err fft_c2r(af_array *out, const af_array in, const double norm_factor,
 
 af_err af_fft_c2r(af_array *out, const af_array in, const double norm_factor,
                   const bool is_odd) {
+    AF_PROFILE_API();
     return fft_c2r(out, in, norm_factor, is_odd, 1);
 }
 
 af_err af_fft2_c2r(af_array *out, const af_array in, const double norm_factor,
                    const bool is_odd) {
+    AF_PROFILE_API();
     return fft_c2r(out, in, norm_factor, is_odd, 2);
 }
 
 af_err af_fft3_c2r(af_array *out, const af_array in, const double norm_factor,
                    const bool is_odd) {
+    AF_PROFILE_API();
     return fft_c2r(out, in, norm_factor, is_odd, 3);
 }
 
 af_err af_set_fft_plan_cache_size(size_t cache_size) {
+    AF_PROFILE_API();
     try {
         detail::setFFTPlanCacheSize(cache_size);
     }
@@ -11,6 +11,7 @@
 
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/dispatch.hpp>
 #include <common/err_common.hpp>
@@ -233,11 +234,13 @@ af_err fft_convolve(af_array *out, const af_array signal, const af_array filter,
 
 af_err af_fft_convolve1(af_array *out, const af_array signal,
                         const af_array filter, const af_conv_mode mode) {
+    AF_PROFILE_API();
     return fft_convolve(out, signal, filter, mode == AF_CONV_EXPAND, 1);
 }
 
 af_err af_fft_convolve2(af_array *out, const af_array signal,
                         const af_array filter, const af_conv_mode mode) {
+    AF_PROFILE_API();
     if (getInfo(signal).dims().ndims() < 2 &&
         getInfo(filter).dims().ndims() < 2) {
         return fft_convolve(out, signal, filter, mode == AF_CONV_EXPAND, 1);
@@ -247,6 +250,7 @@ af_err af_fft_convolve2(af_array *out, const af_array signal,
 
 af_err af_fft_convolve3(af_array *out, const af_array signal,
                         const af_array filter, const af_conv_mode mode) {
+    AF_PROFILE_API();
     if (getInfo(signal).dims().ndims() < 3 &&
         getInfo(filter).dims().ndims() < 3) {
         return fft_convolve(out, signal, filter, mode == AF_CONV_EXPAND, 2);
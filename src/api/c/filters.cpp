@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <medfilt.hpp>
@@ -24,6 +25,7 @@ using detail::ushort;
 
 af_err af_medfilt(af_array *out, const af_array in, const dim_t wind_length,
                   const dim_t wind_width, const af_border_type edge_pad) {
+    AF_PROFILE_API();
     return af_medfilt2(out, in, wind_length, wind_width, edge_pad);
 }
 
@@ -36,6 +38,7 @@ static af_array medfilt1(af_array const &in, dim_t w_wid,
 
 af_err af_medfilt1(af_array *out, const af_array in, const dim_t wind_width,
                    const af_border_type edge_pad) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (wind_width > 0));
         ARG_ASSERT(4, (edge_pad >= AF_PAD_ZERO && edge_pad <= AF_PAD_SYM));
@@ -83,6 +86,7 @@ inline af_array medfilt2(af_array const &in, dim_t w_len, dim_t w_wid,
 
 af_err af_medfilt2(af_array *out, const af_array in, const dim_t wind_length,
                    const dim_t wind_width, const af_border_type edge_pad) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (wind_length == wind_width));
         ARG_ASSERT(2, (wind_length > 0));
@@ -143,6 +147,7 @@ af_err af_medfilt2(af_array *out, const af_array in, const dim_t wind_length,
 
 af_err af_minfilt(af_array *out, const af_array in, const dim_t wind_length,
                   const dim_t wind_width, const af_border_type edge_pad) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (wind_length == wind_width));
         ARG_ASSERT(2, (wind_length > 0));
@@ -170,6 +175,7 @@ af_err af_minfilt(af_array *out, const af_array in, const dim_t wind_length,
 
 af_err af_maxfilt(af_array *out, const af_array in, const dim_t wind_length,
                   const dim_t wind_width, const af_border_type edge_pad) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (wind_length == wind_width));
         ARG_ASSERT(2, (wind_length > 0));
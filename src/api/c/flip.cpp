@@ -9,6 +9,7 @@
 
 #include <Array.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/half.hpp>
 #include <common/indexing_helpers.hpp>
 #include <handle.hpp>
@@ -36,6 +37,7 @@ static inline af_array flip(const af_array in, const unsigned dim) {
 }
 
 af_err af_flip(af_array *result, const af_array in, const unsigned dim) {
+    AF_PROFILE_API();
     af_array out;
     try {
         const ArrayInfo &in_info = getInfo(in);
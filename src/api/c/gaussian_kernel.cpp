@@ -9,6 +9,7 @@
 
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <copy.hpp>
 #include <handle.hpp>
@@ -89,6 +90,7 @@ Array<T> gaussianKernel(const int rows, const int cols, const double sigma_r,
 
 af_err af_gaussian_kernel(af_array *out, const int rows, const int cols,
                           const double sigma_r, const double sigma_c) {
+    AF_PROFILE_API();
     try {
         af_array res;
         res = getHandle<float>(
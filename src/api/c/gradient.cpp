@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <gradient.hpp>
 #include <handle.hpp>
@@ -26,6 +27,7 @@ static inline void gradient(af_array *grad0, af_array *grad1,
 }
 
 af_err af_gradient(af_array *grows, af_array *gcols, const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <features.hpp>
 #include <handle.hpp>
@@ -53,6 +54,7 @@ af_err af_harris(af_features *out, const af_array in,
                  const unsigned max_corners, const float min_response,
                  const float sigma, const unsigned block_size,
                  const float k_thr) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info = getInfo(in);
         dim4 dims             = info.dims();
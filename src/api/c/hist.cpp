@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <common/graphics_common.hpp>
@@ -94,6 +95,7 @@ fg_chart setup_histogram(fg_window const window, const af_array in,
 af_err af_draw_hist(const af_window window, const af_array X,
                     const double minval, const double maxval,
                     const af_cell* const props) {
+    AF_PROFILE_API();
     try {
         if (window == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
 
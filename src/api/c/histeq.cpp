@@ -9,6 +9,7 @@
 
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <common/moddims.hpp>
@@ -76,6 +77,7 @@ static af_array hist_equal(const af_array& in, const af_array& hist) {
 }
 
 af_err af_hist_equal(af_array* out, const af_array in, const af_array hist) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& dataInfo = getInfo(in);
         const ArrayInfo& histInfo = getInfo(hist);
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <histogram.hpp>
@@ -30,6 +31,7 @@ inline af_array histogram(const af_array in, const unsigned &nbins,
 
 af_err af_histogram(af_array *out, const af_array in, const unsigned nbins,
                     const double minval, const double maxval) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <homography.hpp>
@@ -50,6 +51,7 @@ af_err af_homography(af_array* H, int* inliers, const af_array x_src,
                      const af_array y_dst, const af_homography_type htype,
                      const float inlier_thr, const unsigned iterations,
                      const af_dtype otype) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& xsinfo = getInfo(x_src);
         const ArrayInfo& ysinfo = getInfo(y_src);
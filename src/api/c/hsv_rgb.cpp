@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <hsv_rgb.hpp>
@@ -56,9 +57,11 @@ af_err convert(af_array* out, const af_array& in) {
 }
 
 af_err af_hsv2rgb(af_array* out, const af_array in) {
+    AF_PROFILE_API();
     return convert<true>(out, in);
 }
 
 af_err af_rgb2hsv(af_array* out, const af_array in) {
+    AF_PROFILE_API();
     return convert<false>(out, in);
 }
@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <convolve.hpp>
 #include <handle.hpp>
@@ -19,10 +20,13 @@
 #include <cstdio>
 
 using af::dim4;
+using detail::Array;
 using detail::cdouble;
 using detail::cfloat;
+using detail::createSubArray;
 
 af_err af_fir(af_array* y, const af_array b, const af_array x) {
+    AF_PROFILE_API();
     try {
         af_array out;
         AF_CHECK(af_convolve1(&out, x, b, AF_CONV_EXPAND, AF_CONV_AUTO));
@@ -49,6 +53,7 @@ inline static af_array iir(const af_array b, const af_array a,
 
 af_err af_iir(af_array* y, const af_array b, const af_array a,
               const af_array x) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& ainfo = getInfo(a);
         const ArrayInfo& binfo = getInfo(b);
@@ -97,3 +102,49 @@ af_err af_iir(af_array* y, const af_array b, const af_array a,
     CATCHALL;
     return AF_SUCCESS;
 }
+
+// Each section is a second order direct form filter; running them one after
+// another keeps the poles of a high order filter well conditioned instead of
+// expanding them into one long polynomial.
+template<typename T>
+inline static af_array iirSos(const af_array sos, const af_array x) {
+    const Array<T> coeffs = getArray<T>(sos);
+    Array<T> res          = getArray<T>(x);
+
+    const dim_t nsections = coeffs.dims()[1];
+    for (dim_t k = 0; k < nsections; k++) {
+        const af_seq col = {double(k), double(k), 1.};
+        Array<T> b       = createSubArray<T>(coeffs, {{0., 2., 1.}, col});
+        Array<T> a       = createSubArray<T>(coeffs, {{3., 5., 1.}, col});
+        res              = iir<T>(b, a, res);
+    }
+    return getHandle(res);
+}
+
+af_err af_iir_sos(af_array* y, const af_array sos, const af_array x) {
+    AF_PROFILE_API();
+    try {
+        const ArrayInfo& sinfo = getInfo(sos);
+        const ArrayInfo& xinfo = getInfo(x);
+
+        af_dtype xtype = xinfo.getType();
+
+        ARG_ASSERT(1, sinfo.getType() == xtype);
+        ARG_ASSERT(1, sinfo.dims()[0] == 6 && sinfo.ndims() <= 2);
+
+        if (xinfo.ndims() == 0) { return af_retain_array(y, x); }
+
+        af_array res;
+        switch (xtype) {
+            case f32: res = iirSos<float>(sos, x); break;
+            case f64: res = iirSos<double>(sos, x); break;
+            case c32: res = iirSos<cfloat>(sos, x); break;
+            case c64: res = iirSos<cdouble>(sos, x); break;
+            default: TYPE_ERROR(2, xtype);
+        }
+
+        std::swap(*y, res);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
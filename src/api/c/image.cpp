@@ -15,6 +15,7 @@
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <common/graphics_common.hpp>
@@ -77,6 +78,7 @@ static fg_image convert_and_copy_image(const af_array in) {
 
 af_err af_draw_image(const af_window window, const af_array in,
                      const af_cell* const props) {
+    AF_PROFILE_API();
     try {
         if (window == 0) { AF_ERROR("Not a valid window", AF_ERR_INTERNAL); }
 
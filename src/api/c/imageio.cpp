@@ -13,6 +13,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <memory.hpp>
@@ -218,6 +219,7 @@ static af_err readImage(af_array* rImage, const uchar* pSrcLine,
 ////////////////////////////////////////////////////////////////////////////////
 // Load image from disk.
 af_err af_load_image(af_array* out, const char* filename, const bool isColor) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(1, filename != NULL);
 
@@ -516,6 +518,7 @@ af_err af_load_image(af_array* out, const char* filename, const bool isColor) {
 
 // Save an image to disk.
 af_err af_save_image(const char* filename, const af_array in_) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(0, filename != NULL);
 
@@ -707,6 +710,7 @@ af_err af_save_image(const char* filename, const af_array in_) {
 ////////////////////////////////////////////////////////////////////////////////
 /// Load image from memory.
 af_err af_load_image_memory(af_array* out, const void* ptr) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(1, ptr != NULL);
 
@@ -843,6 +847,7 @@ af_err af_load_image_memory(af_array* out, const void* ptr) {
 // Save an image to memory.
 af_err af_save_image_memory(void** ptr, const af_array in_,
                             const af_image_format format) {
+    AF_PROFILE_API();
     try {
         FreeImage_Module& _ = getFreeImagePlugin();
 
@@ -1021,6 +1026,7 @@ af_err af_save_image_memory(void** ptr, const af_array in_,
 }
 
 af_err af_delete_image_memory(void* ptr) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(0, ptr != NULL);
 
@@ -1051,27 +1057,32 @@ af_err af_delete_image_memory(void* ptr) {
 #include <stdio.h>
 #include <af/image.h>
 af_err af_load_image(af_array *out, const char *filename, const bool isColor) {
+    AF_PROFILE_API();
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_save_image(const char *filename, const af_array in_) {
+    AF_PROFILE_API();
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_load_image_memory(af_array *out, const void *ptr) {
+    AF_PROFILE_API();
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_save_image_memory(void **ptr, const af_array in_,
                             const af_image_format format) {
+    AF_PROFILE_API();
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_delete_image_memory(void *ptr) {
+    AF_PROFILE_API();
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
@@ -13,6 +13,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <memory.hpp>
@@ -121,6 +122,7 @@ FREE_IMAGE_TYPE getFIT(FI_CHANNELS channels, af_dtype type) {
 ////////////////////////////////////////////////////////////////////////////////
 // Load image from disk.
 af_err af_load_image_native(af_array* out, const char* filename) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(1, filename != NULL);
 
@@ -395,6 +397,7 @@ static void save_t(T* pDstLine, const af_array in, const dim4& dims,
 
 // Save an image to disk.
 af_err af_save_image_native(const char* filename, const af_array in) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(0, filename != NULL);
 
@@ -527,6 +530,7 @@ af_err af_save_image_native(const char* filename, const af_array in) {
 }
 
 af_err af_is_image_io_available(bool* out) {
+    AF_PROFILE_API();
     *out = true;
     return AF_SUCCESS;
 }
@@ -536,16 +540,19 @@ af_err af_is_image_io_available(bool* out) {
 #include <stdio.h>
 #include <af/image.h>
 af_err af_load_image_native(af_array* out, const char* filename) {
+    AF_PROFILE_API();
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_save_image_native(const char* filename, const af_array in) {
+    AF_PROFILE_API();
     AF_RETURN_ERROR("ArrayFire compiled without Image IO (FreeImage) support",
                     AF_ERR_NOT_CONFIGURED);
 }
 
 af_err af_is_image_io_available(bool* out) {
+    AF_PROFILE_API();
     *out = false;
     return AF_SUCCESS;
 }
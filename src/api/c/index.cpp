@@ -13,6 +13,7 @@
 #include <Array.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/moddims.hpp>
 #include <handle.hpp>
@@ -80,6 +81,7 @@ static af_array indexBySeqs(const af_array& src,
 
 af_err af_index(af_array* result, const af_array in, const unsigned ndims,
                 const af_seq* indices) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (ndims > 0 && ndims <= AF_MAX_DIMS));
 
@@ -155,6 +157,7 @@ static af_array lookup(const af_array& in, const af_array& idx,
 
 af_err af_lookup(af_array* out, const af_array in, const af_array indices,
                  const unsigned dim) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& idxInfo = getInfo(indices);
 
@@ -203,6 +206,7 @@ static inline af_array genIndex(const af_array& in, const af_index_t idxrs[]) {
 
 af_err af_index_gen(af_array* out, const af_array in, const dim_t ndims,
                     const af_index_t* indexs) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (ndims > 0 && ndims <= AF_MAX_DIMS));
         ARG_ASSERT(3, (indexs != NULL));
@@ -303,6 +307,7 @@ af_seq af_make_seq(double begin, double end, double step) {
 }
 
 af_err af_create_indexers(af_index_t** indexers) {
+    AF_PROFILE_API();
     try {
         auto* out = new af_index_t[AF_MAX_DIMS];
         for (int i = 0; i < AF_MAX_DIMS; ++i) {
@@ -318,6 +323,7 @@ af_err af_create_indexers(af_index_t** indexers) {
 
 af_err af_set_array_indexer(af_index_t* indexer, const af_array idx,
                             const dim_t dim) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(0, (indexer != NULL));
         ARG_ASSERT(1, (idx != NULL));
@@ -330,6 +336,7 @@ af_err af_set_array_indexer(af_index_t* indexer, const af_array idx,
 
 af_err af_set_seq_indexer(af_index_t* indexer, const af_seq* idx,
                           const dim_t dim, const bool is_batch) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(0, (indexer != NULL));
         ARG_ASSERT(1, (idx != NULL));
@@ -345,6 +352,7 @@ af_err af_set_seq_indexer(af_index_t* indexer, const af_seq* idx,
 af_err af_set_seq_param_indexer(af_index_t* indexer, const double begin,
                                 const double end, const double step,
                                 const dim_t dim, const bool is_batch) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(0, (indexer != NULL));
         ARG_ASSERT(4, (dim >= 0 && dim <= 3));
@@ -358,6 +366,7 @@ af_err af_set_seq_param_indexer(af_index_t* indexer, const double begin,
 }
 
 af_err af_release_indexers(af_index_t* indexers) {
+    AF_PROFILE_API();
     try {
         delete[] indexers;
     }
@@ -9,6 +9,7 @@
 
 #include <Array.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -35,6 +36,7 @@ af_err af_create_strided_array(af_array *arr, const void *data,
                                const dim_t *const dims_,
                                const dim_t *const strides_, const af_dtype ty,
                                const af_source location) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, offset >= 0);
         ARG_ASSERT(3, ndims >= 1 && ndims <= 4);
@@ -136,6 +138,7 @@ af_err af_create_strided_array(af_array *arr, const void *data,
 
 af_err af_get_strides(dim_t *s0, dim_t *s1, dim_t *s2, dim_t *s3,
                       const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info = getInfo(in);
         *s0                   = info.strides()[0];
@@ -148,6 +151,7 @@ af_err af_get_strides(dim_t *s0, dim_t *s1, dim_t *s2, dim_t *s3,
 }
 
 af_err af_get_offset(dim_t *offset, const af_array arr) {
+    AF_PROFILE_API();
     try {
         dim_t res = getInfo(arr).getOffset();
         std::swap(*offset, res);
@@ -157,6 +161,7 @@ af_err af_get_offset(dim_t *offset, const af_array arr) {
 }
 
 af_err af_get_raw_ptr(void **ptr, const af_array arr) {
+    AF_PROFILE_API();
     try {
         void *res = NULL;
 
@@ -186,6 +191,7 @@ af_err af_get_raw_ptr(void **ptr, const af_array arr) {
 }
 
 af_err af_is_linear(bool *result, const af_array arr) {
+    AF_PROFILE_API();
     try {
         *result = getInfo(arr).isLinear();
     }
@@ -194,6 +200,7 @@ af_err af_is_linear(bool *result, const af_array arr) {
 }
 
 af_err af_is_owner(bool *result, const af_array arr) {
+    AF_PROFILE_API();
     try {
         bool res = false;
 
@@ -223,6 +230,7 @@ af_err af_is_owner(bool *result, const af_array arr) {
 }
 
 af_err af_get_allocated_bytes(size_t *bytes, const af_array arr) {
+    AF_PROFILE_API();
     try {
         af_dtype ty = getInfo(arr).getType();
 
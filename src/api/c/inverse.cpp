@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <inverse.hpp>
@@ -25,12 +26,15 @@ static inline af_array inverse(const af_array in) {
 }
 
 af_err af_inverse(af_array* out, const af_array in, const af_mat_prop options) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& i_info = getInfo(in);
 
+#if !defined(AF_CPU)
         if (i_info.ndims() > 2) {
-            AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
+            AF_ERROR("inverse can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         af_dtype type = i_info.getType();
 
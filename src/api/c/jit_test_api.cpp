@@ -10,15 +10,18 @@
 #include <jit_test_api.h>
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <platform.hpp>
 
 af_err af_get_max_jit_len(int *jitLen) {
+    AF_PROFILE_API();
     *jitLen = detail::getMaxJitSize();
     return AF_SUCCESS;
 }
 
 af_err af_set_max_jit_len(const int maxJitLen) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(1, maxJitLen > 0);
         detail::getMaxJitSize() = maxJitLen;
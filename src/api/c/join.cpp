@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -66,6 +67,7 @@ static inline af_array join_many(const int dim, const unsigned n_arrays,
 
 af_err af_join(af_array *out, const int dim, const af_array first,
                const af_array second) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &finfo{getInfo(first)};
         const ArrayInfo &sinfo{getInfo(second)};
@@ -111,6 +113,7 @@ af_err af_join(af_array *out, const int dim, const af_array first,
 
 af_err af_join_many(af_array *out, const int dim, const unsigned n_arrays,
                     const af_array *inputs) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(3, inputs != nullptr);
 
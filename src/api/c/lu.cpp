@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <lu.hpp>
@@ -44,12 +45,15 @@ static inline af_array lu_inplace(af_array in, bool is_lapack_piv) {
 
 af_err af_lu(af_array *lower, af_array *upper, af_array *pivot,
              const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &i_info = getInfo(in);
 
+#if !defined(AF_CPU)
         if (i_info.ndims() > 2) {
             AF_ERROR("lu can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         af_dtype type = i_info.getType();
 
@@ -79,13 +83,16 @@ af_err af_lu(af_array *lower, af_array *upper, af_array *pivot,
 }
 
 af_err af_lu_inplace(af_array *pivot, af_array in, const bool is_lapack_piv) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &i_info = getInfo(in);
         af_dtype type           = i_info.getType();
 
+#if !defined(AF_CPU)
         if (i_info.ndims() > 2) {
             AF_ERROR("lu can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         ARG_ASSERT(1, i_info.isFloating());  // Only floating and complex types
         ARG_ASSERT(0, pivot != nullptr);
@@ -110,6 +117,7 @@ af_err af_lu_inplace(af_array *pivot, af_array in, const bool is_lapack_piv) {
 }
 
 af_err af_is_lapack_available(bool *out) {
+    AF_PROFILE_API();
     try {
         *out = isLAPACKAvailable();
     }
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <match_template.hpp>
@@ -38,6 +39,7 @@ static af_array match_template(const af_array& sImg, const af_array tImg,
 af_err af_match_template(af_array* out, const af_array search_img,
                          const af_array template_img,
                          const af_match_type m_type) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(3, (m_type >= AF_SAD && m_type <= AF_LSSD));
 
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <meanshift.hpp>
@@ -34,6 +35,7 @@ static inline af_array mean_shift(const af_array &in, const float &s_sigma,
 af_err af_mean_shift(af_array *out, const af_array in,
                      const float spatial_sigma, const float chromatic_sigma,
                      const unsigned num_iterations, const bool is_color) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (spatial_sigma >= 0));
         ARG_ASSERT(3, (chromatic_sigma >= 0));
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
@@ -156,6 +157,7 @@ static af_array median(const af_array& in, const dim_t dim) {
 
 af_err af_median_all(double* realVal, double* imagVal,  // NOLINT
                      const af_array in) {
+    AF_PROFILE_API();
     UNUSED(imagVal);
     try {
         const ArrayInfo& info = getInfo(in);
@@ -178,6 +180,7 @@ af_err af_median_all(double* realVal, double* imagVal,  // NOLINT
 }
 
 af_err af_median(af_array* out, const af_array in, const dim_t dim) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (dim >= 0 && dim <= 4));
 
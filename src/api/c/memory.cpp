@@ -11,6 +11,7 @@
 
 #include <Array.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <events.hpp>
@@ -52,6 +53,7 @@ using std::swap;
 
 af_err af_device_array(af_array *arr, void *data, const unsigned ndims,
                        const dim_t *const dims, const af_dtype type) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
 
@@ -115,6 +117,7 @@ af_err af_device_array(af_array *arr, void *data, const unsigned ndims,
 }
 
 af_err af_get_device_ptr(void **data, const af_array arr) {
+    AF_PROFILE_API();
     try {
         af_dtype type = getInfo(arr).getType();
 
@@ -153,6 +156,7 @@ inline void lockArray(const af_array arr) {
 af_err af_lock_device_ptr(const af_array arr) { return af_lock_array(arr); }
 
 af_err af_lock_array(const af_array arr) {
+    AF_PROFILE_API();
     try {
         af_dtype type = getInfo(arr).getType();
 
@@ -187,6 +191,7 @@ inline bool checkUserLock(const af_array arr) {
 }
 
 af_err af_is_locked_array(bool *res, const af_array arr) {
+    AF_PROFILE_API();
     try {
         af_dtype type = getInfo(arr).getType();
 
@@ -223,6 +228,7 @@ inline void unlockArray(const af_array arr) {
 af_err af_unlock_device_ptr(const af_array arr) { return af_unlock_array(arr); }
 
 af_err af_unlock_array(const af_array arr) {
+    AF_PROFILE_API();
     try {
         af_dtype type = getInfo(arr).getType();
 
@@ -249,6 +255,7 @@ af_err af_unlock_array(const af_array arr) {
 }
 
 af_err af_alloc_device(void **ptr, const dim_t bytes) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         *ptr = memAllocUser(bytes);
@@ -258,6 +265,7 @@ af_err af_alloc_device(void **ptr, const dim_t bytes) {
 }
 
 af_err af_alloc_device_v2(void **ptr, const dim_t bytes) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
 #ifdef AF_OPENCL
@@ -277,6 +285,7 @@ af_err af_alloc_device_v2(void **ptr, const dim_t bytes) {
 }
 
 af_err af_alloc_pinned(void **ptr, const dim_t bytes) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         *ptr = static_cast<void *>(pinnedAlloc<char>(bytes));
@@ -286,6 +295,7 @@ af_err af_alloc_pinned(void **ptr, const dim_t bytes) {
 }
 
 af_err af_free_device(void *ptr) {
+    AF_PROFILE_API();
     try {
         memFreeUser(ptr);
     }
@@ -294,6 +304,7 @@ af_err af_free_device(void *ptr) {
 }
 
 af_err af_free_device_v2(void *ptr) {
+    AF_PROFILE_API();
     try {
 #ifdef AF_OPENCL
         auto mem = static_cast<cl_mem>(ptr);
@@ -307,6 +318,7 @@ af_err af_free_device_v2(void *ptr) {
 }
 
 af_err af_free_pinned(void *ptr) {
+    AF_PROFILE_API();
     try {
         pinnedFree<char>(static_cast<char *>(ptr));
     }
@@ -315,6 +327,7 @@ af_err af_free_pinned(void *ptr) {
 }
 
 af_err af_alloc_host(void **ptr, const dim_t bytes) {
+    AF_PROFILE_API();
     if ((*ptr = malloc(bytes))) {  // NOLINT(hicpp-no-malloc)
         return AF_SUCCESS;
     }
@@ -322,11 +335,13 @@ af_err af_alloc_host(void **ptr, const dim_t bytes) {
 }
 
 af_err af_free_host(void *ptr) {
+    AF_PROFILE_API();
     free(ptr);  // NOLINT(hicpp-no-malloc)
     return AF_SUCCESS;
 }
 
 af_err af_print_mem_info(const char *msg, const int device_id) {
+    AF_PROFILE_API();
     try {
         int device = device_id;
         if (device == -1) { device = static_cast<int>(getActiveDeviceId()); }
@@ -343,6 +358,7 @@ af_err af_print_mem_info(const char *msg, const int device_id) {
 }
 
 af_err af_device_gc() {
+    AF_PROFILE_API();
     try {
         signalMemoryCleanup();
     }
@@ -352,6 +368,7 @@ af_err af_device_gc() {
 
 af_err af_device_mem_info(size_t *alloc_bytes, size_t *alloc_buffers,
                           size_t *lock_bytes, size_t *lock_buffers) {
+    AF_PROFILE_API();
     try {
         deviceMemoryInfo(alloc_bytes, alloc_buffers, lock_bytes, lock_buffers);
     }
@@ -360,6 +377,7 @@ af_err af_device_mem_info(size_t *alloc_bytes, size_t *alloc_buffers,
 }
 
 af_err af_set_mem_step_size(const size_t step_bytes) {
+    AF_PROFILE_API();
     try {
         detail::setMemStepSize(step_bytes);
     }
@@ -368,6 +386,7 @@ af_err af_set_mem_step_size(const size_t step_bytes) {
 }
 
 af_err af_get_mem_step_size(size_t *step_bytes) {
+    AF_PROFILE_API();
     try {
         *step_bytes = detail::getMemStepSize();
     }
@@ -390,6 +409,7 @@ af_memory_manager getHandle(MemoryManager &manager) {
 }
 
 af_err af_create_memory_manager(af_memory_manager *manager) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         std::unique_ptr<MemoryManager> m(new MemoryManager());
@@ -401,6 +421,7 @@ af_err af_create_memory_manager(af_memory_manager *manager) {
 }
 
 af_err af_release_memory_manager(af_memory_manager handle) {
+    AF_PROFILE_API();
     try {
         // NB: does NOT reset the internal memory manager to be the default:
         // af_unset_memory_manager_pinned must be used to fully-reset with a new
@@ -413,6 +434,7 @@ af_err af_release_memory_manager(af_memory_manager handle) {
 }
 
 af_err af_set_memory_manager(af_memory_manager mgr) {
+    AF_PROFILE_API();
     try {
         std::unique_ptr<MemoryManagerFunctionWrapper> newManager(
             new MemoryManagerFunctionWrapper(mgr));
@@ -426,6 +448,7 @@ af_err af_set_memory_manager(af_memory_manager mgr) {
 }
 
 af_err af_unset_memory_manager() {
+    AF_PROFILE_API();
     try {
         detail::resetMemoryManager();
     }
@@ -435,6 +458,7 @@ af_err af_unset_memory_manager() {
 }
 
 af_err af_set_memory_manager_pinned(af_memory_manager mgr) {
+    AF_PROFILE_API();
     try {
         // NB: does NOT free if a non-default implementation is set as the
         // current memory manager - the user is responsible for freeing any
@@ -451,6 +475,7 @@ af_err af_set_memory_manager_pinned(af_memory_manager mgr) {
 }
 
 af_err af_unset_memory_manager_pinned() {
+    AF_PROFILE_API();
     try {
         detail::resetMemoryManagerPinned();
     }
@@ -460,6 +485,7 @@ af_err af_unset_memory_manager_pinned() {
 }
 
 af_err af_memory_manager_get_payload(af_memory_manager handle, void **payload) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         *payload               = manager.payload;
@@ -470,6 +496,7 @@ af_err af_memory_manager_get_payload(af_memory_manager handle, void **payload) {
 }
 
 af_err af_memory_manager_set_payload(af_memory_manager handle, void *payload) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.payload        = payload;
@@ -484,6 +511,7 @@ af_err af_memory_manager_set_payload(af_memory_manager handle, void *payload) {
 
 af_err af_memory_manager_get_active_device_id(af_memory_manager handle,
                                               int *id) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         *id                    = manager.wrapper->getActiveDeviceId();
@@ -496,6 +524,7 @@ af_err af_memory_manager_get_active_device_id(af_memory_manager handle,
 
 af_err af_memory_manager_native_alloc(af_memory_manager handle, void **ptr,
                                       size_t size) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         *ptr                   = manager.wrapper->nativeAlloc(size);
@@ -506,6 +535,7 @@ af_err af_memory_manager_native_alloc(af_memory_manager handle, void **ptr,
 }
 
 af_err af_memory_manager_native_free(af_memory_manager handle, void *ptr) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.wrapper->nativeFree(ptr);
@@ -517,6 +547,7 @@ af_err af_memory_manager_native_free(af_memory_manager handle, void *ptr) {
 
 af_err af_memory_manager_get_max_memory_size(af_memory_manager handle,
                                              size_t *size, int id) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         *size                  = manager.wrapper->getMaxMemorySize(id);
@@ -528,6 +559,7 @@ af_err af_memory_manager_get_max_memory_size(af_memory_manager handle,
 
 af_err af_memory_manager_get_memory_pressure_threshold(af_memory_manager handle,
                                                        float *value) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         *value                 = manager.wrapper->getMemoryPressureThreshold();
@@ -539,6 +571,7 @@ af_err af_memory_manager_get_memory_pressure_threshold(af_memory_manager handle,
 
 af_err af_memory_manager_set_memory_pressure_threshold(af_memory_manager handle,
                                                        float value) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.wrapper->setMemoryPressureThreshold(value);
@@ -553,6 +586,7 @@ af_err af_memory_manager_set_memory_pressure_threshold(af_memory_manager handle,
 
 af_err af_memory_manager_set_initialize_fn(af_memory_manager handle,
                                            af_memory_manager_initialize_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.initialize_fn  = fn;
@@ -564,6 +598,7 @@ af_err af_memory_manager_set_initialize_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_shutdown_fn(af_memory_manager handle,
                                          af_memory_manager_shutdown_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.shutdown_fn    = fn;
@@ -575,6 +610,7 @@ af_err af_memory_manager_set_shutdown_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_alloc_fn(af_memory_manager handle,
                                       af_memory_manager_alloc_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.alloc_fn       = fn;
@@ -586,6 +622,7 @@ af_err af_memory_manager_set_alloc_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_allocated_fn(af_memory_manager handle,
                                           af_memory_manager_allocated_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.allocated_fn   = fn;
@@ -597,6 +634,7 @@ af_err af_memory_manager_set_allocated_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_unlock_fn(af_memory_manager handle,
                                        af_memory_manager_unlock_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.unlock_fn      = fn;
@@ -608,6 +646,7 @@ af_err af_memory_manager_set_unlock_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_signal_memory_cleanup_fn(
     af_memory_manager handle, af_memory_manager_signal_memory_cleanup_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager           = getMemoryManager(handle);
         manager.signal_memory_cleanup_fn = fn;
@@ -619,6 +658,7 @@ af_err af_memory_manager_set_signal_memory_cleanup_fn(
 
 af_err af_memory_manager_set_print_info_fn(af_memory_manager handle,
                                            af_memory_manager_print_info_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.print_info_fn  = fn;
@@ -630,6 +670,7 @@ af_err af_memory_manager_set_print_info_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_user_lock_fn(af_memory_manager handle,
                                           af_memory_manager_user_lock_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.user_lock_fn   = fn;
@@ -641,6 +682,7 @@ af_err af_memory_manager_set_user_lock_fn(af_memory_manager handle,
 
 af_err af_memory_manager_set_user_unlock_fn(
     af_memory_manager handle, af_memory_manager_user_unlock_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager = getMemoryManager(handle);
         manager.user_unlock_fn = fn;
@@ -652,6 +694,7 @@ af_err af_memory_manager_set_user_unlock_fn(
 
 af_err af_memory_manager_set_is_user_locked_fn(
     af_memory_manager handle, af_memory_manager_is_user_locked_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager    = getMemoryManager(handle);
         manager.is_user_locked_fn = fn;
@@ -663,6 +706,7 @@ af_err af_memory_manager_set_is_user_locked_fn(
 
 af_err af_memory_manager_set_get_memory_pressure_fn(
     af_memory_manager handle, af_memory_manager_get_memory_pressure_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager         = getMemoryManager(handle);
         manager.get_memory_pressure_fn = fn;
@@ -675,6 +719,7 @@ af_err af_memory_manager_set_get_memory_pressure_fn(
 af_err af_memory_manager_set_jit_tree_exceeds_memory_pressure_fn(
     af_memory_manager handle,
     af_memory_manager_jit_tree_exceeds_memory_pressure_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager                      = getMemoryManager(handle);
         manager.jit_tree_exceeds_memory_pressure_fn = fn;
@@ -686,6 +731,7 @@ af_err af_memory_manager_set_jit_tree_exceeds_memory_pressure_fn(
 
 af_err af_memory_manager_set_add_memory_management_fn(
     af_memory_manager handle, af_memory_manager_add_memory_management_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager           = getMemoryManager(handle);
         manager.add_memory_management_fn = fn;
@@ -698,6 +744,7 @@ af_err af_memory_manager_set_add_memory_management_fn(
 af_err af_memory_manager_set_remove_memory_management_fn(
     af_memory_manager handle,
     af_memory_manager_remove_memory_management_fn fn) {
+    AF_PROFILE_API();
     try {
         MemoryManager &manager              = getMemoryManager(handle);
         manager.remove_memory_management_fn = fn;
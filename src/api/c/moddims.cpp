@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <common/moddims.hpp>
@@ -40,6 +41,7 @@ af_array flat(const af_array in) {
 
 af_err af_moddims(af_array* out, const af_array in, const unsigned ndims,
                   const dim_t* const dims) {
+    AF_PROFILE_API();
     try {
         if (ndims == 0) {
             *out = retain(in);
@@ -82,6 +84,7 @@ af_err af_moddims(af_array* out, const af_array in, const unsigned ndims,
 }
 
 af_err af_flat(af_array* out, const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(in);
 
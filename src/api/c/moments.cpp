@@ -14,6 +14,7 @@
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <common/graphics_common.hpp>
@@ -40,6 +41,7 @@ static inline void moments(af_array* out, const af_array in,
 
 af_err af_moments(af_array* out, const af_array in,
                   const af_moment_type moment) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& in_info = getInfo(in);
         af_dtype type            = in_info.getType();
@@ -72,6 +74,7 @@ static inline void moment_copy(double* out, const af_array moments) {
 
 af_err af_moments_all(double* out, const af_array in,
                       const af_moment_type moment) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& in_info = getInfo(in);
         dim4 idims               = in_info.dims();
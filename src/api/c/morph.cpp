@@ -9,6 +9,7 @@
 
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <common/indexing_helpers.hpp>
@@ -179,17 +180,21 @@ af_err morph3d(af_array *out, const af_array &in, const af_array &mask,
 }
 
 af_err af_dilate(af_array *out, const af_array in, const af_array mask) {
+    AF_PROFILE_API();
     return morph(out, in, mask, true);
 }
 
 af_err af_erode(af_array *out, const af_array in, const af_array mask) {
+    AF_PROFILE_API();
     return morph(out, in, mask, false);
 }
 
 af_err af_dilate3(af_array *out, const af_array in, const af_array mask) {
+    AF_PROFILE_API();
     return morph3d(out, in, mask, true);
 }
 
 af_err af_erode3(af_array *out, const af_array in, const af_array mask) {
+    AF_PROFILE_API();
     return morph3d(out, in, mask, false);
 }
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <nearest_neighbour.hpp>
@@ -44,6 +45,7 @@ static void nearest_neighbour(af_array* idx, af_array* dist,
 af_err af_nearest_neighbour(af_array* idx, af_array* dist, const af_array query,
                             const af_array train, const dim_t dist_dim,
                             const uint n_dist, const af_match_type dist_type) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& qInfo = getInfo(query);
         const ArrayInfo& tInfo = getInfo(train);
@@ -10,6 +10,7 @@
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <complex.hpp>
 #include <copy.hpp>
@@ -121,6 +122,7 @@ double norm(const af_array a, const af_norm_type type, const double p,
 
 af_err af_norm(double *out, const af_array in, const af_norm_type type,
                const double p, const double q) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &i_info = getInfo(in);
 
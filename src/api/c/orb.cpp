@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <features.hpp>
 #include <handle.hpp>
@@ -54,6 +55,7 @@ af_err af_orb(af_features* feat, af_array* desc, const af_array in,
               const float fast_thr, const unsigned max_feat,
               const float scl_fctr, const unsigned levels,
               const bool blur_img) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(in);
         af::dim4 dims         = info.dims();
@@ -13,6 +13,7 @@
 #include <arith.hpp>
 #include <blas.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <common/moddims.hpp>
@@ -169,6 +170,7 @@ static inline af_array pinverse(const af_array in, const double tol) {
 
 af_err af_pinverse(af_array *out, const af_array in, const double tol,
                    const af_mat_prop options) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &i_info = getInfo(in);
 
@@ -11,6 +11,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <copy.hpp>
@@ -138,6 +139,7 @@ static void printSparse(const char *exp, af_array arr, const int precision,
 }
 
 af_err af_print_array(af_array arr) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info =
             getInfo(arr, false);  // Don't assert sparse/dense
@@ -176,6 +178,7 @@ af_err af_print_array(af_array arr) {
 
 af_err af_print_array_gen(const char *exp, const af_array arr,
                           const int precision) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(0, exp != NULL);
         const ArrayInfo &info =
@@ -215,6 +218,7 @@ af_err af_print_array_gen(const char *exp, const af_array arr,
 
 af_err af_array_to_string(char **output, const char *exp, const af_array arr,
                           const int precision, bool transpose) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(0, exp != NULL);
         const ArrayInfo &info =
@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <qr.hpp>
@@ -43,6 +44,7 @@ static inline af_array qr_inplace(af_array in) {
 }
 
 af_err af_qr(af_array *q, af_array *r, af_array *tau, const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &i_info = getInfo(in);
 
@@ -78,6 +80,7 @@ af_err af_qr(af_array *q, af_array *r, af_array *tau, const af_array in) {
 }
 
 af_err af_qr_inplace(af_array *tau, af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &i_info = getInfo(in);
 
@@ -11,6 +11,7 @@
 
 #include <backend.hpp>
 #include <common/MersenneTwister.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -125,6 +126,7 @@ void validateRandomType(const af_random_engine_type type) {
 }  // namespace
 
 af_err af_get_default_random_engine(af_random_engine *r) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
 
@@ -137,6 +139,7 @@ af_err af_get_default_random_engine(af_random_engine *r) {
 
 af_err af_create_random_engine(af_random_engine *engineHandle,
                                af_random_engine_type rtype, uintl seed) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         validateRandomType(rtype);
@@ -170,6 +173,7 @@ af_err af_create_random_engine(af_random_engine *engineHandle,
 
 af_err af_retain_random_engine(af_random_engine *outHandle,
                                const af_random_engine engineHandle) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         *outHandle = getRandomEngineHandle(*(getRandomEngine(engineHandle)));
@@ -180,6 +184,7 @@ af_err af_retain_random_engine(af_random_engine *outHandle,
 
 af_err af_random_engine_set_type(af_random_engine *engine,
                                  const af_random_engine_type rtype) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         validateRandomType(rtype);
@@ -216,6 +221,7 @@ af_err af_random_engine_set_type(af_random_engine *engine,
 
 af_err af_random_engine_get_type(af_random_engine_type *rtype,
                                  const af_random_engine engine) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         RandomEngine *e = getRandomEngine(engine);
@@ -226,6 +232,7 @@ af_err af_random_engine_get_type(af_random_engine_type *rtype,
 }
 
 af_err af_set_default_random_engine_type(const af_random_engine_type rtype) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         af_random_engine e;
@@ -237,6 +244,7 @@ af_err af_set_default_random_engine_type(const af_random_engine_type rtype) {
 }
 
 af_err af_random_engine_set_seed(af_random_engine *engine, const uintl seed) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         RandomEngine *e = getRandomEngine(*engine);
@@ -252,6 +260,7 @@ af_err af_random_engine_set_seed(af_random_engine *engine, const uintl seed) {
 }
 
 af_err af_random_engine_get_seed(uintl *const seed, af_random_engine engine) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         RandomEngine *e = getRandomEngine(engine);
@@ -264,6 +273,7 @@ af_err af_random_engine_get_seed(uintl *const seed, af_random_engine engine) {
 af_err af_random_uniform(af_array *out, const unsigned ndims,
                          const dim_t *const dims, const af_dtype type,
                          af_random_engine engine) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -296,6 +306,7 @@ af_err af_random_uniform(af_array *out, const unsigned ndims,
 af_err af_random_normal(af_array *out, const unsigned ndims,
                         const dim_t *const dims, const af_dtype type,
                         af_random_engine engine) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -318,6 +329,7 @@ af_err af_random_normal(af_array *out, const unsigned ndims,
 }
 
 af_err af_release_random_engine(af_random_engine engineHandle) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         delete getRandomEngine(engineHandle);
@@ -328,6 +340,7 @@ af_err af_release_random_engine(af_random_engine engineHandle) {
 
 af_err af_randu(af_array *out, const unsigned ndims, const dim_t *const dims,
                 const af_dtype type) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -361,6 +374,7 @@ af_err af_randu(af_array *out, const unsigned ndims, const dim_t *const dims,
 
 af_err af_randn(af_array *out, const unsigned ndims, const dim_t *const dims,
                 const af_dtype type) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -385,6 +399,7 @@ af_err af_randn(af_array *out, const unsigned ndims, const dim_t *const dims,
 }
 
 af_err af_set_seed(const uintl seed) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         af_random_engine engine;
@@ -396,6 +411,7 @@ af_err af_set_seed(const uintl seed) {
 }
 
 af_err af_get_seed(uintl *seed) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         af_random_engine e;
@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <complex.hpp>
 #include <copy.hpp>
@@ -58,6 +59,7 @@ static inline uint rank(const af_array in, double tol) {
 }
 
 af_err af_rank(uint* out, const af_array in, const double tol) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& i_info = getInfo(in);
 
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <regions.hpp>
@@ -27,6 +28,7 @@ static af_array regions(af_array const &in, af_connectivity connectivity) {
 
 af_err af_regions(af_array *out, const af_array in,
                   const af_connectivity connectivity, const af_dtype type) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (connectivity == AF_CONNECTIVITY_4 ||
                        connectivity == AF_CONNECTIVITY_8));
@@ -11,6 +11,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -70,6 +71,7 @@ static inline af_array reorder(const af_array in, const af::dim4 &rdims0) {
 }
 
 af_err af_reorder(af_array *out, const af_array in, const af::dim4 &rdims) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -124,6 +126,7 @@ af_err af_reorder(af_array *out, const af_array in, const af::dim4 &rdims) {
 
 af_err af_reorder(af_array *out, const af_array in, const unsigned x,
                   const unsigned y, const unsigned z, const unsigned w) {
+    AF_PROFILE_API();
     af::dim4 rdims(x, y, z, w);
     return af_reorder(out, in, rdims);
 }
@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <resize.hpp>
@@ -32,6 +33,7 @@ static inline af_array resize(const af_array in, const dim_t odim0,
 
 af_err af_resize(af_array* out, const af_array in, const dim_t odim0,
                  const dim_t odim1, const af_interp_type method) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type         = info.getType();
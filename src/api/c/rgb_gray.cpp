@@ -16,6 +16,7 @@
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/tile.hpp>
 #include <handle.hpp>
@@ -167,10 +168,12 @@ af_err convert(af_array* out, const af_array in, const float r, const float g,
 
 af_err af_rgb2gray(af_array* out, const af_array in, const float rPercent,
                    const float gPercent, const float bPercent) {
+    AF_PROFILE_API();
     return convert<true>(out, in, rPercent, gPercent, bPercent);
 }
 
 af_err af_gray2rgb(af_array* out, const af_array in, const float rFactor,
                    const float gFactor, const float bFactor) {
+    AF_PROFILE_API();
     return convert<false>(out, in, rFactor, gFactor, bFactor);
 }
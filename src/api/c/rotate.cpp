@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <rotate.hpp>
@@ -36,6 +37,7 @@ static inline af_array rotate(const af_array in, const float theta,
 
 af_err af_rotate(af_array *out, const af_array in, const float theta,
                  const bool crop, const af_interp_type method) {
+    AF_PROFILE_API();
     try {
         dim_t odims0 = 0, odims1 = 0;
 
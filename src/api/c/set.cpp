@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <set.hpp>
@@ -29,6 +30,7 @@ static inline af_array setUnique(const af_array in, const bool is_sorted) {
 }
 
 af_err af_set_unique(af_array* out, const af_array in, const bool is_sorted) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& in_info = getInfo(in);
 
@@ -71,6 +73,7 @@ static inline af_array setUnion(const af_array first, const af_array second,
 
 af_err af_set_union(af_array* out, const af_array first, const af_array second,
                     const bool is_unique) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& first_info  = getInfo(first);
         const ArrayInfo& second_info = getInfo(second);
@@ -118,6 +121,7 @@ static inline af_array setIntersect(const af_array first, const af_array second,
 
 af_err af_set_intersect(af_array* out, const af_array first,
                         const af_array second, const bool is_unique) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& first_info  = getInfo(first);
         const ArrayInfo& second_info = getInfo(second);
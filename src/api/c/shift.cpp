@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <shift.hpp>
@@ -28,6 +29,7 @@ static inline af_array shift(const af_array in, const int sdims[4]) {
 }
 
 af_err af_shift(af_array *out, const af_array in, const int sdims[4]) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -61,6 +63,7 @@ af_err af_shift(af_array *out, const af_array in, const int sdims[4]) {
 
 af_err af_shift(af_array *out, const af_array in, const int x, const int y,
                 const int z, const int w) {
+    AF_PROFILE_API();
     const int sdims[] = {x, y, z, w};
     return af_shift(out, in, sdims);
 }
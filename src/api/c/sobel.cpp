@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <sobel.hpp>
@@ -36,6 +37,7 @@ ArrayPair sobelDerivatives(const af_array &in, const unsigned &ker_size) {
 
 af_err af_sobel_operator(af_array *dx, af_array *dy, const af_array img,
                          const unsigned ker_size) {
+    AF_PROFILE_API();
     try {
         // FIXME: ADD SUPPORT FOR OTHER KERNEL SIZES
         // ARG_ASSERT(4, (ker_size==3 || ker_size==5 || ker_size==7));
@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <solve.hpp>
@@ -30,6 +31,7 @@ static inline af_array solve(const af_array a, const af_array b,
 
 af_err af_solve(af_array* out, const af_array a, const af_array b,
                 const af_mat_prop options) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& a_info = getInfo(a);
         const ArrayInfo& b_info = getInfo(b);
@@ -94,6 +96,7 @@ static inline af_array solve_lu(const af_array a, const af_array pivot,
 
 af_err af_solve_lu(af_array* out, const af_array a, const af_array piv,
                    const af_array b, const af_mat_prop options) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& a_info = getInfo(a);
         const ArrayInfo& b_info = getInfo(b);
@@ -9,6 +9,7 @@
 
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <lookup.hpp>
@@ -64,6 +65,7 @@ af_err af_create_sparse_array(af_array *out, const dim_t nRows,
                               const dim_t nCols, const af_array values,
                               const af_array rowIdx, const af_array colIdx,
                               const af_storage stype) {
+    AF_PROFILE_API();
     try {
         // Checks:
         // rowIdx and colIdx arrays are of s32 type
@@ -161,6 +163,7 @@ af_err af_create_sparse_array_from_ptr(
     af_array *out, const dim_t nRows, const dim_t nCols, const dim_t nNZ,
     const void *const values, const int *const rowIdx, const int *const colIdx,
     const af_dtype type, const af_storage stype, const af_source source) {
+    AF_PROFILE_API();
     try {
         // Checks:
         // rowIdx and colIdx arrays are of s32 type
@@ -233,6 +236,7 @@ af_array createSparseArrayFromDense(const af_array _in,
 
 af_err af_create_sparse_array_from_dense(af_array *out, const af_array in,
                                          const af_storage stype) {
+    AF_PROFILE_API();
     try {
         // Checks:
         // stype is within acceptable range
@@ -321,6 +325,7 @@ af_array sparseConvertStorage(const af_array in_,
 
 af_err af_sparse_convert_to(af_array *out, const af_array in,
                             const af_storage destStorage) {
+    AF_PROFILE_API();
     try {
         // Handle dense case
         const ArrayInfo &info = getInfo(in, false, true);
@@ -368,6 +373,7 @@ af_err af_sparse_convert_to(af_array *out, const af_array in,
 }
 
 af_err af_sparse_to_dense(af_array *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         af_array output = nullptr;
 
@@ -408,6 +414,7 @@ af_array getSparseValues(const af_array in) {
 
 af_err af_sparse_get_info(af_array *values, af_array *rows, af_array *cols,
                           af_storage *stype, const af_array in) {
+    AF_PROFILE_API();
     try {
         if (values != NULL) { AF_CHECK(af_sparse_get_values(values, in)); }
         if (rows != NULL) { AF_CHECK(af_sparse_get_row_idx(rows, in)); }
@@ -420,6 +427,7 @@ af_err af_sparse_get_info(af_array *values, af_array *rows, af_array *cols,
 }
 
 af_err af_sparse_get_values(af_array *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
 
@@ -439,6 +447,7 @@ af_err af_sparse_get_values(af_array *out, const af_array in) {
 }
 
 af_err af_sparse_get_row_idx(af_array *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out                       = getHandle(base.getRowIdx());
@@ -448,6 +457,7 @@ af_err af_sparse_get_row_idx(af_array *out, const af_array in) {
 }
 
 af_err af_sparse_get_col_idx(af_array *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out                       = getHandle(base.getColIdx());
@@ -457,6 +467,7 @@ af_err af_sparse_get_col_idx(af_array *out, const af_array in) {
 }
 
 af_err af_sparse_get_nnz(dim_t *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out                       = base.getNNZ();
@@ -466,6 +477,7 @@ af_err af_sparse_get_nnz(dim_t *out, const af_array in) {
 }
 
 af_err af_sparse_get_storage(af_storage *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out                       = base.getStorage();
@@ -9,6 +9,7 @@
 
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <copy.hpp>
 #include <handle.hpp>
@@ -93,11 +94,13 @@ static af_array stdev(const af_array& in, int dim, const af_var_bias bias) {
 
 // NOLINTNEXTLINE(readability-non-const-parameter)
 af_err af_stdev_all(double* realVal, double* imagVal, const af_array in) {
+    AF_PROFILE_API();
     return af_stdev_all_v2(realVal, imagVal, in, AF_VARIANCE_POPULATION);
 }
 
 af_err af_stdev_all_v2(double* realVal, double* imagVal, const af_array in,
                        const af_var_bias bias) {
+    AF_PROFILE_API();
     UNUSED(imagVal);  // TODO implement for complex values
     try {
         const ArrayInfo& info = getInfo(in);
@@ -132,11 +135,13 @@ af_err af_stdev_all_v2(double* realVal, double* imagVal, const af_array in,
 }
 
 af_err af_stdev(af_array* out, const af_array in, const dim_t dim) {
+    AF_PROFILE_API();
     return af_stdev_v2(out, in, AF_VARIANCE_POPULATION, dim);
 }
 
 af_err af_stdev_v2(af_array* out, const af_array in, const af_var_bias bias,
                    const dim_t dim) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(2, (dim >= 0 && dim <= 3));
 
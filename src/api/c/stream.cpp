@@ -9,6 +9,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <type_util.hpp>
@@ -126,6 +127,7 @@ static int save(const char *key, const af_array arr, const char *filename,
 
 af_err af_save_array(int *index, const char *key, const af_array arr,
                      const char *filename, const bool append) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(0, key != NULL);
         ARG_ASSERT(2, filename != NULL);
@@ -328,6 +330,7 @@ int checkVersionAndFindIndex(const char *filename, const char *k) {
 
 af_err af_read_array_index(af_array *out, const char *filename,
                            const unsigned index) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
 
@@ -341,6 +344,7 @@ af_err af_read_array_index(af_array *out, const char *filename,
 }
 
 af_err af_read_array_key(af_array *out, const char *filename, const char *key) {
+    AF_PROFILE_API();
     try {
         AF_CHECK(af_init());
         ARG_ASSERT(1, filename != NULL);
@@ -360,6 +364,7 @@ af_err af_read_array_key(af_array *out, const char *filename, const char *key) {
 
 af_err af_read_array_key_check(int *index, const char *filename,
                                const char *key) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(1, filename != NULL);
         ARG_ASSERT(2, key != NULL);
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <features.hpp>
 #include <handle.hpp>
@@ -55,6 +56,7 @@ static af_features susan(af_array const& in, const unsigned radius,
 af_err af_susan(af_features* out, const af_array in, const unsigned radius,
                 const float diff_thr, const float geom_thr,
                 const float feature_ratio, const unsigned edge) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(in);
         af::dim4 dims         = info.dims();
@@ -13,6 +13,7 @@
 
 #include <Array.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <svd.hpp>
@@ -71,6 +72,7 @@ static inline void svdInPlace(af_array *s, af_array *u, af_array *vt,
 }
 
 af_err af_svd(af_array *u, af_array *s, af_array *vt, const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info = getInfo(in);
         dim4 dims             = info.dims();
@@ -98,6 +100,7 @@ af_err af_svd(af_array *u, af_array *s, af_array *vt, const af_array in) {
 }
 
 af_err af_svd_inplace(af_array *u, af_array *s, af_array *vt, af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info = getInfo(in);
         dim4 dims             = info.dims();
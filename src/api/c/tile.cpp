@@ -7,6 +7,7 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <common/Profiler.hpp>
 #include <common/tile.hpp>
 
 #include <arith.hpp>
@@ -37,6 +38,7 @@ static inline af_array tile(const af_array in, const af::dim4 &tileDims) {
 }
 
 af_err af_tile(af_array *out, const af_array in, const af::dim4 &tileDims) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &info = getInfo(in);
         af_dtype type         = info.getType();
@@ -72,6 +74,7 @@ af_err af_tile(af_array *out, const af_array in, const af::dim4 &tileDims) {
 
 af_err af_tile(af_array *out, const af_array in, const unsigned x,
                const unsigned y, const unsigned z, const unsigned w) {
+    AF_PROFILE_API();
     af::dim4 tileDims(x, y, z, w);
     return af_tile(out, in, tileDims);
 }
@@ -12,6 +12,7 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -39,6 +40,7 @@ af_err topk(af_array *v, af_array *i, const af_array in, const int k,
 
 af_err af_topk(af_array *values, af_array *indices, const af_array in,
                const int k, const int dim, const af_topk_function order) {
+    AF_PROFILE_API();
     try {
         af::topkFunction ord = (order == AF_TOPK_DEFAULT ? AF_TOPK_MAX : order);
 
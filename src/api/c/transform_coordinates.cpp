@@ -10,6 +10,7 @@
 #include <arith.hpp>
 #include <backend.hpp>
 #include <blas.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <convolve.hpp>
 #include <handle.hpp>
@@ -83,6 +84,7 @@ static af_array transform_coordinates(const af_array &tf_, const float d0_,
 
 af_err af_transform_coordinates(af_array *out, const af_array tf,
                                 const float d0_, const float d1_) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &tfInfo = getInfo(tf);
         dim4 tfDims             = tfInfo.dims();
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
@@ -35,6 +36,7 @@ static inline af_array trs(const af_array in, const bool conjugate) {
 }
 
 af_err af_transpose(af_array* out, af_array in, const bool conjugate) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type         = info.getType();
@@ -88,6 +90,7 @@ static inline void transpose_inplace(af_array in, const bool conjugate) {
 }
 
 af_err af_transpose_inplace(af_array in, const bool conjugate) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type         = info.getType();
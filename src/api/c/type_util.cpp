@@ -9,6 +9,7 @@
 
 #include <type_util.hpp>
 
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <af/half.h>
 #include <af/util.h>
@@ -38,6 +39,7 @@ size_t size_of(af_dtype type) {
 }
 
 af_err af_get_size_of(size_t *size, af_dtype type) {
+    AF_PROFILE_API();
     *size = size_of(type);
     return AF_SUCCESS;
 }
@@ -16,6 +16,7 @@
 #include <arith.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
@@ -122,6 +123,7 @@ static af_err af_unary_complex(af_array *out, const af_array in) {
 
 #define UNARY_FN(name, opcode)                           \
     af_err af_##name(af_array *out, const af_array in) { \
+        AF_PROFILE_API();                                \
         return af_unary<af_##opcode##_t>(out, in);       \
     }
 
@@ -129,6 +131,7 @@ static af_err af_unary_complex(af_array *out, const af_array in) {
 
 #define UNARY_COMPLEX(fn)                              \
     af_err af_##fn(af_array *out, const af_array in) { \
+        AF_PROFILE_API();                              \
         return af_unary_complex<af_##fn##_t>(out, in); \
     }
 
@@ -559,6 +562,7 @@ struct unaryOpCplxFun<Tc, Tr, af_sqrt_t> {
 };
 
 af_err af_not(af_array *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         af_array tmp;
         const ArrayInfo &in_info = getInfo(in);
@@ -581,6 +585,7 @@ static inline af_array bitOpNot(const af_array in) {
 }
 
 af_err af_bitnot(af_array *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &iinfo = getInfo(in);
         const af_dtype type    = iinfo.getType();
@@ -611,6 +616,7 @@ af_err af_bitnot(af_array *out, const af_array in) {
 }
 
 af_err af_arg(af_array *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo &in_info = getInfo(in);
 
@@ -636,6 +642,7 @@ af_err af_arg(af_array *out, const af_array in) {
 }
 
 af_err af_pow2(af_array *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         af_array two;
         const ArrayInfo &in_info = getInfo(in);
@@ -653,6 +660,7 @@ af_err af_pow2(af_array *out, const af_array in) {
 }
 
 af_err af_factorial(af_array *out, const af_array in) {
+    AF_PROFILE_API();
     try {
         af_array one;
         const ArrayInfo &in_info = getInfo(in);
@@ -740,6 +748,7 @@ static af_err af_check(af_array *out, const af_array in) {
 
 #define CHECK(fn)                                      \
     af_err af_##fn(af_array *out, const af_array in) { \
+        AF_PROFILE_API();                              \
         return af_check<af_##fn##_t>(out, in);         \
     }
 
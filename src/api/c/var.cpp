@@ -9,6 +9,7 @@
 
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/cast.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
@@ -185,6 +186,7 @@ static af_array var_(const af_array& in, const af_array& weights,
 
 af_err af_var(af_array* out, const af_array in, const bool isbiased,
               const dim_t dim) {
+    AF_PROFILE_API();
     const af_var_bias bias =
         (isbiased ? AF_VARIANCE_SAMPLE : AF_VARIANCE_POPULATION);
     return af_var_v2(out, in, bias, dim);
@@ -192,6 +194,7 @@ af_err af_var(af_array* out, const af_array in, const bool isbiased,
 
 af_err af_var_v2(af_array* out, const af_array in, const af_var_bias bias,
                  const dim_t dim) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(3, (dim >= 0 && dim <= 3));
 
@@ -250,6 +253,7 @@ af_err af_var_v2(af_array* out, const af_array in, const af_var_bias bias,
 
 af_err af_var_weighted(af_array* out, const af_array in, const af_array weights,
                        const dim_t dim) {
+    AF_PROFILE_API();
     try {
         ARG_ASSERT(3, (dim >= 0 && dim <= 3));
 
@@ -328,6 +332,7 @@ af_err af_var_weighted(af_array* out, const af_array in, const af_array weights,
 
 af_err af_var_all(double* realVal, double* imagVal, const af_array in,
                   const bool isbiased) {
+    AF_PROFILE_API();
     const af_var_bias bias =
         (isbiased ? AF_VARIANCE_SAMPLE : AF_VARIANCE_POPULATION);
     return af_var_all_v2(realVal, imagVal, in, bias);
@@ -335,6 +340,7 @@ af_err af_var_all(double* realVal, double* imagVal, const af_array in,
 
 af_err af_var_all_v2(double* realVal, double* imagVal, const af_array in,
                      const af_var_bias bias) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type         = info.getType();
@@ -369,6 +375,7 @@ af_err af_var_all_v2(double* realVal, double* imagVal, const af_array in,
 
 af_err af_var_all_weighted(double* realVal, double* imagVal, const af_array in,
                            const af_array weights) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& iInfo = getInfo(in);
         const ArrayInfo& wInfo = getInfo(weights);
@@ -413,6 +420,7 @@ af_err af_var_all_weighted(double* realVal, double* imagVal, const af_array in,
 af_err af_meanvar(af_array* mean, af_array* var, const af_array in,
                   const af_array weights, const af_var_bias bias,
                   const dim_t dim) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& iInfo = getInfo(in);
         if (weights != 0) {
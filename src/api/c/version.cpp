@@ -7,10 +7,12 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <common/Profiler.hpp>
 #include <version.hpp>
 #include <af/util.h>
 
 af_err af_get_version(int *major, int *minor, int *patch) {
+    AF_PROFILE_API();
     *major = AF_VERSION_MAJOR;
     *minor = AF_VERSION_MINOR;
     *patch = AF_VERSION_PATCH;
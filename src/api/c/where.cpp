@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <where.hpp>
@@ -31,6 +32,7 @@ static inline af_array where(const af_array in) {
 }
 
 af_err af_where(af_array* idx, const af_array in) {
+    AF_PROFILE_API();
     try {
         const ArrayInfo& i_info = getInfo(in);
         af_dtype type           = i_info.getType();
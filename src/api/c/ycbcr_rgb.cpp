@@ -9,6 +9,7 @@
 
 #include <arith.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
 #include <join.hpp>
@@ -154,10 +155,12 @@ af_err convert(af_array* out, const af_array& in, const af_ycc_std standard) {
 
 af_err af_ycbcr2rgb(af_array* out, const af_array in,
                     const af_ycc_std standard) {
+    AF_PROFILE_API();
     return convert<true>(out, in, standard);
 }
 
 af_err af_rgb2ycbcr(af_array* out, const af_array in,
                     const af_ycc_std standard) {
+    AF_PROFILE_API();
     return convert<false>(out, in, standard);
 }
@@ -171,6 +171,20 @@ size_t getMemStepSize() {
     return size_bytes;
 }
 
+void setNumThreads(const int num_threads) {
+    AF_THROW(af_set_num_threads(num_threads));
+}
+
+int getNumThreads() {
+    int num_threads = 0;
+    AF_THROW(af_get_num_threads(&num_threads));
+    return num_threads;
+}
+
+void startTrace(const char *filename) { AF_THROW(af_start_trace(filename)); }
+
+void stopTrace() { AF_THROW(af_stop_trace()); }
+
 AF_DEPRECATED_WARNINGS_OFF
 #define INSTANTIATE(T)                                                        \
     template<>                                                                \
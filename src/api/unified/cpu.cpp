@@ -0,0 +1,40 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/backend.h>
+#include <af/cpu.h>
+#include "symbol_manager.hpp"
+
+af_err afcpu_create_stream(int* stream) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_CPU) { CALL(afcpu_create_stream, stream); }
+    return AF_ERR_NOT_SUPPORTED;
+}
+
+af_err afcpu_set_stream(int stream) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_CPU) { CALL(afcpu_set_stream, stream); }
+    return AF_ERR_NOT_SUPPORTED;
+}
+
+af_err afcpu_get_stream(int* stream) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_CPU) { CALL(afcpu_get_stream, stream); }
+    return AF_ERR_NOT_SUPPORTED;
+}
+
+af_err afcpu_destroy_stream(int stream) {
+    af_backend backend;
+    af_get_active_backend(&backend);
+    if (backend == AF_BACKEND_CPU) { CALL(afcpu_destroy_stream, stream); }
+    return AF_ERR_NOT_SUPPORTED;
+}
@@ -187,3 +187,17 @@ af_err af_set_kernel_cache_directory(const char *path, int override_eval) {
 af_err af_get_kernel_cache_directory(size_t *length, char *path) {
     CALL(af_get_kernel_cache_directory, length, path);
 }
+
+af_err af_set_num_threads(const int num_threads) {
+    CALL(af_set_num_threads, num_threads);
+}
+
+af_err af_get_num_threads(int *num_threads) {
+    CALL(af_get_num_threads, num_threads);
+}
+
+af_err af_start_trace(const char *filename) {
+    CALL(af_start_trace, filename);
+}
+
+af_err af_stop_trace() { CALL_NO_PARAMS(af_stop_trace); }
@@ -137,6 +137,14 @@ af_err af_bilateral(af_array *out, const af_array in, const float spatial_sigma,
     CALL(af_bilateral, out, in, spatial_sigma, chromatic_sigma, isColor);
 }
 
+af_err af_bilateral_v2(af_array *out, const af_array in,
+                       const float spatial_sigma, const float chromatic_sigma,
+                       const bool isColor, const af_bilateral_mode mode) {
+    CHECK_ARRAYS(in);
+    CALL(af_bilateral_v2, out, in, spatial_sigma, chromatic_sigma, isColor,
+         mode);
+}
+
 af_err af_mean_shift(af_array *out, const af_array in,
                      const float spatial_sigma, const float chromatic_sigma,
                      const unsigned iter, const bool is_color) {
@@ -269,6 +277,16 @@ af_err af_iterative_deconv(af_array *out, const af_array in, const af_array ker,
     CALL(af_iterative_deconv, out, in, ker, iterations, relax_factor, algo);
 }
 
+af_err af_iterative_deconv_v2(af_array *out, const af_array in,
+                              const af_array ker, const unsigned iterations,
+                              const float relax_factor,
+                              const af_iterative_deconv_algo algo,
+                              const float tolerance) {
+    CHECK_ARRAYS(in, ker);
+    CALL(af_iterative_deconv_v2, out, in, ker, iterations, relax_factor, algo,
+         tolerance);
+}
+
 af_err af_inverse_deconv(af_array *out, const af_array in, const af_array psf,
                          const float gamma, const af_inverse_deconv_algo algo) {
     CHECK_ARRAYS(in, psf);
@@ -225,6 +225,11 @@ af_err af_iir(af_array *y, const af_array b, const af_array a,
     CALL(af_iir, y, b, a, x);
 }
 
+af_err af_iir_sos(af_array *y, const af_array sos, const af_array x) {
+    CHECK_ARRAYS(sos, x);
+    CALL(af_iir_sos, y, sos, x);
+}
+
 af_err af_medfilt(af_array *out, const af_array in, const dim_t wind_length,
                   const dim_t wind_width, const af_border_type edge_pad) {
     CHECK_ARRAYS(in);
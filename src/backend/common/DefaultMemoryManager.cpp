@@ -9,6 +9,7 @@
 
 #include <common/DefaultMemoryManager.hpp>
 #include <common/Logger.hpp>
+#include <common/Profiler.hpp>
 #include <common/dispatch.hpp>
 #include <common/err_common.hpp>
 #include <common/util.hpp>
@@ -26,10 +27,22 @@ using std::max;
 using std::move;
 using std::stoi;
 using std::string;
+using std::to_string;
 using std::vector;
 
 namespace common {
 
+namespace {
+/// Records a memory manager event of \p bytes and the resulting usage
+void profileMemory(const char *event, size_t bytes, size_t lock_bytes,
+                   size_t total_bytes) {
+    if (!profiler::enabled()) { return; }
+    profiler::instant("memory", event, "\"bytes\":" + to_string(bytes));
+    profiler::counter("memory", "\"locked\":" + to_string(lock_bytes) +
+                                    ",\"allocated\":" + to_string(total_bytes));
+}
+}  // namespace
+
 DefaultMemoryManager::memory_info &
 DefaultMemoryManager::getCurrentMemoryInfo() {
     return memory[this->getActiveDeviceId()];
@@ -62,6 +75,8 @@ void DefaultMemoryManager::cleanDeviceMemoryManager(int device) {
             current.total_buffers -= num_ptrs;
         }
         current.free_map.clear();
+        profileMemory("garbage collect", bytes_freed, current.lock_bytes,
+                      current.total_bytes);
     }
 
     AF_TRACE("GC: Clearing {} buffers {}", free_ptrs.size(),
@@ -187,6 +202,8 @@ void *DefaultMemoryManager::alloc(bool user_lock, const unsigned ndims,
                 current.locked_map[ptr] = info;
                 current.lock_bytes += alloc_bytes;
                 current.lock_buffers++;
+                profileMemory("reuse", alloc_bytes, current.lock_bytes,
+                              current.total_bytes);
             }
         }
 
@@ -208,6 +225,8 @@ void *DefaultMemoryManager::alloc(bool user_lock, const unsigned ndims,
             current.locked_map[ptr] = info;
             current.lock_bytes += alloc_bytes;
             current.lock_buffers++;
+            profileMemory("alloc", alloc_bytes, current.lock_bytes,
+                          current.total_bytes);
         }
     }
 
@@ -268,6 +287,8 @@ void DefaultMemoryManager::unlock(void *ptr, bool user_unlock) {
             current.free_map[bytes].emplace_back(ptr);
         }
         current.locked_map.erase(locked_buffer_iter);
+        profileMemory(this->debug_mode ? "free" : "release", bytes,
+                      current.lock_bytes, current.total_bytes);
     }
 }
 
@@ -0,0 +1,296 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/Profiler.hpp>
+
+#include <common/util.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using std::lock_guard;
+using std::make_shared;
+using std::move;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace common {
+namespace profiler {
+
+namespace detail {
+std::atomic<bool> recording{false};
+}  // namespace detail
+
+namespace {
+
+#if defined(AF_CPU)
+constexpr const char *process_name = "ArrayFire CPU";
+constexpr const char *backend_name = "cpu";
+#elif defined(AF_CUDA)
+constexpr const char *process_name = "ArrayFire CUDA";
+constexpr const char *backend_name = "cuda";
+#elif defined(AF_OPENCL)
+constexpr const char *process_name = "ArrayFire OpenCL";
+constexpr const char *backend_name = "opencl";
+#else
+constexpr const char *process_name = "ArrayFire";
+constexpr const char *backend_name = "af";
+#endif
+
+struct event {
+    char phase;
+    const char *category;
+    const char *name;
+    int64_t begin;
+    int64_t duration;
+    string args;
+};
+
+/// Events of one thread. The owning thread appends under the mutex, which is
+/// only contended while the events are written.
+struct thread_buffer {
+    mutex lock;
+    vector<event> events;
+    int tid;
+};
+
+/// Events a thread buffers before writing them to the file, which bounds the
+/// memory used by long recordings
+constexpr size_t flush_events = 1 << 14;
+
+/// The file named by AF_TRACE_FILE for this backend: the backend name is
+/// added before the extension, so the backends loaded by the unified
+/// library each write their own file, e.g. trace.json becomes
+/// trace.cpu.json.
+string backendTraceFile(const string &file) {
+    size_t dot   = file.find_last_of('.');
+    size_t slash = file.find_last_of("/\\");
+    if (dot == string::npos || (slash != string::npos && dot < slash)) {
+        dot = file.size();
+    }
+    return file.substr(0, dot) + "." + backend_name + file.substr(dot);
+}
+
+class recorder {
+   public:
+    recorder() {
+        string file = getEnvVar("AF_TRACE_FILE");
+        if (!file.empty()) { start(backendTraceFile(file)); }
+    }
+
+    void start(const string &file) {
+        lock_guard<mutex> lock(mutex_);
+        for (auto &buffer : buffers_) {
+            lock_guard<mutex> buffer_lock(buffer->lock);
+            buffer->events.clear();
+        }
+        // The events of an earlier recording that was not stopped are
+        // discarded, including those already written
+        if (out_) {
+            std::fclose(out_);
+            out_ = nullptr;
+            std::remove(file_.c_str());
+        }
+        file_  = file;
+        epoch_ = now();
+        detail::recording.store(true);
+    }
+
+    void stop() {
+        if (!detail::recording.exchange(false)) { return; }
+        lock_guard<mutex> lock(mutex_);
+        for (auto &buffer : buffers_) { write(*buffer); }
+        if (out_) {
+            fprintf(out_, "\n]}\n");
+            std::fclose(out_);
+            out_ = nullptr;
+        }
+    }
+
+    /// Writes the events of \p buffer once it holds flush_events of them
+    void flushIfFull(thread_buffer &buffer) {
+        {
+            lock_guard<mutex> buffer_lock(buffer.lock);
+            if (buffer.events.size() < flush_events) { return; }
+        }
+        lock_guard<mutex> lock(mutex_);
+        if (detail::recording) { write(buffer); }
+    }
+
+    thread_buffer &buffer() {
+        thread_local shared_ptr<thread_buffer> local;
+        if (!local) {
+            local = make_shared<thread_buffer>();
+            lock_guard<mutex> lock(mutex_);
+            local->tid = static_cast<int>(buffers_.size()) + 1;
+            buffers_.push_back(local);
+        }
+        return *local;
+    }
+
+   private:
+    /// Appends the events of \p buffer to the file and clears them. The file
+    /// is created by the first events written, so the backends loaded by
+    /// the unified library that did no work do not write one. Called with
+    /// mutex_ held.
+    void write(thread_buffer &buffer) {
+        lock_guard<mutex> buffer_lock(buffer.lock);
+        if (buffer.events.empty()) { return; }
+        if (!out_ && !open()) {
+            buffer.events.clear();
+            return;
+        }
+        for (const event &e : buffer.events) {
+            // Timestamps are in microseconds
+            fprintf(out_, ",\n{\"ph\":\"%c\",\"pid\":1,\"tid\":%d,", e.phase,
+                    buffer.tid);
+            if (e.category) { fprintf(out_, "\"cat\":\"%s\",", e.category); }
+            fprintf(out_, "\"name\":\"%s\",\"ts\":%.3f", e.name,
+                    (e.begin - epoch_) * 1e-3);
+            if (e.phase == 'X') {
+                fprintf(out_, ",\"dur\":%.3f", e.duration * 1e-3);
+            }
+            if (e.phase == 'i') { fprintf(out_, ",\"s\":\"t\""); }
+            fprintf(out_, ",\"args\":{%s}}", e.args.c_str());
+        }
+        buffer.events.clear();
+    }
+
+    bool open() {
+        out_ = std::fopen(file_.c_str(), "w");
+        if (!out_) {
+            fprintf(stderr, "ArrayFire: could not write the trace to %s\n",
+                    file_.c_str());
+            return false;
+        }
+        fprintf(out_, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        fprintf(out_,
+                "{\"ph\":\"M\",\"pid\":1,\"tid\":0,\"name\":\"process_name\","
+                "\"args\":{\"name\":\"%s\"}}",
+                process_name);
+        return true;
+    }
+
+    mutex mutex_;
+    vector<shared_ptr<thread_buffer>> buffers_;
+    string file_;
+    FILE *out_     = nullptr;
+    int64_t epoch_ = 0;
+};
+
+/// Never destroyed, so threads still running while the library unloads can
+/// record safely
+recorder &getRecorder() {
+    static recorder *rec = new recorder();
+    return *rec;
+}
+
+/// Writes the trace started with AF_TRACE_FILE when the library unloads
+struct env_recording {
+    env_recording() { getRecorder(); }
+    ~env_recording() { getRecorder().stop(); }
+} start_from_env;
+
+void record(event &&e) noexcept {
+    try {
+        recorder &rec         = getRecorder();
+        thread_buffer &buffer = rec.buffer();
+        {
+            lock_guard<mutex> lock(buffer.lock);
+            buffer.events.push_back(move(e));
+        }
+        rec.flushIfFull(buffer);
+    } catch (...) {
+        // Losing an event is better than failing the traced call
+    }
+}
+
+thread_local const char *current_api = nullptr;
+thread_local const char *eval_reason = nullptr;
+
+}  // namespace
+
+void start(const string &filename) { getRecorder().start(filename); }
+
+void stop() { getRecorder().stop(); }
+
+int64_t now() noexcept {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void complete(const char *category, const char *name, int64_t begin,
+              int64_t end, string args) noexcept {
+    if (!enabled()) { return; }
+    record({'X', category, name, begin, end - begin, move(args)});
+}
+
+void instant(const char *category, const char *name, string args) noexcept {
+    if (!enabled()) { return; }
+    record({'i', category, name, now(), 0, move(args)});
+}
+
+void counter(const char *name, string args) noexcept {
+    if (!enabled()) { return; }
+    record({'C', nullptr, name, now(), 0, move(args)});
+}
+
+Scope::Scope(const char *category, const char *name) noexcept
+    : category_(category), name_(name), begin_(enabled() ? now() : -1) {}
+
+Scope::~Scope() {
+    if (active()) { complete(category_, name_, begin_, now(), move(args_)); }
+}
+
+void Scope::setArgs(string args) noexcept { args_ = move(args); }
+
+ApiScope::ApiScope(const char *name) noexcept
+    : scope_("api", name), outer_(current_api) {
+    if (scope_.active()) { current_api = name; }
+}
+
+ApiScope::~ApiScope() { current_api = outer_; }
+
+const char *currentApi() noexcept { return current_api; }
+
+EvalReason::EvalReason(const char *reason) noexcept : outer_(eval_reason) {
+    eval_reason = reason;
+}
+
+EvalReason::~EvalReason() { eval_reason = outer_; }
+
+const char *evalReason() noexcept {
+    return eval_reason ? eval_reason : "explicit";
+}
+
+string jitEvalArgs(size_t nodes, size_t outputs, const af::dim4 &dims) {
+    return "\"nodes\":" + std::to_string(nodes) +
+           ",\"outputs\":" + std::to_string(outputs) +
+           ",\"dims\":" + dimsToJson(dims) + ",\"reason\":\"" +
+           evalReason() + "\"";
+}
+
+string dimsToJson(const af::dim4 &dims) {
+    string out = "[";
+    for (int i = 0; i < 4; i++) {
+        if (i) { out += ","; }
+        out += std::to_string(dims[i]);
+    }
+    return out + "]";
+}
+
+}  // namespace profiler
+}  // namespace common
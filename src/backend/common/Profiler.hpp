@@ -0,0 +1,136 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <af/dim4.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace common {
+namespace profiler {
+
+namespace detail {
+extern std::atomic<bool> recording;
+}  // namespace detail
+
+/// True while events are recorded. This is the only work done by the
+/// profiling hooks when the profiler is off.
+inline bool enabled() noexcept {
+    return detail::recording.load(std::memory_order_relaxed);
+}
+
+/// Starts recording events, discarding those of an earlier recording.
+/// stop() writes them to \p filename as Chrome trace JSON, which loads in
+/// Perfetto and chrome://tracing.
+///
+/// Setting AF_TRACE_FILE starts a recording when the library loads that is
+/// written when it unloads, if anything was recorded. Each backend writes
+/// its own file, named after AF_TRACE_FILE with the backend name added
+/// before the extension. Events are written in chunks while recording, so
+/// long recordings do not grow the memory used.
+void start(const std::string &filename);
+
+/// Stops recording and writes the trace. Does nothing when not recording.
+void stop();
+
+/// Nanoseconds since an arbitrary fixed point
+int64_t now() noexcept;
+
+/// Records a complete ("X") event that ran on the calling thread from
+/// \p begin to \p end. \p args is the body of a JSON object, e.g.
+/// `"bytes":1024`, or empty.
+///
+/// \p category and \p name must outlive the recording; string literals and
+/// __func__ do.
+void complete(const char *category, const char *name, int64_t begin,
+              int64_t end, std::string args = std::string()) noexcept;
+
+/// Records an instant ("i") event on the calling thread
+void instant(const char *category, const char *name,
+             std::string args = std::string()) noexcept;
+
+/// Records a counter ("C") event. Perfetto plots each key of \p args as a
+/// track named \p name.
+void counter(const char *name, std::string args) noexcept;
+
+/// Records a complete event covering its lifetime. The event is dropped if
+/// the profiler was off when the scope was opened.
+class Scope {
+   public:
+    Scope(const char *category, const char *name) noexcept;
+    ~Scope();
+
+    Scope(const Scope &)            = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    /// True when the scope is recorded; use it to skip computing arguments
+    bool active() const noexcept { return begin_ >= 0; }
+
+    /// Sets the arguments of the event, see complete()
+    void setArgs(std::string args) noexcept;
+
+   private:
+    const char *category_;
+    const char *name_;
+    int64_t begin_;
+    std::string args_;
+};
+
+/// Scope of a C API function. Work queued by the backends inside it is
+/// labelled with its name.
+class ApiScope {
+   public:
+    explicit ApiScope(const char *name) noexcept;
+    ~ApiScope();
+
+    ApiScope(const ApiScope &)            = delete;
+    ApiScope &operator=(const ApiScope &) = delete;
+
+   private:
+    Scope scope_;
+    const char *outer_;
+};
+
+/// Name of the innermost ApiScope recorded on the calling thread, or nullptr
+/// outside of one
+const char *currentApi() noexcept;
+
+/// Tags the JIT evaluations started on the calling thread during its
+/// lifetime with \p reason. Evaluations outside of one are "explicit".
+class EvalReason {
+   public:
+    explicit EvalReason(const char *reason) noexcept;
+    ~EvalReason();
+
+    EvalReason(const EvalReason &)            = delete;
+    EvalReason &operator=(const EvalReason &) = delete;
+
+   private:
+    const char *outer_;
+};
+
+/// Reason recorded for JIT evaluations started on the calling thread
+const char *evalReason() noexcept;
+
+/// Arguments of a JIT evaluation event: the number of nodes in the trees and
+/// of outputs, the output dimensions and the reason set with EvalReason
+std::string jitEvalArgs(size_t nodes, size_t outputs, const af::dim4 &dims);
+
+/// Formats \p dims as a JSON array
+std::string dimsToJson(const af::dim4 &dims);
+
+}  // namespace profiler
+}  // namespace common
+
+/// Traces the enclosing C API function
+#define AF_PROFILE_API() \
+    common::profiler::ApiScope af_profile_api_scope_(__func__)
@@ -49,6 +49,12 @@ using uint16_t = unsigned short;
 #include <limits>
 #endif
 
+// Round ties to even on the host, like IEEE 754, the CUDA intrinsics and the
+// F16C instructions used by the CPU backend
+#ifndef HALF_ROUND_TIES_TO_EVEN
+#define HALF_ROUND_TIES_TO_EVEN 1
+#endif
+
 namespace common {
 
 #if defined(__CUDA_ARCH__)
@@ -277,6 +283,9 @@ __DH__ native_half_t float2half_impl(float value) noexcept {
     uint16_t hbits =
         base_table[bits >> 23] +
         static_cast<uint16_t>((bits & 0x7FFFFF) >> shift_table[bits >> 23]);
+    // NaNs are returned quiet, so a payload confined to the low mantissa bits
+    // does not turn into infinity
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) { return hbits | 0x0200; }
     if (R == std::round_to_nearest)
         hbits +=
             (((bits & 0x7FFFFF) >> (shift_table[bits >> 23] - 1)) |
@@ -284,8 +293,9 @@ __DH__ native_half_t float2half_impl(float value) noexcept {
             ((hbits & 0x7C00) != 0x7C00)
 #if HALF_ROUND_TIES_TO_EVEN
             &
-            (((((static_cast<uint32>(1) << (shift_table[bits >> 23] - 1)) - 1) &
-               bits) != 0) |
+            (((((static_cast<uint32_t>(1) << (shift_table[bits >> 23] - 1)) -
+                 1) &
+                bits) != 0) |
              hbits)
 #endif
             ;
@@ -11,6 +11,7 @@
 
 #include <Array.hpp>
 #include <backend.hpp>
+#include <common/Profiler.hpp>
 #include <common/defines.hpp>
 #include <common/jit/Node.hpp>
 
@@ -111,7 +112,8 @@ common::Node_ptr createNaryNode(
 
     common::Node_ptr ptr = createNode(childNodes);
 
-    switch (detail::passesJitHeuristics<Ti>(nodes)) {
+    const kJITHeuristics heuristic = detail::passesJitHeuristics<Ti>(nodes);
+    switch (heuristic) {
         case kJITHeuristics::Pass: {
             return ptr;
         }
@@ -125,10 +127,14 @@ common::Node_ptr createNaryNode(
                     max_height       = childNodes[i]->getHeight();
                 }
             }
-            children[max_height_index]->eval();
+            {
+                profiler::EvalReason reason(getHeuristicName(heuristic));
+                children[max_height_index]->eval();
+            }
             return createNaryNode<Ti, N>(odims, createNode, move(children));
         }
         case kJITHeuristics::MemoryPressure: {
+            profiler::EvalReason reason(getHeuristicName(heuristic));
             for (auto &c : children) { c->eval(); }  // TODO: use evalMultiple()
             return ptr;
         }
@@ -40,6 +40,7 @@ int Node::getNodesMap(Node_map_t &node_map, vector<Node *> &full_nodes,
 }
 
 std::string getFuncName(const vector<Node *> &output_nodes,
+                        const vector<int> &output_ids,
                         const vector<Node *> &full_nodes,
                         const vector<Node_ids> &full_ids, const bool is_linear,
                         const bool loop0, const bool loop1, const bool loop2,
@@ -57,6 +58,13 @@ std::string getFuncName(const vector<Node *> &output_nodes,
         funcName += node->getNameStr();
     }
 
+    // The optimizer may point several outputs at the same node, or an output
+    // at a leaf, so the ids written are part of the kernel
+    for (int id : output_ids) {
+        funcName += 'O';
+        funcName += std::to_string(id);
+    }
+
     for (int i = 0; i < static_cast<int>(full_nodes.size()); i++) {
         full_nodes[i]->genKerName(funcName, full_ids[i]);
     }
@@ -31,6 +31,15 @@ enum class kJITHeuristics {
     MemoryPressure      = 3  /* eval due to memory pressure */
 };
 
+/// Name of \p heuristic as recorded by the profiler
+constexpr const char *getHeuristicName(kJITHeuristics heuristic) noexcept {
+    return heuristic == kJITHeuristics::TreeHeight ? "tree height"
+           : heuristic == kJITHeuristics::KernelParameterSize
+               ? "kernel parameter size"
+           : heuristic == kJITHeuristics::MemoryPressure ? "memory pressure"
+                                                         : "pass";
+}
+
 namespace common {
 class Node;
 }
@@ -248,6 +257,13 @@ class Node {
     // Returns true if this node is a Scalar
     virtual bool isScalar() const { return false; }
 
+    /// Copies the value of a scalar node to \p val unless it is null and
+    /// returns its size in bytes. Returns 0 for every other node.
+    virtual size_t getScalarValue(void *val) const {
+        UNUSED(val);
+        return 0;
+    }
+
     /// Returns true if the buffer is linear
     virtual bool isLinear(const dim_t dims[4]) const;
 
@@ -303,6 +319,7 @@ struct Node_ids {
 };
 
 std::string getFuncName(const std::vector<Node *> &output_nodes,
+                        const std::vector<int> &output_ids,
                         const std::vector<Node *> &full_nodes,
                         const std::vector<Node_ids> &full_ids,
                         const bool is_linear, const bool loop0,
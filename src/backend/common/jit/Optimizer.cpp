@@ -0,0 +1,411 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/jit/Optimizer.hpp>
+
+#include <binary.hpp>
+#include <common/Logger.hpp>
+#include <common/Profiler.hpp>
+#include <common/cast.hpp>
+#include <common/jit/ModdimNode.hpp>
+#include <common/traits.hpp>
+#include <common/util.hpp>
+#include <types.hpp>
+
+#ifdef AF_CPU
+#include <jit/BinaryNode.hpp>
+#include <jit/ScalarNode.hpp>
+#else
+#include <common/jit/BinaryNode.hpp>
+#include <common/jit/ScalarNode.hpp>
+#endif
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+using af::dim4;
+using af::dtype;
+using detail::intl;
+using detail::uchar;
+using detail::uint;
+using detail::uintl;
+using detail::ushort;
+using std::make_shared;
+using std::memcmp;
+using std::shared_ptr;
+using std::unordered_map;
+using std::vector;
+
+namespace common {
+
+namespace {
+
+bool optimizerEnabled() {
+    static const bool enabled = getEnvVar("AF_JIT_OPTIMIZE") != "0";
+    return enabled;
+}
+
+/// Largest scalar value, cdouble
+constexpr size_t kMaxScalarBytes = 16;
+
+/// Operation, type and operands of a node. Two nodes with equal keys compute
+/// the same values.
+struct NodeKey {
+    af_op_t op;
+    dtype type;
+    int nchildren;
+    std::array<int, Node::kMaxChildren> children;
+    dim4 shape;
+    size_t nbytes;
+    std::array<char, kMaxScalarBytes> bytes;
+
+    bool operator==(const NodeKey &o) const noexcept {
+        return op == o.op && type == o.type && nchildren == o.nchildren &&
+               children == o.children && shape == o.shape &&
+               nbytes == o.nbytes &&
+               memcmp(bytes.data(), o.bytes.data(), nbytes) == 0;
+    }
+};
+
+struct NodeKeyHash {
+    size_t operator()(const NodeKey &k) const noexcept {
+        size_t h = std::hash<int>()(k.op) * 31 + std::hash<int>()(k.type);
+        for (int i = 0; i < k.nchildren; i++) {
+            h = h * 31 + std::hash<int>()(k.children[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+            h = h * 31 + std::hash<dim_t>()(k.shape[i]);
+        }
+        for (size_t i = 0; i < k.nbytes; i++) { h = h * 31 + k.bytes[i]; }
+        return h;
+    }
+};
+
+int numChildren(const Node &node) {
+    int n = 0;
+    while (n < Node::kMaxChildren && node.m_children[n] != nullptr) { n++; }
+    return n;
+}
+
+/// Returns true when \p node has a key. Buffers and other leaves are already
+/// deduplicated by getNodesMap and are left alone.
+bool makeKey(const Node &node, const Node_ids &ids, NodeKey &key) {
+    key        = NodeKey{};
+    key.op     = node.getOp();
+    key.type   = node.getType();
+    key.nbytes = node.getScalarValue(key.bytes.data());
+    if (key.op == af_none_t && key.nbytes == 0) { return false; }
+
+    key.nchildren = numChildren(node);
+    for (int i = 0; i < key.nchildren; i++) {
+        key.children[i] = ids.child_ids[i];
+    }
+    if (key.op == af_moddims_t) {
+        key.shape = static_cast<const ModdimNode &>(node).m_new_shape;
+    }
+    return true;
+}
+
+template<typename T>
+bool scalarEquals(const Node &node, T val) {
+    std::array<char, kMaxScalarBytes> bytes{};
+    if (node.getScalarValue(bytes.data()) != sizeof(T)) { return false; }
+    return memcmp(bytes.data(), &val, sizeof(T)) == 0;
+}
+
+/// True if \p node is a scalar of type \p type holding \p val. Half and
+/// complex values are never matched.
+bool isScalarValue(const Node &node, dtype type, int val) {
+    if (node.getType() != type) { return false; }
+    switch (type) {
+        case f32: return scalarEquals(node, static_cast<float>(val));
+        case f64: return scalarEquals(node, static_cast<double>(val));
+        case s32: return scalarEquals(node, static_cast<int>(val));
+        case u32: return scalarEquals(node, static_cast<uint>(val));
+        case s64: return scalarEquals(node, static_cast<intl>(val));
+        case u64: return scalarEquals(node, static_cast<uintl>(val));
+        case s16: return scalarEquals(node, static_cast<short>(val));
+        case u16: return scalarEquals(node, static_cast<ushort>(val));
+        case u8: return scalarEquals(node, static_cast<uchar>(val));
+        default: return false;
+    }
+}
+
+#ifdef AF_CPU
+template<typename T>
+Node_ptr createScalar(T val) {
+    return make_shared<cpu::jit::ScalarNode<T>>(val);
+}
+
+template<typename T>
+Node_ptr createMul(const Node_ptr &lhs, const Node_ptr &rhs) {
+    return make_shared<cpu::jit::BinaryNode<T, T, af_mul_t>>(lhs, rhs);
+}
+#else
+template<typename T>
+Node_ptr createScalar(T val) {
+    return make_shared<ScalarNode<T>>(val);
+}
+
+template<typename T>
+Node_ptr createMul(const Node_ptr &lhs, const Node_ptr &rhs) {
+    detail::BinOp<T, T, af_mul_t> bop;
+    return make_shared<BinaryNode>(
+        static_cast<dtype>(af::dtype_traits<T>::af_type), bop.name(), lhs,
+        rhs, af_mul_t);
+}
+#endif
+
+template<typename T>
+Node_ptr foldScalars(af_op_t op, const Node &lhs, const Node &rhs) {
+    T a, b;
+    lhs.getScalarValue(&a);
+    rhs.getScalarValue(&b);
+    switch (op) {
+        case af_add_t: return createScalar<T>(a + b);
+        case af_sub_t: return createScalar<T>(a - b);
+        case af_mul_t: return createScalar<T>(a * b);
+        case af_div_t: return createScalar<T>(a / b);
+        default: return nullptr;
+    }
+}
+
+/// The graph being rewritten. Nodes are referred to by their new ids.
+struct Rewriter {
+    vector<Node *> nodes;
+    vector<Node_ids> ids;
+    unordered_map<NodeKey, int, NodeKeyHash> seen;
+    vector<Node_ptr> &created;
+    size_t merged = 0, folded = 0, identities = 0, casts = 0, powers = 0;
+
+    explicit Rewriter(vector<Node_ptr> &created_) : created(created_) {}
+
+    static spdlog::logger *getLogger() noexcept {
+        static shared_ptr<spdlog::logger> logger(loggerFactory("jit"));
+        return logger.get();
+    }
+
+    void report(size_t before) const {
+        if (nodes.size() != before) {
+            AF_TRACE(
+                "Optimized JIT tree from {} to {} nodes: merged {}, folded "
+                "{}, identities {}, casts {}, powers {}",
+                before, nodes.size(), merged, folded, identities, casts,
+                powers);
+        }
+        UNUSED(before);
+
+        if (profiler::enabled()) {
+            profiler::instant(
+                "jit", "optimizeNodes",
+                "\"before\":" + std::to_string(before) +
+                    ",\"after\":" + std::to_string(nodes.size()) +
+                    ",\"merged\":" + std::to_string(merged) +
+                    ",\"folded\":" + std::to_string(folded) +
+                    ",\"identities\":" + std::to_string(identities) +
+                    ",\"casts\":" + std::to_string(casts) +
+                    ",\"powers\":" + std::to_string(powers));
+        }
+
+        JitOptimizerCounters &counters = jitOptimizerCounters();
+        counters.merged += merged;
+        counters.folded += folded;
+        counters.identities += identities;
+        counters.casts += casts;
+        counters.powers += powers;
+    }
+
+    /// Adds \p node with children \p children, or returns the id of an equal
+    /// node added before
+    int add(Node *node, const Node_ids &children) {
+        Node_ids nid = children;
+        nid.id       = static_cast<int>(nodes.size());
+        NodeKey key;
+        if (makeKey(*node, nid, key)) {
+            auto it = seen.find(key);
+            if (it != seen.end()) {
+                merged++;
+                return it->second;
+            }
+            seen.emplace(key, nid.id);
+        }
+        nodes.push_back(node);
+        ids.push_back(nid);
+        return nid.id;
+    }
+
+    /// Returns the id \p node simplifies to, or -1 if no rule applies
+    int simplify(Node *node, const Node_ids &c) {
+        const af_op_t op  = node->getOp();
+        const dtype type  = node->getType();
+        const int nchild  = numChildren(*node);
+        const bool sameTy = nchild > 0 && nodes[c.child_ids[0]]->getType() ==
+                                              type;
+
+        if (nchild == 1) {
+            Node *child = nodes[c.child_ids[0]];
+            // Involutions
+            if ((op == af_conj_t || op == af_bitnot_t) &&
+                child->getOp() == op && sameTy) {
+                identities++;
+                return ids[c.child_ids[0]].child_ids[0];
+            }
+            // cast<outer>(cast<inner>(x)) with x of type outer
+            if (op == af_cast_t && child->getOp() == af_cast_t) {
+                const int grand = ids[c.child_ids[0]].child_ids[0];
+                if (nodes[grand]->getType() == type &&
+                    canOptimizeCast(type, child->getType())) {
+                    casts++;
+                    return grand;
+                }
+            }
+            return -1;
+        }
+        if (nchild != 2 || !sameTy) { return -1; }
+
+        const int l = c.child_ids[0], r = c.child_ids[1];
+        Node *lhs = nodes[l], *rhs = nodes[r];
+        if (rhs->getType() != type) { return -1; }
+        const bool integral = isInteger(type);
+
+        switch (op) {
+            case af_mul_t:
+                if (isScalarValue(*rhs, type, 1)) { return identity(l); }
+                if (isScalarValue(*lhs, type, 1)) { return identity(r); }
+                break;
+            case af_div_t:
+                if (isScalarValue(*rhs, type, 1)) { return identity(l); }
+                break;
+            case af_add_t:
+                // -0 + 0 is +0, so floating point x + 0 is kept
+                if (integral && isScalarValue(*rhs, type, 0)) {
+                    return identity(l);
+                }
+                if (integral && isScalarValue(*lhs, type, 0)) {
+                    return identity(r);
+                }
+                break;
+            case af_sub_t:
+                if (isScalarValue(*rhs, type, 0)) { return identity(l); }
+                // Negation is 0 - x; 0 - (0 - x) only gives back x exactly
+                // for integers because of signed zeros
+                if (integral && isScalarValue(*lhs, type, 0) &&
+                    rhs->getOp() == af_sub_t &&
+                    isScalarValue(*nodes[ids[r].child_ids[0]], type, 0)) {
+                    return identity(ids[r].child_ids[1]);
+                }
+                break;
+            default: break;
+        }
+
+        if (op >= af_add_t && op <= af_div_t && lhs->getScalarValue(nullptr) &&
+            rhs->getScalarValue(nullptr)) {
+            Node_ptr out;
+            switch (type) {
+                case f32: out = foldScalars<float>(op, *lhs, *rhs); break;
+                case f64: out = foldScalars<double>(op, *lhs, *rhs); break;
+                default: break;
+            }
+            if (out) {
+                folded++;
+                created.push_back(out);
+                return add(out.get(), Node_ids{});
+            }
+        }
+
+        if (op == af_pow_t && (type == f32 || type == f64) &&
+            isScalarValue(*rhs, type, 2)) {
+            const Node_ptr &base = node->m_children[0];
+            Node_ptr out =
+                type == f32 ? createMul<float>(base, base)
+                            : createMul<double>(base, base);
+            powers++;
+            created.push_back(out);
+            Node_ids mid{};
+            mid.child_ids[0] = l;
+            mid.child_ids[1] = l;
+            return add(out.get(), mid);
+        }
+        return -1;
+    }
+
+    int identity(int id) {
+        identities++;
+        return id;
+    }
+
+    /// Drops the nodes that no output depends on and renumbers the rest
+    void compact(vector<int> &output_ids) {
+        vector<int> remap(nodes.size(), -1);
+        for (int id : output_ids) { remap[id] = 0; }
+        for (int i = static_cast<int>(nodes.size()) - 1; i >= 0; i--) {
+            if (remap[i] < 0) { continue; }
+            const int n = numChildren(*nodes[i]);
+            for (int k = 0; k < n; k++) { remap[ids[i].child_ids[k]] = 0; }
+        }
+        int next = 0;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (remap[i] < 0) { continue; }
+            remap[i]    = next;
+            Node_ids id = ids[i];
+            const int n = numChildren(*nodes[i]);
+            for (int k = 0; k < n; k++) {
+                id.child_ids[k] = remap[id.child_ids[k]];
+            }
+            id.id       = next;
+            nodes[next] = nodes[i];
+            ids[next]   = id;
+            next++;
+        }
+        nodes.resize(next);
+        ids.resize(next);
+        for (int &id : output_ids) { id = remap[id]; }
+    }
+};
+
+}  // namespace
+
+JitOptimizerCounters &jitOptimizerCounters() {
+    static JitOptimizerCounters counters;
+    return counters;
+}
+
+void optimizeNodes(vector<Node *> &full_nodes, vector<Node_ids> &full_ids,
+                   vector<int> &output_ids, vector<Node_ptr> &created) {
+    if (!optimizerEnabled()) { return; }
+
+    Rewriter rw(created);
+    rw.nodes.reserve(full_nodes.size());
+    rw.ids.reserve(full_ids.size());
+
+    // full_nodes is ordered children first, so every child id is remapped
+    // before its parents are visited
+    vector<int> remap(full_nodes.size());
+    for (size_t i = 0; i < full_nodes.size(); i++) {
+        Node *node = full_nodes[i];
+        Node_ids c = full_ids[i];
+        const int n = numChildren(*node);
+        for (int k = 0; k < n; k++) { c.child_ids[k] = remap[c.child_ids[k]]; }
+
+        int id = rw.simplify(node, c);
+        if (id < 0) { id = rw.add(node, c); }
+        remap[i] = id;
+    }
+    for (int &id : output_ids) { id = remap[id]; }
+    rw.compact(output_ids);
+
+    rw.report(full_nodes.size());
+
+    full_nodes.swap(rw.nodes);
+    full_ids.swap(rw.ids);
+}
+
+}  // namespace common
@@ -0,0 +1,55 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <common/jit/Node.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace common {
+
+/// Number of rewrites made by each pass of optimizeNodes since startup
+struct JitOptimizerCounters {
+    /// Structurally identical nodes merged into one
+    std::atomic<size_t> merged{0};
+    /// Arithmetic between two scalars replaced by its result
+    std::atomic<size_t> folded{0};
+    /// Nodes replaced by an operand: x*1, x/1, x-0, integer x+0 and
+    /// involutions such as conj(conj(x))
+    std::atomic<size_t> identities{0};
+    /// Round trips through a wider type removed from cast chains
+    std::atomic<size_t> casts{0};
+    /// pow(x, 2) rewritten to x*x
+    std::atomic<size_t> powers{0};
+};
+
+/// Returns the counters updated by optimizeNodes
+JitOptimizerCounters &jitOptimizerCounters();
+
+/// Simplifies a JIT tree flattened by Node::getNodesMap before it is
+/// evaluated.
+///
+/// Rewrites \p full_nodes and \p full_ids in place. Nodes are visited
+/// children first, so a node is first simplified with the rules below and
+/// then merged with an earlier node that has the same operation, type and
+/// (already merged) children. Nodes that are no longer referenced are
+/// dropped and the ids are renumbered; \p output_ids is updated to match.
+///
+/// The rules only fire when the result is unchanged bit for bit, except for
+/// pow(x, 2) whose replacement x*x is correctly rounded. Nodes created by the
+/// pass are appended to \p created, which must outlive \p full_nodes. The
+/// original nodes are never modified, so the pass is safe to run on trees
+/// shared with other arrays. Setting AF_JIT_OPTIMIZE=0 disables it.
+void optimizeNodes(std::vector<Node *> &full_nodes,
+                   std::vector<Node_ids> &full_ids,
+                   std::vector<int> &output_ids,
+                   std::vector<Node_ptr> &created);
+
+}  // namespace common
@@ -14,6 +14,7 @@
 
 #include <math.hpp>
 #include <types.hpp>
+#include <cstring>
 #include <iomanip>
 
 namespace common {
@@ -84,8 +85,13 @@ class ScalarNode : public common::Node {
                   << ";\n";
     }
 
-    // Returns true if this node is a Buffer
-    virtual bool isScalar() const { return false; }
+    // Returns true if this node is a Scalar
+    bool isScalar() const final { return true; }
+
+    size_t getScalarValue(void* val) const final {
+        if (val) { std::memcpy(val, &m_val, sizeof(T)); }
+        return sizeof(T);
+    }
 
     std::string getNameStr() const final { return detail::shortname<T>(false); }
 
@@ -87,6 +87,7 @@ const char* getName(af_dtype type) {
         case s64: return "long long";
         case u8: return "unsigned char";
         case b8: return "bool";
+        case f16: return "half";
         default: return "unknown type";
     }
 }
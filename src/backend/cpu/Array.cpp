@@ -12,6 +12,7 @@
 
 #include <Param.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/Profiler.hpp>
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <common/jit/NodeIterator.hpp>
@@ -20,6 +21,7 @@
 #include <jit/BufferNode.hpp>
 #include <jit/Node.hpp>
 #include <jit/ScalarNode.hpp>
+#include <jit/ViewNode.hpp>
 #include <memory.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
@@ -34,6 +36,7 @@
 #include <algorithm>  // IWYU pragma: keep
 #include <cstddef>
 #include <cstring>
+#include <string>
 #include <type_traits>
 #include <utility>
 
@@ -44,12 +47,14 @@ using common::Node_map_t;
 using common::Node_ptr;
 using common::NodeIterator;
 using cpu::jit::BufferNode;
+using cpu::jit::ViewNode;
 
 using nonstd::span;
 using std::adjacent_find;
 using std::copy;
 using std::is_standard_layout;
 using std::make_shared;
+using std::shared_ptr;
 using std::move;
 using std::vector;
 
@@ -60,6 +65,19 @@ shared_ptr<BufferNode<T>> bufferNodePtr() {
     return std::make_shared<BufferNode<T>>();
 }
 
+namespace {
+/// Number of distinct nodes in the trees rooted at \p nodes
+size_t treeSize(const vector<Node_ptr> &nodes) {
+    Node_map_t node_map;
+    vector<Node *> full_nodes;
+    vector<common::Node_ids> ids;
+    for (const auto &node : nodes) {
+        node->getNodesMap(node_map, full_nodes, ids);
+    }
+    return full_nodes.size();
+}
+}  // namespace
+
 template<typename T>
 Array<T>::Array(dim4 dims)
     : info(getActiveDeviceId(), dims, 0, calcStrides(dims),
@@ -148,9 +166,22 @@ T *Array<T>::device() {
         *this = copyArray<T>(*this);
     }
     getQueue().sync();
+    syncBufferStreams(data.get());
     return this->get();
 }
 
+/// Queued task evaluating the JIT trees \p nodes into \p outputs. The jit
+/// event is recorded here so that it covers the evaluation rather than the
+/// queueing; its arguments \p args are built on the calling thread, which
+/// knows why the trees are evaluated.
+template<typename T>
+void evalTask(vector<Param<T>> outputs, vector<Node_ptr> nodes,
+              std::string args) {
+    common::profiler::Scope profile("jit", "evalMultiple");
+    if (profile.active()) { profile.setArgs(move(args)); }
+    kernel::evalMultiple<T>(move(outputs), move(nodes));
+}
+
 template<typename T>
 void evalMultiple(vector<Array<T> *> array_ptrs) {
     vector<Array<T> *> outputs;
@@ -187,7 +218,12 @@ void evalMultiple(vector<Array<T> *> array_ptrs) {
 
     if (params.empty()) return;
 
-    getQueue().enqueue(cpu::kernel::evalMultiple<T>, params, nodes);
+    std::string args;
+    if (common::profiler::enabled()) {
+        args = common::profiler::jitEvalArgs(treeSize(nodes), nodes.size(),
+                                             outputs[0]->dims());
+    }
+    getQueue().enqueue(evalTask<T>, params, nodes, move(args));
 
     for (Array<T> *array : outputs) { array->node.reset(); }
 }
@@ -196,6 +232,9 @@ template<typename T>
 Node_ptr Array<T>::getNode() {
     if (node) { return node; }
 
+    // The JIT kernel reading this buffer runs on the active queue
+    if (streamsInUse()) { waitForBufferStream(getQueue(), data.get()); }
+
     std::shared_ptr<BufferNode<T>> out = bufferNodePtr<T>();
     unsigned bytes = this->getDataDims().elements() * sizeof(T);
     out->setData(data, bytes, getOffset(), dims().get(), strides().get(),
@@ -263,9 +302,42 @@ Array<T> createNodeArray(const dim4 &dims, Node_ptr node) {
     return out;
 }
 
+template<typename T>
+shared_ptr<ViewNode<T>> createViewNode(const Array<T> &in) {
+    if (!in.isReady()) {
+        auto view = std::dynamic_pointer_cast<ViewNode<T>>(in.getNode());
+        if (view) { return view; }
+        in.eval();
+    }
+    auto buffer = std::static_pointer_cast<BufferNode<T>>(in.getNode());
+    return make_shared<ViewNode<T>>(buffer);
+}
+
 template<typename T>
 Array<T> createSubArray(const Array<T> &parent, const vector<af_seq> &index,
                         bool copy) {
+    if (copy && !parent.isReady()) {
+        // Index an unevaluated view by composing with it, e.g. flip(tile(a))
+        auto view = std::dynamic_pointer_cast<ViewNode<T>>(parent.getNode());
+        if (view) {
+            const dim4 &pDims = parent.dims();
+            dim4 dims         = toDims(index, pDims);
+            dim4 begin        = toOffset(index, pDims);
+            dim4 step         = toStride(index, dim4(1));
+            // A whole dimension read backwards, as flip does, is reversed
+            // in the view, which also works for shifted and tiled views
+            for (int i = 0; i < 4; i++) {
+                if (step[i] == -1 && begin[i] == pDims[i] - 1 &&
+                    dims[i] == pDims[i]) {
+                    view     = view->flip(i, pDims[i]);
+                    begin[i] = 0;
+                    step[i]  = 1;
+                }
+            }
+            auto sliced = view->slice(begin, step, dims);
+            if (sliced) { return createNodeArray<T>(dims, sliced); }
+        }
+    }
     parent.eval();
 
     dim4 dDims          = parent.getDataDims();
@@ -289,8 +361,10 @@ Array<T> createSubArray(const Array<T> &parent, const vector<af_seq> &index,
 
     if (!copy) { return out; }
 
+    // Read strided and reversed sub-arrays through a JIT view so they are
+    // only copied if they are evaluated on their own
     if (strides[0] != 1 || strides[1] < 0 || strides[2] < 0 || strides[3] < 0) {
-        out = copyArray(out);
+        out = createNodeArray<T>(dims, createViewNode(out));
     }
 
     return out;
@@ -308,6 +382,7 @@ void writeHostDataArray(Array<T> &arr, const T *const data,
     arr.eval();
     // Ensure the memory being written to isnt used anywhere else.
     getQueue().sync();
+    syncBufferStreams(arr.getData().get());
     memcpy(arr.get(), data, bytes);
 }
 
@@ -332,6 +407,7 @@ void Array<T>::setDataDims(const dim4 &new_dims) {
     template Array<T> createEmptyArray<T>(const dim4 &dims);                  \
     template Array<T> createSubArray<T>(                                      \
         const Array<T> &parent, const vector<af_seq> &index, bool copy);      \
+    template shared_ptr<ViewNode<T>> createViewNode<T>(const Array<T> &in);   \
     template void destroyArray<T>(Array<T> * A);                              \
     template Array<T> createNodeArray<T>(const dim4 &dims, Node_ptr node);    \
     template void Array<T>::eval();                                           \
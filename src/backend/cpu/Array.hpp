@@ -33,7 +33,9 @@ namespace cpu {
 namespace jit {
 template<typename T>
 class BufferNode;
-}
+template<typename T>
+class ViewNode;
+}  // namespace jit
 
 namespace kernel {
 template<typename T>
@@ -96,6 +98,12 @@ template<typename T>
 Array<T> createSubArray(const Array<T> &parent,
                         const std::vector<af_seq> &index, bool copy = true);
 
+/// Returns a JIT view reading \p in. An unevaluated view, such as the result
+/// of tile, reorder, transpose, shift or strided indexing, is returned as is
+/// so that the caller can compose with it; any other array is evaluated.
+template<typename T>
+std::shared_ptr<jit::ViewNode<T>> createViewNode(const Array<T> &in);
+
 // Creates a new Array object on the heap and returns a reference to it.
 template<typename T>
 void destroyArray(Array<T> *A);
@@ -114,6 +122,7 @@ void *getDevicePtr(const Array<T> &arr) {
 template<typename T>
 void *getRawPtr(const Array<T> &arr) {
     getQueue().sync();
+    syncBufferStreams(arr.getData().get());
     return (void *)(arr.get(false));
 }
 
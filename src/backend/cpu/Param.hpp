@@ -119,8 +119,8 @@ template<typename T>
 class Array;
 
 // These functions are needed to convert Array<T> to Param<T> when queueing up
-// functions. This is fine becacuse we only have 1 compute queue. This ensures
-// there's no race conditions.
+// functions. Arrays used on a queue other than the one that produced them are
+// ordered by queue::enqueue, which ensures there's no race conditions.
 
 /// \brief Converts Array<T> to Param<T> or CParam<T> based on the constness
 ///        of the Array<T> object. If called on anything else, the object is
@@ -7,28 +7,32 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
+#include <Array.hpp>
 #include <anisotropic_diffusion.hpp>
 #include <kernel/anisotropic_diffusion.hpp>
 #include <platform.hpp>
 
 namespace cpu {
 template<typename T>
-void anisotropicDiffusion(Array<T>& inout, const float dt, const float mct,
+void anisotropicDiffusion(Array<T>& inout, const float dt, const float K,
+                          const unsigned iterations,
                           const af::fluxFunction fftype,
                           const af::diffusionEq eq) {
+    Array<T> tmp = createEmptyArray<T>(inout.dims());
     if (eq == AF_DIFFUSION_MCDE) {
-        getQueue().enqueue(kernel::anisotropicDiffusion<T, true>, inout, dt,
-                           mct, fftype);
+        getQueue().enqueue(kernel::diffuseIterations<T, true>, inout, tmp, dt,
+                           K, iterations, fftype);
     } else {
-        getQueue().enqueue(kernel::anisotropicDiffusion<T, false>, inout, dt,
-                           mct, fftype);
+        getQueue().enqueue(kernel::diffuseIterations<T, false>, inout, tmp,
+                           dt, K, iterations, fftype);
     }
 }
 
-#define INSTANTIATE(T)                                     \
-    template void anisotropicDiffusion<T>(                 \
-        Array<T> & inout, const float dt, const float mct, \
-        const af::fluxFunction fftype, const af::diffusionEq eq);
+#define INSTANTIATE(T)                                            \
+    template void anisotropicDiffusion<T>(                        \
+        Array<T> & inout, const float dt, const float K,          \
+        const unsigned iterations, const af::fluxFunction fftype, \
+        const af::diffusionEq eq);
 
 INSTANTIATE(double)
 INSTANTIATE(float)
@@ -14,7 +14,8 @@ template<typename T>
 class Array;
 
 template<typename T>
-void anisotropicDiffusion(Array<T>& inout, const float dt, const float mct,
+void anisotropicDiffusion(Array<T>& inout, const float dt, const float K,
+                          const unsigned iterations,
                           const af::fluxFunction fftype,
                           const af::diffusionEq eq);
 }  // namespace cpu
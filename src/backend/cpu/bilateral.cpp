@@ -28,9 +28,20 @@ Array<outType> bilateral(const Array<inType> &in, const float &sSigma,
     return out;
 }
 
-#define INSTANTIATE(inT, outT)                                    \
-    template Array<outT> bilateral<inT, outT>(const Array<inT> &, \
-                                              const float &, const float &);
+template<typename inType, typename outType>
+Array<outType> bilateralGrid(const Array<inType> &in, const float &sSigma,
+                             const float &cSigma) {
+    Array<outType> out = createEmptyArray<outType>(in.dims());
+    getQueue().enqueue(kernel::bilateralGrid<outType, inType>, out, in, sSigma,
+                       cSigma);
+    return out;
+}
+
+#define INSTANTIATE(inT, outT)                                               \
+    template Array<outT> bilateral<inT, outT>(const Array<inT> &,            \
+                                              const float &, const float &); \
+    template Array<outT> bilateralGrid<inT, outT>(                           \
+        const Array<inT> &, const float &, const float &);
 
 INSTANTIATE(double, double)
 INSTANTIATE(float, float)
@@ -13,4 +13,8 @@ namespace cpu {
 template<typename inType, typename outType>
 Array<outType> bilateral(const Array<inType> &in, const float &spatialSigma,
                          const float &chromaticSigma);
-}
+
+template<typename inType, typename outType>
+Array<outType> bilateralGrid(const Array<inType> &in, const float &spatialSigma,
+                             const float &chromaticSigma);
+}  // namespace cpu
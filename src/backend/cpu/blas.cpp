@@ -328,6 +328,22 @@ void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs, const T *alpha,
     getQueue().enqueue(func, out, lhs, rhs);
 }
 
+template<typename T>
+void gemm(af_mat_prop optLhs, af_mat_prop optRhs, int M, int N, int K,
+          const T *alpha, const T *lhs, int lda, const T *rhs, int ldb,
+          const T *beta, T *out, int ldc) {
+    using BT  = typename blas_base<T>::type;
+    using CBT = const typename blas_base<T>::type;
+
+    auto alpha_ = scale_type<T, false>(alpha);
+    auto beta_  = scale_type<T, false>(beta);
+    gemm_func<T>()(CblasColMajor, toCblasTranspose(optLhs),
+                   toCblasTranspose(optRhs), M, N, K, alpha_.getScale(),
+                   reinterpret_cast<CBT *>(lhs), lda,
+                   reinterpret_cast<CBT *>(rhs), ldb, beta_.getScale(),
+                   reinterpret_cast<BT *>(out), ldc);
+}
+
 template<>
 void gemm<half>(Array<half> &out, af_mat_prop optLhs, af_mat_prop optRhs,
                 const half *alpha, const Array<half> &lhs,
@@ -374,7 +390,11 @@ Array<half> dot<half>(const Array<half> &lhs, const Array<half> &rhs,
     template void gemm<TYPE>(Array<TYPE> & out, af_mat_prop optLhs,          \
                              af_mat_prop optRhs, const TYPE *alphas,         \
                              const Array<TYPE> &lhs, const Array<TYPE> &rhs, \
-                             const TYPE *beta)
+                             const TYPE *beta);                              \
+    template void gemm<TYPE>(af_mat_prop optLhs, af_mat_prop optRhs, int M,  \
+                             int N, int K, const TYPE *alpha,                \
+                             const TYPE *lhs, int lda, const TYPE *rhs,      \
+                             int ldb, const TYPE *beta, TYPE *out, int ldc)
 
 INSTANTIATE_GEMM(float);
 INSTANTIATE_GEMM(cfloat);
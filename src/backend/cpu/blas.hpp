@@ -16,6 +16,15 @@ template<typename T>
 void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs, const T *alpha,
           const Array<T> &lhs, const Array<T> &rhs, const T *beta);
 
+/// Multiplies column major matrices in host memory on the calling thread,
+/// out = alpha * op(lhs) * op(rhs) + beta * out with op(lhs) M x K and
+/// op(rhs) K x N. Used by kernels in the queue that feed buffers of their
+/// own to the BLAS library.
+template<typename T>
+void gemm(af_mat_prop optLhs, af_mat_prop optRhs, int M, int N, int K,
+          const T *alpha, const T *lhs, int lda, const T *rhs, int ldb,
+          const T *beta, T *out, int ldc);
+
 template<typename T>
 Array<T> matmul(const Array<T> &lhs, const Array<T> &rhs, af_mat_prop optLhs,
                 af_mat_prop optRhs) {
@@ -34,4 +34,16 @@ Array<char> edgeTrackingByHysteresis(const Array<char>& strong,
 
     return out;
 }
+
+Array<char> cannyEdges(const Array<float>& smoothed, const float t1,
+                       const af_canny_threshold ct, const float t2,
+                       const bool isf) {
+    Array<char> out    = createEmptyArray<char>(smoothed.dims());
+    Array<float> edges = createEmptyArray<float>(smoothed.dims());
+
+    getQueue().enqueue(kernel::cannyEdges, out, edges, smoothed, t1, ct, t2,
+                       isf);
+
+    return out;
+}
 }  // namespace cpu
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <af/defines.h>
 
 namespace cpu {
 Array<float> nonMaximumSuppression(const Array<float>& mag,
@@ -16,4 +17,10 @@ Array<float> nonMaximumSuppression(const Array<float>& mag,
 
 Array<char> edgeTrackingByHysteresis(const Array<char>& strong,
                                      const Array<char>& weak);
+
+/// Canny edges of the smoothed image \p smoothed, from its sobel
+/// derivatives to the edges traced by hysteresis, in one kernel
+Array<char> cannyEdges(const Array<float>& smoothed, const float t1,
+                       const af_canny_threshold ct, const float t2,
+                       const bool isf);
 }  // namespace cpu
@@ -18,6 +18,7 @@
 #include <copy.hpp>
 #include <types.hpp>
 
+#include <kernel/batched_linalg.hpp>
 #include <lapack_helper.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
@@ -63,10 +64,26 @@ int cholesky_inplace(Array<T> &in, const bool is_upper) {
     char uplo = 'L';
     if (is_upper) { uplo = 'U'; }
 
-    int info  = 0;
+    int info = 0;
+    if (kernel::batched::useBatched(iDims)) {
+        getQueue().enqueue(kernel::batched::potrf<T>, &info, in, is_upper);
+        // Ensure the value of info has been written into info.
+        getQueue().sync();
+        return info;
+    }
+
+    // Reports the status of the first matrix of a batch that fails
     auto func = [&](int *info, Param<T> in) {
-        *info = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo, N, in.get(),
-                                in.strides(1));
+        dim4 iStrides = in.strides();
+        for (dim_t w = 0; w < iDims[3]; ++w) {
+            for (dim_t z = 0; z < iDims[2]; ++z) {
+                int status = potrf_func<T>()(
+                    AF_LAPACK_COL_MAJOR, uplo, N,
+                    in.get() + z * iStrides[2] + w * iStrides[3],
+                    iStrides[1]);
+                if (*info == 0) { *info = status; }
+            }
+        }
     };
 
     getQueue().enqueue(func, &info, in);
@@ -17,11 +17,14 @@
 #include <convolve.hpp>
 #include <handle.hpp>
 #include <kernel/convolve.hpp>
+#include <kernel/unwrap.hpp>
 #include <platform.hpp>
 #include <reorder.hpp>
 #include <transpose.hpp>
 #include <unwrap.hpp>
 #include <wrap.hpp>
+
+#include <algorithm>
 #include <vector>
 
 #include <af/defines.h>
@@ -155,13 +158,113 @@ Array<T> convolve2_unwrap(const Array<T> &signal, const Array<T> &filter,
     return out;
 }
 
+/// Bytes of the windows that convolve2_gemm unwraps at a time, so that
+/// they stay in the L2 cache while all the filters are applied to them
+constexpr size_t conv_tile_bytes = 256 * 1024;
+
+/// Convolves the images of \p signal as convolve2_unwrap does, multiplying
+/// the windows with the flipped filters. The windows of a tile of output
+/// positions are unwrapped by the threads and passed to gemm right away,
+/// so the matrix of all the windows is never formed and the result is
+/// written in its final layout.
+template<typename T>
+Array<T> convolve2_gemm(const Array<T> &signal, const Array<T> &filter,
+                        const dim4 &stride, const dim4 &padding,
+                        const dim4 &dilation) {
+    const dim4 sDims = signal.dims();
+    const dim4 fDims = filter.dims();
+
+    dim_t outputWidth =
+        1 + (sDims[0] + 2 * padding[0] - (((fDims[0] - 1) * dilation[0]) + 1)) /
+                stride[0];
+    dim_t outputHeight =
+        1 + (sDims[1] + 2 * padding[1] - (((fDims[1] - 1) * dilation[1]) + 1)) /
+                stride[1];
+
+    Array<T> out = createEmptyArray<T>(
+        dim4(outputWidth, outputHeight, fDims[3], sDims[3]));
+    signal.eval();
+    filter.eval();
+
+    const dim_t sx = stride[0], sy = stride[1];
+    const dim_t px = padding[0], py = padding[1];
+    const dim_t dx = dilation[0], dy = dilation[1];
+
+    auto func = [=](Param<T> output, CParam<T> image, CParam<T> filt) {
+        const dim_t wx       = fDims[0];
+        const dim_t wy       = fDims[1];
+        const dim_t channels = fDims[2];
+        const dim_t window   = wx * wy;
+        const dim_t K        = window * channels;
+        const dim_t F        = fDims[3];
+        const dim_t P        = outputWidth * outputHeight;
+        const dim4 iStrides  = image.strides();
+        const dim4 fStrides  = filt.strides();
+        const dim4 oStrides  = output.strides();
+
+        // Column f holds filter f flipped along dims 0 and 1, in the order
+        // of the elements of an unwrapped window
+        std::vector<T> weights(K * F);
+        for (dim_t f = 0; f < F; ++f) {
+            for (dim_t c = 0; c < channels; ++c) {
+                const T *src = filt.get() + f * fStrides[3] + c * fStrides[2];
+                T *dst       = weights.data() + f * K + c * window;
+                for (dim_t y = 0; y < wy; ++y) {
+                    for (dim_t x = 0; x < wx; ++x) {
+                        dst[y * wx + x] = src[(wx - 1 - x) * fStrides[0] +
+                                              (wy - 1 - y) * fStrides[1]];
+                    }
+                }
+            }
+        }
+
+        const dim_t tile =
+            std::min(P, std::max<dim_t>(conv_tile_bytes / (K * sizeof(T)), 16));
+        std::vector<T> windows(K * tile);
+
+        const T alpha = scalar<T>(1);
+        const T beta  = scalar<T>(0);
+        for (dim_t n = 0; n < sDims[3]; ++n) {
+            const T *iptr = image.get() + n * iStrides[3];
+            T *optr       = output.get() + n * oStrides[3];
+            for (dim_t p0 = 0; p0 < P; p0 += tile) {
+                const dim_t count = std::min(tile, P - p0);
+                threadPool().parallel_for(
+                    0, count, grainSize(K), [&](dim_t begin, dim_t end) {
+                        for (dim_t i = begin; i < end; ++i) {
+                            const dim_t p   = p0 + i;
+                            const dim_t spx = (p % outputWidth) * sx - px;
+                            const dim_t spy = (p / outputWidth) * sy - py;
+                            for (dim_t c = 0; c < channels; ++c) {
+                                kernel::unwrapPatch(
+                                    windows.data() + i * K + c * window,
+                                    iptr + c * iStrides[2], sDims.get(),
+                                    iStrides.get(), wx, wy, spx, spy, dx, dy);
+                            }
+                        }
+                    });
+                gemm(AF_MAT_TRANS, AF_MAT_NONE, int(count), int(F), int(K),
+                     &alpha, windows.data(), int(K), weights.data(), int(K),
+                     &beta, optr + p0, int(oStrides[2]));
+            }
+        }
+    };
+    getQueue().enqueue(func, out, signal, filter);
+
+    return out;
+}
+
 template<typename T>
 Array<T> convolve2(Array<T> const &signal, Array<T> const &filter,
                    const dim4 stride, const dim4 padding, const dim4 dilation) {
-    Array<T> out = createEmptyArray<T>(dim4());
-    out = convolve2_unwrap<T>(signal, filter, stride, padding, dilation);
+    return convolve2_gemm<T>(signal, filter, stride, padding, dilation);
+}
 
-    return out;
+template<>
+Array<half> convolve2<half>(Array<half> const &signal,
+                            Array<half> const &filter, const dim4 stride,
+                            const dim4 padding, const dim4 dilation) {
+    return convolve2_unwrap<half>(signal, filter, stride, padding, dilation);
 }
 
 #define INSTANTIATE(T)                                                        \
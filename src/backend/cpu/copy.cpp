@@ -35,6 +35,7 @@ void copyData(T *to, const Array<T> &from) {
     from.eval();
     // Ensure all operations on 'from' are complete before copying data to host.
     getQueue().sync();
+    syncBufferStreams(from.getData().get());
     if (from.isLinear()) {
         // FIXME: Check for errors / exceptions
         memcpy(to, from.get(), from.elements() * sizeof(T));
@@ -131,6 +132,7 @@ template<typename T>
 T getScalar(const Array<T> &in) {
     in.eval();
     getQueue().sync();
+    syncBufferStreams(in.getData().get());
     return in.get()[0];
 }
 
@@ -0,0 +1,42 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <deconvolution.hpp>
+
+#include <Array.hpp>
+#include <kernel/deconvolution.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+
+namespace cpu {
+template<typename T>
+Array<T> iterativeDeconv(const Array<T> &in, const Array<T> &psf,
+                         const unsigned iterations, const float relaxFactor,
+                         const float tolerance,
+                         const af_iterative_deconv_algo algo) {
+    Array<T> out = createEmptyArray<T>(in.dims());
+    if (algo == AF_ITERATIVE_DECONV_RICHARDSONLUCY) {
+        getQueue().enqueue(kernel::richardsonLucy<T>, out, in, psf,
+                           iterations, tolerance);
+    } else {
+        getQueue().enqueue(kernel::landweber<T>, out, in, psf, iterations,
+                           relaxFactor, tolerance);
+    }
+    return out;
+}
+
+#define INSTANTIATE(T)                                      \
+    template Array<T> iterativeDeconv<T>(                   \
+        const Array<T> &in, const Array<T> &psf,            \
+        const unsigned iterations, const float relaxFactor, \
+        const float tolerance, const af_iterative_deconv_algo algo);
+
+INSTANTIATE(float)
+INSTANTIATE(double)
+}  // namespace cpu
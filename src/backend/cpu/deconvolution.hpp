@@ -0,0 +1,24 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <Array.hpp>
+#include <af/defines.h>
+
+namespace cpu {
+/// Runs up to \p iterations of \p algo on \p in, which is blurred by
+/// \p psf. Both are padded to the same size and \p psf is shifted to have
+/// its centre at the origin; the result has the padded size. A
+/// \p tolerance above zero stops the iterations once one changes the
+/// estimate by at most \p tolerance times its norm.
+template<typename T>
+Array<T> iterativeDeconv(const Array<T> &in, const Array<T> &psf,
+                         const unsigned iterations, const float relaxFactor,
+                         const float tolerance,
+                         const af_iterative_deconv_algo algo);
+}  // namespace cpu
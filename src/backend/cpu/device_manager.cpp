@@ -10,16 +10,30 @@
 #include <common/DefaultMemoryManager.hpp>
 #include <common/err_common.hpp>
 #include <common/graphics_common.hpp>
+#include <common/util.hpp>
 #include <device_manager.hpp>
 #include <memory.hpp>
 #include <af/version.h>
 
+#ifdef USE_MKL
+#include <mkl_service.h>
+#endif
+
 #include <cctype>
+#include <cstdlib>
+#include <limits>
 #include <sstream>
+#include <string>
+#include <thread>
 
 using common::memory::MemoryManagerBase;
 using std::string;
 
+#if !defined(USE_MKL) && defined(OS_LNX)
+// Provided by OpenBLAS. Weak so other CBLAS implementations still link.
+extern "C" void openblas_set_num_threads(int) __attribute__((weak));
+#endif
+
 #ifdef CPUID_CAPABLE
 
 CPUInfo::CPUInfo()
@@ -121,8 +135,25 @@ CPUInfo::CPUInfo()
 
 namespace cpu {
 
+namespace {
+/// BLAS and LAPACK calls run on the queue's worker, outside the pool, so they
+/// are given the same number of threads instead of competing with it. FFTW is
+/// linked without its threading library and always runs on one thread.
+void setBlasThreads(unsigned num_threads) {
+    const int n = static_cast<int>(num_threads);
+#if defined(USE_MKL)
+    mkl_set_num_threads(n);
+#elif defined(OS_LNX)
+    if (openblas_set_num_threads) { openblas_set_num_threads(n); }
+#else
+    UNUSED(n);
+#endif
+}
+}  // namespace
+
 DeviceManager::DeviceManager()
     : queues(MAX_QUEUES)
+    , nextStreamId(1)
     , fgMngr(new graphics::ForgeManager())
     , memManager(new common::DefaultMemoryManager(
           getDeviceCount(), common::MAX_BUFFERS,
@@ -131,6 +162,21 @@ DeviceManager::DeviceManager()
     std::unique_ptr<cpu::Allocator> deviceMemoryManager(new cpu::Allocator());
     memManager->setAllocator(std::move(deviceMemoryManager));
     memManager->initialize();
+
+    unsigned nthreads = std::thread::hardware_concurrency();
+    if (nthreads == 0) { nthreads = static_cast<unsigned>(cinfo.threads()); }
+    // Malformed values fall back to the default instead of throwing out of
+    // the constructor
+    string env_threads = getEnvVar("AF_CPU_NUM_THREADS");
+    char* env_end      = nullptr;
+    long requested     = std::strtol(env_threads.c_str(), &env_end, 10);
+    bool env_valid     = !env_threads.empty() && *env_end == '\0' &&
+                         requested > 0 &&
+                         requested <= std::numeric_limits<int>::max();
+    if (env_valid) { nthreads = static_cast<unsigned>(requested); }
+    pool.reset(new ThreadPool(nthreads,
+                              getEnvVar("AF_CPU_THREAD_AFFINITY") == "1"));
+    if (env_valid) { setBlasThreads(nthreads); }
 }
 
 DeviceManager& DeviceManager::getInstance() {
@@ -140,6 +186,17 @@ DeviceManager& DeviceManager::getInstance() {
 
 CPUInfo DeviceManager::getCPUInfo() const { return cinfo; }
 
+void DeviceManager::setNumThreads(unsigned num_threads) {
+    // Kernels already queued may be running on the pool
+    queues[0].sync();
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        for (auto& s : streams) { s.second->sync(); }
+    }
+    pool->resize(num_threads);
+    setBlasThreads(num_threads);
+}
+
 void DeviceManager::resetMemoryManager() {
     // Replace with default memory manager
     std::unique_ptr<MemoryManagerBase> mgr(
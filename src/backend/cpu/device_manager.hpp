@@ -11,9 +11,11 @@
 
 #include <platform.hpp>
 #include <queue.hpp>
+#include <thread_pool.hpp>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 
 using common::memory::MemoryManagerBase;
 
@@ -102,6 +104,18 @@ class DeviceManager {
 
     friend queue& getQueue(int device);
 
+    friend int createStream();
+
+    friend void destroyStream(int id);
+
+    friend queue* getStream(int id);
+
+    friend queue* acquireStream(int id);
+
+    friend void releaseStream(int id);
+
+    friend ThreadPool& threadPool();
+
     friend MemoryManagerBase& memoryManager();
 
     friend void setMemoryManager(std::unique_ptr<MemoryManagerBase> mgr);
@@ -125,6 +139,8 @@ class DeviceManager {
 
     CPUInfo getCPUInfo() const;
 
+    void setNumThreads(unsigned num_threads);
+
    private:
     DeviceManager();
     // Following two declarations are required to
@@ -136,6 +152,17 @@ class DeviceManager {
 
     // Attributes
     std::vector<queue> queues;
+
+    /// Queues created through createStream, keyed by stream id
+    std::unordered_map<int, std::unique_ptr<queue>> streams;
+    /// Number of threads that selected each stream, keyed by stream id
+    std::unordered_map<int, int> streamUsers;
+    int nextStreamId;
+    std::mutex streamMutex;
+
+    /// Pool the kernels parallelise on. Sized by AF_CPU_NUM_THREADS or the
+    /// number of logical CPUs; AF_CPU_THREAD_AFFINITY=1 pins its workers.
+    std::unique_ptr<ThreadPool> pool;
     std::unique_ptr<graphics::ForgeManager> fgMngr;
     const CPUInfo cinfo;
     std::unique_ptr<MemoryManagerBase> memManager;
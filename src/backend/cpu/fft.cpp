@@ -11,7 +11,7 @@
 
 #include <Array.hpp>
 #include <copy.hpp>
-#include <fftw3.h>
+#include <fftw_transform.hpp>
 #include <platform.hpp>
 #include <types.hpp>
 #include <af/dim4.hpp>
@@ -24,47 +24,10 @@ using std::array;
 
 namespace cpu {
 
-template<typename T>
-struct fftw_transform;
-
-#define TRANSFORM(PRE, TY)                                             \
-    template<>                                                         \
-    struct fftw_transform<TY> {                                        \
-        typedef PRE##_plan plan_t;                                     \
-        typedef PRE##_complex ctype_t;                                 \
-                                                                       \
-        template<typename... Args>                                     \
-        plan_t create(Args... args) {                                  \
-            return PRE##_plan_many_dft(args...);                       \
-        }                                                              \
-        void execute(plan_t plan) { return PRE##_execute(plan); }      \
-        void destroy(plan_t plan) { return PRE##_destroy_plan(plan); } \
-    };
-
-TRANSFORM(fftwf, cfloat)
-TRANSFORM(fftw, cdouble)
-
-template<typename To, typename Ti>
-struct fftw_real_transform;
-
-#define TRANSFORM_REAL(PRE, To, Ti, POST)                              \
-    template<>                                                         \
-    struct fftw_real_transform<To, Ti> {                               \
-        typedef PRE##_plan plan_t;                                     \
-        typedef PRE##_complex ctype_t;                                 \
-                                                                       \
-        template<typename... Args>                                     \
-        plan_t create(Args... args) {                                  \
-            return PRE##_plan_many_dft_##POST(args...);                \
-        }                                                              \
-        void execute(plan_t plan) { return PRE##_execute(plan); }      \
-        void destroy(plan_t plan) { return PRE##_destroy_plan(plan); } \
-    };
-
-TRANSFORM_REAL(fftwf, cfloat, float, r2c)
-TRANSFORM_REAL(fftw, cdouble, double, r2c)
-TRANSFORM_REAL(fftwf, float, cfloat, c2r)
-TRANSFORM_REAL(fftw, double, cdouble, c2r)
+std::mutex &fftwPlannerMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
 
 inline array<int, AF_MAX_DIMS> computeDims(const int rank, const dim4 &idims) {
     array<int, AF_MAX_DIMS> retVal = {};
@@ -11,7 +11,7 @@
 
 #include <Array.hpp>
 #include <common/dispatch.hpp>
-#include <fftw3.h>
+#include <fftw_transform.hpp>
 #include <kernel/fftconvolve.hpp>
 #include <queue.hpp>
 #include <af/dim4.hpp>
@@ -42,6 +42,9 @@ Array<T> fftconvolve(Array<T> const& signal, Array<T> const& filter,
                                             float, double>::type;
 
     constexpr bool IsTypeDouble = std::is_same<T, double>::value;
+    using transform_t =
+        fftw_transform<typename std::conditional<IsTypeDouble, cdouble,
+                                                 cfloat>::type>;
 
     const dim4& sd = signal.dims();
     const dim4& fd = filter.dims();
@@ -95,73 +98,36 @@ Array<T> fftconvolve(Array<T> const& signal, Array<T> const& filter,
                        paddedFilStrides, filter, offset);
 
     // NOLINTNEXTLINE(performance-unnecessary-value-param)
-    auto upstream_dft = [=](Param<convT> packed,
-                            const array<int, AF_MAX_DIMS> fftDims) {
+    auto upstream_fft = [=](Param<convT> packed,
+                            const array<int, AF_MAX_DIMS> fftDims,
+                            const int sign) {
+        using ctype_t             = typename transform_t::ctype_t;
         const dim4 packedDims     = packed.dims();
         const dim4 packed_strides = packed.strides();
-        // Compute forward FFT
-        if (IsTypeDouble) {
-            fftw_plan plan = fftw_plan_many_dft(
-                rank, fftDims.data(), packedDims[rank],
-                reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2,
-                reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2, FFTW_FORWARD,
-                FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
-
-            fftw_execute(plan);
-            fftw_destroy_plan(plan);
-        } else {
-            fftwf_plan plan = fftwf_plan_many_dft(
-                rank, fftDims.data(), packedDims[rank],
-                reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2,
-                reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2, FFTW_FORWARD,
-                FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
-
-            fftwf_execute(plan);
-            fftwf_destroy_plan(plan);
-        }
+
+        transform_t transform;
+        auto plan = transform.create(
+            rank, fftDims.data(), packedDims[rank],
+            reinterpret_cast<ctype_t*>(packed.get()), nullptr,
+            packed_strides[0], packed_strides[rank] / 2,
+            reinterpret_cast<ctype_t*>(packed.get()), nullptr,
+            packed_strides[0], packed_strides[rank] / 2, sign,
+            FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
+
+        transform.execute(plan);
+        transform.destroy(plan);
     };
-    getQueue().enqueue(upstream_dft, packed, fftDims);
+
+    // Compute forward FFT
+    getQueue().enqueue(upstream_fft, packed, fftDims, FFTW_FORWARD);
 
     // Multiply filter and signal FFT arrays
     getQueue().enqueue(kernel::complexMultiply<convT>, packed, paddedSigDims,
                        paddedSigStrides, paddedFilDims, paddedFilStrides, kind,
                        offset);
 
-    // NOLINTNEXTLINE(performance-unnecessary-value-param)
-    auto upstream_idft = [=](Param<convT> packed,
-                             const array<int, AF_MAX_DIMS> fftDims) {
-        const dim4 packedDims     = packed.dims();
-        const dim4 packed_strides = packed.strides();
-        // Compute inverse FFT
-        if (IsTypeDouble) {
-            fftw_plan plan = fftw_plan_many_dft(
-                rank, fftDims.data(), packedDims[rank],
-                reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2,
-                reinterpret_cast<fftw_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2, FFTW_BACKWARD,
-                FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
-
-            fftw_execute(plan);
-            fftw_destroy_plan(plan);
-        } else {
-            fftwf_plan plan = fftwf_plan_many_dft(
-                rank, fftDims.data(), packedDims[rank],
-                reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2,
-                reinterpret_cast<fftwf_complex*>(packed.get()), nullptr,
-                packed_strides[0], packed_strides[rank] / 2, FFTW_BACKWARD,
-                FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
-
-            fftwf_execute(plan);
-            fftwf_destroy_plan(plan);
-        }
-    };
-    getQueue().enqueue(upstream_idft, packed, fftDims);
+    // Compute inverse FFT
+    getQueue().enqueue(upstream_fft, packed, fftDims, FFTW_BACKWARD);
 
     // Compute output dimensions
     dim4 oDims(1);
@@ -0,0 +1,77 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <fftw3.h>
+#include <types.hpp>
+
+#include <mutex>
+
+namespace cpu {
+
+/// Guards the FFTW planner, which is not thread safe. Plans are made and
+/// destroyed inside queued tasks, so the workers of different queues may
+/// plan at the same time. Executing a plan does not need the lock.
+std::mutex &fftwPlannerMutex();
+
+template<typename T>
+struct fftw_transform;
+
+#define TRANSFORM(PRE, TY)                                              \
+    template<>                                                          \
+    struct fftw_transform<TY> {                                         \
+        typedef PRE##_plan plan_t;                                      \
+        typedef PRE##_complex ctype_t;                                  \
+                                                                        \
+        template<typename... Args>                                      \
+        plan_t create(Args... args) {                                   \
+            std::lock_guard<std::mutex> lock(fftwPlannerMutex());       \
+            return PRE##_plan_many_dft(args...);                        \
+        }                                                               \
+        void execute(plan_t plan) { return PRE##_execute(plan); }       \
+        void destroy(plan_t plan) {                                     \
+            std::lock_guard<std::mutex> lock(fftwPlannerMutex());       \
+            return PRE##_destroy_plan(plan);                            \
+        }                                                               \
+    };
+
+TRANSFORM(fftwf, cfloat)
+TRANSFORM(fftw, cdouble)
+
+#undef TRANSFORM
+
+template<typename To, typename Ti>
+struct fftw_real_transform;
+
+#define TRANSFORM_REAL(PRE, To, Ti, POST)                               \
+    template<>                                                          \
+    struct fftw_real_transform<To, Ti> {                                \
+        typedef PRE##_plan plan_t;                                      \
+        typedef PRE##_complex ctype_t;                                  \
+                                                                        \
+        template<typename... Args>                                      \
+        plan_t create(Args... args) {                                   \
+            std::lock_guard<std::mutex> lock(fftwPlannerMutex());       \
+            return PRE##_plan_many_dft_##POST(args...);                 \
+        }                                                               \
+        void execute(plan_t plan) { return PRE##_execute(plan); }       \
+        void destroy(plan_t plan) {                                     \
+            std::lock_guard<std::mutex> lock(fftwPlannerMutex());       \
+            return PRE##_destroy_plan(plan);                            \
+        }                                                               \
+    };
+
+TRANSFORM_REAL(fftwf, cfloat, float, r2c)
+TRANSFORM_REAL(fftw, cdouble, double, r2c)
+TRANSFORM_REAL(fftwf, float, cfloat, c2r)
+TRANSFORM_REAL(fftw, double, cdouble, c2r)
+
+#undef TRANSFORM_REAL
+
+}  // namespace cpu
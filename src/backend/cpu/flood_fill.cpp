@@ -21,16 +21,28 @@ Array<T> floodFill(const Array<T>& image, const Array<uint>& seedsX,
                    const Array<uint>& seedsY, const T newValue,
                    const T lowValue, const T highValue,
                    const af::connectivity nlookup) {
-    auto out = createValueArray(image.dims(), T(0));
+    auto out = createEmptyArray<T>(image.dims());
     getQueue().enqueue(kernel::floodFill<T>, out, image, seedsX, seedsY,
                        newValue, lowValue, highValue, nlookup);
     return out;
 }
 
+template<typename T>
+Array<T> floodFillGrow(const Array<T>& image, const Array<T>& previous,
+                       const T newValue, const T lowValue, const T highValue,
+                       const af::connectivity nlookup) {
+    auto out = createEmptyArray<T>(image.dims());
+    getQueue().enqueue(kernel::floodFillGrow<T>, out, image, previous,
+                       newValue, lowValue, highValue, nlookup);
+    return out;
+}
+
 #define INSTANTIATE(T)                                                         \
     template Array<T> floodFill(const Array<T>&, const Array<uint>&,           \
                                 const Array<uint>&, const T, const T, const T, \
-                                const af::connectivity);
+                                const af::connectivity);                       \
+    template Array<T> floodFillGrow(const Array<T>&, const Array<T>&, const T, \
+                                    const T, const T, const af::connectivity);
 
 INSTANTIATE(float)
 INSTANTIATE(uint)
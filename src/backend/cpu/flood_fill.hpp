@@ -18,4 +18,12 @@ Array<T> floodFill(const Array<T>& image, const Array<uint>& seedsX,
                    const Array<uint>& seedsY, const T newValue,
                    const T lowValue, const T highValue,
                    const af::connectivity nlookup = AF_CONNECTIVITY_8);
+
+/// Grows the non zero pixels of \p previous through the pixels of \p image
+/// within [\p lowValue, \p highValue]. When these limits contain the ones
+/// \p previous was filled with, the result is the fill from its seeds.
+template<typename T>
+Array<T> floodFillGrow(const Array<T>& image, const Array<T>& previous,
+                       const T newValue, const T lowValue, const T highValue,
+                       const af::connectivity nlookup = AF_CONNECTIVITY_8);
 }  // namespace cpu
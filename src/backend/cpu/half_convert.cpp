@@ -0,0 +1,126 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <half_convert.hpp>
+
+// The vector paths are compiled with per function target attributes and
+// picked at runtime, so the library itself does not require F16C
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define AF_HALF_DISPATCH
+#include <immintrin.h>
+#endif
+
+using common::half;
+
+namespace cpu {
+
+namespace {
+
+using half_to_float_fn = void (*)(float *, const half *, size_t);
+using float_to_half_fn = void (*)(half *, const float *, size_t);
+
+void halfToFloatScalar(float *out, const half *in, size_t count) {
+    for (size_t i = 0; i < count; i++) { out[i] = static_cast<float>(in[i]); }
+}
+
+void floatToHalfScalar(half *out, const float *in, size_t count) {
+    for (size_t i = 0; i < count; i++) { out[i] = half(in[i]); }
+}
+
+#ifdef AF_HALF_DISPATCH
+
+__attribute__((target("avx,f16c"))) void halfToFloatF16C(float *out,
+                                                          const half *in,
+                                                          size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+    }
+    halfToFloatScalar(out + i, in + i, count - i);
+}
+
+__attribute__((target("avx,f16c"))) void floatToHalfF16C(half *out,
+                                                          const float *in,
+                                                          size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i),
+                                    _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), h);
+    }
+    floatToHalfScalar(out + i, in + i, count - i);
+}
+
+__attribute__((target("avx512f"))) void halfToFloatAVX512(float *out,
+                                                           const half *in,
+                                                           size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i h =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        _mm512_storeu_ps(out + i, _mm512_cvtph_ps(h));
+    }
+    halfToFloatF16C(out + i, in + i, count - i);
+}
+
+__attribute__((target("avx512f"))) void floatToHalfAVX512(half *out,
+                                                           const float *in,
+                                                           size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i h = _mm512_cvtps_ph(_mm512_loadu_ps(in + i),
+                                    _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), h);
+    }
+    floatToHalfF16C(out + i, in + i, count - i);
+}
+
+#endif
+
+struct conversion_path {
+    const char *name;
+    half_to_float_fn to_float;
+    float_to_half_fn to_half;
+};
+
+conversion_path selectPath() {
+#ifdef AF_HALF_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {"avx512f", halfToFloatAVX512, floatToHalfAVX512};
+    }
+    // F16C has no __builtin_cpu_supports name in older compilers; every
+    // processor with AVX2 implements it
+    if (__builtin_cpu_supports("avx2")) {
+        return {"f16c", halfToFloatF16C, floatToHalfF16C};
+    }
+#endif
+    return {"scalar", halfToFloatScalar, floatToHalfScalar};
+}
+
+const conversion_path &path() {
+    static const conversion_path selected = selectPath();
+    return selected;
+}
+
+}  // namespace
+
+void convertHalfToFloat(float *out, const half *in, size_t count) {
+    path().to_float(out, in, count);
+}
+
+void convertFloatToHalf(half *out, const float *in, size_t count) {
+    path().to_half(out, in, count);
+}
+
+const char *halfConversionPath() { return path().name; }
+
+}  // namespace cpu
@@ -0,0 +1,46 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <common/half.hpp>
+
+#include <cstddef>
+
+namespace cpu {
+
+/// Converts \p count f16 values to single precision.
+///
+/// Uses the F16C or AVX-512 conversion instructions when the host CPU
+/// supports them and the scalar common::half conversion otherwise. Both
+/// produce the same values; signalling NaNs may come out quieted.
+void convertHalfToFloat(float *out, const common::half *in, size_t count);
+
+/// Converts \p count single precision values to f16, rounding to nearest
+/// even like common::half(float).
+void convertFloatToHalf(common::half *out, const float *in, size_t count);
+
+/// Name of the instruction set used by the bulk f16 conversions: "avx512f",
+/// "f16c" or "scalar"
+const char *halfConversionPath();
+
+/// Converts \p count values of \p in to the type of \p out
+template<typename To, typename Ti>
+void convertValues(To *out, const Ti *in, size_t count) {
+    for (size_t i = 0; i < count; i++) { out[i] = static_cast<To>(in[i]); }
+}
+
+inline void convertValues(float *out, const common::half *in, size_t count) {
+    convertHalfToFloat(out, in, count);
+}
+
+inline void convertValues(common::half *out, const float *in, size_t count) {
+    convertFloatToHalf(out, in, count);
+}
+
+}  // namespace cpu
@@ -13,8 +13,10 @@
 #include <homography.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
+#include <thread_pool.hpp>
 #include <af/dim4.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstring>
@@ -23,10 +25,12 @@
 
 using af::dim4;
 using std::abs;
+using std::max_element;
 using std::array;
 using std::log;
 using std::max;
 using std::min;
+using std::nth_element;
 using std::numeric_limits;
 using std::pow;
 using std::round;
@@ -199,10 +203,12 @@ int computeHomography(T* H_ptr, const float* rnd_ptr, const float* x_src_ptr,
     float src_scale = sqrt(2.0f) / sqrt(src_var);
     float dst_scale = sqrt(2.0f) / sqrt(dst_var);
 
-    Array<T> A     = createValueArray<T>(af::dim4(9, 9), static_cast<T>(0));
-    af::dim4 Adims = A.dims();
-    T* A_ptr       = A.get();
-    getQueue().sync();
+    // The 9x9 system and its right singular vectors are small enough to live
+    // on the stack, which keeps every hypothesis free of allocations
+    array<T, 81> A{};
+    array<T, 81> V{};
+    const af::dim4 Adims(9, 9);
+    T* A_ptr = A.data();
 
     for (unsigned j = 0; j < 4; j++) {
         float srcx = (src_pt_x[j] - x_src_mean) * src_scale;
@@ -225,17 +231,10 @@ int computeHomography(T* H_ptr, const float* rnd_ptr, const float* x_src_ptr,
         APTR(8, j * 2 + 1) = -dstx;
     }
 
-    Array<T> V =
-        createValueArray<T>(af::dim4(Adims[1], Adims[1]), static_cast<T>(0));
-    V.eval();
-    getQueue().sync();
-    JacobiSVD<T, 9, 9>(A.get(), V.get());
-
-    dim4 Vdims = V.dims();
-    T* V_ptr   = V.get();
+    JacobiSVD<T, 9, 9>(A.data(), V.data());
 
     array<T, 9> vH{};
-    for (unsigned j = 0; j < 9; j++) { vH[j] = V_ptr[8 * Vdims[0] + j]; }
+    for (unsigned j = 0; j < 9; j++) { vH[j] = V[8 * Adims[0] + j]; }
 
     H_ptr[0] = src_scale * x_dst_mean * vH[6] + src_scale * vH[0] / dst_scale;
     H_ptr[1] = src_scale * x_dst_mean * vH[7] + src_scale * vH[1] / dst_scale;
@@ -261,8 +260,59 @@ int computeHomography(T* H_ptr, const float* rnd_ptr, const float* x_src_ptr,
     return 0;
 }
 
+// Number of matches scored between checks for early termination. Scoring a
+// whole block keeps the inner loop free of branches so it vectorizes.
+static const unsigned ScoreBlock = 64;
+
+// Reprojection error of every match in [begin, end) under H, written to err
+template<typename T>
+void reprojectionError(float* err, const T* H, const float* x_src,
+                       const float* y_src, const float* x_dst,
+                       const float* y_dst, const unsigned begin,
+                       const unsigned end) {
+    const T h0 = H[0], h1 = H[1], h2 = H[2];
+    const T h3 = H[3], h4 = H[4], h5 = H[5];
+    const T h6 = H[6], h7 = H[7], h8 = H[8];
+    for (unsigned j = begin; j < end; j++) {
+        float z = h6 * x_src[j] + h7 * y_src[j] + h8;
+        float x = (h0 * x_src[j] + h1 * y_src[j] + h2) / z;
+        float y = (h3 * x_src[j] + h4 * y_src[j] + h5) / z;
+
+        err[j - begin] = sq(x_dst[j] - x) + sq(y_dst[j] - y);
+    }
+}
+
+// Counts the inliers of H. Returns early once the hypothesis can no longer
+// collect more than `target` inliers, in which case the returned count is
+// only a lower bound and at most `target`.
+template<typename T>
+int countInliers(const T* H, const float* x_src, const float* y_src,
+                 const float* x_dst, const float* y_dst,
+                 const unsigned nsamples, const float thr_sq,
+                 const int target) {
+    array<float, ScoreBlock> dist;
+    int inliers = 0;
+    for (unsigned b = 0; b < nsamples; b += ScoreBlock) {
+        const unsigned e = min(b + ScoreBlock, nsamples);
+        reprojectionError<T>(dist.data(), H, x_src, y_src, x_dst, y_dst, b, e);
+        for (unsigned j = 0; j < e - b; j++) { inliers += dist[j] < thr_sq; }
+
+        if (inliers + static_cast<int>(nsamples - e) <= target) {
+            return inliers;
+        }
+    }
+    return inliers;
+}
+
+// Hypotheses generated and scored per thread in each batch of RANSAC
+static const unsigned HypothesesPerThread = 4;
+
 // LMedS:
 // http://research.microsoft.com/en-us/um/people/zhang/INRIA/Publis/Tutorial-Estim/node25.html
+//
+// The hypotheses are generated and scored in parallel, then folded into the
+// best one in their original order, so the result is the same as evaluating
+// them one at a time.
 template<typename T>
 int findBestHomography(Array<T>& bestH, const Array<float>& x_src,
                        const Array<float>& y_src, const Array<float>& x_dst,
@@ -273,87 +323,106 @@ int findBestHomography(Array<T>& bestH, const Array<float>& x_src,
     const float* y_src_ptr = y_src.get();
     const float* x_dst_ptr = x_dst.get();
     const float* y_dst_ptr = y_dst.get();
-
-    Array<T> H =
-        createValueArray<T>(af::dim4(9, iterations), static_cast<T>(0));
-    H.eval();
-    getQueue().sync();
-
-    const af::dim4& rdims = rnd.dims();
-    const af::dim4& Hdims = H.dims();
-
-    unsigned iter    = iterations;
-    unsigned bestIdx = 0;
-    int bestInliers  = 0;
-    float minMedian  = numeric_limits<float>::max();
-
-    for (unsigned i = 0; i < iter; i++) {
-        const unsigned Hidx = Hdims[0] * i;
-        T* H_ptr            = H.get() + Hidx;
-
-        const unsigned ridx  = rdims[0] * i;
-        const float* rnd_ptr = rnd.get() + ridx;
-
-        if (computeHomography<T>(H_ptr, rnd_ptr, x_src_ptr, y_src_ptr,
-                                 x_dst_ptr, y_dst_ptr)) {
-            continue;
-        }
-
-        if (htype == AF_HOMOGRAPHY_RANSAC) {
-            int inliers_count = 0;
-            for (unsigned j = 0; j < nsamples; j++) {
-                float z = H_ptr[6] * x_src_ptr[j] + H_ptr[7] * y_src_ptr[j] +
-                          H_ptr[8];
-                float x = (H_ptr[0] * x_src_ptr[j] + H_ptr[1] * y_src_ptr[j] +
-                           H_ptr[2]) /
-                          z;
-                float y = (H_ptr[3] * x_src_ptr[j] + H_ptr[4] * y_src_ptr[j] +
-                           H_ptr[5]) /
-                          z;
-
-                float dist = sq(x_dst_ptr[j] - x) + sq(y_dst_ptr[j] - y);
-                if (dist < (inlier_thr * inlier_thr)) { inliers_count++; }
-            }
-            iter =
-                updateIterations(static_cast<float>(nsamples - inliers_count) /
-                                     static_cast<float>(nsamples),
-                                 iter);
-            if (inliers_count > bestInliers) {
-                bestIdx     = i;
-                bestInliers = inliers_count;
+    const float* rnd_ptr   = rnd.get();
+    const dim_t rstride    = rnd.dims()[0];
+
+    unsigned iter      = iterations;
+    int bestInliers    = 0;
+    float minMedian    = numeric_limits<float>::max();
+    const float thr_sq = inlier_thr * inlier_thr;
+
+    array<T, 9> best{};
+
+    // Hypotheses [first, first + count) go to Hs, with valid[k] cleared when
+    // the k-th sample is degenerate
+    const unsigned batch =
+        htype == AF_HOMOGRAPHY_RANSAC
+            ? min(iter, HypothesesPerThread * threadPool().size())
+            : iter;
+    vector<T> Hs(batch * 9);
+    vector<unsigned char> valid(batch);
+    auto hypothesis = [&](const unsigned first, const dim_t k) {
+        valid[k] = !computeHomography<T>(
+            Hs.data() + k * 9, rnd_ptr + rstride * (first + k), x_src_ptr,
+            y_src_ptr, x_dst_ptr, y_dst_ptr);
+        return valid[k];
+    };
+    auto keep = [&](const unsigned k) {
+        std::copy(Hs.data() + k * 9, Hs.data() + k * 9 + 9, best.begin());
+    };
+
+    if (htype == AF_HOMOGRAPHY_RANSAC) {
+        // The iteration count shrinks with every new best, so the hypotheses
+        // run in batches of a few per thread to bound the wasted work
+        vector<int> inliers(batch);
+        for (unsigned first = 0; first < iter; first += batch) {
+            const unsigned count = min(batch, iter - first);
+
+            // A hypothesis can only replace the best one by beating it, so
+            // scoring stops as soon as that is out of reach. The bound is
+            // taken at the start of the batch, which lets every hypothesis
+            // that could win be counted exactly.
+            const int target = bestInliers;
+            threadPool().parallel_for(0, count, 1, [&](dim_t b, dim_t e) {
+                for (dim_t k = b; k < e; k++) {
+                    if (!hypothesis(first, k)) { continue; }
+                    inliers[k] = countInliers<T>(
+                        Hs.data() + k * 9, x_src_ptr, y_src_ptr, x_dst_ptr,
+                        y_dst_ptr, nsamples, thr_sq, target);
+                }
+            });
+
+            // The first hypothesis is the result if none of them improves on
+            // it
+            for (unsigned k = 0; k < count && first + k < iter; k++) {
+                if (!valid[k]) { continue; }
+                if (first + k == 0) { keep(k); }
+                if (inliers[k] > bestInliers) {
+                    keep(k);
+                    bestInliers = inliers[k];
+                    iter        = updateIterations(
+                        static_cast<float>(nsamples - inliers[k]) /
+                            static_cast<float>(nsamples),
+                        iter);
+                }
             }
-        } else if (htype == AF_HOMOGRAPHY_LMEDS) {
+        }
+    } else if (htype == AF_HOMOGRAPHY_LMEDS) {
+        vector<float> medians(iter);
+        threadPool().parallel_for(0, iter, 1, [&](dim_t b, dim_t e) {
             vector<float> err(nsamples);
-            for (unsigned j = 0; j < nsamples; j++) {
-                float z = H_ptr[6] * x_src_ptr[j] + H_ptr[7] * y_src_ptr[j] +
-                          H_ptr[8];
-                float x = (H_ptr[0] * x_src_ptr[j] + H_ptr[1] * y_src_ptr[j] +
-                           H_ptr[2]) /
-                          z;
-                float y = (H_ptr[3] * x_src_ptr[j] + H_ptr[4] * y_src_ptr[j] +
-                           H_ptr[5]) /
-                          z;
-
-                float dist = sq(x_dst_ptr[j] - x) + sq(y_dst_ptr[j] - y);
-                err[j]     = sqrt(dist);
-            }
-
-            stable_sort(err.begin(), err.end());
-
-            float median = err[nsamples / 2];
-            if (nsamples % 2 == 0) {
-                median = (median + err[nsamples / 2 - 1]) * 0.5f;
+            for (dim_t k = b; k < e; k++) {
+                if (!hypothesis(0, k)) { continue; }
+                reprojectionError<T>(err.data(), Hs.data() + k * 9, x_src_ptr,
+                                     y_src_ptr, x_dst_ptr, y_dst_ptr, 0,
+                                     nsamples);
+
+                // Only the middle order statistics are needed. err holds
+                // squared distances, which have the same order as the
+                // distances.
+                auto mid = err.begin() + nsamples / 2;
+                nth_element(err.begin(), mid, err.end());
+                float median = sqrt(*mid);
+                if (nsamples % 2 == 0) {
+                    float lower = sqrt(*max_element(err.begin(), mid));
+                    median      = (median + lower) * 0.5f;
+                }
+                medians[k] = median;
             }
-
-            if (median < minMedian &&
-                median > numeric_limits<float>::epsilon()) {
-                minMedian = median;
-                bestIdx   = i;
+        });
+
+        for (unsigned k = 0; k < iter; k++) {
+            if (!valid[k]) { continue; }
+            if (k == 0) { keep(k); }
+            if (medians[k] < minMedian &&
+                medians[k] > numeric_limits<float>::epsilon()) {
+                minMedian = medians[k];
+                keep(k);
             }
         }
     }
 
-    memcpy(bestH.get(), H.get() + bestIdx * 9, 9 * sizeof(T));
+    memcpy(bestH.get(), best.data(), 9 * sizeof(T));
 
     if (htype == AF_HOMOGRAPHY_LMEDS) {
         float sigma =
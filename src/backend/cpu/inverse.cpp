@@ -19,6 +19,7 @@
 #include <cassert>
 
 #include <identity.hpp>
+#include <kernel/batched_linalg.hpp>
 #include <lapack_helper.hpp>
 #include <lu.hpp>
 #include <platform.hpp>
@@ -56,12 +57,27 @@ Array<T> inverse(const Array<T> &in) {
         return solve(in, I);
     }
 
+    if (kernel::batched::useBatched(in.dims())) {
+        Array<T> out = createEmptyArray<T>(in.dims());
+        getQueue().enqueue(kernel::batched::getri<T>, out, in);
+        return out;
+    }
+
     Array<T> A       = copyArray<T>(in);
     Array<int> pivot = lu_inplace<T>(A, false);
 
     auto func = [=](Param<T> A, Param<int> pivot, int M) {
-        getri_func<T>()(AF_LAPACK_COL_MAJOR, M, A.get(), A.strides(1),
-                        pivot.get());
+        dim4 aDims    = A.dims();
+        dim4 aStrides = A.strides();
+        dim4 pStrides = pivot.strides();
+        for (dim_t w = 0; w < aDims[3]; ++w) {
+            for (dim_t z = 0; z < aDims[2]; ++z) {
+                getri_func<T>()(
+                    AF_LAPACK_COL_MAJOR, M,
+                    A.get() + z * aStrides[2] + w * aStrides[3], aStrides[1],
+                    pivot.get() + z * pStrides[2] + w * pStrides[3]);
+            }
+        }
     };
     getQueue().enqueue(func, A, pivot, M);
 
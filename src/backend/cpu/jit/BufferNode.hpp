@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <half_convert.hpp>
 #include <optypes.hpp>
 #include <af/defines.h>
 #include "Node.hpp"
@@ -57,6 +58,17 @@ class BufferNode : public TNode<T> {
         }
     }
 
+    /// Returns the first element read by the node
+    T *getPtr() const noexcept { return m_ptr; }
+
+    /// Returns the dimensions of the buffer
+    const dim_t *getDims() const noexcept { return m_dims; }
+
+    /// Returns the strides of the buffer
+    const dim_t *getStrides() const noexcept { return m_strides; }
+
+    const BufferNode<T> *getBuffer() const final { return this; }
+
     void setShape(af::dim4 new_shape) final {
         auto new_strides = calcStrides(new_shape);
         m_dims[0]        = new_shape[0];
@@ -78,6 +90,10 @@ class BufferNode : public TNode<T> {
         l_off += (y < (int)m_dims[1]) * y * m_strides[1];
         T *in_ptr   = m_ptr + l_off;
         Tc *out_ptr = this->m_val.data();
+        if (x + lim <= m_dims[0]) {
+            convertValues(out_ptr, in_ptr + x, lim);
+            return;
+        }
         for (int i = 0; i < lim; i++) {
             out_ptr[i] =
                 static_cast<Tc>(in_ptr[((x + i) < m_dims[0]) ? (x + i) : 0]);
@@ -85,13 +101,7 @@ class BufferNode : public TNode<T> {
     }
 
     void calc(int idx, int lim) final {
-        using Tc = compute_t<T>;
-
-        T *in_ptr   = m_ptr + idx;
-        Tc *out_ptr = this->m_val.data();
-        for (int i = 0; i < lim; i++) {
-            out_ptr[i] = static_cast<Tc>(in_ptr[i]);
-        }
+        convertValues(this->m_val.data(), m_ptr + idx, lim);
     }
 
     void getInfo(unsigned &len, unsigned &buf_count,
@@ -0,0 +1,109 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <common/defines.hpp>
+#include <jit/BufferNode.hpp>
+#include <jit/Node.hpp>
+#include <utility.hpp>
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace cpu {
+
+namespace jit {
+
+/// Reads a buffer at the positions given by an index tree along one
+/// dimension, i.e. a lookup that can be part of a larger JIT tree.
+///
+/// The child is evaluated over the output coordinates and must broadcast
+/// along every dimension but \p dim, which is what an index vector reshaped
+/// to lie along \p dim does. Indices outside the buffer are wrapped with
+/// trimIndex.
+template<typename T, typename Ti>
+class GatherNode : public TNode<T> {
+   protected:
+    using common::Node::m_children;
+    std::shared_ptr<BufferNode<T>> m_buffer_node;
+    int m_dim;
+
+   public:
+    GatherNode(std::shared_ptr<BufferNode<T>> buffer_node,
+               common::Node_ptr indices, int dim)
+        : TNode<T>(T(0), indices->getHeight() + 1, {{indices}})
+        , m_buffer_node(std::move(buffer_node))
+        , m_dim(dim) {}
+
+    std::unique_ptr<common::Node> clone() final {
+        return std::make_unique<GatherNode>(*this);
+    }
+
+    const BufferNode<T> *getBuffer() const final {
+        return m_buffer_node.get();
+    }
+
+    void calc(int x, int y, int z, int w, int lim) final {
+        using Tc = compute_t<T>;
+
+        const dim_t *dims    = m_buffer_node->getDims();
+        const dim_t *strides = m_buffer_node->getStrides();
+        const auto &idx = static_cast<TNode<Ti> *>(m_children[0].get())->m_val;
+
+        dim_t pos[4] = {0, y, z, w};
+        pos[m_dim]   = 0;
+        const T *in_ptr =
+            m_buffer_node->getPtr() + pos[1] * strides[1] +
+            pos[2] * strides[2] + pos[3] * strides[3];
+        const dim_t len    = dims[m_dim];
+        const dim_t stride = strides[m_dim];
+        Tc *out_ptr        = this->m_val.data();
+        if (m_dim == 0) {
+            for (int i = 0; i < lim; i++) {
+                dim_t src  = trimIndex(static_cast<int>(idx[i]), len);
+                out_ptr[i] = static_cast<Tc>(in_ptr[src * stride]);
+            }
+        } else {
+            // The index is the same for the whole run along dimension 0
+            in_ptr += trimIndex(static_cast<int>(idx[0]), len) * stride;
+            for (int i = 0; i < lim; i++) {
+                out_ptr[i] = static_cast<Tc>(in_ptr[(x + i) * strides[0]]);
+            }
+        }
+    }
+
+    void getInfo(unsigned &len, unsigned &buf_count,
+                 unsigned &bytes) const final {
+        m_buffer_node->getInfo(len, buf_count, bytes);
+    }
+
+    size_t getBytes() const final { return m_buffer_node->getBytes(); }
+
+    bool isLinear(const dim_t *dims) const final {
+        UNUSED(dims);
+        return false;
+    }
+
+    void genKerName(std::string &kerString,
+                    const common::Node_ids &ids) const final {
+        UNUSED(kerString);
+        UNUSED(ids);
+    }
+
+    void genFuncs(std::stringstream &kerStream,
+                  const common::Node_ids &ids) const final {
+        UNUSED(kerStream);
+        UNUSED(ids);
+    }
+};
+
+}  // namespace jit
+
+}  // namespace cpu
@@ -32,6 +32,9 @@ constexpr int VECTOR_LENGTH = 256;
 template<typename T>
 using array = std::array<T, VECTOR_LENGTH>;
 
+template<typename T>
+class BufferNode;
+
 }  // namespace jit
 
 template<typename T>
@@ -49,6 +52,9 @@ class TNode : public common::Node {
         m_val.fill(static_cast<compute_t<T>>(val));
     }
 
+    /// The buffer the node reads, nullptr if it reads none of its own
+    virtual const jit::BufferNode<T> *getBuffer() const { return nullptr; }
+
     virtual ~TNode() = default;
 };
 
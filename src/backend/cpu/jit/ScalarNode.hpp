@@ -9,6 +9,7 @@
 
 #pragma once
 #include <optypes.hpp>
+#include <cstring>
 #include <vector>
 #include "Node.hpp"
 
@@ -60,6 +61,12 @@ class ScalarNode : public TNode<T> {
     }
 
     bool isScalar() const final { return true; }
+
+    size_t getScalarValue(void *val) const final {
+        constexpr size_t bytes = sizeof(compute_t<T>);
+        if (val) { std::memcpy(val, this->m_val.data(), bytes); }
+        return bytes;
+    }
 };
 }  // namespace jit
 
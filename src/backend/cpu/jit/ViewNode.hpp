@@ -0,0 +1,190 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <common/defines.hpp>
+#include <jit/BufferNode.hpp>
+#include <jit/Node.hpp>
+#include <af/dim4.hpp>
+
+#include <array>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace cpu {
+
+namespace jit {
+
+/// Reads a buffer through a view, so that strided sub-arrays, tiles,
+/// reorders, flips and shifts can be used in a JIT tree without first being
+/// copied.
+///
+/// The output coordinate c along dimension d reads element
+/// (c + shift[d]) % dims[d] of the view along d, m_strides[d] elements apart
+/// starting at m_ptr. Strides may be any value, including negative ones and a
+/// stride other than one along the first dimension, and outputs larger than
+/// the view repeat it. Views compose: reorder, flip, shift and slice return a
+/// new node reading the same buffer.
+template<typename T>
+class ViewNode : public TNode<T> {
+   protected:
+    /// Keeps the buffer alive
+    std::shared_ptr<BufferNode<T>> m_buffer_node;
+    const T *m_ptr;
+    std::array<dim_t, 4> m_dims;
+    std::array<dim_t, 4> m_strides;
+    std::array<dim_t, 4> m_shifts;
+
+    /// Position along \p d of the element read for output coordinate \p c
+    dim_t wrap(dim_t c, int d) const {
+        c += m_shifts[d];
+        return c < m_dims[d] ? c : c % m_dims[d];
+    }
+
+   public:
+    /// Creates a view of the whole buffer, with its dimensions and strides
+    explicit ViewNode(std::shared_ptr<BufferNode<T>> buffer_node)
+        : TNode<T>(T(0), 0, {})
+        , m_buffer_node(std::move(buffer_node))
+        , m_ptr(m_buffer_node->getPtr())
+        , m_shifts{0, 0, 0, 0} {
+        for (int i = 0; i < 4; i++) {
+            m_dims[i]    = m_buffer_node->getDims()[i];
+            m_strides[i] = m_buffer_node->getStrides()[i];
+        }
+    }
+
+    std::unique_ptr<common::Node> clone() final {
+        return std::make_unique<ViewNode>(*this);
+    }
+
+    const BufferNode<T> *getBuffer() const final {
+        return m_buffer_node.get();
+    }
+
+    /// True when an output of dimensions \p odims ends where a period of
+    /// the view ends along every dimension, in which case repeating the
+    /// output is the same as reading the view further.
+    bool isPeriodic(const af::dim4 &odims) const {
+        for (int i = 0; i < 4; i++) {
+            if (odims[i] % m_dims[i] != 0) { return false; }
+        }
+        return true;
+    }
+
+    /// Returns a view whose dimension d reads dimension \p rdims[d] of this
+    /// one
+    std::shared_ptr<ViewNode> reorder(const af::dim4 &rdims) const {
+        auto out = std::make_shared<ViewNode>(*this);
+        for (int i = 0; i < 4; i++) {
+            out->m_dims[i]    = m_dims[rdims[i]];
+            out->m_strides[i] = m_strides[rdims[i]];
+            out->m_shifts[i]  = m_shifts[rdims[i]];
+        }
+        return out;
+    }
+
+    /// Returns this view reversed along \p dim, where the output is \p len
+    /// long along \p dim
+    std::shared_ptr<ViewNode> flip(int dim, dim_t len) const {
+        // Reading from the last element backwards turns index i into
+        // dims - 1 - i, so the shift is chosen such that
+        // dims - 1 - (c + shift') % dims == (shift + len - 1 - c) % dims
+        auto out      = std::make_shared<ViewNode>(*this);
+        const dim_t n = m_dims[dim];
+        out->m_ptr += (n - 1) * m_strides[dim];
+        out->m_strides[dim] = -m_strides[dim];
+        out->m_shifts[dim]  = ((-(m_shifts[dim] + len)) % n + n) % n;
+        return out;
+    }
+
+    /// Returns this view circularly shifted by \p shifts, as af::shift does,
+    /// where the output dimensions are \p odims. Returns nullptr unless
+    /// isPeriodic(odims).
+    std::shared_ptr<ViewNode> shift(const int shifts[4],
+                                    const af::dim4 &odims) const {
+        if (!isPeriodic(odims)) { return nullptr; }
+        auto out = std::make_shared<ViewNode>(*this);
+        for (int i = 0; i < 4; i++) {
+            const dim_t len  = odims[i];
+            const dim_t s    = ((-shifts[i]) % len + len) % len;
+            out->m_shifts[i] = (m_shifts[i] + s) % m_dims[i];
+        }
+        return out;
+    }
+
+    /// Returns the elements begin[d] + c * step[d] of this view, where the
+    /// output dimensions are \p odims. Returns nullptr when a dimension that
+    /// is shifted or repeated is sliced, which would need the view to wrap
+    /// in the middle of a run.
+    std::shared_ptr<ViewNode> slice(const af::dim4 &begin,
+                                    const af::dim4 &step,
+                                    const af::dim4 &odims) const {
+        auto out = std::make_shared<ViewNode>(*this);
+        for (int i = 0; i < 4; i++) {
+            if (begin[i] == 0 && step[i] == 1) { continue; }
+            const dim_t last = begin[i] + (odims[i] - 1) * step[i];
+            if (m_shifts[i] != 0 || begin[i] < 0 || begin[i] >= m_dims[i] ||
+                last < 0 || last >= m_dims[i]) {
+                return nullptr;
+            }
+            out->m_ptr += begin[i] * m_strides[i];
+            out->m_strides[i] = m_strides[i] * step[i];
+            out->m_dims[i]    = odims[i];
+        }
+        return out;
+    }
+
+    void calc(int x, int y, int z, int w, int lim) final {
+        using Tc = compute_t<T>;
+
+        const T *in_ptr = m_ptr + wrap(y, 1) * m_strides[1] +
+                          wrap(z, 2) * m_strides[2] + wrap(w, 3) * m_strides[3];
+        Tc *out_ptr = this->m_val.data();
+        if (m_strides[0] == 1 && m_shifts[0] == 0 && x + lim <= m_dims[0]) {
+            for (int i = 0; i < lim; i++) {
+                out_ptr[i] = static_cast<Tc>(in_ptr[x + i]);
+            }
+        } else {
+            for (int i = 0; i < lim; i++) {
+                const dim_t idx = wrap(x + i, 0) * m_strides[0];
+                out_ptr[i]      = static_cast<Tc>(in_ptr[idx]);
+            }
+        }
+    }
+
+    void getInfo(unsigned &len, unsigned &buf_count,
+                 unsigned &bytes) const final {
+        m_buffer_node->getInfo(len, buf_count, bytes);
+    }
+
+    size_t getBytes() const final { return m_buffer_node->getBytes(); }
+
+    bool isLinear(const dim_t *dims) const final {
+        UNUSED(dims);
+        return false;
+    }
+
+    void genKerName(std::string &kerString,
+                    const common::Node_ids &ids) const final {
+        UNUSED(kerString);
+        UNUSED(ids);
+    }
+
+    void genFuncs(std::stringstream &kerStream,
+                  const common::Node_ids &ids) const final {
+        UNUSED(kerStream);
+        UNUSED(ids);
+    }
+};
+
+}  // namespace jit
+
+}  // namespace cpu
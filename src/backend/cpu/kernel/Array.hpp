@@ -12,6 +12,8 @@
 #include <common/jit/ModdimNode.hpp>
 #include <common/jit/Node.hpp>
 #include <common/jit/NodeIterator.hpp>
+#include <common/jit/Optimizer.hpp>
+#include <half_convert.hpp>
 #include <jit/BufferNode.hpp>
 #include <jit/Node.hpp>
 #include <jit/UnaryNode.hpp>
@@ -22,7 +24,7 @@ namespace cpu {
 namespace kernel {
 
 /// Clones node_index_map and update the child pointers
-std::vector<std::shared_ptr<common::Node>> cloneNodes(
+inline std::vector<std::shared_ptr<common::Node>> cloneNodes(
     const std::vector<common::Node *> &node_index_map,
     const std::vector<common::Node_ids> &ids) {
     using common::Node;
@@ -43,7 +45,7 @@ std::vector<std::shared_ptr<common::Node>> cloneNodes(
 
 /// Sets the shape of the buffer node_index_map under the moddims node to the
 /// new shape
-void propagateModdimsShape(
+inline void propagateModdimsShape(
     std::vector<std::shared_ptr<common::Node>> &node_clones) {
     using common::NodeIterator;
     for (auto &node : node_clones) {
@@ -65,7 +67,7 @@ void propagateModdimsShape(
 }
 
 /// Removes node_index_map whos operation matchs a unary operation \p op.
-void removeNodeOfOperation(
+inline void removeNodeOfOperation(
     std::vector<std::shared_ptr<common::Node>> &node_index_map, af_op_t op) {
     using common::Node;
 
@@ -91,64 +93,159 @@ void removeNodeOfOperation(
 
 /// Returns the cloned output_nodes located in the node_clones array
 ///
-/// This function returns the new cloned version of the output_nodes_ from
-/// the node_clones array. If the output node is a moddim node, then it will
-/// set the output node to be its first non-moddim node child
+/// This function returns the new cloned version of the output nodes, whose
+/// indices in node_clones are given by \p output_ids. If the output node is a
+/// moddim node, then it will set the output node to be its first non-moddim
+/// node child
 template<typename T>
 std::vector<TNode<T> *> getClonedOutputNodes(
-    common::Node_map_t &node_index_map,
-    const std::vector<std::shared_ptr<common::Node>> &node_clones,
-    const std::vector<common::Node_ptr> &output_nodes_) {
+    const std::vector<int> &output_ids,
+    const std::vector<std::shared_ptr<common::Node>> &node_clones) {
     std::vector<TNode<T> *> cloned_output_nodes;
-    cloned_output_nodes.reserve(output_nodes_.size());
-    for (auto &n : output_nodes_) {
-        TNode<T> *ptr;
-        if (n->getOp() == af_moddims_t) {
-            // if the output node is a moddims node, then set the output node
-            // to be the child of the moddims node. This is necessary because
-            // we remove the moddim node_index_map from the tree later
-            int child_index = node_index_map[n->m_children[0].get()];
-            ptr = static_cast<TNode<T> *>(node_clones[child_index].get());
-            while (ptr->getOp() == af_moddims_t) {
-                ptr = static_cast<TNode<T> *>(ptr->m_children[0].get());
-            }
-        } else {
-            int node_index = node_index_map[n.get()];
-            ptr = static_cast<TNode<T> *>(node_clones[node_index].get());
+    cloned_output_nodes.reserve(output_ids.size());
+    for (int id : output_ids) {
+        // if the output node is a moddims node, then set the output node
+        // to be the child of the moddims node. This is necessary because
+        // we remove the moddim node_index_map from the tree later
+        common::Node *ptr = node_clones[id].get();
+        while (ptr->getOp() == af_moddims_t) {
+            ptr = ptr->m_children[0].get();
         }
-        cloned_output_nodes.push_back(ptr);
+        cloned_output_nodes.push_back(static_cast<TNode<T> *>(ptr));
     }
     return cloned_output_nodes;
 }
 
+/// Clones the trees of \p output_nodes_ into a list of nodes that can be
+/// evaluated in order and returns it. The clones of the output nodes are
+/// written to \p cloned_output_nodes.
+template<typename T>
+std::vector<std::shared_ptr<common::Node>> prepareNodes(
+    const std::vector<common::Node_ptr> &output_nodes_,
+    std::vector<TNode<T> *> &cloned_output_nodes) {
+    common::Node_map_t node_index_map;
+    std::vector<common::Node *> full_nodes;
+    std::vector<common::Node_ids> ids;
+    std::vector<int> output_ids;
+
+    for (auto &node : output_nodes_) {
+        output_ids.push_back(
+            node->getNodesMap(node_index_map, full_nodes, ids));
+    }
+
+    std::vector<common::Node_ptr> optimized_nodes;
+    common::optimizeNodes(full_nodes, ids, output_ids, optimized_nodes);
+    auto node_clones = cloneNodes(full_nodes, ids);
+
+    cloned_output_nodes = getClonedOutputNodes<T>(output_ids, node_clones);
+    propagateModdimsShape(node_clones);
+    removeNodeOfOperation(node_clones, af_moddims_t);
+    return node_clones;
+}
+
+/// Evaluates the tree of \p node over \p dims without writing it to memory.
+///
+/// \p fn(vals, lim, x, y, z, w) is called once for every run of \p lim
+/// (at most jit::VECTOR_LENGTH) values starting at (x, y, z, w). The runs
+/// never cross dimension 0 and are visited in memory order.
+template<typename T, typename F>
+void evalNodeColumns(const common::Node_ptr &node, const af::dim4 &dims,
+                     F &&fn) {
+    std::vector<TNode<T> *> outputs;
+    auto node_clones = prepareNodes<T>({node}, outputs);
+
+    const int num_nodes     = static_cast<int>(node_clones.size());
+    const compute_t<T> *val = outputs[0]->m_val.data();
+    const int dim0          = static_cast<int>(dims[0]);
+    for (int w = 0; w < (int)dims[3]; w++) {
+        for (int z = 0; z < (int)dims[2]; z++) {
+            for (int y = 0; y < (int)dims[1]; y++) {
+                for (int x = 0; x < dim0; x += jit::VECTOR_LENGTH) {
+                    int lim = std::min(jit::VECTOR_LENGTH, dim0 - x);
+                    for (int n = 0; n < num_nodes; n++) {
+                        node_clones[n]->calc(x, y, z, w, lim);
+                    }
+                    fn(val, lim, x, y, z, w);
+                }
+            }
+        }
+    }
+}
+
+/// Evaluates the tree of \p node over \p dims for a reduction along \p dim,
+/// without writing it to memory. The outputs are visited in blocks whose
+/// inputs are all evaluated before the next block starts, so the partial
+/// results of a block fit in a buffer of jit::VECTOR_LENGTH elements.
+///
+/// A block is \p n outputs starting at (x, y, z, w), whose coordinate along
+/// \p dim is 0: a single output when \p dim is 0, and up to
+/// jit::VECTOR_LENGTH consecutive outputs along dimension 0 otherwise.
+/// \p begin(n) opens a block and \p end(x, y, z, w, n) closes it. In
+/// between, \p fn(vals, lim) is called for the inputs of the block in
+/// increasing order along \p dim: lim values along dimension 0 for each of
+/// them when \p dim is 0, or one value for each output of the block.
+template<typename T, typename Begin, typename F, typename End>
+void evalNodeAlong(const common::Node_ptr &node, const af::dim4 &dims,
+                   const int dim, Begin &&begin, F &&fn, End &&end) {
+    std::vector<TNode<T> *> outputs;
+    auto node_clones = prepareNodes<T>({node}, outputs);
+
+    const int num_nodes     = static_cast<int>(node_clones.size());
+    const compute_t<T> *val = outputs[0]->m_val.data();
+    const int dim0          = static_cast<int>(dims[0]);
+    const int len           = static_cast<int>(dims[dim]);
+    int odims[4]            = {dim0, static_cast<int>(dims[1]),
+                               static_cast<int>(dims[2]),
+                               static_cast<int>(dims[3])};
+    odims[dim]              = 1;
+
+    auto calc = [&](int x, int y, int z, int w, int lim) {
+        for (int n = 0; n < num_nodes; n++) {
+            node_clones[n]->calc(x, y, z, w, lim);
+        }
+        fn(val, lim);
+    };
+
+    for (int w = 0; w < odims[3]; w++) {
+        for (int z = 0; z < odims[2]; z++) {
+            for (int y = 0; y < odims[1]; y++) {
+                if (dim == 0) {
+                    begin(1);
+                    for (int x = 0; x < dim0; x += jit::VECTOR_LENGTH) {
+                        const int lim = std::min(jit::VECTOR_LENGTH, dim0 - x);
+                        calc(x, y, z, w, lim);
+                    }
+                    end(0, y, z, w, 1);
+                    continue;
+                }
+                for (int x = 0; x < dim0; x += jit::VECTOR_LENGTH) {
+                    const int lim = std::min(jit::VECTOR_LENGTH, dim0 - x);
+                    int pos[4]    = {x, y, z, w};
+                    begin(lim);
+                    for (int i = 0; i < len; i++) {
+                        pos[dim] = i;
+                        calc(x, pos[1], pos[2], pos[3], lim);
+                    }
+                    end(x, y, z, w, lim);
+                }
+            }
+        }
+    }
+}
+
 template<typename T>
 void evalMultiple(std::vector<Param<T>> arrays,
                   std::vector<common::Node_ptr> output_nodes_) {
-    using common::ModdimNode;
-    using common::Node;
-    using common::Node_map_t;
-    using common::NodeIterator;
-
     af::dim4 odims = arrays[0].dims();
     af::dim4 ostrs = arrays[0].strides();
 
-    Node_map_t node_index_map;
     std::vector<T *> ptrs;
-    std::vector<common::Node *> full_nodes;
-    std::vector<common::Node_ids> ids;
-
     int narrays = static_cast<int>(arrays.size());
     ptrs.reserve(narrays);
-    for (int i = 0; i < narrays; i++) {
-        ptrs.push_back(arrays[i].get());
-        output_nodes_[i]->getNodesMap(node_index_map, full_nodes, ids);
-    }
-    auto node_clones = cloneNodes(full_nodes, ids);
+    for (int i = 0; i < narrays; i++) { ptrs.push_back(arrays[i].get()); }
 
-    std::vector<TNode<T> *> cloned_output_nodes =
-        getClonedOutputNodes<T>(node_index_map, node_clones, output_nodes_);
-    propagateModdimsShape(node_clones);
-    removeNodeOfOperation(node_clones, af_moddims_t);
+    std::vector<TNode<T> *> cloned_output_nodes;
+    auto node_clones = prepareNodes<T>(output_nodes_, cloned_output_nodes);
 
     bool is_linear = true;
     for (auto &node : node_clones) { is_linear &= node->isLinear(odims.get()); }
@@ -165,9 +262,8 @@ void evalMultiple(std::vector<Param<T>> arrays,
                 node_clones[n]->calc(i, lim);
             }
             for (int n = 0; n < num_output_nodes; n++) {
-                std::copy(cloned_output_nodes[n]->m_val.begin(),
-                          cloned_output_nodes[n]->m_val.begin() + lim,
-                          ptrs[n] + i);
+                convertValues(ptrs[n] + i, cloned_output_nodes[n]->m_val.data(),
+                              lim);
             }
         }
     } else {
@@ -191,10 +287,9 @@ void evalMultiple(std::vector<Param<T>> arrays,
                             node_clones[n]->calc(x, y, z, w, lim);
                         }
                         for (int n = 0; n < num_output_nodes; n++) {
-                            std::copy(
-                                cloned_output_nodes[n]->m_val.begin(),
-                                cloned_output_nodes[n]->m_val.begin() + lim,
-                                ptrs[n] + id);
+                            convertValues(ptrs[n] + id,
+                                          cloned_output_nodes[n]->m_val.data(),
+                                          lim);
                         }
                     }
                 }
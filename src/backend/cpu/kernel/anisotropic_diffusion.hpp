@@ -11,10 +11,13 @@
 
 #include <Array.hpp>
 #include <math.hpp>
+#include <thread_pool.hpp>
 
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstring>
+#include <vector>
 
 using std::exp;
 using std::pow;
@@ -23,168 +26,286 @@ using std::sqrt;
 namespace cpu {
 namespace kernel {
 
-int index(int x, int y, int stride1) { return y * stride1 + x; }
-
-float quad(float value) { return 1.0f / (1.0f + value); }
-
-float computeGradientBasedUpdate(const float mct, const float NW, const float N,
-                                 const float NE, const float W, const float C,
-                                 const float E, const float SW, const float S,
-                                 const float SE,
-                                 const af_flux_function fftype) {
-    float delta = 0.f;
-
-    float dx, dy, df, db, cx, cxd;
-
-    // centralized derivatives
-    dx = (E - W) * 0.5f;
-    dy = (S - N) * 0.5f;
-
-    // half-d's and conductance along first dimension
-    df = E - C;
-    db = C - W;
+inline float quad(float value) { return 1.0f / (1.0f + value); }
+
+// The update of a pixel is the sum of the fluxes through the four edges to
+// its neighbours, and the flux through an edge is the same for the pixels
+// on both sides of it. The fluxes are computed once per edge: for the edges
+// along dimension 0 of a column, and for the edges from one column to the
+// next, which the next column reuses.
+
+/// Flux through an edge, from the difference \p d of the pixels on its two
+/// sides and the sum \p across of their central differences along the
+/// other dimension
+template<bool isMCDE>
+inline float edgeFlux(const float d, const float across, const float mct,
+                      const af_flux_function fftype) {
+    const float gmsq = d * d + 0.25f * pow(across, 2.f);
+    if (isMCDE) { return (d / sqrt(1.0e-10f + gmsq)) * exp(gmsq * mct); }
+    const float c = fftype == AF_FLUX_EXPONENTIAL ? exp(gmsq * mct)
+                                                  : quad(gmsq * mct);
+    return c * d;
+}
 
-    float gmsqf = (df * df + 0.25f * pow(dy + 0.5f * (SE - NE), 2.f)) * mct;
-    float gmsqb = (db * db + 0.25f * pow(dy + 0.5f * (SW - NW), 2.f)) * mct;
-    if (fftype == AF_FLUX_EXPONENTIAL) {
-        cx  = exp(gmsqf);
-        cxd = exp(gmsqb);
-    } else {
-        cx  = quad(gmsqf);
-        cxd = quad(gmsqb);
-    }
-    delta = (cx * df - cxd * db);
-
-    // half-d's and conductance along second dimension
-    df = S - C;
-    db = C - N;
-
-    gmsqf = (df * df + 0.25f * pow(dx + 0.5f * (SE - SW), 2.f)) * mct;
-    gmsqb = (db * db + 0.25f * pow(dx + 0.5f * (NE - NW), 2.f)) * mct;
-    if (fftype == AF_FLUX_EXPONENTIAL) {
-        cx  = exp(gmsqf);
-        cxd = exp(gmsqb);
-    } else {
-        cx  = quad(gmsqf);
-        cxd = quad(gmsqb);
+/// Fluxes through the edges from \p left to \p right, the column after it,
+/// for the pixels 1 to d0 - 2
+template<typename T, bool isMCDE>
+void acrossFlux(float* flux, const T* left, const T* right, const int d0,
+                const float mct, const af_flux_function fftype) {
+    for (int i = 1; i < d0 - 1; ++i) {
+        const float dl = ((float)left[i + 1] - (float)left[i - 1]) * 0.5f;
+        const float dr = 0.5f * ((float)right[i + 1] - (float)right[i - 1]);
+        flux[i] = edgeFlux<isMCDE>((float)right[i] - (float)left[i], dl + dr,
+                                   mct, fftype);
     }
-    delta += (cx * df - cxd * db);
-
-    return delta;
 }
 
-float computeCurvatureBasedUpdate(const float mct, const float NW,
-                                  const float N, const float NE, const float W,
-                                  const float C, const float E, const float SW,
-                                  const float S, const float SE) {
-    float delta     = 0.f;
-    float prop_grad = 0.f;
-
-    float df0, db0;
-    float dx, dy, df, db, cx, cxd, gmf, gmb, gmsqf, gmsqb;
-
-    // centralized derivatives
-    dx = (E - W) * 0.5f;
-    dy = (S - N) * 0.5f;
-
-    // half-d's and conductance along first dimension
-    df  = E - C;
-    db  = C - W;
-    df0 = df;
-    db0 = db;
-
-    gmsqf = (df * df + 0.25f * pow(dy + 0.5f * (SE - NE), 2.f));
-    gmsqb = (db * db + 0.25f * pow(dy + 0.5f * (SW - NW), 2.f));
-
-    gmf = sqrt(1.0e-10f + gmsqf);
-    gmb = sqrt(1.0e-10f + gmsqb);
-
-    cx  = exp(gmsqf * mct);
-    cxd = exp(gmsqb * mct);
-
-    delta = ((df / gmf) * cx - (db / gmb) * cxd);
+/// Updates one column from the previous iteration's columns \p prev, \p cur
+/// and \p next. \p left holds the fluxes from \p prev to \p cur, \p right
+/// is set to the fluxes from \p cur to \p next and \p down is scratch. The
+/// first and last pixels are copied.
+template<typename T, bool isMCDE>
+void diffuseColumn(T* out, const T* prev, const T* cur, const T* next,
+                   const float* left, float* right, float* down, const int d0,
+                   const float dt, const float mct,
+                   const af_flux_function fftype) {
+    acrossFlux<T, isMCDE>(right, cur, next, d0, mct, fftype);
+    for (int i = 0; i < d0 - 1; ++i) {
+        const float dc = ((float)next[i] - (float)prev[i]) * 0.5f;
+        const float dn = 0.5f * ((float)next[i + 1] - (float)prev[i + 1]);
+        down[i] = edgeFlux<isMCDE>((float)cur[i + 1] - (float)cur[i], dc + dn,
+                                   mct, fftype);
+    }
 
-    // half-d's and conductance along second dimension
-    df = S - C;
-    db = C - N;
+    out[0] = cur[0];
+    for (int i = 1; i < d0 - 1; ++i) {
+        const float C = cur[i];
+        float delta   = (down[i] - down[i - 1]) + (right[i] - left[i]);
+        if (isMCDE) {
+            const float df0 = (float)cur[i + 1] - C;
+            const float db0 = C - (float)cur[i - 1];
+            const float df  = (float)next[i] - C;
+            const float db  = C - (float)prev[i];
+
+            float prop_grad = 0.f;
+            if (delta > 0.f) {
+                prop_grad += (pow(fminf(db0, 0.0f), 2.0f) +
+                              pow(fmaxf(df0, 0.0f), 2.0f));
+                prop_grad +=
+                    (pow(fminf(db, 0.0f), 2.0f) + pow(fmaxf(df, 0.0f), 2.0f));
+            } else {
+                prop_grad += (pow(fmaxf(db0, 0.0f), 2.0f) +
+                              pow(fminf(df0, 0.0f), 2.0f));
+                prop_grad +=
+                    (pow(fmaxf(db, 0.0f), 2.0f) + pow(fminf(df, 0.0f), 2.0f));
+            }
+            delta = sqrt(prop_grad) * delta;
+        }
+        out[i] = (T)(C + delta * dt);
+    }
+    if (d0 > 1) { out[d0 - 1] = cur[d0 - 1]; }
+}
 
-    gmsqf = (df * df + 0.25f * pow(dx + 0.5f * (SE - SW), 2.f));
-    gmsqb = (db * db + 0.25f * pow(dx + 0.5f * (NE - NW), 2.f));
-    gmf   = sqrt(1.0e-10f + gmsqf);
-    gmb   = sqrt(1.0e-10f + gmsqb);
+/// Sum of the squared gradients along dimension 0 of one column, with the
+/// one sided differences of gradient() at both ends
+template<typename T>
+double columnEnergy(const T* col, const int d0) {
+    if (d0 < 2) { return 0.0; }
+    double sum = 0.0;
+    for (int i = 1; i < d0 - 1; ++i) {
+        const float g = 0.5f * (float)(col[i + 1] - col[i - 1]);
+        sum += g * g;
+    }
+    const float g0 = (float)(col[1] - col[0]);
+    const float g1 = (float)(col[d0 - 1] - col[d0 - 2]);
+    return sum + g0 * g0 + g1 * g1;
+}
 
-    cx  = exp(gmsqf * mct);
-    cxd = exp(gmsqb * mct);
+/// Columns [first, last] that the gradient along dimension 1 at column
+/// \p j depends on
+inline void acrossColumns(int& first, int& last, const int j, const int d1) {
+    first = std::max(j - 1, 0);
+    last  = std::min(j + 1, d1 - 1);
+}
 
-    delta += ((df / gmf) * cx - (db / gmb) * cxd);
+/// Sum of the squared gradients along dimension 1 at column \p j of \p img
+template<typename T>
+double acrossEnergy(const T* img, const dim_t stride1, const int j,
+                    const int d0, const int d1) {
+    if (d1 < 2) { return 0.0; }
+    int first, last;
+    acrossColumns(first, last, j, d1);
+    const float f = (j == 0 || j == d1 - 1) ? 1.f : 0.5f;
+    const T* l    = img + first * stride1;
+    const T* r    = img + last * stride1;
+    double sum    = 0.0;
+    for (int i = 0; i < d0; ++i) {
+        const float g = f * (float)(r[i] - l[i]);
+        sum += g * g;
+    }
+    return sum;
+}
 
-    if (delta > 0.f) {
-        prop_grad +=
-            (pow(fminf(db0, 0.0f), 2.0f) + pow(fmaxf(df0, 0.0f), 2.0f));
-        prop_grad += (pow(fminf(db, 0.0f), 2.0f) + pow(fmaxf(df, 0.0f), 2.0f));
-    } else {
-        prop_grad +=
-            (pow(fmaxf(db0, 0.0f), 2.0f) + pow(fminf(df0, 0.0f), 2.0f));
-        prop_grad += (pow(fmaxf(db, 0.0f), 2.0f) + pow(fminf(df, 0.0f), 2.0f));
+/// Image slices split into strips of whole columns, the unit of work of the
+/// threads
+struct diffusion_strips {
+    diffusion_strips(const af::dim4& dims)
+        : d0(dims[0])
+        , d1(dims[1])
+        , d2(dims[2])
+        , slices(dims[2] * dims[3])
+        , width(grainSize(4 * dims[0]))
+        , perSlice((dims[1] + width - 1) / width) {}
+
+    dim_t count() const { return slices * perSlice; }
+
+    /// Offset of the slice of strip \p s
+    dim_t offset(dim_t s, const af::dim4& strides) const {
+        const dim_t slice = s / perSlice;
+        return (slice % d2) * strides[2] + (slice / d2) * strides[3];
     }
 
-    return sqrt(prop_grad) * delta;
+    /// First column of strip \p s
+    int begin(dim_t s) const { return (s % perSlice) * width; }
+
+    /// One past the last column of strip \p s
+    int end(dim_t s) const { return std::min<int>(begin(s) + width, d1); }
+
+    const int d0, d1;
+    const dim_t d2, slices, width, perSlice;
+};
+
+/// Sum of the squared gradients of \p in, as computed by gradient(), over
+/// all its slices
+template<typename T>
+double gradientEnergy(CParam<T> in) {
+    const af::dim4 dims    = in.dims();
+    const af::dim4 strides = in.strides();
+    const diffusion_strips strips(dims);
+
+    std::vector<double> partial(strips.count(), 0.0);
+    threadPool().parallel_for(
+        0, strips.count(), 1, [&](dim_t begin, dim_t end) {
+            for (dim_t s = begin; s < end; ++s) {
+                const T* img = in.get() + strips.offset(s, strides);
+                for (int j = strips.begin(s); j < strips.end(s); ++j) {
+                    partial[s] += columnEnergy(img + j * strides[1], strips.d0);
+                    partial[s] +=
+                        acrossEnergy(img, strides[1], j, strips.d0, strips.d1);
+                }
+            }
+        });
+
+    double sum = 0.0;
+    for (double p : partial) { sum += p; }
+    return sum;
 }
 
+/// One explicit step of the diffusion from \p in to \p out. Every thread
+/// updates a strip of columns and, while the columns it wrote are still in
+/// cache, sums the squared gradients of the result that \p energy returns.
+/// The terms that need a column of another strip are added at the end.
 template<typename T, bool isMCDE>
-void anisotropicDiffusion(Param<T> inout, const float dt, const float mct,
-                          const af_flux_function fftype) {
-    const auto dims     = inout.dims();
-    const auto strides  = inout.strides();
-    const auto d1stride = strides[1];
-    const int d0        = dims[0] - 1;
-    const int d1        = dims[1] - 1;
-    const int d2        = dims[2];
-    const int d3        = dims[3];
-
-    for (int b3 = 0; b3 < d3; ++b3) {
-        for (int b2 = 0; b2 < d2; ++b2) {
-            T* img = inout.get() + b2 * strides[2] + b3 * strides[3];
-            for (int j = 1; j < d1; ++j) {
-                for (int i = 1; i < d0; ++i) {
-                    float C     = 0.f;
-                    float delta = 0.f;
-
-                    const int ip1 = i + 1;
-                    const int im1 = i - 1;
-                    const int jp1 = j + 1;
-                    const int jm1 = j - 1;
-
-                    if (isMCDE) {
-                        delta = computeCurvatureBasedUpdate(
-                            mct, img[index(im1, jm1, d1stride)],
-                            img[index(i, jm1, d1stride)],
-                            img[index(ip1, jm1, d1stride)],
-                            img[index(im1, j, d1stride)],
-                            C = img[index(i, j, d1stride)],
-                            img[index(ip1, j, d1stride)],
-                            img[index(im1, jp1, d1stride)],
-                            img[index(i, jp1, d1stride)],
-                            img[index(ip1, jp1, d1stride)]);
-
+void diffusionStep(Param<T> out, CParam<T> in, const float dt,
+                   const float mct, const af_flux_function fftype,
+                   double* energy) {
+    const af::dim4 dims    = in.dims();
+    const af::dim4 strides = in.strides();
+    const diffusion_strips strips(dims);
+    const int d0 = strips.d0, d1 = strips.d1;
+
+    std::vector<double> partial(strips.count(), 0.0);
+    threadPool().parallel_for(
+        0, strips.count(), 1, [&](dim_t begin, dim_t end) {
+            for (dim_t s = begin; s < end; ++s) {
+                const T* src = in.get() + strips.offset(s, strides);
+                T* dst       = out.get() + strips.offset(s, strides);
+                const int b  = strips.begin(s);
+                const int e  = strips.end(s);
+
+                std::vector<float> left(d0), right(d0), down(d0);
+                if (b > 0 && b < d1 - 1) {
+                    acrossFlux<T, isMCDE>(left.data(),
+                                          src + (b - 1) * strides[1],
+                                          src + b * strides[1], d0, mct,
+                                          fftype);
+                }
+                for (int j = b; j < e; ++j) {
+                    T* col = dst + j * strides[1];
+                    if (j == 0 || j == d1 - 1) {
+                        std::memcpy(col, src + j * strides[1], d0 * sizeof(T));
+                        if (j == 0 && d1 > 2) {
+                            acrossFlux<T, isMCDE>(left.data(), src,
+                                                  src + strides[1], d0, mct,
+                                                  fftype);
+                        }
                     } else {
-                        delta = computeGradientBasedUpdate(
-                            mct, img[index(im1, jm1, d1stride)],
-                            img[index(i, jm1, d1stride)],
-                            img[index(ip1, jm1, d1stride)],
-                            img[index(im1, j, d1stride)],
-                            C = img[index(i, j, d1stride)],
-                            img[index(ip1, j, d1stride)],
-                            img[index(im1, jp1, d1stride)],
-                            img[index(i, jp1, d1stride)],
-                            img[index(ip1, jp1, d1stride)], fftype);
+                        diffuseColumn<T, isMCDE>(
+                            col, src + (j - 1) * strides[1],
+                            src + j * strides[1], src + (j + 1) * strides[1],
+                            left.data(), right.data(), down.data(), d0, dt,
+                            mct, fftype);
+                        std::swap(left, right);
+                    }
+                    if (!energy) { continue; }
+
+                    partial[s] += columnEnergy(col, d0);
+                    // Columns whose gradient across needs no other strip
+                    // and no column after j
+                    for (int k = std::max(j - 1, b); k <= j; ++k) {
+                        int first, last;
+                        acrossColumns(first, last, k, d1);
+                        if (first >= b && last == j) {
+                            partial[s] +=
+                                acrossEnergy(dst, strides[1], k, d0, d1);
+                        }
                     }
-
-                    img[i + j * d1stride] = (T)(C + delta * dt);
                 }
             }
+        });
+
+    if (!energy) { return; }
+
+    double sum = 0.0;
+    for (dim_t s = 0; s < strips.count(); ++s) {
+        const T* dst = out.get() + strips.offset(s, strides);
+        const int b  = strips.begin(s);
+        const int e  = strips.end(s);
+
+        sum += partial[s];
+        for (int k = b; k < e; k += std::max(e - 1 - b, 1)) {
+            int first, last;
+            acrossColumns(first, last, k, d1);
+            if (first < b || last >= e) {
+                sum += acrossEnergy(dst, strides[1], k, d0, d1);
+            }
         }
     }
+    *energy = sum;
+}
+
+/// Runs \p iterations steps of the diffusion on \p inout. Each step reads
+/// one buffer and writes the other, and sums the squared gradients of what
+/// it wrote for the conductance scale of the next step, so an iteration is
+/// a single pass over the image.
+template<typename T, bool isMCDE>
+void diffuseIterations(Param<T> inout, Param<T> tmp, const float dt,
+                       const float K, const unsigned iterations,
+                       const af_flux_function fftype) {
+    const af::dim4 dims = inout.dims();
+    const float cnst    = -2.0f * K * K / dims.elements();
+
+    Param<T> buffers[2] = {inout, tmp};
+    double energy       = gradientEnergy<T>(inout);
+    for (unsigned i = 0; i < iterations; ++i) {
+        const float mct = 1.0f / (cnst * static_cast<float>(energy));
+        const bool last = i + 1 == iterations;
+        diffusionStep<T, isMCDE>(buffers[(i + 1) % 2], buffers[i % 2], dt,
+                                 mct, fftype, last ? nullptr : &energy);
+    }
+    if (iterations % 2) {
+        std::memcpy(inout.get(), tmp.get(), dims.elements() * sizeof(T));
+    }
 }
 }  // namespace kernel
 }  // namespace cpu
@@ -0,0 +1,488 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <math.hpp>
+#include <types.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+namespace batched {
+
+// Batched dense linear algebra for many small square matrices.
+//
+// LAPACK is called once per matrix which, for orders in the single digits,
+// spends far more time in argument checking and blocking logic than in the
+// actual factorization. The routines here instead gather `lanes<T>()`
+// matrices of a batch into an interleaved (structure of arrays) tile where
+// element (i, j) of every matrix is stored contiguously. Every inner loop then
+// runs across the batch which the compiler vectorizes, and orders up to
+// kMaxUnrolledOrder are instantiated with a compile time size so that the
+// loops over rows and columns are fully unrolled.
+
+/// Largest matrix order handled by the batched routines
+constexpr int kMaxOrder = 64;
+
+/// Orders up to this value are specialized at compile time
+constexpr int kMaxUnrolledOrder = 8;
+
+/// Number of matrices interleaved in a tile. Sized to fill a 256-bit register
+template<typename T>
+constexpr int lanes() {
+    return (32 / static_cast<int>(sizeof(T))) < 2
+               ? 2
+               : (32 / static_cast<int>(sizeof(T)));
+}
+
+/// Returns true if a matrix (or batch of matrices) of shape \p dims should be
+/// processed by the batched routines instead of per-matrix LAPACK calls
+inline bool useBatched(const af::dim4 &dims) {
+    const dim_t n = dims[0];
+    if (n != dims[1] || n > kMaxOrder) { return false; }
+    return (dims[2] * dims[3] > 1) || n <= kMaxUnrolledOrder;
+}
+
+template<typename T>
+inline T conjugate(T val) {
+    return val;
+}
+template<>
+inline cfloat conjugate(cfloat val) {
+    return std::conj(val);
+}
+template<>
+inline cdouble conjugate(cdouble val) {
+    return std::conj(val);
+}
+
+// Matches the magnitude used by i?amax so pivots agree with LAPACK
+inline float pivotMagnitude(float val) { return std::abs(val); }
+inline double pivotMagnitude(double val) { return std::abs(val); }
+inline float pivotMagnitude(cfloat val) {
+    return std::abs(val.real()) + std::abs(val.imag());
+}
+inline double pivotMagnitude(cdouble val) {
+    return std::abs(val.real()) + std::abs(val.imag());
+}
+
+inline double realPart(float val) { return val; }
+inline double realPart(double val) { return val; }
+inline double realPart(cfloat val) { return val.real(); }
+inline double realPart(cdouble val) { return val.real(); }
+
+/// Offset of matrix \p idx of a batch laid out along dimensions 2 and 3
+inline dim_t batchOffset(const af::dim4 &dims, const af::dim4 &strides,
+                         dim_t idx) {
+    return (idx % dims[2]) * strides[2] + (idx / dims[2]) * strides[3];
+}
+
+/// Copies up to lanes<T>() matrices starting at batch index \p first into the
+/// interleaved tile. Unused lanes are filled with the identity so that they
+/// never produce a singular pivot.
+template<typename T>
+void gather(T *tile, CParam<T> in, dim_t first, bool identityFill) {
+    constexpr int L     = lanes<T>();
+    const af::dim4 dims = in.dims();
+    const af::dim4 st   = in.strides();
+    const dim_t rows    = dims[0];
+    const dim_t cols    = dims[1];
+    const dim_t count   = dims[2] * dims[3];
+    const T *iptr       = in.get();
+
+    for (int l = 0; l < L; ++l) {
+        const dim_t idx = first + l;
+        if (idx < count) {
+            const T *mat = iptr + batchOffset(dims, st, idx);
+            for (dim_t j = 0; j < cols; ++j) {
+                for (dim_t i = 0; i < rows; ++i) {
+                    tile[(j * rows + i) * L + l] = mat[j * st[1] + i];
+                }
+            }
+        } else {
+            for (dim_t j = 0; j < cols; ++j) {
+                for (dim_t i = 0; i < rows; ++i) {
+                    tile[(j * rows + i) * L + l] =
+                        scalar<T>((identityFill && i == j) ? 1.0 : 0.0);
+                }
+            }
+        }
+    }
+}
+
+/// Writes the valid lanes of the interleaved tile back to \p out
+template<typename T>
+void scatter(Param<T> out, const T *tile, dim_t first) {
+    constexpr int L     = lanes<T>();
+    const af::dim4 dims = out.dims();
+    const af::dim4 st   = out.strides();
+    const dim_t rows    = dims[0];
+    const dim_t cols    = dims[1];
+    const dim_t count   = dims[2] * dims[3];
+    T *optr             = out.get();
+
+    for (int l = 0; l < L && first + l < count; ++l) {
+        T *mat = optr + batchOffset(dims, st, first + l);
+        for (dim_t j = 0; j < cols; ++j) {
+            for (dim_t i = 0; i < rows; ++i) {
+                mat[j * st[1] + i] = tile[(j * rows + i) * L + l];
+            }
+        }
+    }
+}
+
+// The tile routines below take the order both as a template parameter (NF)
+// and as a runtime argument. When NF is non zero it overrides the runtime
+// value so that all loop bounds are compile time constants.
+
+/// LU factorization with partial pivoting of every lane of \p a (n x n).
+/// Pivots are 1-based as in LAPACK and stored as ipiv[k * L + lane].
+template<typename T, int NF>
+void getrfTile(T *a, int *ipiv, int *info, const int n_) {
+    constexpr int L = lanes<T>();
+    const int n     = NF > 0 ? NF : n_;
+    using BT        = decltype(pivotMagnitude(T()));
+
+    for (int k = 0; k < n; ++k) {
+        int p[L];
+        BT best[L];
+        for (int l = 0; l < L; ++l) {
+            p[l]    = k;
+            best[l] = pivotMagnitude(a[(k * n + k) * L + l]);
+        }
+        for (int i = k + 1; i < n; ++i) {
+            for (int l = 0; l < L; ++l) {
+                const BT mag = pivotMagnitude(a[(k * n + i) * L + l]);
+                if (mag > best[l]) {
+                    best[l] = mag;
+                    p[l]    = i;
+                }
+            }
+        }
+
+        for (int l = 0; l < L; ++l) {
+            ipiv[k * L + l] = p[l] + 1;
+            if (p[l] == k) { continue; }
+            for (int j = 0; j < n; ++j) {
+                std::swap(a[(j * n + k) * L + l], a[(j * n + p[l]) * L + l]);
+            }
+        }
+
+        // As in LAPACK, a zero pivot is recorded and its column is left
+        // unscaled; the factorization goes on with the next column
+        T rcp[L];
+        for (int l = 0; l < L; ++l) {
+            const T piv = a[(k * n + k) * L + l];
+            if (piv == scalar<T>(0)) {
+                if (info[l] == 0) { info[l] = k + 1; }
+                rcp[l] = scalar<T>(1);
+            } else {
+                rcp[l] = scalar<T>(1) / piv;
+            }
+        }
+
+        T *colk = a + (k * n) * L;
+        for (int i = k + 1; i < n; ++i) {
+            for (int l = 0; l < L; ++l) { colk[i * L + l] *= rcp[l]; }
+        }
+
+        for (int j = k + 1; j < n; ++j) {
+            T *colj = a + (j * n) * L;
+            for (int i = k + 1; i < n; ++i) {
+                for (int l = 0; l < L; ++l) {
+                    colj[i * L + l] -= colk[i * L + l] * colj[k * L + l];
+                }
+            }
+        }
+    }
+}
+
+/// Solves op(A) X = B in place for triangular A (n x n) and B (n x nrhs)
+template<typename T, int NF>
+void trsmTile(T *b, const T *a, const int n_, const int nrhs, bool is_upper,
+              bool is_unit) {
+    constexpr int L = lanes<T>();
+    const int n     = NF > 0 ? NF : n_;
+
+    for (int c = 0; c < nrhs; ++c) {
+        T *x = b + (c * n) * L;
+        if (is_upper) {
+            for (int i = n - 1; i >= 0; --i) {
+                const T *coli = a + (i * n) * L;
+                if (!is_unit) {
+                    for (int l = 0; l < L; ++l) {
+                        x[i * L + l] /= coli[i * L + l];
+                    }
+                }
+                for (int r = 0; r < i; ++r) {
+                    for (int l = 0; l < L; ++l) {
+                        x[r * L + l] -= coli[r * L + l] * x[i * L + l];
+                    }
+                }
+            }
+        } else {
+            for (int i = 0; i < n; ++i) {
+                const T *coli = a + (i * n) * L;
+                if (!is_unit) {
+                    for (int l = 0; l < L; ++l) {
+                        x[i * L + l] /= coli[i * L + l];
+                    }
+                }
+                for (int r = i + 1; r < n; ++r) {
+                    for (int l = 0; l < L; ++l) {
+                        x[r * L + l] -= coli[r * L + l] * x[i * L + l];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// Solves A X = B in place using the factorization from getrfTile
+template<typename T, int NF>
+void getrsTile(T *b, const T *a, const int *ipiv, const int n_,
+               const int nrhs) {
+    constexpr int L = lanes<T>();
+    const int n     = NF > 0 ? NF : n_;
+
+    for (int i = 0; i < n; ++i) {
+        for (int l = 0; l < L; ++l) {
+            const int p = ipiv[i * L + l] - 1;
+            if (p == i) { continue; }
+            for (int c = 0; c < nrhs; ++c) {
+                std::swap(b[(c * n + i) * L + l], b[(c * n + p) * L + l]);
+            }
+        }
+    }
+    trsmTile<T, NF>(b, a, n, nrhs, false, true);
+    trsmTile<T, NF>(b, a, n, nrhs, true, false);
+}
+
+/// Cholesky factorization of every lane of \p a. Only the requested triangle
+/// is referenced and updated. As in LAPACK, the factorization of a lane stops
+/// at its first non positive pivot: info[lane] is set to its 1-based column,
+/// the pivot is left as is and the lane is not updated any further.
+template<typename T, int NF>
+void potrfTile(T *a, int *info, const int n_, bool is_upper) {
+    constexpr int L = lanes<T>();
+    const int n     = NF > 0 ? NF : n_;
+
+    for (int k = 0; k < n; ++k) {
+        T rcp[L];
+        bool active[L];
+        bool any = false;
+        for (int l = 0; l < L; ++l) {
+            active[l] = info[l] == 0;
+            rcp[l]    = scalar<T>(0);
+            if (!active[l]) { continue; }
+            const double d = realPart(a[(k * n + k) * L + l]);
+            if (!(d > 0.0)) {
+                info[l]   = k + 1;
+                active[l] = false;
+                continue;
+            }
+            const double s         = std::sqrt(d);
+            a[(k * n + k) * L + l] = scalar<T>(s);
+            rcp[l]                 = scalar<T>(1.0 / s);
+            any                    = true;
+        }
+        if (!any) { break; }
+
+        if (is_upper) {
+            // A = U^H U, row k of U lives in the upper triangle
+            for (int j = k + 1; j < n; ++j) {
+                for (int l = 0; l < L; ++l) {
+                    if (active[l]) { a[(j * n + k) * L + l] *= rcp[l]; }
+                }
+            }
+            for (int j = k + 1; j < n; ++j) {
+                T *colj = a + (j * n) * L;
+                for (int i = k + 1; i <= j; ++i) {
+                    const T *coli = a + (i * n) * L;
+                    for (int l = 0; l < L; ++l) {
+                        if (!active[l]) { continue; }
+                        colj[i * L + l] -=
+                            conjugate(coli[k * L + l]) * colj[k * L + l];
+                    }
+                }
+            }
+        } else {
+            // A = L L^H, column k of L lives in the lower triangle
+            T *colk = a + (k * n) * L;
+            for (int i = k + 1; i < n; ++i) {
+                for (int l = 0; l < L; ++l) {
+                    if (active[l]) { colk[i * L + l] *= rcp[l]; }
+                }
+            }
+            for (int j = k + 1; j < n; ++j) {
+                T *colj = a + (j * n) * L;
+                for (int i = j; i < n; ++i) {
+                    for (int l = 0; l < L; ++l) {
+                        if (!active[l]) { continue; }
+                        colj[i * L + l] -=
+                            colk[i * L + l] * conjugate(colk[j * L + l]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+#define BATCHED_DISPATCH(FN, T, N, ...)         \
+    switch (N) {                                \
+        case 1: FN<T, 1>(__VA_ARGS__); break;   \
+        case 2: FN<T, 2>(__VA_ARGS__); break;   \
+        case 3: FN<T, 3>(__VA_ARGS__); break;   \
+        case 4: FN<T, 4>(__VA_ARGS__); break;   \
+        case 5: FN<T, 5>(__VA_ARGS__); break;   \
+        case 6: FN<T, 6>(__VA_ARGS__); break;   \
+        case 7: FN<T, 7>(__VA_ARGS__); break;   \
+        case 8: FN<T, 8>(__VA_ARGS__); break;   \
+        default: FN<T, 0>(__VA_ARGS__); break;  \
+    }
+
+/// In place LU factorization of a batch of square matrices. \p pivot has
+/// shape (n, 1, batch dims) and receives 1-based LAPACK style pivots.
+template<typename T>
+void getrf(Param<T> a, Param<int> pivot) {
+    constexpr int L     = lanes<T>();
+    const af::dim4 dims = a.dims();
+    const int n         = static_cast<int>(dims[0]);
+    const dim_t count   = dims[2] * dims[3];
+
+    std::vector<T> tile(n * n * L);
+    std::vector<int> ipiv(n * L);
+    int info[L];
+
+    for (dim_t first = 0; first < count; first += L) {
+        std::fill(info, info + L, 0);
+        gather<T>(tile.data(), a, first, true);
+        BATCHED_DISPATCH(getrfTile, T, n, tile.data(), ipiv.data(), info, n);
+        scatter<T>(a, tile.data(), first);
+
+        for (int l = 0; l < L && first + l < count; ++l) {
+            int *piv = pivot.get() +
+                       batchOffset(pivot.dims(), pivot.strides(), first + l);
+            for (int k = 0; k < n; ++k) { piv[k] = ipiv[k * L + l]; }
+        }
+    }
+}
+
+/// Solves A X = B for a batch of square systems. \p x holds B on entry and X
+/// on exit. \p a is left untouched.
+template<typename T>
+void gesv(Param<T> x, CParam<T> a) {
+    constexpr int L     = lanes<T>();
+    const af::dim4 dims = a.dims();
+    const int n         = static_cast<int>(dims[0]);
+    const int nrhs      = static_cast<int>(x.dims(1));
+    const dim_t count   = dims[2] * dims[3];
+
+    std::vector<T> atile(n * n * L);
+    std::vector<T> btile(n * nrhs * L);
+    std::vector<int> ipiv(n * L);
+    int info[L] = {0};
+
+    for (dim_t first = 0; first < count; first += L) {
+        gather<T>(atile.data(), a, first, true);
+        gather<T>(btile.data(), x, first, false);
+        BATCHED_DISPATCH(getrfTile, T, n, atile.data(), ipiv.data(), info, n);
+        BATCHED_DISPATCH(getrsTile, T, n, btile.data(), atile.data(),
+                         ipiv.data(), n, nrhs);
+        scatter<T>(x, btile.data(), first);
+    }
+}
+
+/// Solves A X = B for a batch of triangular systems. \p x holds B on entry
+template<typename T>
+void trtrs(Param<T> x, CParam<T> a, bool is_upper, bool is_unit) {
+    constexpr int L     = lanes<T>();
+    const af::dim4 dims = a.dims();
+    const int n         = static_cast<int>(dims[0]);
+    const int nrhs      = static_cast<int>(x.dims(1));
+    const dim_t count   = dims[2] * dims[3];
+
+    std::vector<T> atile(n * n * L);
+    std::vector<T> btile(n * nrhs * L);
+
+    for (dim_t first = 0; first < count; first += L) {
+        gather<T>(atile.data(), a, first, true);
+        gather<T>(btile.data(), x, first, false);
+        BATCHED_DISPATCH(trsmTile, T, n, btile.data(), atile.data(), n, nrhs,
+                         is_upper, is_unit);
+        scatter<T>(x, btile.data(), first);
+    }
+}
+
+/// Inverts a batch of square matrices
+template<typename T>
+void getri(Param<T> out, CParam<T> in) {
+    constexpr int L     = lanes<T>();
+    const af::dim4 dims = in.dims();
+    const int n         = static_cast<int>(dims[0]);
+    const dim_t count   = dims[2] * dims[3];
+
+    std::vector<T> atile(n * n * L);
+    std::vector<T> btile(n * n * L);
+    std::vector<int> ipiv(n * L);
+    int info[L] = {0};
+
+    for (dim_t first = 0; first < count; first += L) {
+        gather<T>(atile.data(), in, first, true);
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i < n; ++i) {
+                for (int l = 0; l < L; ++l) {
+                    btile[(j * n + i) * L + l] = scalar<T>(i == j ? 1.0 : 0.0);
+                }
+            }
+        }
+        BATCHED_DISPATCH(getrfTile, T, n, atile.data(), ipiv.data(), info, n);
+        BATCHED_DISPATCH(getrsTile, T, n, btile.data(), atile.data(),
+                         ipiv.data(), n, n);
+        scatter<T>(out, btile.data(), first);
+    }
+}
+
+/// In place Cholesky factorization of a batch of Hermitian positive definite
+/// matrices. \p info receives the LAPACK style status of the first matrix in
+/// the batch that failed to factorize, or 0.
+template<typename T>
+void potrf(int *info, Param<T> a, bool is_upper) {
+    constexpr int L     = lanes<T>();
+    const af::dim4 dims = a.dims();
+    const int n         = static_cast<int>(dims[0]);
+    const dim_t count   = dims[2] * dims[3];
+
+    std::vector<T> tile(n * n * L);
+    int linfo[L];
+    *info = 0;
+
+    for (dim_t first = 0; first < count; first += L) {
+        std::fill(linfo, linfo + L, 0);
+        gather<T>(tile.data(), a, first, true);
+        BATCHED_DISPATCH(potrfTile, T, n, tile.data(), linfo, n, is_upper);
+        scatter<T>(a, tile.data(), first);
+
+        for (int l = 0; l < L && first + l < count; ++l) {
+            if (*info == 0) { *info = linfo[l]; }
+        }
+    }
+}
+
+#undef BATCHED_DISPATCH
+
+}  // namespace batched
+}  // namespace kernel
+}  // namespace cpu
@@ -9,176 +9,407 @@
 
 #pragma once
 #include <Param.hpp>
-#include <array>
+#include <kernel/flood_fill.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
 #include <cassert>
-#include <list>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
+
+/// Suppresses the pixels 1 to d0 - 2 of column \p cur of the gradient
+/// magnitude whose magnitude is not above the magnitudes interpolated on
+/// both sides along the gradient (dx, dy). \p prev and \p next are the
+/// columns before and after it.
+inline void suppressColumn(float* out, const float* prev, const float* cur,
+                           const float* next, const float* dX,
+                           const float* dY, const dim_t d0) {
+    for (dim_t i = 1; i < d0 - 1; ++i) {
+        const float curr = cur[i];
+        if (curr == 0) {
+            out[i] = 0.f;
+            continue;
+        }
+        const float se = next[i + 1];
+        const float nw = prev[i - 1];
+        const float ea = cur[i + 1];
+        const float we = cur[i - 1];
+        const float ne = prev[i + 1];
+        const float sw = next[i - 1];
+        const float no = prev[i];
+        const float so = next[i];
+        const float dx = dX[i];
+        const float dy = dY[i];
+
+        float a1, a2, b1, b2, alpha;
+
+        if (dx >= 0) {
+            if (dy >= 0) {
+                const bool isDxMagGreater = (dx - dy) >= 0;
+
+                a1    = isDxMagGreater ? ea : so;
+                a2    = isDxMagGreater ? we : no;
+                b1    = se;
+                b2    = nw;
+                alpha = isDxMagGreater ? dy / dx : dx / dy;
+            } else {
+                const bool isDyMagGreater = (dx + dy) >= 0;
+
+                a1    = isDyMagGreater ? ea : no;
+                a2    = isDyMagGreater ? we : so;
+                b1    = ne;
+                b2    = sw;
+                alpha = isDyMagGreater ? -dy / dx : dx / -dy;
+            }
+        } else {
+            if (dy >= 0) {
+                const bool isDyMagGreater = (dx + dy) >= 0;
+
+                a1    = isDyMagGreater ? so : we;
+                a2    = isDyMagGreater ? no : ea;
+                b1    = sw;
+                b2    = ne;
+                alpha = isDyMagGreater ? -dx / dy : dy / -dx;
+            } else {
+                const bool isDxMagGreater = (-dx + dy) >= 0;
+
+                a1    = isDxMagGreater ? we : no;
+                a2    = isDxMagGreater ? ea : so;
+                b1    = nw;
+                b2    = se;
+                alpha = isDxMagGreater ? dy / dx : dx / dy;
+            }
+        }
+
+        const float mag1 = (1.0f - alpha) * a1 + alpha * b1;
+        const float mag2 = (1.0f - alpha) * a2 + alpha * b2;
+
+        out[i] = (curr > mag1 && curr > mag2) ? curr : 0.f;
+    }
+}
+
 template<typename T>
 void nonMaxSuppression(Param<T> output, CParam<T> magnitude, CParam<T> dxParam,
                        CParam<T> dyParam) {
-    const af::dim4 dims    = magnitude.dims();
-    const af::dim4 strides = magnitude.strides();
+    const af::dim4 dims = magnitude.dims();
+    const dim_t d0 = dims[0], d1 = dims[1];
 
-    T* out       = output.get();
-    const T* mag = magnitude.get();
-    const T* dX  = dxParam.get();
-    const T* dY  = dyParam.get();
+    // Columns 1 to d1 - 2 of every image; the borders of the output are
+    // left as they are
+    auto offset = [](const af::dim4& strides, dim_t j, dim_t b2, dim_t b3) {
+        return (j + 1) * strides[1] + b2 * strides[2] + b3 * strides[3];
+    };
+    threadPool().parallel_for(
+        af::dim4(1, d1 - 2, dims[2], dims[3]), grainSize(d0 * 16),
+        [&](dim_t j, dim_t b2, dim_t b3) {
+            const af::dim4 ms = magnitude.strides();
+            const T* mag      = magnitude.get() + offset(ms, j, b2, b3);
+            suppressColumn(
+                output.get() + offset(output.strides(), j, b2, b3),
+                mag - ms[1], mag, mag + ms[1],
+                dxParam.get() + offset(dxParam.strides(), j, b2, b3),
+                dyParam.get() + offset(dyParam.strides(), j, b2, b3), d0);
+        });
+}
 
-    for (dim_t b3 = 0; b3 < dims[3]; ++b3) {
-        for (dim_t b2 = 0; b2 < dims[2]; ++b2) {
-            dim_t offset;
-
-            offset = dims[0] + 1;
-
-            for (dim_t j = 2; j < dims[1]; ++j, offset += 2) {
-                for (dim_t i = 2; i < dims[0]; ++i, ++offset) {
-                    T curr = mag[offset];
-                    if (curr == 0) {
-                        out[offset] = (T)0;
-                    } else {
-                        const float se = mag[offset + dims[0] + 1];
-                        const float nw = mag[offset - dims[0] - 1];
-                        const float ea = mag[offset + 1];
-                        const float we = mag[offset - 1];
-                        const float ne = mag[offset - dims[0] + 1];
-                        const float sw = mag[offset + dims[0] - 1];
-                        const float no = mag[offset - dims[0]];
-                        const float so = mag[offset + dims[0]];
-                        const float dx = dX[offset];
-                        const float dy = dY[offset];
-
-                        float a1, a2, b1, b2, alpha;
-
-                        if (dx >= 0) {
-                            if (dy >= 0) {
-                                const bool isDxMagGreater = (dx - dy) >= 0;
-
-                                a1    = isDxMagGreater ? ea : so;
-                                a2    = isDxMagGreater ? we : no;
-                                b1    = se;
-                                b2    = nw;
-                                alpha = isDxMagGreater ? dy / dx : dx / dy;
-                            } else {
-                                const bool isDyMagGreater = (dx + dy) >= 0;
-
-                                a1    = isDyMagGreater ? ea : no;
-                                a2    = isDyMagGreater ? we : so;
-                                b1    = ne;
-                                b2    = sw;
-                                alpha = isDyMagGreater ? -dy / dx : dx / -dy;
-                            }
-                        } else {
-                            if (dy >= 0) {
-                                const bool isDyMagGreater = (dx + dy) >= 0;
-
-                                a1    = isDyMagGreater ? so : we;
-                                a2    = isDyMagGreater ? no : ea;
-                                b1    = sw;
-                                b2    = ne;
-                                alpha = isDyMagGreater ? -dx / dy : dy / -dx;
-                            } else {
-                                const bool isDxMagGreater = (-dx + dy) >= 0;
-
-                                a1    = isDxMagGreater ? we : no;
-                                a2    = isDxMagGreater ? ea : so;
-                                b1    = nw;
-                                b2    = se;
-                                alpha = isDxMagGreater ? dy / dx : dx / dy;
-                            }
-                        }
+/// Sobel derivatives of column \p c of the d0 x d1 image \p in, with the
+/// borders reflected as the sobel kernel does, and their gradient
+/// magnitude
+inline void gradientColumn(float* gx, float* gy, float* mag, const float* in,
+                           const dim_t stride1, const dim_t d0,
+                           const dim_t d1, const dim_t c, const bool isf) {
+    auto reflect101 = [](dim_t index, dim_t endIndex) {
+        return std::abs(endIndex - std::abs(endIndex - index));
+    };
+    const float* w = in + reflect101(c - 1, d1 - 1) * stride1;
+    const float* m = in + c * stride1;
+    const float* e = in + reflect101(c + 1, d1 - 1) * stride1;
 
-                        float mag1 = (1.0f - alpha) * a1 + alpha * b1;
-                        float mag2 = (1.0f - alpha) * a2 + alpha * b2;
+    auto derivatives = [&](dim_t i, dim_t up, dim_t down) {
+        const float NW = w[up], SW = w[down];
+        const float NE = e[up], SE = e[down];
+        gx[i] = SW + SE - (NW + NE) + 2 * (m[down] - m[up]);
+        gy[i] = NE + SE - (NW + SW) + 2 * (e[i] - w[i]);
+    };
+    derivatives(0, 1, 1);
+    for (dim_t i = 1; i < d0 - 1; ++i) { derivatives(i, i - 1, i + 1); }
+    derivatives(d0 - 1, d0 - 2, d0 - 2);
 
-                        if (curr > mag1 && curr > mag2) {
-                            out[offset] = curr;
-                        } else {
-                            out[offset] = (T)0;
-                        }
+    if (isf) {
+        for (dim_t i = 0; i < d0; ++i) {
+            mag[i] = std::abs(gx[i]) + std::abs(gy[i]);
+        }
+    } else {
+        for (dim_t i = 0; i < d0; ++i) {
+            mag[i] = std::sqrt(gx[i] * gx[i] + gy[i] * gy[i]);
+        }
+    }
+}
+
+/// Smallest and largest value of the suppressed magnitude
+using value_range = std::pair<float, float>;
+
+/// Writes the non maximum suppressed gradient magnitude of the smoothed
+/// image \p in to \p out, which has zero borders, and returns its range.
+/// Each thread takes a strip of at least 16 whole columns and keeps the
+/// derivatives and magnitudes of the three columns around the current one,
+/// so the derivatives are never written out.
+inline value_range suppressedMagnitude(Param<float> out, CParam<float> in,
+                                       const bool isf) {
+    const af::dim4 dims = in.dims();
+    const af::dim4 is   = in.strides();
+    const af::dim4 os   = out.strides();
+    const dim_t d0 = dims[0], d1 = dims[1];
+    const dim_t columns = d1 * dims[2] * dims[3];
+    assert(is[0] == 1 && os[0] == 1);
+
+    auto merge = [](const value_range& a, const value_range& b) {
+        return value_range(std::min(a.first, b.first),
+                           std::max(a.second, b.second));
+    };
+    const value_range empty(std::numeric_limits<float>::max(),
+                            std::numeric_limits<float>::lowest());
+
+    return threadPool().parallel_reduce(
+        0, columns, std::max<dim_t>(grainSize(d0 * 32), 16), empty,
+        [&](dim_t begin, dim_t end) {
+            std::vector<float> buffer(9 * d0);
+            float* gx[3];
+            float* gy[3];
+            float* mag[3];
+            for (int k = 0; k < 3; ++k) {
+                gx[k]  = buffer.data() + (3 * k) * d0;
+                gy[k]  = buffer.data() + (3 * k + 1) * d0;
+                mag[k] = buffer.data() + (3 * k + 2) * d0;
+            }
+
+            value_range range = empty;
+            // The columns of one image within [begin, end) at a time
+            for (dim_t c = begin; c < end;) {
+                const dim_t b = c / d1, j0 = c % d1;
+                const dim_t j1 = std::min(d1, j0 + end - c);
+                c += j1 - j0;
+
+                const float* src = in.get() + (b % dims[2]) * is[2] +
+                                   (b / dims[2]) * is[3];
+                float* dst = out.get() + (b % dims[2]) * os[2] +
+                             (b / dims[2]) * os[3];
+                auto gradient = [&](dim_t col) {
+                    const int k = col % 3;
+                    gradientColumn(gx[k], gy[k], mag[k], src, is[1], d0, d1,
+                                   col, isf);
+                };
+
+                if (j0 > 0) { gradient(j0 - 1); }
+                gradient(j0);
+                for (dim_t j = j0; j < j1; ++j) {
+                    float* col = dst + j * os[1];
+                    if (j == 0 || j == d1 - 1) {
+                        std::fill(col, col + d0, 0.f);
+                        range = merge(range, value_range(0.f, 0.f));
+                        if (j + 1 < d1) { gradient(j + 1); }
+                        continue;
+                    }
+                    gradient(j + 1);
+                    suppressColumn(col, mag[(j - 1) % 3], mag[j % 3],
+                                   mag[(j + 1) % 3], gx[j % 3], gy[j % 3],
+                                   d0);
+                    col[0]      = 0.f;
+                    col[d0 - 1] = 0.f;
+                    for (dim_t i = 0; i < d0; ++i) {
+                        range.first  = std::min(range.first, col[i]);
+                        range.second = std::max(range.second, col[i]);
                     }
                 }
             }
+            return range;
+        },
+        merge);
+}
+
+/// Otsu's threshold of the suppressed magnitude \p edges of one image,
+/// taken over a histogram of \p nbins bins of [0, maxVal]. The class
+/// statistics are accumulated in the order of the generic implementation,
+/// so the threshold, a bin index, is the same.
+inline float otsuThreshold(const float* edges, const dim_t d0, const dim_t d1,
+                           const dim_t stride1, const unsigned nbins,
+                           const float maxVal) {
+    if (nbins < 2) { return 0.f; }
+    std::vector<unsigned> hist(nbins, 0);
+    const float step = static_cast<double>(maxVal) / static_cast<float>(nbins);
+    for (dim_t j = 0; j < d1; ++j) {
+        const float* col = edges + j * stride1;
+        for (dim_t i = 0; i < d0; ++i) {
+            int bin = static_cast<int>(col[i] / step);
+            bin     = std::min(std::max(bin, 0), static_cast<int>(nbins) - 1);
+            hist[bin]++;
+        }
+    }
+
+    const float total = static_cast<float>(d0 * d1);
+    std::vector<float> cumFreqs(nbins), cumProduct(nbins);
+    float cumFreq = 0.f, cumProd = 0.f, weightedSum = 0.f;
+    for (unsigned b = 0; b < nbins; ++b) {
+        const float freq    = static_cast<float>(hist[b]) / total;
+        const float product = static_cast<float>(b) * freq;
+        cumFreq += freq;
+        cumProd += product;
+        weightedSum += product;
+        cumFreqs[b]   = cumFreq;
+        cumProduct[b] = cumProd;
+    }
 
-            out += strides[2];
-            mag += strides[2];
-            dX += strides[2];
-            dY += strides[2];
+    float best         = std::numeric_limits<float>::lowest();
+    unsigned threshold = 0;
+    for (unsigned b = 0; b + 1 < nbins; ++b) {
+        const float qL    = cumFreqs[b];
+        const float qH    = 1.0f - qL;
+        const float muL   = cumProduct[b] / qL;
+        const float muH   = (weightedSum - cumProduct[b]) / qH;
+        const float diff  = muL - muH;
+        const float sigma = (diff * diff) * (qL * (1.0f - qL));
+        if (sigma > best) {
+            best      = sigma;
+            threshold = b;
         }
-        out += strides[3];
-        mag += strides[3];
-        dX += strides[3];
-        dY += strides[3];
     }
+    return static_cast<float>(threshold);
 }
 
-template<typename T>
-void traceEdge(T* out, const T* strong, const T* weak, int t, int stride1) {
-    if (!out || !strong || !weak) return;
-
-    const T EDGE = 1;
-
-    std::list<dim_t> edges;  // list of edges to be checked
-    edges.push_back(t);
-
-    do {
-        t = edges.front();
-        edges.pop_front();  // remove the last after read
-
-        // get indices of 8 neighbours
-        std::array<dim_t, 8> potentials;
-
-        potentials[0] = t - stride1 - 1;    // north-west
-        potentials[1] = potentials[0] + 1;  // north
-        potentials[2] = potentials[1] + 1;  // north-east
-        potentials[3] = t - 1;              // west
-        potentials[4] = t + 1;              // east
-        potentials[5] = t + stride1 - 1;    // south-west
-        potentials[6] = potentials[5] + 1;  // south
-        potentials[7] = potentials[6] + 1;  // south-east
-
-        // test 8 neighbours and add them into edge
-        // list only if they are also edges
-        for (auto it : potentials) {
-            if (weak[it] > 0 && out[it] != EDGE) {
-                out[it] = EDGE;
-                edges.emplace_back(it);
+/// Marks the pixels of \p mask from the suppressed magnitude of one image:
+/// the ones at or above \p high are strong edges, filled up front, and the
+/// ones in [low, high) are weak edges, candidates for the fill. The value
+/// compared is (edge - offset) / scale. The borders are never edges.
+inline void classifyEdges(fill_mask& mask, const float* edges,
+                          const dim_t stride1, const float offset,
+                          const float scale, const float low,
+                          const float high) {
+    threadPool().parallel_for(
+        0, mask.d1, grainSize(mask.d0), [&](dim_t begin, dim_t end) {
+            for (dim_t y = begin; y < end; ++y) {
+                const float* src = edges + y * stride1;
+                uchar* row       = mask.row(y);
+                bool strong      = false;
+                std::fill(row, row + mask.d0, rejected);
+                if (y == 0 || y == mask.d1 - 1) {
+                    mask.rowHasFilled[y] = 0;
+                    continue;
+                }
+                for (dim_t x = 1; x < mask.d0 - 1; ++x) {
+                    const float v = (src[x] - offset) / scale;
+                    row[x] = v >= high ? filled
+                             : v >= low ? candidate
+                                        : rejected;
+                    strong |= v >= high;
+                }
+                mask.rowHasFilled[y] = strong;
             }
-        }
-    } while (!edges.empty());
+        });
+}
+
+/// Writes one for the pixels of \p mask filled and zero elsewhere
+inline void writeEdges(char* out, const dim_t stride1, const fill_mask& mask) {
+    threadPool().parallel_for(
+        0, mask.d1, grainSize(mask.d0), [&](dim_t begin, dim_t end) {
+            for (dim_t y = begin; y < end; ++y) {
+                const uchar* src = mask.row(y);
+                char* dst        = out + y * stride1;
+                for (dim_t x = 0; x < mask.d0; ++x) {
+                    dst[x] = src[x] == filled ? 1 : 0;
+                }
+            }
+        });
 }
 
 template<typename T>
 void edgeTrackingHysteresis(Param<T> out, CParam<T> strong, CParam<T> weak) {
-    const af::dim4 dims    = strong.dims();
-    const dim_t batchCount = dims[2] * dims[3];
-    const dim_t jMax       = dims[1] - 1;
-    const dim_t iMax       = dims[0] - 1;
-
-    const T* sptr = strong.get();
-    const T* wptr = weak.get();
-    T* optr       = out.get();
-
-    for (dim_t batchId = 0; batchId < batchCount; ++batchId) {
-        // Skip processing borders
-        dim_t t = dims[0] + 1;
-
-        for (dim_t j = 1; j <= jMax; ++j) {
-            for (dim_t i = 1; i <= iMax; ++i, ++t) {
-                // if current pixel(sptr) is part of a edge
-                // and output doesn't have it marked already,
-                // mark it and trace the pixels from here.
-                if (sptr[t] > 0 && optr[t] != 1) {
-                    optr[t] = 1;
-                    traceEdge(optr, sptr, wptr, t, dims[0]);
+    const af::dim4 dims = strong.dims();
+    const dim_t d0 = dims[0], d1 = dims[1];
+
+    fill_mask mask(d0, d1);
+    for (dim_t b3 = 0; b3 < dims[3]; ++b3) {
+        for (dim_t b2 = 0; b2 < dims[2]; ++b2) {
+            const T* sptr = strong.get() + b2 * strong.strides(2) +
+                            b3 * strong.strides(3);
+            const T* wptr =
+                weak.get() + b2 * weak.strides(2) + b3 * weak.strides(3);
+            threadPool().parallel_for(
+                0, d1, grainSize(d0), [&](dim_t begin, dim_t end) {
+                    for (dim_t y = begin; y < end; ++y) {
+                        const T* s = sptr + y * strong.strides(1);
+                        const T* w = wptr + y * weak.strides(1);
+                        uchar* row = mask.row(y);
+                        bool seeds = false;
+                        for (dim_t x = 0; x < d0; ++x) {
+                            row[x] = s[x] > 0   ? filled
+                                     : w[x] > 0 ? candidate
+                                                : rejected;
+                            seeds |= s[x] > 0;
+                        }
+                        mask.rowHasFilled[y] = seeds;
+                    }
+                });
+            growRegion(mask, AF_CONNECTIVITY_8);
+
+            T* optr = out.get() + b2 * out.strides(2) + b3 * out.strides(3);
+            for (dim_t y = 0; y < d1; ++y) {
+                const uchar* src = mask.row(y);
+                T* dst           = optr + y * out.strides(1);
+                for (dim_t x = 0; x < d0; ++x) {
+                    dst[x] = src[x] == filled ? T(1) : T(0);
                 }
             }
         }
-        optr += out.strides(2);
-        sptr += strong.strides(2);
-        wptr += weak.strides(2);
     }
 }
+
+/// Canny edges of the smoothed image \p in. The derivatives, their
+/// magnitude and the non maximum suppression are one pass over the image
+/// into \p edges, which also yields the range of the suppressed magnitude.
+/// The strong and weak edges are then marked in a pixel mask per image and
+/// the weak edges connected to strong ones are found by the region growing
+/// of the flood fill, which labels the runs of all rows with a union find
+/// when there are several threads.
+///
+/// With AF_CANNY_THRESHOLD_MANUAL the thresholds \p t1 and \p t2 apply to
+/// the magnitude normalised to [0, 1] over all images. With
+/// AF_CANNY_THRESHOLD_AUTO_OTSU the high threshold of every image is Otsu's
+/// threshold of its magnitude and the low one is \p t1 times it.
+inline void cannyEdges(Param<char> out, Param<float> edges, CParam<float> in,
+                       const float t1, const af_canny_threshold ct,
+                       const float t2, const bool isf) {
+    const af::dim4 dims = in.dims();
+    const af::dim4 es   = edges.strides();
+    const af::dim4 os   = out.strides();
+    const dim_t d0 = dims[0], d1 = dims[1];
+
+    const value_range range = suppressedMagnitude(edges, in, isf);
+    const float minVal = range.first, maxVal = range.second;
+
+    fill_mask mask(d0, d1);
+    for (dim_t b3 = 0; b3 < dims[3]; ++b3) {
+        for (dim_t b2 = 0; b2 < dims[2]; ++b2) {
+            const float* eptr = edges.get() + b2 * es[2] + b3 * es[3];
+            if (ct == AF_CANNY_THRESHOLD_AUTO_OTSU) {
+                const float high =
+                    otsuThreshold(eptr, d0, d1, es[1],
+                                  static_cast<unsigned>(maxVal), maxVal);
+                classifyEdges(mask, eptr, es[1], 0.f, 1.f, high * t1, high);
+            } else {
+                classifyEdges(mask, eptr, es[1], minVal, maxVal - minVal, t1,
+                              t2);
+            }
+            growRegion(mask, AF_CONNECTIVITY_8);
+            writeEdges(out.get() + b2 * os[2] + b3 * os[3], os[1], mask);
+        }
+    }
+}
+
 }  // namespace kernel
 }  // namespace cpu
@@ -12,6 +12,8 @@
 #include <math.hpp>
 #include <af/defines.h>
 
+#include <algorithm>
+
 namespace cpu {
 namespace kernel {
 
@@ -22,7 +24,8 @@ void one2one_1d(InT *optr, InT const *const iptr, AccT const *const fptr,
                 const bool expand) {
     dim_t start = (expand ? 0 : fDims[0] / 2);
     dim_t end   = (expand ? oDims[0] : start + sDims[0]);
-    for (dim_t i = start; i < end; ++i) {
+
+    auto edge = [&](dim_t i) {
         AccT accum = 0.0;
         for (dim_t f = 0; f < fDims[0]; ++f) {
             dim_t iIdx = i - f;
@@ -32,7 +35,41 @@ void one2one_1d(InT *optr, InT const *const iptr, AccT const *const fptr,
             accum += AccT(s_val * fptr[f]);
         }
         optr[i - start] = InT(accum);
+    };
+
+    // Outputs in [lo, hi) see the whole filter inside the signal, so they are
+    // computed without bounds checks, a block of outputs at a time to reuse
+    // each filter tap. Taps are accumulated in the same order as at the edges.
+    constexpr dim_t Block = 4;
+    const dim_t lo = std::max(start, std::min(end, fDims[0] - 1));
+    const dim_t hi = std::max(lo, std::min(end, sDims[0]));
+    const dim_t ss = sStrides[0];
+
+    for (dim_t i = start; i < lo; ++i) { edge(i); }
+
+    dim_t i = lo;
+    for (; i + Block <= hi; i += Block) {
+        AccT accum[Block];
+        for (dim_t b = 0; b < Block; ++b) { accum[b] = 0.0; }
+        for (dim_t f = 0; f < fDims[0]; ++f) {
+            InT const *src = iptr + (i - f) * ss;
+            for (dim_t b = 0; b < Block; ++b) {
+                accum[b] += AccT(src[b * ss] * fptr[f]);
+            }
+        }
+        for (dim_t b = 0; b < Block; ++b) {
+            optr[i + b - start] = InT(accum[b]);
+        }
+    }
+    for (; i < hi; ++i) {
+        AccT accum = 0.0;
+        for (dim_t f = 0; f < fDims[0]; ++f) {
+            accum += AccT(iptr[(i - f) * ss] * fptr[f]);
+        }
+        optr[i - start] = InT(accum);
     }
+
+    for (i = hi; i < end; ++i) { edge(i); }
 }
 
 template<typename InT, typename AccT>
@@ -9,6 +9,7 @@
 
 #pragma once
 #include <Param.hpp>
+#include <half_convert.hpp>
 #include <math.hpp>
 #include <af/defines.h>
 #include <af/dim4.hpp>
@@ -153,6 +154,46 @@ struct CopyImpl<T, T> {
     }
 };
 
+/// Converts between f16 and f32 one row at a time with the bulk conversion
+/// routines when both arrays have the same shape and unit stride along
+/// dimension 0
+template<typename OutT, typename InT>
+void convertCopy(Param<OutT> dst, CParam<InT> src) {
+    af::dim4 dims        = dst.dims();
+    af::dim4 dst_strides = dst.strides();
+    af::dim4 src_strides = src.strides();
+    if (dims != src.dims() || dst_strides[0] != 1 || src_strides[0] != 1) {
+        copyElemwise(dst, src, scalar<OutT>(0), 1.0);
+        return;
+    }
+
+    for (dim_t l = 0; l < dims[3]; ++l) {
+        for (dim_t k = 0; k < dims[2]; ++k) {
+            for (dim_t j = 0; j < dims[1]; ++j) {
+                convertValues(dst.get() + l * dst_strides[3] +
+                                  k * dst_strides[2] + j * dst_strides[1],
+                              src.get() + l * src_strides[3] +
+                                  k * src_strides[2] + j * src_strides[1],
+                              dims[0]);
+            }
+        }
+    }
+}
+
+template<>
+struct CopyImpl<float, common::half> {
+    static void copy(Param<float> dst, CParam<common::half> src) {
+        convertCopy(dst, src);
+    }
+};
+
+template<>
+struct CopyImpl<common::half, float> {
+    static void copy(Param<common::half> dst, CParam<float> src) {
+        convertCopy(dst, src);
+    }
+};
+
 template<typename OutT, typename InT>
 void copy(Param<OutT> dst, CParam<InT> src) {
     CopyImpl<OutT, InT>::copy(dst, src);
@@ -0,0 +1,129 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/defines.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// Local maximum of a corner response at \p row of column \p col
+struct corner_point {
+    dim_t row, col;
+    float resp;
+};
+
+using corner_list = std::shared_ptr<std::vector<corner_point>>;
+
+/// Keeps the rows [begin, end) of column \p col whose response in \p cur is
+/// above the responses of their 8 neighbours and at least \p minResp.
+/// \p prev and \p next are the responses of the columns next to it.
+template<typename T>
+void suppressColumn(std::vector<corner_point> &found, const T *prev,
+                    const T *cur, const T *next, const dim_t col,
+                    const dim_t begin, const dim_t end, const T minResp) {
+    for (dim_t y = begin; y < end; ++y) {
+        T maxV = std::max(std::max(prev[y - 1], prev[y]), prev[y + 1]);
+        maxV   = std::max(maxV, std::max(cur[y - 1], cur[y + 1]));
+        maxV   = std::max(maxV, std::max(std::max(next[y - 1], next[y]),
+                                         next[y + 1]));
+
+        const T v = cur[y];
+        if (v > maxV && v >= minResp) {
+            found.push_back({y, col, static_cast<float>(v)});
+        }
+    }
+}
+
+/// Finds the local maxima of the corner response of a d0 x d1 image. The
+/// response of column c is written to the rows [border, d0 - border) of a
+/// column buffer by the callable returned from \p makeResponse, called as
+/// response(buffer, c) for c in [border, d1 - border); the maxima are
+/// searched one pixel further in. The columns are split into strips, each
+/// with its own response callable, which is called for consecutive columns
+/// and keeps only the responses of the last three. \p cost is the work of
+/// one response. Returns the maxima in column major order.
+template<typename T, typename ResponseFactory>
+std::vector<corner_point> localMaxima(const dim_t d0, const dim_t d1,
+                                      const dim_t border, const T minResp,
+                                      const dim_t cost,
+                                      ResponseFactory &&makeResponse) {
+    const dim_t first = border + 1;
+    const dim_t lastX = d1 - border - 1;
+    const dim_t lastY = d0 - border - 1;
+    if (lastX <= first || lastY <= first) { return {}; }
+
+    std::vector<std::vector<corner_point>> columns(lastX - first);
+    const dim_t grain = std::max<dim_t>(grainSize(cost * d0), 16);
+    threadPool().parallel_for(first, lastX, grain, [&](dim_t begin,
+                                                       dim_t end) {
+        auto response = makeResponse();
+        std::vector<T> window(3 * d0);
+        auto column = [&](dim_t c) { return window.data() + (c % 3) * d0; };
+
+        response(column(begin - 1), begin - 1);
+        response(column(begin), begin);
+        for (dim_t c = begin; c < end; ++c) {
+            response(column(c + 1), c + 1);
+            suppressColumn(columns[c - first], column(c - 1), column(c),
+                           column(c + 1), c, first, lastY, minResp);
+        }
+    });
+
+    size_t total = 0;
+    for (const auto &found : columns) { total += found.size(); }
+    std::vector<corner_point> corners;
+    corners.reserve(total);
+    for (const auto &found : columns) {
+        corners.insert(corners.end(), found.begin(), found.end());
+    }
+    return corners;
+}
+
+/// Keeps the \p count strongest of \p corners, ordered by decreasing
+/// response and, among equal responses, in their column major order. A
+/// heap of \p count corners is kept while the others are scanned, so only
+/// the selected ones are sorted.
+inline void keepStrongest(std::vector<corner_point> &corners,
+                          const size_t count) {
+    if (corners.size() <= count) { return; }
+    std::partial_sort(corners.begin(), corners.begin() + count, corners.end(),
+                      [](const corner_point &a, const corner_point &b) {
+                          if (a.resp != b.resp) { return a.resp > b.resp; }
+                          if (a.col != b.col) { return a.col < b.col; }
+                          return a.row < b.row;
+                      });
+    corners.resize(count);
+}
+
+/// Writes the positions and responses of \p corners. The column of a
+/// corner goes to \p xOut for \p colIsX, its row otherwise.
+inline void writeCorners(Param<float> xOut, Param<float> yOut,
+                         Param<float> respOut, corner_list corners,
+                         const bool colIsX) {
+    float *x    = xOut.get();
+    float *y    = yOut.get();
+    float *resp = respOut.get();
+    for (size_t i = 0; i < corners->size(); ++i) {
+        const corner_point &p = (*corners)[i];
+        x[i]    = static_cast<float>(colIsX ? p.col : p.row);
+        y[i]    = static_cast<float>(colIsX ? p.row : p.col);
+        resp[i] = p.resp;
+    }
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -0,0 +1,284 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/defines.hpp>
+#include <fftw_transform.hpp>
+#include <thread_pool.hpp>
+
+#include <complex>
+#include <utility>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// Buffers and transforms of one deconvolution. The d0 x d1 images live in
+/// the real buffers x and w, their half spectra of (d0 / 2 + 1) x d1 bins
+/// in spec. The plans are made once for these buffers and executed every
+/// iteration, so the iterations neither allocate nor plan.
+template<typename T>
+class deconv_workspace {
+   public:
+    using Tc        = std::complex<T>;
+    using forward_t = fftw_real_transform<Tc, T>;
+    using inverse_t = fftw_real_transform<T, Tc>;
+    using plan_t    = typename forward_t::plan_t;
+    using ctype_t   = typename forward_t::ctype_t;
+
+    deconv_workspace(dim_t d0, dim_t d1)
+        : d0(d0)
+        , d1(d1)
+        , h0(d0 / 2 + 1)
+        , x(d0 * d1)
+        , w(d0 * d1)
+        , spec(h0 * d1)
+        , psf(h0 * d1) {
+        int n[]  = {static_cast<int>(d1), static_cast<int>(d0)};
+        auto out = reinterpret_cast<ctype_t *>(spec.data());
+        forwardX = forward_t().create(2, n, 1, x.data(), nullptr, 1, 0, out,
+                                      nullptr, 1, 0, FFTW_ESTIMATE);
+        forwardW = forward_t().create(2, n, 1, w.data(), nullptr, 1, 0, out,
+                                      nullptr, 1, 0, FFTW_ESTIMATE);
+        inverse  = inverse_t().create(2, n, 1, out, nullptr, 1, 0, w.data(),
+                                      nullptr, 1, 0, FFTW_ESTIMATE);
+    }
+
+    ~deconv_workspace() {
+        forward_t().destroy(forwardX);
+        forward_t().destroy(forwardW);
+        inverse_t().destroy(inverse);
+    }
+
+    deconv_workspace(const deconv_workspace &)            = delete;
+    deconv_workspace &operator=(const deconv_workspace &) = delete;
+
+    /// Runs one of the plans of the workspace
+    static void execute(plan_t plan) { forward_t().execute(plan); }
+
+    dim_t pixels() const { return d0 * d1; }
+    dim_t bins() const { return h0 * d1; }
+
+    /// Weight of bin i in the norm of the full spectrum: every bin but the
+    /// ones of the first and, for even d0, the last row stands for itself
+    /// and its mirror image
+    T weight(dim_t i) const {
+        const dim_t k0 = i % h0;
+        return (k0 == 0 || 2 * k0 == d0) ? T(1) : T(2);
+    }
+
+    /// Copies \p src to the real buffer \p dst
+    void load(std::vector<T> &dst, CParam<T> src) {
+        const af::dim4 strides = src.strides();
+        threadPool().parallel_for(
+            0, d1, grainSize(d0), [&](dim_t begin, dim_t end) {
+                for (dim_t y = begin; y < end; ++y) {
+                    const T *in = src.get() + y * strides[1];
+                    T *out      = dst.data() + y * d0;
+                    for (dim_t i = 0; i < d0; ++i) {
+                        out[i] = in[i * strides[0]];
+                    }
+                }
+            });
+    }
+
+    /// Copies the real buffer \p src to \p dst
+    void store(Param<T> dst, const std::vector<T> &src) {
+        const af::dim4 strides = dst.strides();
+        threadPool().parallel_for(
+            0, d1, grainSize(d0), [&](dim_t begin, dim_t end) {
+                for (dim_t y = begin; y < end; ++y) {
+                    const T *in = src.data() + y * d0;
+                    T *out      = dst.get() + y * strides[1];
+                    for (dim_t i = 0; i < d0; ++i) {
+                        out[i * strides[0]] = in[i];
+                    }
+                }
+            });
+    }
+
+    /// Sets psf to the spectrum of \p kernel scaled by \p scale
+    void loadPsf(CParam<T> kernel, const T scale) {
+        load(w, kernel);
+        execute(forwardW);
+        threadPool().parallel_for(
+            0, bins(), grainSize(1), [&](dim_t begin, dim_t end) {
+                for (dim_t i = begin; i < end; ++i) {
+                    psf[i] = spec[i] * scale;
+                }
+            });
+    }
+
+    /// Multiplies spec by psf, or by its conjugate for \p conjugate
+    void multiplyPsf(const bool conjugate) {
+        threadPool().parallel_for(
+            0, bins(), grainSize(4), [&](dim_t begin, dim_t end) {
+                for (dim_t i = begin; i < end; ++i) {
+                    const T a = spec[i].real(), b = spec[i].imag();
+                    const T c = psf[i].real();
+                    const T d = conjugate ? -psf[i].imag() : psf[i].imag();
+                    spec[i]   = Tc(a * c - b * d, a * d + b * c);
+                }
+            });
+    }
+
+    const dim_t d0, d1, h0;
+    std::vector<T> x, w;
+    std::vector<Tc> spec, psf;
+    plan_t forwardX, forwardW, inverse;
+};
+
+/// Squared norms of the change of an estimate and of the new estimate
+using change_norms = std::pair<double, double>;
+
+inline change_norms addNorms(const change_norms &a, const change_norms &b) {
+    return {a.first + b.first, a.second + b.second};
+}
+
+/// Whether the change of the estimate is at most \p tolerance times the
+/// norm of the new estimate
+inline bool converged(const change_norms &norms, const float tolerance) {
+    const double tol = tolerance;
+    return norms.first <= tol * tol * norms.second;
+}
+
+/// Richardson-Lucy deconvolution of \p in, which is blurred by \p psf. Both
+/// are padded to the same size and \p psf is shifted to have its centre at
+/// the origin. Each iteration multiplies the estimate x by
+/// correlate(in / convolve(x, psf), psf), with the convolutions done on the
+/// spectra in place. The normalisation of the inverse transforms is folded
+/// into the PSF spectrum. A \p tolerance above zero stops the iterations
+/// once one changes the estimate by at most \p tolerance times its norm.
+template<typename T>
+void richardsonLucy(Param<T> out, CParam<T> in, CParam<T> psf,
+                    const unsigned iterations, const float tolerance) {
+    const af::dim4 dims = in.dims();
+    deconv_workspace<T> ws(dims[0], dims[1]);
+
+    std::vector<T> observed(ws.pixels());
+    ws.load(observed, in);
+    ws.load(ws.x, in);
+    ws.loadPsf(psf, T(1) / static_cast<T>(ws.pixels()));
+
+    const dim_t grain = grainSize(4);
+    for (unsigned it = 0; it < iterations; ++it) {
+        ws.execute(ws.forwardX);
+        ws.multiplyPsf(false);
+        ws.execute(ws.inverse);
+        threadPool().parallel_for(
+            0, ws.pixels(), grain, [&](dim_t begin, dim_t end) {
+                for (dim_t i = begin; i < end; ++i) {
+                    ws.w[i] = observed[i] / ws.w[i];
+                }
+            });
+
+        ws.execute(ws.forwardW);
+        ws.multiplyPsf(true);
+        ws.execute(ws.inverse);
+        const change_norms norms = threadPool().parallel_reduce(
+            0, ws.pixels(), grain, change_norms(0.0, 0.0),
+            [&](dim_t begin, dim_t end) {
+                change_norms sums(0.0, 0.0);
+                for (dim_t i = begin; i < end; ++i) {
+                    const T prev = ws.x[i];
+                    const T next = prev * ws.w[i];
+                    ws.x[i]      = next;
+                    sums.first += double(next - prev) * double(next - prev);
+                    sums.second += double(next) * double(next);
+                }
+                return sums;
+            },
+            addNorms);
+        if (tolerance > 0.f && converged(norms, tolerance)) { break; }
+    }
+    ws.store(out, ws.x);
+}
+
+/// Landweber deconvolution of \p in, which is blurred by \p psf, both laid
+/// out as for richardsonLucy. The iteration
+/// X = X * (1 - relaxFactor * |P|^2) + relaxFactor * conj(P) * I
+/// works on every bin of the spectrum on its own. Without a \p tolerance
+/// all iterations of a bin are run in one go, otherwise the spectrum is
+/// updated one iteration at a time until the change of the estimate, whose
+/// norm is the weighted norm of its half spectrum, is small enough.
+template<typename T>
+void landweber(Param<T> out, CParam<T> in, CParam<T> psf,
+               const unsigned iterations, const float relaxFactor,
+               const float tolerance) {
+    using Tc = std::complex<T>;
+
+    const af::dim4 dims = in.dims();
+    deconv_workspace<T> ws(dims[0], dims[1]);
+
+    ws.loadPsf(psf, T(1));
+    ws.load(ws.x, in);
+    ws.execute(ws.forwardX);
+
+    // The spectrum of the input is the first estimate. The factors of the
+    // update replace the PSF spectrum: its real part is the factor of the
+    // estimate and its imaginary part is unused.
+    const T alpha = relaxFactor;
+    std::vector<Tc> rhs(ws.bins());
+    threadPool().parallel_for(
+        0, ws.bins(), grainSize(4), [&](dim_t begin, dim_t end) {
+            for (dim_t i = begin; i < end; ++i) {
+                const Tc p = ws.psf[i];
+                rhs[i]     = std::conj(p) * ws.spec[i] * alpha;
+                ws.psf[i]  = Tc(T(1) - alpha * std::norm(p), T(0));
+            }
+        });
+
+    if (tolerance > 0.f) {
+        for (unsigned it = 0; it < iterations; ++it) {
+            const change_norms norms = threadPool().parallel_reduce(
+                0, ws.bins(), grainSize(4), change_norms(0.0, 0.0),
+                [&](dim_t begin, dim_t end) {
+                    change_norms sums(0.0, 0.0);
+                    for (dim_t i = begin; i < end; ++i) {
+                        const Tc prev = ws.spec[i];
+                        const Tc next = prev * ws.psf[i].real() + rhs[i];
+                        ws.spec[i]      = next;
+                        const double wt = ws.weight(i);
+                        sums.first += wt * std::norm(next - prev);
+                        sums.second += wt * std::norm(next);
+                    }
+                    return sums;
+                },
+                addNorms);
+            if (converged(norms, tolerance)) { break; }
+        }
+    } else {
+        threadPool().parallel_for(
+            0, ws.bins(), grainSize(4 * iterations),
+            [&](dim_t begin, dim_t end) {
+                for (dim_t i = begin; i < end; ++i) {
+                    const T lhs = ws.psf[i].real();
+                    const Tc b  = rhs[i];
+                    Tc z        = ws.spec[i];
+                    for (unsigned it = 0; it < iterations; ++it) {
+                        z = z * lhs + b;
+                    }
+                    ws.spec[i] = z;
+                }
+            });
+    }
+
+    const T norm = T(1) / static_cast<T>(ws.pixels());
+    threadPool().parallel_for(
+        0, ws.bins(), grainSize(2), [&](dim_t begin, dim_t end) {
+            for (dim_t i = begin; i < end; ++i) { ws.spec[i] *= norm; }
+        });
+    ws.execute(ws.inverse);
+    ws.store(out, ws.w);
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -10,6 +10,11 @@
 #pragma once
 #include <Param.hpp>
 #include <math.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
@@ -28,25 +33,6 @@ inline int idx_x(int i) {
 
 inline int idx(int y, int x, unsigned idim0) { return x * idim0 + y; }
 
-// test_greater()
-// Tests if a pixel x > p + thr
-inline int test_greater(float x, float p, float thr) { return (x > p + thr); }
-
-// test_smaller()
-// Tests if a pixel x < p - thr
-inline int test_smaller(float x, float p, float thr) { return (x < p - thr); }
-
-// test_pixel()
-// Returns -1 when x < p - thr
-// Returns  0 when x >= p - thr && x <= p + thr
-// Returns  1 when x > p + thr
-template<typename T>
-inline int test_pixel(const T *image, const float p, float thr, int y, int x,
-                      unsigned idim0) {
-    return -test_smaller((float)image[idx(y, x, idim0)], p, thr) +
-           test_greater((float)image[idx(y, x, idim0)], p, thr);
-}
-
 // abs_diff()
 // Returns absolute difference of x and y
 inline int abs_diff(int x, int y) { return abs(x - y); }
@@ -56,159 +42,224 @@ inline unsigned abs_diff(unsigned x, unsigned y) {
 inline float abs_diff(float x, float y) { return fabs(x - y); }
 inline double abs_diff(double x, double y) { return fabs(x - y); }
 
+/// Offsets of the 16 pixels of the Bresenham circle of radius 3, in order
+/// around the circle, along dimension 0 (y) and dimension 1 (x). Points 0,
+/// 4, 8 and 12 are the cardinal ones.
+struct fast_circle {
+    int y[16], x[16];
+
+    fast_circle() {
+        for (int i = 0; i < 16; i++) {
+            y[i] = idx_y(i);
+            x[i] = idx_x(i);
+        }
+    }
+};
+
+/// Corner found at (y, x) with its score
+struct fast_feature {
+    unsigned y, x;
+    float score;
+};
+
+/// Whether the 16 bit circle \p mask holds a run of \p arc_length set bits,
+/// including the runs that wrap around from point 15 to point 0
+inline bool has_arc(unsigned mask, unsigned arc_length) {
+    const unsigned doubled = mask | (mask << 16);
+    unsigned run           = doubled;
+    for (unsigned k = 1; k < arc_length; k++) { run &= doubled >> k; }
+    return run != 0;
+}
+
+/// Runs the segment test on the pixels [y_begin, y_end) of column \p x.
+///
+/// Each block of pixels first compares the 4 cardinal points of their
+/// circles in a loop the compiler vectorises. An arc of at least 9 of the 16
+/// points contains at least arc_length / 4 of them, so the other pixels are
+/// rejected before their full circles are tested and scored.
 template<typename T>
-void locate_features(CParam<T> in, Param<float> score, Param<float> x_out,
-                     Param<float> y_out, Param<float> score_out,
-                     unsigned *count, float const thr,
-                     unsigned const arc_length, unsigned const nonmax,
-                     unsigned const max_feat, unsigned const edge) {
-    af::dim4 in_dims = in.dims();
-    T const *in_ptr  = in.get();
-
-    for (int y = edge; y < (int)(in_dims[0] - edge); y++) {
-        for (int x = edge; x < (int)(in_dims[1] - edge); x++) {
-            float p = in_ptr[idx(y, x, in_dims[0])];
-
-            // Start by testing opposite pixels of the circle that will result
-            // in a non-kepoint
-            int d;
-            d = test_pixel<T>(in_ptr, p, thr, y - 3, x, in_dims[0]) |
-                test_pixel<T>(in_ptr, p, thr, y + 3, x, in_dims[0]);
-            if (d == 0) continue;
-
-            d &= test_pixel<T>(in_ptr, p, thr, y - 2, x + 2, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y + 2, x - 2, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y, x + 3, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y, x - 3, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y + 2, x + 2, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y - 2, x - 2, in_dims[0]);
-            if (d == 0) continue;
-
-            d &= test_pixel<T>(in_ptr, p, thr, y - 3, x + 1, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y + 3, x - 1, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y - 1, x + 3, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y + 1, x - 3, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y + 1, x + 3, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y - 1, x - 3, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y + 3, x + 1, in_dims[0]) |
-                 test_pixel<T>(in_ptr, p, thr, y - 3, x - 1, in_dims[0]);
-            if (d == 0) continue;
-
-            int sum = 0;
-
-            // Sum responses [-1, 0 or 1] of first arc_length pixels
-            for (int i = 0; i < static_cast<int>(arc_length); i++)
-                sum += test_pixel<T>(in_ptr, p, thr, y + idx_y(i), x + idx_x(i),
-                                     in_dims[0]);
-
-            // Test maximum and mininmum responses of first segment of
-            // arc_length pixels
-            int max_sum = 0, min_sum = 0;
-            max_sum = std::max(max_sum, sum);
-            min_sum = std::min(min_sum, sum);
-
-            // Sum responses and test the remaining 16-arc_length pixels of the
-            // circle
-            for (int i = arc_length; i < 16; i++) {
-                sum -= test_pixel<T>(in_ptr, p, thr, y + idx_y(i - arc_length),
-                                     x + idx_x(i - arc_length), in_dims[0]);
-                sum += test_pixel<T>(in_ptr, p, thr, y + idx_y(i), x + idx_x(i),
-                                     in_dims[0]);
-                max_sum = std::max(max_sum, sum);
-                min_sum = std::min(min_sum, sum);
-            }
+void segment_test_column(std::vector<fast_feature> &found, const T *in_ptr,
+                         const unsigned idim0, const fast_circle &circle,
+                         const int x, const int y_begin, const int y_end,
+                         const float thr, const unsigned arc_length) {
+    constexpr int block = 64;
+    const int cardinals = static_cast<int>(arc_length / 4);
+
+    int offset[16];
+    for (int i = 0; i < 16; i++) {
+        offset[i] = idx(y_begin + circle.y[i], x + circle.x[i], idim0) -
+                    idx(y_begin, x, idim0);
+    }
 
-            // To completely test all possible segments, it's necessary to test
-            // segments that include the top junction of the circle
-            for (int i = 0; i < static_cast<int>(arc_length - 1); i++) {
-                sum -= test_pixel<T>(
-                    in_ptr, p, thr, y + idx_y(16 - arc_length + i),
-                    x + idx_x(16 - arc_length + i), in_dims[0]);
-                sum += test_pixel<T>(in_ptr, p, thr, y + idx_y(i), x + idx_x(i),
-                                     in_dims[0]);
-                max_sum = std::max(max_sum, sum);
-                min_sum = std::min(min_sum, sum);
+    const T *center = in_ptr + idx(y_begin, x, idim0);
+    unsigned char candidate[block];
+
+    for (int b = 0; b < y_end - y_begin; b += block) {
+        const int n = std::min(block, y_end - y_begin - b);
+        const T *c  = center + b;
+
+        for (int k = 0; k < n; k++) {
+            const float p  = (float)c[k];
+            const float hi = p + thr;
+            const float lo = p - thr;
+            const float c0 = (float)c[k + offset[0]];
+            const float c1 = (float)c[k + offset[4]];
+            const float c2 = (float)c[k + offset[8]];
+            const float c3 = (float)c[k + offset[12]];
+            const int bright = (c0 > hi) + (c1 > hi) + (c2 > hi) + (c3 > hi);
+            const int dark   = (c0 < lo) + (c1 < lo) + (c2 < lo) + (c3 < lo);
+            candidate[k] = (bright >= cardinals) | (dark >= cardinals);
+        }
+
+        for (int k = 0; k < n; k++) {
+            if (!candidate[k]) { continue; }
+
+            const float p  = (float)c[k];
+            const float hi = p + thr;
+            const float lo = p - thr;
+            unsigned bright = 0, dark = 0;
+            for (int i = 0; i < 16; i++) {
+                const float v = (float)c[k + offset[i]];
+                bright |= unsigned(v > hi) << i;
+                dark |= unsigned(v < lo) << i;
+            }
+            if (!has_arc(bright, arc_length) && !has_arc(dark, arc_length)) {
+                continue;
             }
 
             float s_bright = 0, s_dark = 0;
             for (int i = 0; i < 16; i++) {
-                float p_x =
-                    (float)in_ptr[idx(y + idx_y(i), x + idx_x(i), in_dims[0])];
-
-                s_bright +=
-                    test_greater(p_x, p, thr) * (abs_diff(p_x, p) - thr);
-                s_dark += test_smaller(p_x, p, thr) * (abs_diff(p, p_x) - thr);
+                const float v = (float)c[k + offset[i]];
+                if (bright >> i & 1u) { s_bright += abs_diff(v, p) - thr; }
+                if (dark >> i & 1u) { s_dark += abs_diff(p, v) - thr; }
             }
+            found.push_back({static_cast<unsigned>(y_begin + b + k),
+                             static_cast<unsigned>(x),
+                             std::max(s_bright, s_dark)});
+        }
+    }
+}
 
-            // If sum at some point was equal to (+-)arc_length, there is a
-            // segment that for which all pixels are much brighter or much
-            // brighter than central pixel p.
-            if (max_sum == static_cast<int>(arc_length) ||
-                min_sum == -static_cast<int>(arc_length)) {
-                unsigned j = *count;
-                ++*count;
-                if (j < max_feat) {
-                    float *x_out_ptr     = x_out.get();
-                    float *y_out_ptr     = y_out.get();
-                    float *score_out_ptr = score_out.get();
-                    x_out_ptr[j]         = static_cast<float>(x);
-                    y_out_ptr[j]         = static_cast<float>(y);
-                    score_out_ptr[j] =
-                        static_cast<float>(std::max(s_bright, s_dark));
-                    if (nonmax == 1) {
-                        float *score_ptr = score.get();
-                        score_ptr[idx(y, x, in_dims[0])] =
-                            std::max(s_bright, s_dark);
-                    }
-                }
+/// Finds the FAST corners of \p in, threading over the columns. The first
+/// \p max_feat corners ordered by y, then x, are written out and \p count
+/// is set to the number of corners found.
+template<typename T>
+void locate_features(CParam<T> in, Param<float> score, Param<float> x_out,
+                     Param<float> y_out, Param<float> score_out,
+                     unsigned *count, float const thr,
+                     unsigned const arc_length, unsigned const nonmax,
+                     unsigned const max_feat, unsigned const edge) {
+    const af::dim4 in_dims = in.dims();
+    const unsigned idim0   = static_cast<unsigned>(in_dims[0]);
+    const int y_begin      = static_cast<int>(edge);
+    const int y_end        = static_cast<int>(in_dims[0] - edge);
+    const int x_begin      = static_cast<int>(edge);
+    const int x_end        = static_cast<int>(in_dims[1] - edge);
+
+    *count = 0;
+    if (y_end <= y_begin || x_end <= x_begin) { return; }
+
+    const fast_circle circle;
+    std::vector<std::vector<fast_feature>> columns(x_end - x_begin);
+    threadPool().parallel_for(
+        x_begin, x_end, grainSize(16 * (y_end - y_begin)),
+        [&](dim_t begin, dim_t end) {
+            for (dim_t x = begin; x < end; ++x) {
+                segment_test_column(columns[x - x_begin], in.get(), idim0,
+                                    circle, static_cast<int>(x), y_begin,
+                                    y_end, thr, arc_length);
             }
+        });
+
+    // The corners come out column by column; bucket them by y, scattering
+    // the columns in order, to report them ordered by y, then x
+    std::vector<unsigned> row_start(y_end - y_begin + 1, 0);
+    for (auto &column : columns) {
+        for (const fast_feature &f : column) { row_start[f.y - y_begin + 1]++; }
+    }
+    for (size_t r = 1; r < row_start.size(); r++) {
+        row_start[r] += row_start[r - 1];
+    }
+    std::vector<fast_feature> features(row_start.back());
+    for (auto &column : columns) {
+        for (const fast_feature &f : column) {
+            features[row_start[f.y - y_begin]++] = f;
         }
     }
+
+    *count             = static_cast<unsigned>(features.size());
+    const unsigned len = std::min(*count, max_feat);
+
+    float *x_out_ptr     = x_out.get();
+    float *y_out_ptr     = y_out.get();
+    float *score_out_ptr = score_out.get();
+    float *score_ptr     = score.get();
+    for (unsigned j = 0; j < len; j++) {
+        const fast_feature &f = features[j];
+        x_out_ptr[j]          = static_cast<float>(f.x);
+        y_out_ptr[j]          = static_cast<float>(f.y);
+        score_out_ptr[j]      = f.score;
+        if (nonmax == 1) { score_ptr[idx(f.y, f.x, idim0)] = f.score; }
+    }
 }
 
-void non_maximal(CParam<float> score, CParam<float> x_in, CParam<float> y_in,
-                 Param<float> x_out, Param<float> y_out, Param<float> score_out,
-                 unsigned *count, unsigned const total_feat,
-                 unsigned const edge) {
+/// Keeps the features whose score is above the scores of their 8 neighbours,
+/// in their input order. The features are tested in parallel.
+inline void non_maximal(CParam<float> score, CParam<float> x_in,
+                        CParam<float> y_in, Param<float> x_out,
+                        Param<float> y_out, Param<float> score_out,
+                        unsigned *count, unsigned const total_feat,
+                        unsigned const edge) {
     float const *score_ptr = score.get();
     float const *x_in_ptr  = x_in.get();
     float const *y_in_ptr  = y_in.get();
 
     af::dim4 score_dims = score.dims();
 
+    std::vector<unsigned char> keep(total_feat, 0);
+    threadPool().parallel_for(
+        0, total_feat, grainSize(16), [&](dim_t begin, dim_t end) {
+            for (dim_t k = begin; k < end; k++) {
+                unsigned x = static_cast<unsigned>(round(x_in_ptr[k]));
+                unsigned y = static_cast<unsigned>(round(y_in_ptr[k]));
+
+                if (y >= score_dims[1] - edge - 1 || y <= edge + 1 ||
+                    x >= score_dims[0] - edge - 1 || x <= edge + 1) {
+                    continue;
+                }
+
+                float v = score_ptr[y + score_dims[0] * x];
+                float max_v;
+                max_v = std::max(score_ptr[y - 1 + score_dims[0] * (x - 1)],
+                                 score_ptr[y - 1 + score_dims[0] * x]);
+                max_v = std::max(max_v,
+                                 score_ptr[y - 1 + score_dims[0] * (x + 1)]);
+                max_v = std::max(max_v, score_ptr[y + score_dims[0] * (x - 1)]);
+                max_v = std::max(max_v, score_ptr[y + score_dims[0] * (x + 1)]);
+                max_v = std::max(max_v,
+                                 score_ptr[y + 1 + score_dims[0] * (x - 1)]);
+                max_v = std::max(max_v, score_ptr[y + 1 + score_dims[0] * (x)]);
+                max_v = std::max(max_v,
+                                 score_ptr[y + 1 + score_dims[0] * (x + 1)]);
+
+                // Keeps the keypoint if its response is the maximum of its
+                // 8-neighborhood
+                keep[k] = v > max_v;
+            }
+        });
+
+    float *x_out_ptr     = x_out.get();
+    float *y_out_ptr     = y_out.get();
+    float *score_out_ptr = score_out.get();
     for (unsigned k = 0; k < total_feat; k++) {
+        if (!keep[k]) { continue; }
         unsigned x = static_cast<unsigned>(round(x_in_ptr[k]));
         unsigned y = static_cast<unsigned>(round(y_in_ptr[k]));
 
-        float v = score_ptr[y + score_dims[0] * x];
-        float max_v;
-        max_v = std::max(score_ptr[y - 1 + score_dims[0] * (x - 1)],
-                         score_ptr[y - 1 + score_dims[0] * x]);
-        max_v = std::max(max_v, score_ptr[y - 1 + score_dims[0] * (x + 1)]);
-        max_v = std::max(max_v, score_ptr[y + score_dims[0] * (x - 1)]);
-        max_v = std::max(max_v, score_ptr[y + score_dims[0] * (x + 1)]);
-        max_v = std::max(max_v, score_ptr[y + 1 + score_dims[0] * (x - 1)]);
-        max_v = std::max(max_v, score_ptr[y + 1 + score_dims[0] * (x)]);
-        max_v = std::max(max_v, score_ptr[y + 1 + score_dims[0] * (x + 1)]);
-
-        if (y >= score_dims[1] - edge - 1 || y <= edge + 1 ||
-            x >= score_dims[0] - edge - 1 || x <= edge + 1)
-            continue;
-
-        // Stores keypoint to feat_out if it's response is maximum compared to
-        // its 8-neighborhood
-        if (v > max_v) {
-            unsigned j = *count;
-            ++*count;
-
-            float *x_out_ptr     = x_out.get();
-            float *y_out_ptr     = y_out.get();
-            float *score_out_ptr = score_out.get();
-
-            x_out_ptr[j]     = static_cast<float>(x);
-            y_out_ptr[j]     = static_cast<float>(y);
-            score_out_ptr[j] = static_cast<float>(v);
-        }
+        unsigned j = (*count)++;
+        x_out_ptr[j]     = static_cast<float>(x);
+        y_out_ptr[j]     = static_cast<float>(y);
+        score_out_ptr[j] = score_ptr[y + score_dims[0] * x];
     }
 }
 
@@ -9,112 +9,328 @@
 
 #pragma once
 
-#include <ParamIterator.hpp>
+#include <Param.hpp>
 #include <common/defines.hpp>
+#include <thread_pool.hpp>
 
-#include <queue>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
-// Output array is set to the following values during the progression
-// of the algorithm.
+// State of every pixel during a fill, kept in a mask of the image size
 //
-// 0 - not visited at all (default values in output because it was created
-//                         using createValueArray helper at level of the
-//                         functions caller)
-// 1 - not valid
-// 2 - valid (candidate for neighborhood walk, pushed onto the queue)
-//
-// Once, the algorithm is finished, output is reset
-// to either zero or \p newValue for all valid pixels.
-template<typename T>
-void floodFill(Param<T> out, CParam<T> in, CParam<uint> x, CParam<uint> y,
-               T newValue, T lower, T upper, af::connectivity connectivity) {
-    UNUSED(connectivity);
+// rejected  - outside the threshold limits
+// candidate - within the limits, not reached yet
+// filled    - part of the segmented region; seeds are filled up front
+//             whether or not they are within the limits
+enum : uchar { rejected = 0, candidate = 1, filled = 2 };
 
-    using af::dim4;
-    using PtrDist    = typename ParamIterator<T>::difference_type;
-    using Point      = std::pair<uint, uint>;
-    using Candidates = std::queue<Point>;
+/// Pixel mask of one image with the region grown so far
+class fill_mask {
+   public:
+    fill_mask(dim_t d0, dim_t d1)
+        : d0(d0), d1(d1), state(d0 * d1), rowHasFilled(d1, 0) {}
 
-    const dim4 dims    = in.dims();
-    const dim4 strides = in.strides();
+    uchar *row(dim_t y) { return state.data() + y * d0; }
+    const uchar *row(dim_t y) const { return state.data() + y * d0; }
 
-    ParamIterator<T> endOfNeighborhood;
-    const dim4 nhoodRadii(1, 1, 0, 0);
-    const dim4 nhood(2 * nhoodRadii[0] + 1, 2 * nhoodRadii[1] + 1,
-                     2 * nhoodRadii[2] + 1, 2 * nhoodRadii[3] + 1);
+    void fill(dim_t x, dim_t y) {
+        row(y)[x]       = filled;
+        rowHasFilled[y] = 1;
+    }
 
-    auto isInside = [&dims](uint x, uint y) {
-        return (x >= 0 && x < dims[0] && y >= 0 && y < dims[1]);
-    };
-    auto leftTopPtr = [&strides, &nhoodRadii](T* ptr, const af::dim4& center) {
-        T* ltPtr = ptr;
-        for (dim_t d = 0; d < AF_MAX_DIMS; ++d) {
-            ltPtr += ((center[d] - nhoodRadii[d]) * strides[d]);
+    const dim_t d0, d1;
+    std::vector<uchar> state;
+    // Rows holding any pixel filled before the fill starts
+    std::vector<uchar> rowHasFilled;
+};
+
+template<typename T>
+void thresholdRow(uchar *dst, const T *src, const dim_t step, const dim_t n,
+                  const T lower, const T upper) {
+    for (dim_t x = 0; x < n; ++x) {
+        const T v = src[x * step];
+        dst[x]    = static_cast<uchar>(v >= lower && v <= upper);
+    }
+}
+
+/// Marks the pixels within [lower, upper] as candidates
+template<typename T>
+void thresholdMask(fill_mask &mask, CParam<T> in, const T lower,
+                   const T upper) {
+    const af::dim4 strides = in.strides();
+    threadPool().parallel_for(
+        0, mask.d1, grainSize(mask.d0), [&](dim_t begin, dim_t end) {
+            for (dim_t y = begin; y < end; ++y) {
+                const T *src = in.get() + y * strides[1];
+                if (strides[0] == 1) {
+                    thresholdRow(mask.row(y), src, 1, mask.d0, lower, upper);
+                } else {
+                    thresholdRow(mask.row(y), src, strides[0], mask.d0, lower,
+                                 upper);
+                }
+            }
+        });
+}
+
+/// Grows the filled pixels through the candidates one horizontal span at a
+/// time: every span is filled in full and the rows above and below are
+/// scanned once for the runs of candidates it touches. Only the pixels of
+/// the region and its border are visited.
+inline void scanlineFill(fill_mask &mask, const dim_t diagonal) {
+    using Point = std::pair<dim_t, dim_t>;
+    const dim_t d0 = mask.d0, d1 = mask.d1;
+
+    // Start from every candidate next to a pixel filled up front
+    std::vector<Point> stack;
+    for (dim_t y = 0; y < d1; ++y) {
+        const dim_t y0 = std::max<dim_t>(y - 1, 0);
+        const dim_t y1 = std::min<dim_t>(y + 1, d1 - 1);
+        bool nearFilled = false;
+        for (dim_t ny = y0; ny <= y1; ++ny) {
+            nearFilled |= mask.rowHasFilled[ny] != 0;
         }
-        return ltPtr;
-    };
-    Candidates queue;
-    {
-        auto oit = begin(out);
-        for (auto xit = begin(x), yit = begin(y);
-             xit != end(x) && yit != end(y); ++xit, ++yit) {
-            if (isInside(*xit, *yit)) {
-                queue.emplace(*xit, *yit);
-                oit.operator->()[(*xit) + (*yit) * dims[0]] = T(2);
+        if (!nearFilled) { continue; }
+
+        const uchar *row = mask.row(y);
+        for (dim_t x = 0; x < d0; ++x) {
+            if (row[x] != candidate) { continue; }
+            for (dim_t ny = y0; ny <= y1; ++ny) {
+                const dim_t reach = ny == y ? 1 : diagonal;
+                const dim_t x0    = std::max<dim_t>(x - reach, 0);
+                const dim_t x1    = std::min<dim_t>(x + reach, d0 - 1);
+                const uchar *nrow = mask.row(ny);
+                bool touches      = false;
+                for (dim_t nx = x0; nx <= x1; ++nx) {
+                    touches |= nrow[nx] == filled;
+                }
+                if (touches) {
+                    stack.emplace_back(x, y);
+                    break;
+                }
             }
         }
     }
 
-    T* inPtr  = const_cast<T*>(in.get());
-    T* outPtr = out.get();
+    while (!stack.empty()) {
+        const Point p = stack.back();
+        stack.pop_back();
 
-    while (!queue.empty()) {
-        Point& p = queue.front();
+        uchar *row = mask.row(p.second);
+        if (row[p.first] != candidate) { continue; }
 
-        const dim4 center(p.first, p.second, 0, 0);
+        dim_t left = p.first, right = p.first;
+        while (left > 0 && row[left - 1] == candidate) { --left; }
+        while (right + 1 < d0 && row[right + 1] == candidate) { ++right; }
+        std::fill(row + left, row + right + 1, filled);
 
-        CParam<T> inNHood(const_cast<const T*>(leftTopPtr(inPtr, center)),
-                          nhood, strides);
-        Param<T> outNHood(leftTopPtr(outPtr, center), nhood, strides);
+        const dim_t x0 = std::max<dim_t>(left - diagonal, 0);
+        const dim_t x1 = std::min<dim_t>(right + diagonal, d0 - 1);
+        for (dim_t ny = p.second - 1; ny <= p.second + 1; ny += 2) {
+            if (ny < 0 || ny >= d1) { continue; }
+            const uchar *nrow = mask.row(ny);
+            for (dim_t x = x0; x <= x1; ++x) {
+                if (nrow[x] == candidate &&
+                    (x == x0 || nrow[x - 1] != candidate)) {
+                    stack.emplace_back(x, ny);
+                }
+            }
+        }
+    }
+}
 
-        ParamIterator<T> inIter(inNHood);
-        ParamIterator<T> outIter(outNHood);
+/// Horizontal run of candidate or filled pixels, [begin, end) of row y
+struct fill_run {
+    dim_t y, begin, end;
+    bool seeded;
+};
 
-        while (inIter != endOfNeighborhood) {
-            const T* ptr     = inIter.operator->();
-            PtrDist dist     = ptr - inPtr;
-            const uint currx = static_cast<uint>(dist % dims[0]);
-            const uint curry = static_cast<uint>(dist / dims[0]);
+/// Grows the filled pixels through the candidates by labelling the runs of
+/// the whole image with a union find. The rows are split between the
+/// threads, each joins the runs of its own rows, and the joins across the
+/// rows where the threads' ranges meet are made last. The region is the
+/// union of the sets holding a filled pixel.
+inline void unionFindFill(fill_mask &mask, const dim_t diagonal) {
+    const dim_t d0 = mask.d0, d1 = mask.d1;
+    const dim_t grain = grainSize(d0);
 
-            if (isInside(currx, curry) && (*outIter == 0)) {
-                // Current point is inside image boundaries and hasn't been
-                // visited at all.
-                if (*inIter >= lower && *inIter <= upper) {
-                    // Current pixel is within threshold limits.
-                    // Mark as valid and push on to the queue
-                    *outIter = T(2);
-                    queue.emplace(currx, curry);
-                } else {
-                    // Not valid pixel
-                    *outIter = T(1);
+    // Runs of every row, numbered in row order
+    std::vector<dim_t> rowStart(d1 + 1, 0);
+    threadPool().parallel_for(0, d1, grain, [&](dim_t begin, dim_t end) {
+        for (dim_t y = begin; y < end; ++y) {
+            const uchar *row = mask.row(y);
+            dim_t count      = 0;
+            for (dim_t x = 0; x < d0; ++x) {
+                const bool starts = x == 0 || row[x - 1] == rejected;
+                count += row[x] != rejected && starts;
+            }
+            rowStart[y + 1] = count;
+        }
+    });
+    std::partial_sum(rowStart.begin(), rowStart.end(), rowStart.begin());
+
+    std::vector<fill_run> runs(rowStart[d1]);
+    std::vector<dim_t> parent(runs.size());
+    std::iota(parent.begin(), parent.end(), dim_t(0));
+
+    auto find = [&parent](dim_t r) {
+        while (parent[r] != r) {
+            parent[r] = parent[parent[r]];
+            r         = parent[r];
+        }
+        return r;
+    };
+    auto join = [&](dim_t a, dim_t b) {
+        a = find(a);
+        b = find(b);
+        if (a != b) { parent[std::max(a, b)] = std::min(a, b); }
+    };
+    // Joins the runs of row y with the runs of row y + 1 that touch them
+    auto joinRows = [&](dim_t y) {
+        dim_t i = rowStart[y], j = rowStart[y + 1];
+        while (i < rowStart[y + 1] && j < rowStart[y + 2]) {
+            const fill_run &a = runs[i];
+            const fill_run &b = runs[j];
+            if (a.begin < b.end + diagonal && b.begin < a.end + diagonal) {
+                join(i, j);
+            }
+            if (a.end < b.end) {
+                ++i;
+            } else {
+                ++j;
+            }
+        }
+    };
+
+    std::vector<uchar> chunkStart(d1, 0);
+    threadPool().parallel_for(0, d1, grain, [&](dim_t begin, dim_t end) {
+        chunkStart[begin] = 1;
+        for (dim_t y = begin; y < end; ++y) {
+            const uchar *row = mask.row(y);
+            dim_t r          = rowStart[y];
+            for (dim_t x = 0; x < d0;) {
+                if (row[x] == rejected) {
+                    ++x;
+                    continue;
                 }
+                fill_run &run = runs[r++];
+                run.y         = y;
+                run.begin     = x;
+                run.seeded    = false;
+                for (; x < d0 && row[x] != rejected; ++x) {
+                    run.seeded |= row[x] == filled;
+                }
+                run.end = x;
             }
-            // Both input and output neighborhood iterators
-            // should increment in lock step for this algorithm
-            // to work correctly
-            ++inIter;
-            ++outIter;
         }
-        queue.pop();
+        // Sets only ever join runs of this range, so the threads don't
+        // touch each other's parents
+        for (dim_t y = begin; y + 1 < end; ++y) { joinRows(y); }
+    });
+    for (dim_t y = 1; y < d1; ++y) {
+        if (chunkStart[y]) { joinRows(y - 1); }
+    }
+
+    std::vector<uchar> selected(runs.size(), 0);
+    for (dim_t r = 0; r < static_cast<dim_t>(runs.size()); ++r) {
+        parent[r] = find(r);
+        if (runs[r].seeded) { selected[parent[r]] = 1; }
     }
 
-    for (auto outIter = begin(out); outIter != end(out); ++outIter) {
-        *outIter = (*outIter == T(2) ? newValue : T(0));
+    threadPool().parallel_for(
+        0, static_cast<dim_t>(runs.size()), grainSize(d0),
+        [&](dim_t begin, dim_t end) {
+            for (dim_t r = begin; r < end; ++r) {
+                const fill_run &run = runs[r];
+                if (selected[parent[r]]) {
+                    uchar *row = mask.row(run.y);
+                    std::fill(row + run.begin, row + run.end, filled);
+                }
+            }
+        });
+}
+
+/// Grows the filled pixels of \p mask through the candidates. A single
+/// thread fills span by span; with more threads the whole image is
+/// labelled in parallel instead.
+inline void growRegion(fill_mask &mask, const af::connectivity connectivity) {
+    const dim_t diagonal = connectivity == AF_CONNECTIVITY_8 ? 1 : 0;
+    if (threadPool().size() > 1 && mask.d1 > 1) {
+        unionFindFill(mask, diagonal);
+    } else {
+        scanlineFill(mask, diagonal);
+    }
+}
+
+/// Writes \p newValue to the filled pixels and zero everywhere else
+template<typename T>
+void writeRegion(Param<T> out, const fill_mask &mask, const T newValue) {
+    const af::dim4 strides = out.strides();
+    threadPool().parallel_for(
+        0, mask.d1, grainSize(mask.d0), [&](dim_t begin, dim_t end) {
+            for (dim_t y = begin; y < end; ++y) {
+                const uchar *src = mask.row(y);
+                T *dst           = out.get() + y * strides[1];
+                for (dim_t x = 0; x < mask.d0; ++x) {
+                    dst[x] = src[x] == filled ? newValue : T(0);
+                }
+            }
+        });
+}
+
+/// Fills the region of pixels within [lower, upper] connected to the seeds
+/// (x, y). Seeds outside the image are ignored; the others are part of the
+/// region whether or not they are within the limits.
+template<typename T>
+void floodFill(Param<T> out, CParam<T> in, CParam<uint> x, CParam<uint> y,
+               T newValue, T lower, T upper, af::connectivity connectivity) {
+    const af::dim4 dims = in.dims();
+
+    fill_mask mask(dims[0], dims[1]);
+    thresholdMask(mask, in, lower, upper);
+
+    const dim_t numSeeds = std::min(x.dims().elements(), y.dims().elements());
+    for (dim_t s = 0; s < numSeeds; ++s) {
+        const uint sx = x.get()[s * x.strides()[0]];
+        const uint sy = y.get()[s * y.strides()[0]];
+        if (sx < dims[0] && sy < dims[1]) { mask.fill(sx, sy); }
     }
+
+    growRegion(mask, connectivity);
+    writeRegion(out, mask, newValue);
+}
+
+/// Grows the non zero pixels of \p previous through the pixels within
+/// [lower, upper]. This is the fill from the seeds of \p previous whenever
+/// the limits contain the ones \p previous was filled with, because every
+/// pixel of the old region is then reached again.
+template<typename T>
+void floodFillGrow(Param<T> out, CParam<T> in, CParam<T> previous,
+                   T newValue, T lower, T upper,
+                   af::connectivity connectivity) {
+    const af::dim4 dims    = in.dims();
+    const af::dim4 strides = previous.strides();
+
+    fill_mask mask(dims[0], dims[1]);
+    thresholdMask(mask, in, lower, upper);
+
+    threadPool().parallel_for(
+        0, dims[1], grainSize(dims[0]), [&](dim_t begin, dim_t end) {
+            for (dim_t y = begin; y < end; ++y) {
+                const T *src = previous.get() + y * strides[1];
+                for (dim_t x = 0; x < dims[0]; ++x) {
+                    if (src[x * strides[0]] != T(0)) { mask.fill(x, y); }
+                }
+            }
+        });
+
+    growRegion(mask, connectivity);
+    writeRegion(out, mask, newValue);
 }
 
 }  // namespace kernel
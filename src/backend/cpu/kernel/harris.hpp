@@ -9,111 +9,237 @@
 
 #pragma once
 #include <Param.hpp>
+#include <kernel/corners.hpp>
+#include <math.hpp>
+#include <thread_pool.hpp>
 #include <utility.hpp>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace cpu {
 namespace kernel {
 
+/// Derivatives of column \p c of a d0 x d1 image as computed by gradient:
+/// central differences inside the image, one sided ones on its border.
+/// \p ix is the derivative along dim 1, \p iy the one along dim 0.
 template<typename T>
-void second_order_deriv(Param<T> ixx, Param<T> ixy, Param<T> iyy,
-                        const unsigned in_len, CParam<T> ix, CParam<T> iy) {
-    T* ixx_out     = ixx.get();
-    T* ixy_out     = ixy.get();
-    T* iyy_out     = iyy.get();
-    const T* ix_in = ix.get();
-    const T* iy_in = iy.get();
-    for (unsigned x = 0; x < in_len; x++) {
-        ixx_out[x] = ix_in[x] * ix_in[x];
-        ixy_out[x] = ix_in[x] * iy_in[x];
-        iyy_out[x] = iy_in[x] * iy_in[x];
+void gradientColumn(T* ix, T* iy, const T* in, const dim_t stride1,
+                    const dim_t d0, const dim_t d1, const dim_t c) {
+    const T half  = scalar<T>(0.5);
+    const T one   = scalar<T>(1.0);
+    const T* cur  = in + c * stride1;
+    const T* prev = in + (c == 0 ? c : c - 1) * stride1;
+    const T* next = in + (c == d1 - 1 ? c : c + 1) * stride1;
+
+    const T f1 = (c == 0 || c == d1 - 1) ? one : half;
+    for (dim_t i = 0; i < d0; ++i) { ix[i] = f1 * (next[i] - prev[i]); }
+
+    iy[0] = one * (cur[1] - cur[0]);
+    for (dim_t i = 1; i < d0 - 1; ++i) {
+        iy[i] = half * (cur[i + 1] - cur[i - 1]);
     }
+    iy[d0 - 1] = one * (cur[d0 - 1] - cur[d0 - 2]);
 }
 
+/// Adds \p src[i + shift] * \p weight to \p acc[i] for the i that stay in
+/// [0, n); the others see a zero outside the column
 template<typename T>
-void harris_responses(Param<T> resp, const unsigned idim0, const unsigned idim1,
-                      CParam<T> ixx, CParam<T> ixy, CParam<T> iyy,
-                      const float k_thr, const unsigned border_len) {
-    T* resp_out      = resp.get();
-    const T* ixx_in  = ixx.get();
-    const T* ixy_in  = ixy.get();
-    const T* iyy_in  = iyy.get();
-    const unsigned r = border_len;
-
-    for (unsigned x = r; x < idim1 - r; x++) {
-        for (unsigned y = r; y < idim0 - r; y++) {
-            const unsigned idx = x * idim0 + y;
-
-            // Calculates matrix trace and determinant
-            T tr  = ixx_in[idx] + iyy_in[idx];
-            T det = ixx_in[idx] * iyy_in[idx] - ixy_in[idx] * ixy_in[idx];
-
-            // Calculates local Harris response
-            resp_out[idx] = det - k_thr * (tr * tr);
-        }
-    }
+void addShifted(T* acc, const T* src, const dim_t n, const dim_t shift,
+                const T weight) {
+    const dim_t begin = std::max<dim_t>(0, -shift);
+    const dim_t end   = std::min<dim_t>(n, n - shift);
+    for (dim_t i = begin; i < end; ++i) { acc[i] += src[i + shift] * weight; }
 }
 
+/// Entries of the structure tensor of an image, summed over a window of
+/// length len along both dimensions with the image zero padded, as two
+/// passes of convolve2 with the window filter would. The first pass sums
+/// the products of the derivatives along dim 0 for all columns up front;
+/// the second one runs per column as the responses are asked for.
+///
+/// An empty filter is the box window. Its sums are taken from running sums
+/// in double, so each pixel costs the same whatever the window length.
 template<typename T>
-void non_maximal(Param<float> xOut, Param<float> yOut, Param<float> respOut,
-                 unsigned* count, const unsigned idim0, const unsigned idim1,
-                 CParam<T> respIn, const float min_resp,
-                 const unsigned border_len, const unsigned max_corners) {
-    float* x_out     = xOut.get();
-    float* y_out     = yOut.get();
-    float* resp_out  = respOut.get();
-    const T* resp_in = respIn.get();
-    // Responses on the border don't have 8-neighbors to compare, discard them
-    const unsigned r = border_len + 1;
-
-    for (unsigned x = r; x < idim1 - r; x++) {
-        for (unsigned y = r; y < idim0 - r; y++) {
-            const T v = resp_in[x * idim0 + y];
-
-            // Find maximum neighborhood response
-            T max_v;
-            max_v = std::max(resp_in[(x - 1) * idim0 + y - 1],
-                             resp_in[x * idim0 + y - 1]);
-            max_v = std::max(max_v, resp_in[(x + 1) * idim0 + y - 1]);
-            max_v = std::max(max_v, resp_in[(x - 1) * idim0 + y]);
-            max_v = std::max(max_v, resp_in[(x + 1) * idim0 + y]);
-            max_v = std::max(max_v, resp_in[(x - 1) * idim0 + y + 1]);
-            max_v = std::max(max_v, resp_in[(x)*idim0 + y + 1]);
-            max_v = std::max(max_v, resp_in[(x + 1) * idim0 + y + 1]);
-
-            // Stores corner to {x,y,resp}_out if it's response is maximum
-            // compared to its 8-neighborhood and greater or equal minimum
-            // response
-            if (v > max_v && v >= (T)min_resp) {
-                const unsigned idx = *count;
-                *count += 1;
-                if (idx < max_corners) {
-                    x_out[idx]    = (float)x;
-                    y_out[idx]    = (float)y;
-                    resp_out[idx] = (float)v;
+class structure_tensor {
+   public:
+    structure_tensor(const dim_t d0, const dim_t d1, std::vector<T> filter,
+                     const dim_t len)
+        : d0(d0)
+        , d1(d1)
+        , len(len)
+        , half(len / 2)
+        , filter(std::move(filter))
+        , xx(d0 * d1)
+        , xy(d0 * d1)
+        , yy(d0 * d1) {}
+
+    bool isBox() const { return filter.empty(); }
+
+    /// Sums the products of the derivatives of \p in along dim 0
+    void sumColumns(CParam<T> in) {
+        const dim_t stride1 = in.strides()[1];
+        threadPool().parallel_for(
+            0, d1, grainSize(d0 * (3 * len + 8)), [&](dim_t begin, dim_t end) {
+                std::vector<T> ix(d0), iy(d0);
+                std::vector<T> pxx(d0), pxy(d0), pyy(d0);
+                std::vector<double> prefix(d0 + 1);
+                for (dim_t c = begin; c < end; ++c) {
+                    gradientColumn(ix.data(), iy.data(), in.get(), stride1, d0,
+                                   d1, c);
+                    for (dim_t i = 0; i < d0; ++i) {
+                        pxx[i] = ix[i] * ix[i];
+                        pxy[i] = ix[i] * iy[i];
+                        pyy[i] = iy[i] * iy[i];
+                    }
+                    T* oxx = xx.data() + c * d0;
+                    T* oxy = xy.data() + c * d0;
+                    T* oyy = yy.data() + c * d0;
+                    if (isBox()) {
+                        boxColumn(oxx, pxx.data(), prefix.data());
+                        boxColumn(oxy, pxy.data(), prefix.data());
+                        boxColumn(oyy, pyy.data(), prefix.data());
+                    } else {
+                        filterColumn(oxx, pxx.data());
+                        filterColumn(oxy, pxy.data());
+                        filterColumn(oyy, pyy.data());
+                    }
+                }
+            });
+    }
+
+    /// Harris responses det - k * tr^2 of the columns, written to the rows
+    /// [border, d0 - border). Keeps the window sums of the last column for
+    /// the box window, so the columns are to be asked for in order.
+    class response {
+       public:
+        response(const structure_tensor& tensor, const float k_thr,
+                 const dim_t border)
+            : t(tensor)
+            , k_thr(k_thr)
+            , begin(border)
+            , end(tensor.d0 - border)
+            , acc(3 * tensor.d0)
+            , sums(tensor.isBox() ? 3 * tensor.d0 : 0)
+            , last(-1) {}
+
+        void operator()(T* out, const dim_t c) {
+            const dim_t d0 = t.d0;
+            if (t.isBox()) {
+                slideTo(c);
+                const double scale = 1.0 / double(t.len * t.len);
+                for (dim_t i = begin; i < end; ++i) {
+                    acc[i]          = static_cast<T>(sums[i] * scale);
+                    acc[d0 + i]     = static_cast<T>(sums[d0 + i] * scale);
+                    acc[2 * d0 + i] = static_cast<T>(sums[2 * d0 + i] * scale);
+                }
+            } else {
+                std::fill(acc.begin(), acc.end(), scalar<T>(0));
+                for (dim_t f = 0; f < t.len; ++f) {
+                    const dim_t src = c + t.half - f;
+                    if (src < 0 || src >= t.d1) { continue; }
+                    const T w = t.filter[f];
+                    for (dim_t i = begin; i < end; ++i) {
+                        acc[i] += t.xx[src * d0 + i] * w;
+                        acc[d0 + i] += t.xy[src * d0 + i] * w;
+                        acc[2 * d0 + i] += t.yy[src * d0 + i] * w;
+                    }
                 }
             }
+            const T* sxx = acc.data();
+            const T* sxy = acc.data() + d0;
+            const T* syy = acc.data() + 2 * d0;
+
+            for (dim_t i = begin; i < end; ++i) {
+                const T tr  = sxx[i] + syy[i];
+                const T det = sxx[i] * syy[i] - sxy[i] * sxy[i];
+                out[i]      = det - k_thr * (tr * tr);
+            }
+        }
+
+       private:
+        /// Moves the box window along dim 1 to the one of column \p c
+        void slideTo(const dim_t c) {
+            const dim_t d0 = t.d0;
+            auto add       = [&](const dim_t src, const double sign) {
+                if (src < 0 || src >= t.d1) { return; }
+                for (dim_t i = begin; i < end; ++i) {
+                    sums[i] += sign * t.xx[src * d0 + i];
+                    sums[d0 + i] += sign * t.xy[src * d0 + i];
+                    sums[2 * d0 + i] += sign * t.yy[src * d0 + i];
+                }
+            };
+            if (last >= 0 && c == last + 1) {
+                add(c + t.half, 1.0);
+                add(c + t.half - t.len, -1.0);
+            } else {
+                std::fill(sums.begin(), sums.end(), 0.0);
+                for (dim_t f = 0; f < t.len; ++f) { add(c + t.half - f, 1.0); }
+            }
+            last = c;
+        }
+
+        const structure_tensor& t;
+        const float k_thr;
+        const dim_t begin, end;
+        std::vector<T> acc;
+        std::vector<double> sums;
+        dim_t last;
+    };
+
+    const dim_t d0, d1, len, half;
+    const std::vector<T> filter;
+    std::vector<T> xx, xy, yy;
+
+   private:
+    /// Applies the filter along the column \p in. The taps are added one at
+    /// a time to all pixels, in the order convolve2 adds them to a pixel.
+    void filterColumn(T* out, const T* in) const {
+        std::fill(out, out + d0, scalar<T>(0));
+        for (dim_t f = 0; f < len; ++f) {
+            addShifted(out, in, d0, half - f, filter[f]);
         }
     }
-}
 
-static void keep_corners(Param<float> xOut, Param<float> yOut,
-                         Param<float> respOut, CParam<float> xIn,
-                         CParam<float> yIn, CParam<float> respIn,
-                         CParam<unsigned> respIdx, const unsigned n_corners) {
-    float* x_out         = xOut.get();
-    float* y_out         = yOut.get();
-    float* resp_out      = respOut.get();
-    const float* x_in    = xIn.get();
-    const float* y_in    = yIn.get();
-    const float* resp_in = respIn.get();
-    const uint* resp_idx = respIdx.get();
-
-    // Keep only the first n_feat features
-    for (unsigned f = 0; f < n_corners; f++) {
-        x_out[f]    = x_in[resp_idx[f]];
-        y_out[f]    = y_in[resp_idx[f]];
-        resp_out[f] = resp_in[f];
+    /// Sums the box window along the column \p in from its prefix sums
+    void boxColumn(T* out, const T* in, double* prefix) const {
+        prefix[0] = 0.0;
+        for (dim_t i = 0; i < d0; ++i) { prefix[i + 1] = prefix[i] + in[i]; }
+        for (dim_t i = 0; i < d0; ++i) {
+            const dim_t hi = std::min<dim_t>(i + half + 1, d0);
+            const dim_t lo = std::max<dim_t>(i + half + 1 - len, 0);
+            out[i]         = static_cast<T>(prefix[hi] - prefix[lo]);
+        }
     }
+};
+
+/// Finds the Harris corners of \p in, the local maxima of the response
+/// that are at least \p minResp. The tensor is summed over \p filter, or
+/// over a box of length \p len if it is empty. At most \p cornerLimit
+/// corners are kept in column major order; of these the \p maxCorners
+/// strongest ones if it isn't zero.
+template<typename T>
+void harrisCorners(corner_list corners, CParam<T> in, std::vector<T> filter,
+                   const unsigned len,
+                   const float k_thr, const T minResp,
+                   const unsigned border_len, const unsigned cornerLimit,
+                   const unsigned maxCorners) {
+    const af::dim4 dims = in.dims();
+    const dim_t border  = border_len;
+    if (dims[0] <= 2 * border + 2 || dims[1] <= 2 * border + 2) { return; }
+
+    structure_tensor<T> tensor(dims[0], dims[1], std::move(filter), len);
+    tensor.sumColumns(in);
+
+    using response_t = typename structure_tensor<T>::response;
+    const dim_t cost = tensor.isBox() ? 12 : 3 * len + 6;
+    *corners = localMaxima<T>(dims[0], dims[1], border, minResp, cost, [&] {
+        return response_t(tensor, k_thr, border);
+    });
+
+    if (corners->size() > cornerLimit) { corners->resize(cornerLimit); }
+    if (maxCorners > 0) { keepStrongest(*corners, maxCorners); }
 }
 
 }  // namespace kernel
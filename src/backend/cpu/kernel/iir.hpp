@@ -9,45 +9,79 @@
 
 #pragma once
 #include <Param.hpp>
+#include <math.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
+/// Number of independent signals filtered in lockstep. The recurrence is
+/// serial along a signal, so the only parallelism is across signals; keeping
+/// the filter state of several columns side by side lets the inner loops
+/// vectorise while producing exactly the same values per signal.
+constexpr int IIR_LANES = 8;
+
 template<typename T>
 void iir(Param<T> y, Param<T> c, CParam<T> a) {
-    dim4 ydims = c.dims();
-    int num_a  = a.dims(0);
+    dim4 ydims        = c.dims();
+    int num_a         = a.dims(0);
+    const bool a_cols = a.dims().ndims() > 1;
 
-    for (int l = 0; l < (int)ydims[3]; l++) {
-        dim_t yidx3 = l * y.strides(3);
-        dim_t cidx3 = l * c.strides(3);
-        dim_t aidx3 = l * a.strides(3);
+    // Each block of lanes is independent of the others
+    const dim_t nblocks = (ydims[1] + IIR_LANES - 1) / IIR_LANES;
+    const dim_t nunits  = nblocks * ydims[2] * ydims[3];
+    threadPool().parallel_for(
+        0, nunits, grainSize(ydims[0] * num_a * IIR_LANES),
+        [&](dim_t ub, dim_t ue) {
+            std::vector<T> h_z(num_a * IIR_LANES);
+            std::vector<T> h_a(num_a * IIR_LANES);
 
-        for (int k = 0; k < (int)ydims[2]; k++) {
-            dim_t yidx2 = k * y.strides(2) + yidx3;
-            dim_t cidx2 = k * c.strides(2) + cidx3;
-            dim_t aidx2 = k * a.strides(2) + aidx3;
+            for (dim_t u = ub; u < ue; u++) {
+                const int j0 = static_cast<int>(u % nblocks) * IIR_LANES;
+                const int k  = static_cast<int>((u / nblocks) % ydims[2]);
+                const int l  = static_cast<int>(u / (nblocks * ydims[2]));
 
-            for (int j = 0; j < (int)ydims[1]; j++) {
-                dim_t yidx1 = j * y.strides(1) + yidx2;
-                dim_t cidx1 = j * c.strides(1) + cidx2;
-                dim_t aidx1 = j * a.strides(1) + aidx2;
+                dim_t yidx2 = k * y.strides(2) + l * y.strides(3);
+                dim_t cidx2 = k * c.strides(2) + l * c.strides(3);
+                dim_t aidx2 = k * a.strides(2) + l * a.strides(3);
 
-                std::vector<T> h_z(num_a);
+                const int lanes = std::min(IIR_LANES, (int)ydims[1] - j0);
 
-                const T *h_a = a.get() + (a.dims().ndims() > 1 ? aidx1 : 0);
-                T *h_c       = c.get() + cidx1;
-                T *h_y       = y.get() + yidx1;
+                const T *h_c[IIR_LANES];
+                T *h_y[IIR_LANES];
+                for (int n = 0; n < lanes; n++) {
+                    const int j   = j0 + n;
+                    h_c[n]        = c.get() + j * c.strides(1) + cidx2;
+                    h_y[n]        = y.get() + j * y.strides(1) + yidx2;
+                    const T *aptr =
+                        a.get() + (a_cols ? j * a.strides(1) + aidx2 : 0);
+                    for (int ii = 0; ii < num_a; ii++) {
+                        h_a[ii * IIR_LANES + n] = aptr[ii];
+                    }
+                }
+                std::fill(h_z.begin(), h_z.end(), scalar<T>(0));
 
+                T *z        = h_z.data();
+                const T *ca = h_a.data();
                 for (int i = 0; i < (int)ydims[0]; i++) {
-                    T y = h_y[i] = (h_c[i] + h_z[0]) / h_a[0];
+                    T yv[IIR_LANES];
+                    for (int n = 0; n < lanes; n++) {
+                        yv[n] = h_y[n][i] = (h_c[n][i] + z[n]) / ca[n];
+                    }
                     for (int ii = 1; ii < num_a; ii++) {
-                        h_z[ii - 1] = h_z[ii] - h_a[ii] * y;
+                        T *zo       = z + (ii - 1) * IIR_LANES;
+                        const T *zi = z + ii * IIR_LANES;
+                        const T *ai = ca + ii * IIR_LANES;
+                        for (int n = 0; n < lanes; n++) {
+                            zo[n] = zi[n] - ai[n] * yv[n];
+                        }
                     }
                 }
             }
-        }
-    }
+        });
 }
 
 }  // namespace kernel
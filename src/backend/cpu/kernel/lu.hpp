@@ -62,12 +62,20 @@ void lu_split(Param<T> lower, Param<T> upper, CParam<T> in) {
 }
 
 void convertPivot(Param<int> p, Param<int> pivot) {
-    int *d_pi = pivot.get();
-    int *d_po = p.get();
-    dim_t d0  = pivot.dims(0);
-    for (int j = 0; j < (int)d0; j++) {
-        // 1 indexed in pivot
-        std::swap(d_po[j], d_po[d_pi[j] - 1]);
+    af::dim4 pdm = pivot.dims();
+    af::dim4 pst = pivot.strides();
+    af::dim4 ost = p.strides();
+    dim_t d0     = pdm[0];
+
+    for (dim_t w = 0; w < pdm[3]; w++) {
+        for (dim_t z = 0; z < pdm[2]; z++) {
+            const int *d_pi = pivot.get() + w * pst[3] + z * pst[2];
+            int *d_po       = p.get() + w * ost[3] + z * ost[2];
+            for (int j = 0; j < (int)d0; j++) {
+                // 1 indexed in pivot
+                std::swap(d_po[j], d_po[d_pi[j] - 1]);
+            }
+        }
     }
 }
 
@@ -9,134 +9,318 @@
 
 #pragma once
 #include <Param.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
+/// Summed area tables of one image and optionally of its squared values,
+/// for sums over windows clipped to the image in constant time. They are
+/// accumulated in double, so window sums of integer images are exact.
+template<typename InT>
+class window_sums {
+   public:
+    window_sums(const InT *src, const af::dim4 &strides, const dim_t d0,
+                const dim_t d1, const bool withSquares)
+        : pitch_(d0 + 1), d0_(d0), d1_(d1) {
+        sums_.assign(pitch_ * (d1 + 1), 0.0);
+        if (withSquares) { squares_.assign(pitch_ * (d1 + 1), 0.0); }
+
+        // Prefix sums along each row, then accumulated down the columns
+        threadPool().parallel_for(
+            0, d1, grainSize(d0), [&](dim_t begin, dim_t end) {
+                for (dim_t j = begin; j < end; ++j) {
+                    const InT *row = src + j * strides[1];
+                    double *sum    = &sums_[(j + 1) * pitch_];
+                    double *sqr =
+                        withSquares ? &squares_[(j + 1) * pitch_] : nullptr;
+                    double acc = 0.0, accSq = 0.0;
+                    for (dim_t i = 0; i < d0; ++i) {
+                        const double v = double(row[i * strides[0]]);
+                        acc += v;
+                        sum[i + 1] = acc;
+                        if (sqr) {
+                            accSq += v * v;
+                            sqr[i + 1] = accSq;
+                        }
+                    }
+                }
+            });
+        threadPool().parallel_for(
+            0, pitch_, grainSize(d1), [&](dim_t begin, dim_t end) {
+                for (dim_t j = 1; j <= d1; ++j) {
+                    accumulate(sums_, j, begin, end);
+                    if (withSquares) { accumulate(squares_, j, begin, end); }
+                }
+            });
+    }
+
+    /// Sum over the window of \p w0 by \p w1 pixels starting at (i, j)
+    double sum(dim_t i, dim_t j, dim_t w0, dim_t w1) const {
+        return window(sums_, i, j, w0, w1);
+    }
+
+    /// Sum of squares over the window of \p w0 by \p w1 pixels at (i, j)
+    double squares(dim_t i, dim_t j, dim_t w0, dim_t w1) const {
+        return window(squares_, i, j, w0, w1);
+    }
+
+   private:
+    void accumulate(std::vector<double> &table, dim_t j, dim_t begin,
+                    dim_t end) {
+        double *row        = &table[j * pitch_];
+        const double *prev = row - pitch_;
+        for (dim_t i = begin; i < end; ++i) { row[i] += prev[i]; }
+    }
+
+    double window(const std::vector<double> &table, dim_t i, dim_t j,
+                  dim_t w0, dim_t w1) const {
+        const dim_t i1 = std::min(i + w0, d0_);
+        const dim_t j1 = std::min(j + w1, d1_);
+        return table[j1 * pitch_ + i1] - table[j * pitch_ + i1] -
+               table[j1 * pitch_ + i] + table[j * pitch_ + i];
+    }
+
+    dim_t pitch_, d0_, d1_;
+    std::vector<double> sums_;
+    std::vector<double> squares_;
+};
+
+template<af::matchType MatchType>
+constexpr bool needsMean() {
+    return MatchType == AF_ZSAD || MatchType == AF_LSAD ||
+           MatchType == AF_ZSSD || MatchType == AF_LSSD ||
+           MatchType == AF_ZNCC;
+}
+
+/// Contribution of one pixel pair to the disparity of a window
+template<af::matchType MatchType, typename T>
+T matchCost(const T s, const T t, const T wMean, const T tMean) {
+    T temp;
+    switch (MatchType) {
+        case AF_SAD: return std::fabs(s - t);
+        case AF_ZSAD: return std::fabs(s - wMean - t + tMean);
+        case AF_LSAD: return std::fabs(s - (wMean / tMean) * t);
+        case AF_SSD: return (s - t) * (s - t);
+        case AF_ZSSD: temp = s - wMean - t + tMean; return temp * temp;
+        case AF_LSSD: temp = s - (wMean / tMean) * t; return temp * temp;
+        default: return T(0);
+    }
+}
+
+/// Adds the cost of template pixel \p t to the \p count offsets of one row
+/// whose window sees the image pixels \p src. The unit stride is passed as
+/// a constant so that the loop vectorises.
+template<af::matchType MatchType, typename OutT, typename InT>
+void accumulateCost(OutT *acc, const InT *src, const dim_t step,
+                    const dim_t count, const OutT t, const OutT *wMean,
+                    const OutT tMean) {
+    for (dim_t si = 0; si < count; si++) {
+        acc[si] +=
+            matchCost<MatchType>((OutT)src[si * step], t, wMean[si], tMean);
+    }
+}
+
+template<typename OutT, typename InT>
+OutT templateMean(CParam<InT> tImg) {
+    const af::dim4 tDims    = tImg.dims();
+    const af::dim4 tStrides = tImg.strides();
+    const InT *tpl          = tImg.get();
+
+    OutT mean = OutT(0);
+    for (dim_t tj = 0; tj < tDims[1]; tj++) {
+        for (dim_t ti = 0; ti < tDims[0]; ti++) {
+            mean += (OutT)tpl[tj * tStrides[1] + ti * tStrides[0]];
+        }
+    }
+    return mean / tDims.elements();
+}
+
+/// Evaluates the disparity at every offset by visiting every template pixel.
+/// Each output row accumulates one template pixel at a time over all of its
+/// offsets, which keeps the inner loop contiguous, and the rows are shared
+/// between the threads of the pool. The window is zero outside the image.
 template<typename OutT, typename InT, af::matchType MatchType>
 void matchTemplate(Param<OutT> out, CParam<InT> sImg, CParam<InT> tImg) {
-    constexpr bool needMean = MatchType == AF_ZSAD || MatchType == AF_LSAD ||
-                              MatchType == AF_ZSSD || MatchType == AF_LSSD ||
-                              MatchType == AF_ZNCC;
+    constexpr bool needMean = needsMean<MatchType>();
 
     const af::dim4 sDims    = sImg.dims();
     const af::dim4 tDims    = tImg.dims();
     const af::dim4 sStrides = sImg.strides();
     const af::dim4 tStrides = tImg.strides();
+    const af::dim4 oStrides = out.strides();
 
     const dim_t tDim0 = tDims[0];
     const dim_t tDim1 = tDims[1];
     const dim_t sDim0 = sDims[0];
     const dim_t sDim1 = sDims[1];
 
-    const af::dim4 oStrides = out.strides();
+    const dim_t winNumElements = tDims.elements();
+    const InT *tpl             = tImg.get();
+    const OutT tImgMean = needMean ? templateMean<OutT>(tImg) : OutT(0);
 
-    OutT tImgMean        = OutT(0);
-    dim_t winNumElements = tImg.dims().elements();
-    const InT* tpl       = tImg.get();
-
-    if (needMean) {
-        for (dim_t tj = 0; tj < tDim1; tj++) {
-            dim_t tjStride = tj * tStrides[1];
+    for (dim_t b3 = 0; b3 < sDims[3]; ++b3) {
+        for (dim_t b2 = 0; b2 < sDims[2]; ++b2) {
+            const InT *src = sImg.get() + b2 * sStrides[2] + b3 * sStrides[3];
+            OutT *dst      = out.get() + b2 * oStrides[2] + b3 * oStrides[3];
 
-            for (dim_t ti = 0; ti < tDim0; ti++) {
-                tImgMean += (OutT)tpl[tjStride + ti * tStrides[0]];
+            std::unique_ptr<window_sums<InT>> sums;
+            if (needMean) {
+                sums.reset(
+                    new window_sums<InT>(src, sStrides, sDim0, sDim1, false));
             }
+
+            const dim_t grain = grainSize(sDim0 * winNumElements);
+            threadPool().parallel_for(
+                0, sDim1, grain, [&](dim_t begin, dim_t end) {
+                    std::vector<OutT> acc(sDim0);
+                    std::vector<OutT> wMean(sDim0, OutT(0));
+                    for (dim_t sj = begin; sj < end; ++sj) {
+                        if (needMean) {
+                            for (dim_t si = 0; si < sDim0; ++si) {
+                                wMean[si] = static_cast<OutT>(
+                                    sums->sum(si, sj, tDim0, tDim1) /
+                                    winNumElements);
+                            }
+                        }
+                        std::fill(acc.begin(), acc.end(), OutT(0));
+                        for (dim_t tj = 0; tj < tDim1; tj++) {
+                            const dim_t j = sj + tj;
+                            const InT *row =
+                                j < sDim1 ? src + j * sStrides[1] : nullptr;
+                            for (dim_t ti = 0; ti < tDim0; ti++) {
+                                const OutT t =
+                                    (OutT)tpl[tj * tStrides[1] +
+                                              ti * tStrides[0]];
+                                const dim_t inside =
+                                    row ? std::max<dim_t>(sDim0 - ti, 0) : 0;
+                                if (inside > 0) {
+                                    const InT *s = row + ti * sStrides[0];
+                                    if (sStrides[0] == 1) {
+                                        accumulateCost<MatchType>(
+                                            acc.data(), s, 1, inside, t,
+                                            wMean.data(), tImgMean);
+                                    } else {
+                                        accumulateCost<MatchType>(
+                                            acc.data(), s, sStrides[0], inside,
+                                            t, wMean.data(), tImgMean);
+                                    }
+                                }
+                                for (dim_t si = inside; si < sDim0; si++) {
+                                    acc[si] += matchCost<MatchType>(
+                                        OutT(0), t, wMean[si], tImgMean);
+                                }
+                            }
+                        }
+                        std::copy(acc.begin(), acc.end(),
+                                  dst + sj * oStrides[1]);
+                    }
+                });
         }
-        tImgMean /= winNumElements;
     }
+}
+
+/// Writes \p in rotated by 180 degrees, which turns the convolution with it
+/// into a cross correlation
+template<typename OutT, typename InT>
+void flipTemplate(Param<OutT> out, CParam<InT> in) {
+    const af::dim4 dims     = in.dims();
+    const af::dim4 iStrides = in.strides();
+    const af::dim4 oStrides = out.strides();
+
+    for (dim_t j = 0; j < dims[1]; ++j) {
+        for (dim_t i = 0; i < dims[0]; ++i) {
+            out.get()[(dims[1] - 1 - j) * oStrides[1] + (dims[0] - 1 - i)] =
+                (OutT)in.get()[j * iStrides[1] + i * iStrides[0]];
+        }
+    }
+}
+
+/// Evaluates the squared difference measures from window sums and the cross
+/// correlation of the image with the template, \p corr, which is the full
+/// convolution with the flipped template. With S and S2 the sum and sum of
+/// squares of a window of N pixels, T and T2 those of the template and C the
+/// correlation:
+///
+///     SSD  = S2 - 2 C + T2
+///     ZSSD = (S2 - S^2 / N) - 2 (C - T S / N) + (T2 - T^2 / N)
+///     LSSD = S2 - 2 r C + r^2 T2, where r = S / T
+template<typename OutT, typename InT, af::matchType MatchType>
+void matchTemplateCorrelated(Param<OutT> out, CParam<InT> sImg,
+                             CParam<InT> tImg, CParam<OutT> corr) {
+    const af::dim4 sDims    = sImg.dims();
+    const af::dim4 tDims    = tImg.dims();
+    const af::dim4 sStrides = sImg.strides();
+    const af::dim4 tStrides = tImg.strides();
+    const af::dim4 cStrides = corr.strides();
+    const af::dim4 oStrides = out.strides();
+
+    const dim_t tDim0 = tDims[0];
+    const dim_t tDim1 = tDims[1];
+    const dim_t sDim0 = sDims[0];
+    const dim_t sDim1 = sDims[1];
+    const double n    = static_cast<double>(tDims.elements());
 
-    OutT* dst      = out.get();
-    const InT* src = sImg.get();
+    double tSum = 0.0, tSquares = 0.0;
+    for (dim_t tj = 0; tj < tDim1; tj++) {
+        for (dim_t ti = 0; ti < tDim0; ti++) {
+            const double t = static_cast<double>(
+                tImg.get()[tj * tStrides[1] + ti * tStrides[0]]);
+            tSum += t;
+            tSquares += t * t;
+        }
+    }
 
     for (dim_t b3 = 0; b3 < sDims[3]; ++b3) {
         for (dim_t b2 = 0; b2 < sDims[2]; ++b2) {
-            // slide through image window after window
-            for (dim_t sj = 0; sj < sDim1; sj++) {
-                dim_t ojStride = sj * oStrides[1];
-
-                for (dim_t si = 0; si < sDim0; si++) {
-                    OutT disparity = OutT(0);
-
-                    // mean for window
-                    // this variable will be used based on MatchType value
-                    OutT wImgMean = OutT(0);
-                    if (needMean) {
-                        for (dim_t tj = 0, j = sj; tj < tDim1; tj++, j++) {
-                            dim_t jStride = j * sStrides[1];
-
-                            for (dim_t ti = 0, i = si; ti < tDim0; ti++, i++) {
-                                InT sVal = ((j < sDim1 && i < sDim0)
-                                                ? src[jStride + i * sStrides[0]]
-                                                : InT(0));
-                                wImgMean += (OutT)sVal;
-                            }
-                        }
-                        wImgMean /= winNumElements;
-                    }
+            const InT *src = sImg.get() + b2 * sStrides[2] + b3 * sStrides[3];
+            const OutT *cor =
+                corr.get() + b2 * cStrides[2] + b3 * cStrides[3] +
+                (tDim1 - 1) * cStrides[1] + (tDim0 - 1);
+            OutT *dst = out.get() + b2 * oStrides[2] + b3 * oStrides[3];
 
-                    // run the window match metric
-                    for (dim_t tj = 0, j = sj; tj < tDim1; tj++, j++) {
-                        dim_t jStride  = j * sStrides[1];
-                        dim_t tjStride = tj * tStrides[1];
-
-                        for (dim_t ti = 0, i = si; ti < tDim0; ti++, i++) {
-                            InT sVal = ((j < sDim1 && i < sDim0)
-                                            ? src[jStride + i * sStrides[0]]
-                                            : InT(0));
-                            InT tVal = tpl[tjStride + ti * tStrides[0]];
-                            OutT temp;
+            const window_sums<InT> sums(src, sStrides, sDim0, sDim1, true);
+
+            threadPool().parallel_for(
+                0, sDim1, grainSize(sDim0 * 16), [&](dim_t begin, dim_t end) {
+                    for (dim_t sj = begin; sj < end; ++sj) {
+                        for (dim_t si = 0; si < sDim0; ++si) {
+                            const double s  = sums.sum(si, sj, tDim0, tDim1);
+                            const double s2 =
+                                sums.squares(si, sj, tDim0, tDim1);
+                            const double c  = static_cast<double>(
+                                cor[sj * cStrides[1] + si]);
+                            double disparity;
                             switch (MatchType) {
-                                case AF_SAD:
-                                    disparity += fabs((OutT)sVal - (OutT)tVal);
-                                    break;
-                                case AF_ZSAD:
-                                    disparity += fabs((OutT)sVal - wImgMean -
-                                                      (OutT)tVal + tImgMean);
-                                    break;
-                                case AF_LSAD:
-                                    disparity +=
-                                        fabs((OutT)sVal -
-                                             (wImgMean / tImgMean) * tVal);
-                                    break;
-                                case AF_SSD:
-                                    disparity += ((OutT)sVal - (OutT)tVal) *
-                                                 ((OutT)sVal - (OutT)tVal);
-                                    break;
                                 case AF_ZSSD:
-                                    temp = ((OutT)sVal - wImgMean - (OutT)tVal +
-                                            tImgMean);
-                                    disparity += temp * temp;
-                                    break;
-                                case AF_LSSD:
-                                    temp = ((OutT)sVal -
-                                            (wImgMean / tImgMean) * tVal);
-                                    disparity += temp * temp;
-                                    break;
-                                case AF_NCC:
-                                    // TODO: furture implementation
+                                    disparity = (s2 - s * s / n) -
+                                                2.0 * (c - tSum * s / n) +
+                                                (tSquares - tSum * tSum / n);
                                     break;
-                                case AF_ZNCC:
-                                    // TODO: furture implementation
-                                    break;
-                                case AF_SHD:
-                                    // TODO: furture implementation
+                                case AF_LSSD: {
+                                    const double r = s / tSum;
+                                    disparity =
+                                        s2 - 2.0 * r * c + r * r * tSquares;
+                                } break;
+                                default:
+                                    disparity = s2 - 2.0 * c + tSquares;
                                     break;
                             }
+                            // Rounding in the correlation can leave small
+                            // negative values near a perfect match
+                            dst[sj * oStrides[1] + si] =
+                                static_cast<OutT>(std::max(disparity, 0.0));
                         }
                     }
-                    // output is just created, hence not doing the
-                    // extra multiplication for 0th dim stride
-                    dst[ojStride + si] = disparity;
-                }
-            }
-            src += sStrides[2];
-            dst += oStrides[2];
+                });
         }
-        src += sStrides[3];
-        dst += oStrides[3];
     }
-};
+}
 
 }  // namespace kernel
 }  // namespace cpu
@@ -10,6 +10,11 @@
 #pragma once
 #include <Array.hpp>
 #include <common/Transform.hpp>
+#include <common/jit/Node.hpp>
+#include <kernel/Array.hpp>
+
+#include <algorithm>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
@@ -121,5 +126,39 @@ struct mean_dim<Ti, Tw, To, 0> {
     }
 };
 
+/// Averages the JIT tree \p in of shape \p idims along \p dim, evaluating
+/// it a block of outputs at a time instead of reading a materialised input.
+/// The running means are updated in the same order as in mean_dim.
+template<typename Ti, typename Tw, typename To>
+struct mean_dim_node {
+    void operator()(Param<To> output, common::Node_ptr in,
+                    const af::dim4 idims, const int dim) {
+        using MeanOpT = MeanOp<compute_t<Ti>, compute_t<To>, compute_t<Tw>>;
+        const af::dim4 ostrides = output.strides();
+        To* const outPtr        = output.get();
+
+        // Running means of the outputs of the current block
+        std::vector<MeanOpT> ops(jit::VECTOR_LENGTH, MeanOpT(0, 0));
+        const int step = dim == 0 ? 0 : 1;
+
+        auto begin = [&](int n) {
+            std::fill(ops.begin(), ops.begin() + n, MeanOpT(0, 0));
+        };
+        auto accumulate = [&](const compute_t<Ti>* vals, int lim) {
+            for (int i = 0; i < lim; i++) {
+                ops[i * step](compute_t<Ti>(data_t<Ti>(vals[i])), 1);
+            }
+        };
+        auto end = [&](int x, int y, int z, int w, int n) {
+            To* o = outPtr + y * ostrides[1] + z * ostrides[2] +
+                    w * ostrides[3];
+            for (int i = 0; i < n; i++) {
+                o[(x + i) * ostrides[0]] = ops[i].runningMean;
+            }
+        };
+        evalNodeAlong<Ti>(in, idims, dim, begin, accumulate, end);
+    }
+};
+
 }  // namespace kernel
 }  // namespace cpu
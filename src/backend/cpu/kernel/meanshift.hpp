@@ -9,12 +9,211 @@
 
 #pragma once
 #include <Param.hpp>
+#include <thread_pool.hpp>
 #include <utility.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
 #include <type_traits>
 #include <vector>
 
 namespace cpu {
 namespace kernel {
+
+/// Rows of a column sharing one colour bounding box in the grid
+constexpr dim_t mean_shift_block = 8;
+
+/// One image of the filter with its pixels interleaved, the colours of a
+/// pixel next to each other, and a grid of the colour bounds of
+/// mean_shift_block rows of every column. A block whose bounds are too far
+/// from the colour of a window's centre holds no pixel within range of it
+/// and is skipped whole.
+template<typename AccType>
+class mean_shift_image {
+   public:
+    template<typename T>
+    mean_shift_image(const T* data, const af::dim4& strides, const dim_t d0,
+                     const dim_t d1, const unsigned channels)
+        : d0(d0)
+        , d1(d1)
+        , channels(channels)
+        , blocks((d0 + mean_shift_block - 1) / mean_shift_block)
+        , pixels(d0 * d1 * channels)
+        , lo(blocks * d1 * channels)
+        , hi(blocks * d1 * channels) {
+        threadPool().parallel_for(
+            0, d1, grainSize(d0 * channels), [&](dim_t begin, dim_t end) {
+                for (dim_t j = begin; j < end; ++j) {
+                    loadColumn(data + j * strides[1], strides, j);
+                }
+            });
+    }
+
+    const AccType* pixel(const dim_t i, const dim_t j) const {
+        return pixels.data() + (j * d0 + i) * channels;
+    }
+
+    /// Squared distance of \p colour to the colour bounds of block \p k of
+    /// column \p j. It is never above the distance to any pixel of the
+    /// block, as computed when testing the pixel.
+    AccType blockDistance(const AccType* colour, const dim_t k,
+                          const dim_t j) const {
+        const dim_t b = (j * blocks + k) * channels;
+        AccType norm  = 0;
+        for (unsigned ch = 0; ch < channels; ++ch) {
+            const AccType c = colour[ch];
+            AccType diff    = 0;
+            if (c < lo[b + ch]) {
+                diff = c - lo[b + ch];
+            } else if (c > hi[b + ch]) {
+                diff = c - hi[b + ch];
+            }
+            norm += (diff * diff);
+        }
+        return norm;
+    }
+
+    const dim_t d0, d1;
+    const unsigned channels;
+    const dim_t blocks;
+
+   private:
+    template<typename T>
+    void loadColumn(const T* column, const af::dim4& strides, const dim_t j) {
+        AccType* dst = pixels.data() + j * d0 * channels;
+        for (dim_t i = 0; i < d0; ++i) {
+            for (unsigned ch = 0; ch < channels; ++ch) {
+                dst[i * channels + ch] = static_cast<AccType>(
+                    column[i * strides[0] + ch * strides[2]]);
+            }
+        }
+        for (dim_t k = 0; k < blocks; ++k) {
+            const dim_t first = k * mean_shift_block;
+            const dim_t last  = std::min(first + mean_shift_block, d0);
+            AccType* blo      = lo.data() + (j * blocks + k) * channels;
+            AccType* bhi      = hi.data() + (j * blocks + k) * channels;
+            for (unsigned ch = 0; ch < channels; ++ch) {
+                blo[ch] = bhi[ch] = dst[first * channels + ch];
+            }
+            for (dim_t i = first + 1; i < last; ++i) {
+                for (unsigned ch = 0; ch < channels; ++ch) {
+                    const AccType v = dst[i * channels + ch];
+                    blo[ch]         = std::min(blo[ch], v);
+                    bhi[ch]         = std::max(bhi[ch], v);
+                }
+            }
+        }
+    }
+
+    std::vector<AccType> pixels;
+    std::vector<AccType> lo, hi;
+};
+
+/// Runs the mean shift iterations of the pixel (i, j) and writes its final
+/// colour to \p result. The window is clipped to the image once per
+/// iteration, and the pixels within range of the centre colour are summed
+/// in the order of the full window scan. \p Channels fixes the number of
+/// channels at compile time unless it is zero.
+template<unsigned Channels, typename AccType>
+void shiftPixel(AccType* result, const mean_shift_image<AccType>& img,
+                const dim_t i, const dim_t j, const dim_t radius,
+                const AccType cvar, const unsigned numIterations) {
+    const unsigned channels = Channels ? Channels : img.channels;
+
+    std::array<AccType, 4> currentCenterColors{{0}};
+    std::array<AccType, 4> currentMeanColors{{0}};
+    for (unsigned ch = 0; ch < channels; ++ch) {
+        currentCenterColors[ch] = img.pixel(i, j)[ch];
+    }
+
+    int meanPosJ = j;
+    int meanPosI = i;
+
+    for (unsigned it = 0; it < numIterations; ++it) {
+        int oldMeanPosJ = meanPosJ;
+        int oldMeanPosI = meanPosI;
+        unsigned count  = 0;
+        int shift_y     = 0;
+        int shift_x     = 0;
+
+        currentMeanColors.fill(0);
+
+        const dim_t j0 = std::max<dim_t>(meanPosJ - radius, 0);
+        const dim_t j1 = std::min<dim_t>(meanPosJ + radius, img.d1 - 1);
+        const dim_t i0 = std::max<dim_t>(meanPosI - radius, 0);
+        const dim_t i1 = std::min<dim_t>(meanPosI + radius, img.d0 - 1);
+        for (dim_t tj = j0; tj <= j1; ++tj) {
+            int hit_count = 0;
+            for (dim_t k = i0 / mean_shift_block; k <= i1 / mean_shift_block;
+                 ++k) {
+                if (img.blockDistance(currentCenterColors.data(), k, tj) >
+                    cvar) {
+                    continue;
+                }
+                const dim_t first = std::max(i0, k * mean_shift_block);
+                const dim_t last =
+                    std::min(i1 + 1, (k + 1) * mean_shift_block);
+                for (dim_t ti = first; ti < last; ++ti) {
+                    const AccType* colour = img.pixel(ti, tj);
+
+                    AccType norm = 0;
+                    for (unsigned ch = 0; ch < channels; ++ch) {
+                        AccType diff = currentCenterColors[ch] - colour[ch];
+                        norm += (diff * diff);
+                    }
+                    if (norm <= cvar) {
+                        for (unsigned ch = 0; ch < channels; ++ch) {
+                            currentMeanColors[ch] += colour[ch];
+                        }
+                        shift_x += ti;
+                        ++hit_count;
+                    }
+                }
+            }
+            count += hit_count;
+            shift_y += tj * hit_count;
+        }
+
+        if (count == 0) { break; }
+
+        const AccType fcount = 1 / static_cast<AccType>(count);
+
+        meanPosJ = static_cast<int>(std::trunc(shift_y * fcount));
+        meanPosI = static_cast<int>(std::trunc(shift_x * fcount));
+
+        for (unsigned ch = 0; ch < channels; ++ch) {
+            currentMeanColors[ch] = std::trunc(currentMeanColors[ch] * fcount);
+        }
+
+        AccType norm = 0;
+        for (unsigned ch = 0; ch < channels; ++ch) {
+            AccType diff = currentMeanColors[ch] - currentCenterColors[ch];
+            norm += (diff * diff);
+        }
+
+        // stop the process if mean converged or within given tolerance range
+        bool stop =
+            (meanPosJ == oldMeanPosJ && oldMeanPosI == meanPosI) ||
+            ((abs(oldMeanPosJ - meanPosJ) + abs(oldMeanPosI - meanPosI) +
+              norm) <= 1);
+
+        for (unsigned ch = 0; ch < channels; ++ch) {
+            currentCenterColors[ch] = currentMeanColors[ch];
+        }
+
+        if (stop) { break; }
+    }
+
+    for (unsigned ch = 0; ch < channels; ++ch) {
+        result[ch] = currentCenterColors[ch];
+    }
+}
+
+/// Mean shift filter of every image of \p in. The columns of an image are
+/// split between the threads; every pixel reads the interleaved copy of its
+/// image only.
 template<typename T, bool IsColor>
 void meanShift(Param<T> out, CParam<T> in, const float spatialSigma,
                const float chromaticSigma, const unsigned numIterations) {
@@ -29,111 +228,33 @@ void meanShift(Param<T> out, CParam<T> in, const float spatialSigma,
     const dim_t radius      = std::max((int)(spatialSigma * 1.5f), 1);
     const AccType cvar      = chromaticSigma * chromaticSigma;
 
-    std::array<AccType, 4> currentCenterColors{{0}};
-    std::array<AccType, 4> currentMeanColors{{0}};
-    std::array<AccType, 4> tempColors{{0}};
+    const dim_t window = (2 * radius + 1) * (2 * radius + 1);
+    auto shift         = IsColor ? (channels == 3 ? shiftPixel<3, AccType>
+                                                  : shiftPixel<0, AccType>)
+                                 : shiftPixel<1, AccType>;
     for (dim_t b3 = 0; b3 < dims[3]; ++b3) {
         for (unsigned b2 = 0; b2 < bCount; ++b2) {
             T* outData      = out.get() + b2 * ostrides[2] + b3 * ostrides[3];
             const T* inData = in.get() + b2 * istrides[2] + b3 * istrides[3];
 
-            for (dim_t j = 0; j < dims[1]; ++j) {
-                dim_t j_in_off  = j * istrides[1];
-                dim_t j_out_off = j * ostrides[1];
-
-                for (dim_t i = 0; i < dims[0]; ++i) {
-                    dim_t i_in_off  = i * istrides[0];
-                    dim_t i_out_off = i * ostrides[0];
-
-                    for (unsigned ch = 0; ch < channels; ++ch)
-                        currentCenterColors[ch] = static_cast<AccType>(
-                            inData[j_in_off + i_in_off + ch * istrides[2]]);
-
-                    int meanPosJ = j;
-                    int meanPosI = i;
-
-                    // scope of meanshift iterations begin
-                    for (unsigned it = 0; it < numIterations; ++it) {
-                        int oldMeanPosJ = meanPosJ;
-                        int oldMeanPosI = meanPosI;
-                        unsigned count  = 0;
-                        int shift_y     = 0;
-                        int shift_x     = 0;
-
-                        currentMeanColors.fill(0);
-                        // Windowing operation
-                        for (dim_t wj = -radius; wj <= radius; ++wj) {
-                            int hit_count = 0;
-                            dim_t tj      = meanPosJ + wj;
-                            if (tj < 0 || tj > dims[1] - 1) continue;
-
-                            dim_t tjstride = tj * istrides[1];
-
-                            for (dim_t wi = -radius; wi <= radius; ++wi) {
-                                dim_t ti = meanPosI + wi;
-                                if (ti < 0 || ti > dims[0] - 1) continue;
-
-                                dim_t tistride = ti * istrides[0];
-
-                                AccType norm = 0;
-                                for (unsigned ch = 0; ch < channels; ++ch) {
-                                    tempColors[ch] = static_cast<AccType>(
-                                        inData[tistride + tjstride +
-                                               ch * istrides[2]]);
-                                    AccType diff = currentCenterColors[ch] -
-                                                   tempColors[ch];
-                                    norm += (diff * diff);
-                                }
-                                if (norm <= cvar) {
-                                    for (unsigned ch = 0; ch < channels; ++ch)
-                                        currentMeanColors[ch] += tempColors[ch];
-
-                                    shift_x += ti;
-                                    ++hit_count;
-                                }
+            const mean_shift_image<AccType> img(inData, istrides, dims[0],
+                                                dims[1], channels);
+            threadPool().parallel_for(
+                0, dims[1], grainSize(dims[0] * window),
+                [&](dim_t begin, dim_t end) {
+                    std::array<AccType, 4> result{{0}};
+                    for (dim_t j = begin; j < end; ++j) {
+                        T* dst = outData + j * ostrides[1];
+                        for (dim_t i = 0; i < dims[0]; ++i) {
+                            shift(result.data(), img, i, j, radius, cvar,
+                                  numIterations);
+                            for (unsigned ch = 0; ch < channels; ++ch) {
+                                dst[i * ostrides[0] + ch * ostrides[2]] =
+                                    static_cast<T>(result[ch]);
                             }
-                            count += hit_count;
-                            shift_y += tj * hit_count;
                         }
-
-                        if (count == 0) break;
-
-                        const AccType fcount = 1 / static_cast<AccType>(count);
-
-                        meanPosJ =
-                            static_cast<int>(std::trunc(shift_y * fcount));
-                        meanPosI =
-                            static_cast<int>(std::trunc(shift_x * fcount));
-
-                        for (unsigned ch = 0; ch < channels; ++ch)
-                            currentMeanColors[ch] =
-                                std::trunc(currentMeanColors[ch] * fcount);
-
-                        AccType norm = 0;
-                        for (unsigned ch = 0; ch < channels; ++ch) {
-                            AccType diff =
-                                currentMeanColors[ch] - currentCenterColors[ch];
-                            norm += (diff * diff);
-                        }
-
-                        // stop the process if mean converged or within given
-                        // tolerance range
-                        bool stop = (meanPosJ == oldMeanPosJ &&
-                                     oldMeanPosI == meanPosI) ||
-                                    ((abs(oldMeanPosJ - meanPosJ) +
-                                      abs(oldMeanPosI - meanPosI) + norm) <= 1);
-
-                        for (unsigned ch = 0; ch < channels; ++ch)
-                            currentCenterColors[ch] = currentMeanColors[ch];
-
-                        if (stop) break;
-                    }  // scope of meanshift iterations end
-
-                    for (dim_t ch = 0; ch < channels; ++ch)
-                        outData[j_out_off + i_out_off + ch * ostrides[2]] =
-                            static_cast<T>(currentCenterColors[ch]);
-                }
-            }
+                    }
+                });
         }
     }
 }
@@ -9,8 +9,11 @@
 
 #pragma once
 #include <Param.hpp>
+#include <thread_pool.hpp>
 #include <utility.hpp>
 
+#include <vector>
+
 namespace cpu {
 namespace kernel {
 
@@ -111,6 +114,9 @@ void keep_features(float* x_out, float* y_out, float* score_out,
     }
 }
 
+/// Harris response of the features that fit on \p image. The responses are
+/// computed in parallel and the usable features are then written out in
+/// their input order.
 template<typename T, bool use_scl>
 void harris_response(float* x_out, float* y_out, float* score_out,
                      float* size_out, const float* x_in, const float* y_in,
@@ -120,67 +126,84 @@ void harris_response(float* x_out, float* y_out, float* score_out,
                      const unsigned patch_size) {
     const af::dim4 idims = image.dims();
     const T* image_ptr   = image.get();
+
+    std::vector<unsigned> x_feat(total_feat), y_feat(total_feat);
+    std::vector<float> resp_feat(total_feat), size_feat(total_feat);
+    std::vector<unsigned char> usable(total_feat, 0);
+    threadPool().parallel_for(
+        0, total_feat, grainSize(block_size * block_size),
+        [&](dim_t begin, dim_t end) {
+            for (dim_t f = begin; f < end; f++) {
+                unsigned x, y;
+                float scl = 1.f;
+                if (use_scl) {
+                    // Update x and y coordinates according to scale
+                    scl = scl_in[f];
+                    x   = (unsigned)round(x_in[f] * scl);
+                    y   = (unsigned)round(y_in[f] * scl);
+                } else {
+                    x = (unsigned)round(x_in[f]);
+                    y = (unsigned)round(y_in[f]);
+                }
+
+                // Round feature size to nearest odd integer
+                float size = 2.f * floor((patch_size * scl) / 2.f) + 1.f;
+
+                // Avoid keeping features that might be too wide and might not
+                // fit on the image, sqrt(2.f) is the radius when angle is 45
+                // degrees and represents widest case possible
+                unsigned patch_r = ceil(size * sqrt(2.f) / 2.f);
+                if (x < patch_r || y < patch_r || x >= idims[1] - patch_r ||
+                    y >= idims[0] - patch_r)
+                    continue;
+
+                unsigned r = block_size / 2;
+
+                float ixx = 0.f, iyy = 0.f, ixy = 0.f;
+                unsigned block_size_sq = block_size * block_size;
+                for (unsigned k = 0; k < block_size_sq; k++) {
+                    int i = k / block_size - r;
+                    int j = k % block_size - r;
+
+                    // Calculate local x and y derivatives
+                    float ix = image_ptr[(x + i + 1) * idims[0] + y + j] -
+                               image_ptr[(x + i - 1) * idims[0] + y + j];
+                    float iy = image_ptr[(x + i) * idims[0] + y + j + 1] -
+                               image_ptr[(x + i) * idims[0] + y + j - 1];
+
+                    // Accumulate second order derivatives
+                    ixx += ix * ix;
+                    iyy += iy * iy;
+                    ixy += ix * iy;
+                }
+
+                float tr  = ixx + iyy;
+                float det = ixx * iyy - ixy * ixy;
+
+                // Calculate Harris responses
+                x_feat[f]    = x;
+                y_feat[f]    = y;
+                resp_feat[f] = det - k_thr * (tr * tr);
+                size_feat[f] = size;
+                usable[f]    = 1;
+            }
+        });
+
+    // Scale factor
+    // TODO: improve response scaling
+    float rscale = 0.001f;
+    rscale       = rscale * rscale * rscale * rscale;
+
     for (unsigned f = 0; f < total_feat; f++) {
-        unsigned x, y;
-        float scl = 1.f;
-        if (use_scl) {
-            // Update x and y coordinates according to scale
-            scl = scl_in[f];
-            x   = (unsigned)round(x_in[f] * scl);
-            y   = (unsigned)round(y_in[f] * scl);
-        } else {
-            x = (unsigned)round(x_in[f]);
-            y = (unsigned)round(y_in[f]);
-        }
-
-        // Round feature size to nearest odd integer
-        float size = 2.f * floor((patch_size * scl) / 2.f) + 1.f;
-
-        // Avoid keeping features that might be too wide and might not fit on
-        // the image, sqrt(2.f) is the radius when angle is 45 degrees and
-        // represents widest case possible
-        unsigned patch_r = ceil(size * sqrt(2.f) / 2.f);
-        if (x < patch_r || y < patch_r || x >= idims[1] - patch_r ||
-            y >= idims[0] - patch_r)
-            continue;
-
-        unsigned r = block_size / 2;
-
-        float ixx = 0.f, iyy = 0.f, ixy = 0.f;
-        unsigned block_size_sq = block_size * block_size;
-        for (unsigned k = 0; k < block_size_sq; k++) {
-            int i = k / block_size - r;
-            int j = k % block_size - r;
-
-            // Calculate local x and y derivatives
-            float ix = image_ptr[(x + i + 1) * idims[0] + y + j] -
-                       image_ptr[(x + i - 1) * idims[0] + y + j];
-            float iy = image_ptr[(x + i) * idims[0] + y + j + 1] -
-                       image_ptr[(x + i) * idims[0] + y + j - 1];
-
-            // Accumulate second order derivatives
-            ixx += ix * ix;
-            iyy += iy * iy;
-            ixy += ix * iy;
-        }
+        if (!usable[f]) { continue; }
 
         unsigned idx = *usable_feat;
         *usable_feat += 1;
-        float tr  = ixx + iyy;
-        float det = ixx * iyy - ixy * ixy;
 
-        // Calculate Harris responses
-        float resp = det - k_thr * (tr * tr);
-
-        // Scale factor
-        // TODO: improve response scaling
-        float rscale = 0.001f;
-        rscale       = rscale * rscale * rscale * rscale;
-
-        x_out[idx]     = x;
-        y_out[idx]     = y;
-        score_out[idx] = resp * rscale;
-        if (use_scl) size_out[idx] = size;
+        x_out[idx]     = x_feat[f];
+        y_out[idx]     = y_feat[f];
+        score_out[idx] = resp_feat[f] * rscale;
+        if (use_scl) size_out[idx] = size_feat[f];
     }
 }
 
@@ -190,93 +213,106 @@ void centroid_angle(const float* x_in, const float* y_in,
                     CParam<T> image, const unsigned patch_size) {
     const af::dim4 idims = image.dims();
     const T* image_ptr   = image.get();
-    for (unsigned f = 0; f < total_feat; f++) {
-        unsigned x = (unsigned)round(x_in[f]);
-        unsigned y = (unsigned)round(y_in[f]);
-
-        unsigned r = patch_size / 2;
-        if (x < r || y < r || x > idims[1] - r || y > idims[0] - r) continue;
-
-        T m01 = (T)0, m10 = (T)0;
-        unsigned patch_size_sq = patch_size * patch_size;
-        for (unsigned k = 0; k < patch_size_sq; k++) {
-            int i = k / patch_size - r;
-            int j = k % patch_size - r;
-
-            // Calculate first order moments
-            T p = image_ptr[(x + i) * idims[0] + y + j];
-            m01 += j * p;
-            m10 += i * p;
-        }
-
-        float angle        = atan2(m01, m10);
-        orientation_out[f] = angle;
-    }
+    threadPool().parallel_for(
+        0, total_feat, grainSize(patch_size * patch_size),
+        [&](dim_t begin, dim_t end) {
+            for (dim_t f = begin; f < end; f++) {
+                unsigned x = (unsigned)round(x_in[f]);
+                unsigned y = (unsigned)round(y_in[f]);
+
+                unsigned r = patch_size / 2;
+                if (x < r || y < r || x > idims[1] - r || y > idims[0] - r)
+                    continue;
+
+                T m01 = (T)0, m10 = (T)0;
+                unsigned patch_size_sq = patch_size * patch_size;
+                for (unsigned k = 0; k < patch_size_sq; k++) {
+                    int i = k / patch_size - r;
+                    int j = k % patch_size - r;
+
+                    // Calculate first order moments
+                    T p = image_ptr[(x + i) * idims[0] + y + j];
+                    m01 += j * p;
+                    m10 += i * p;
+                }
+
+                float angle        = atan2(m01, m10);
+                orientation_out[f] = angle;
+            }
+        });
 }
 
+/// Pixel at (\p dist_x, \p dist_y) from (\p x, \p y) in the frame of a
+/// keypoint rotated by the angle of sine \p ori_sin and cosine \p ori_cos
+/// and scaled by \p patch_scl
 template<typename T>
-inline T get_pixel(unsigned x, unsigned y, const float ori, const unsigned size,
-                   const int dist_x, const int dist_y, CParam<T> image,
-                   const unsigned patch_size) {
-    const af::dim4 idims = image.dims();
-    const T* image_ptr   = image.get();
-    float ori_sin        = sin(ori);
-    float ori_cos        = cos(ori);
-    float patch_scl      = (float)size / (float)patch_size;
-
+inline T get_pixel(unsigned x, unsigned y, const float ori_sin,
+                   const float ori_cos, const float patch_scl,
+                   const int dist_x, const int dist_y, const T* image_ptr,
+                   const dim_t idim0) {
     // Calculate point coordinates based on orientation and size
     x += round(dist_x * patch_scl * ori_cos - dist_y * patch_scl * ori_sin);
     y += round(dist_x * patch_scl * ori_sin + dist_y * patch_scl * ori_cos);
 
-    return image_ptr[x * idims[0] + y];
+    return image_ptr[x * idim0 + y];
 }
 
+/// Computes the 256 bit descriptors of the features, one keypoint per
+/// iteration of a parallel loop
 template<typename T>
 void extract_orb(unsigned* desc_out, const unsigned n_feat, float* x_in_out,
                  float* y_in_out, const float* ori_in, float* size_out,
                  CParam<T> image, const float scl, const unsigned patch_size) {
     const af::dim4 idims = image.dims();
-    for (unsigned f = 0; f < n_feat; f++) {
-        unsigned x    = (unsigned)round(x_in_out[f]);
-        unsigned y    = (unsigned)round(y_in_out[f]);
-        float ori     = ori_in[f];
-        unsigned size = patch_size;
-
-        unsigned r = ceil(patch_size * sqrt(2.f) / 2.f);
-        if (x < r || y < r || x >= idims[1] - r || y >= idims[0] - r) continue;
-
-        // Descriptor fixed at 256 bits for now
-        // Storing descriptor as a vector of 8 x 32-bit unsigned numbers
-        for (unsigned i = 0; i < 8; i++) {
-            unsigned v = 0;
-
-            // j < 32 for 256 bits descriptor
-            for (unsigned j = 0; j < 32; j++) {
-                // Get position from distribution pattern and values of points
-                // p1 and p2
-                int dist_x = ref_pat[i * 32 * 4 + j * 4];
-                int dist_y = ref_pat[i * 32 * 4 + j * 4 + 1];
-                T p1       = get_pixel(x, y, ori, size, dist_x, dist_y, image,
-                                 patch_size);
-
-                dist_x = ref_pat[i * 32 * 4 + j * 4 + 2];
-                dist_y = ref_pat[i * 32 * 4 + j * 4 + 3];
-                T p2   = get_pixel(x, y, ori, size, dist_x, dist_y, image,
-                                 patch_size);
-
-                // Calculate bit based on p1 and p2 and shifts it to correct
-                // position
-                v |= (p1 < p2) << j;
+    const T* image_ptr   = image.get();
+    threadPool().parallel_for(
+        0, n_feat, grainSize(2 * REF_PAT_SAMPLES),
+        [&](dim_t begin, dim_t end) {
+            for (dim_t f = begin; f < end; f++) {
+                unsigned x    = (unsigned)round(x_in_out[f]);
+                unsigned y    = (unsigned)round(y_in_out[f]);
+                float ori     = ori_in[f];
+                unsigned size = patch_size;
+
+                unsigned r = ceil(patch_size * sqrt(2.f) / 2.f);
+                if (x < r || y < r || x >= idims[1] - r || y >= idims[0] - r)
+                    continue;
+
+                // The rotation is the same for all the points of a keypoint
+                float ori_sin   = sin(ori);
+                float ori_cos   = cos(ori);
+                float patch_scl = (float)size / (float)patch_size;
+
+                // Descriptor fixed at 256 bits for now
+                // Storing descriptor as a vector of 8 x 32-bit unsigned
+                // numbers
+                for (unsigned i = 0; i < 8; i++) {
+                    unsigned v = 0;
+
+                    // j < 32 for 256 bits descriptor
+                    for (unsigned j = 0; j < 32; j++) {
+                        // Get position from distribution pattern and values
+                        // of points p1 and p2
+                        const int* pat = ref_pat + i * 32 * 4 + j * 4;
+                        T p1 = get_pixel(x, y, ori_sin, ori_cos, patch_scl,
+                                         pat[0], pat[1], image_ptr, idims[0]);
+                        T p2 = get_pixel(x, y, ori_sin, ori_cos, patch_scl,
+                                         pat[2], pat[3], image_ptr, idims[0]);
+
+                        // Calculate bit based on p1 and p2 and shifts it to
+                        // correct position
+                        v |= (p1 < p2) << j;
+                    }
+
+                    // Store 32 bits of descriptor
+                    desc_out[f * 8 + i] += v;
+                }
+
+                x_in_out[f] = round(x * scl);
+                y_in_out[f] = round(y * scl);
+                size_out[f] = patch_size * scl;
             }
-
-            // Store 32 bits of descriptor
-            desc_out[f * 8 + i] += v;
-        }
-
-        x_in_out[f] = round(x * scl);
-        y_in_out[f] = round(y * scl);
-        size_out[f] = patch_size * scl;
-    }
+        });
 }
 
 }  // namespace kernel
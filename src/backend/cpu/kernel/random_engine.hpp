@@ -13,6 +13,7 @@
 #include <common/dispatch.hpp>
 #include <common/half.hpp>
 #include <err_cpu.hpp>
+#include <half_convert.hpp>
 #include <kernel/random_engine_mersenne.hpp>
 #include <kernel/random_engine_philox.hpp>
 #include <kernel/random_engine_threefry.hpp>
@@ -149,11 +150,22 @@ double transform<double>(uint *val, uint index) {
     return 1. - getDouble01(val, index);
 }
 
+// Uniform value of type T in its compute type. The f16 values are converted
+// in bulk by the callers
+template<typename T>
+compute_t<T> uniform(uint *val, uint index) {
+    return transform<T>(val, index);
+}
+
 template<>
-common::half transform<common::half>(uint *val, uint index) {
+float uniform<common::half>(uint *val, uint index) {
     float v = val[index >> 1U] >> (16U * (index & 1U)) & 0x0000ffff;
-    return static_cast<common::half>(
-        1.f - fmaf(v, unsigned_half_factor, unsigned_half_half_factor));
+    return 1.f - fmaf(v, unsigned_half_factor, unsigned_half_half_factor);
+}
+
+template<>
+common::half transform<common::half>(uint *val, uint index) {
+    return static_cast<common::half>(uniform<common::half>(val, index));
 }
 
 // Generates rationals in [-1, 1)
@@ -192,6 +204,7 @@ void philoxUniform(T *out, size_t elements, const uintl seed, uintl counter) {
     size_t len    = num_iters * ELEMS_PER_ITER;
 
     constexpr size_t NUM_WRITES = 16 / sizeof(T);
+    compute_t<T> block[ELEMS_PER_ITER];
     for (size_t iter = 0; iter < len; iter += ELEMS_PER_ITER) {
         for (size_t i = 0; i < WRITE_STRIDE; i += RESET_CTR) {
             for (size_t j = 0; j < RESET_CTR; ++j) {
@@ -211,13 +224,15 @@ void philoxUniform(T *out, size_t elements, const uintl seed, uintl counter) {
                 // Use the same ctr array for each of the 4 locations,
                 // but each of the location gets a different ctr value
                 for (size_t buf_idx = 0; buf_idx < NUM_WRITES; ++buf_idx) {
-                    size_t out_idx = iter + buf_idx * WRITE_STRIDE + i + j;
-                    if (out_idx < elements) {
-                        out[out_idx] = transform<T>(ctr, buf_idx);
+                    size_t block_idx = buf_idx * WRITE_STRIDE + i + j;
+                    if (iter + block_idx < elements) {
+                        block[block_idx] = uniform<T>(ctr, buf_idx);
                     }
                 }
             }
         }
+        convertValues(out + iter, block,
+                      std::min(ELEMS_PER_ITER, elements - iter));
     }
 }
 
@@ -234,13 +249,23 @@ void threefryUniform(T *out, size_t elements, const uintl seed, uintl counter) {
     uint ctr[2] = {loc, hic};
     uint val[2];
 
+    // Values are generated BLOCK at a time and converted together
+    constexpr int BLOCK = 256;
+    compute_t<T> block[BLOCK];
+
     int reset = (2 * sizeof(uint)) / sizeof(T);
-    for (int i = 0; i < (int)elements; i += reset) {
-        threefry(key, ctr, val);
-        ++ctr[0];
-        ctr[1] += (ctr[0] == 0);
-        int lim = (reset < (int)(elements - i)) ? reset : (int)(elements - i);
-        for (int j = 0; j < lim; ++j) { out[i + j] = transform<T>(val, j); }
+    for (int b = 0; b < (int)elements; b += BLOCK) {
+        int block_len = std::min(BLOCK, (int)elements - b);
+        for (int i = 0; i < block_len; i += reset) {
+            threefry(key, ctr, val);
+            ++ctr[0];
+            ctr[1] += (ctr[0] == 0);
+            int lim = std::min(reset, block_len - i);
+            for (int j = 0; j < lim; ++j) {
+                block[i + j] = uniform<T>(val, j);
+            }
+        }
+        convertValues(out + b, block, block_len);
     }
 }
 
@@ -12,6 +12,12 @@
 #include <common/Binary.hpp>
 #include <common/Transform.hpp>
 #include <common/half.hpp>
+#include <common/jit/Node.hpp>
+#include <kernel/Array.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
@@ -61,6 +67,45 @@ struct reduce_dim<op, Ti, To, 0> {
     }
 };
 
+/// Reduces the JIT tree \p in of shape \p idims along \p dim. The tree is
+/// evaluated a block of outputs at a time inside the reduction, so neither
+/// the input nor a buffer of partial results the size of the output is
+/// written to memory. Every output element sees its inputs in the same order
+/// as in reduce_dim, which keeps the results identical.
+template<af_op_t op, typename Ti, typename To>
+struct reduce_dim_node {
+    common::Transform<data_t<Ti>, compute_t<To>, op> transform;
+    common::Binary<compute_t<To>, op> reduce;
+    void operator()(Param<To> out, common::Node_ptr in, const af::dim4 idims,
+                    const int dim, bool change_nan, double nanval) {
+        const af::dim4 ostrides  = out.strides();
+        data_t<To> *const outPtr = out.get();
+
+        // Partial results of the outputs of the current block
+        std::array<compute_t<To>, jit::VECTOR_LENGTH> acc;
+        const int step = dim == 0 ? 0 : 1;
+
+        auto begin = [&](int n) {
+            std::fill(acc.begin(), acc.begin() + n, reduce.init());
+        };
+        auto accumulate = [&](const compute_t<Ti> *vals, int lim) {
+            for (int i = 0; i < lim; i++) {
+                compute_t<To> in_val = transform(data_t<Ti>(vals[i]));
+                if (change_nan) in_val = IS_NAN(in_val) ? nanval : in_val;
+                acc[i * step] = reduce(in_val, acc[i * step]);
+            }
+        };
+        auto end = [&](int x, int y, int z, int w, int n) {
+            data_t<To> *o = outPtr + y * ostrides[1] + z * ostrides[2] +
+                            w * ostrides[3];
+            for (int i = 0; i < n; i++) {
+                o[(x + i) * ostrides[0]] = data_t<To>(acc[i]);
+            }
+        };
+        evalNodeAlong<Ti>(in, idims, dim, begin, accumulate, end);
+    }
+};
+
 template<typename Tk>
 void n_reduced_keys(Param<Tk> okeys, int *n_reduced, CParam<Tk> keys) {
     const af::dim4 kdims = keys.dims();
@@ -198,5 +243,29 @@ struct reduce_all {
     }
 };
 
+/// Reduces every element of the JIT tree \p in of shape \p dims, evaluating
+/// it a column at a time. See reduce_dim_node.
+template<af_op_t op, typename Ti, typename To>
+struct reduce_all_node {
+    common::Transform<data_t<Ti>, compute_t<To>, op> transform;
+    common::Binary<compute_t<To>, op> reduce;
+    void operator()(Param<To> out, common::Node_ptr in, const af::dim4 dims,
+                    bool change_nan, double nanval) {
+        compute_t<To> out_val = common::Binary<compute_t<To>, op>::init();
+
+        auto accumulate = [&](const compute_t<Ti> *vals, int lim, int, int,
+                              int, int) {
+            for (int i = 0; i < lim; i++) {
+                compute_t<To> in_val = transform(data_t<Ti>(vals[i]));
+                if (change_nan) in_val = IS_NAN(in_val) ? nanval : in_val;
+                out_val = reduce(in_val, out_val);
+            }
+        };
+        evalNodeColumns<Ti>(in, dims, accumulate);
+
+        *out.get() = data_t<To>(out_val);
+    }
+};
+
 }  // namespace kernel
 }  // namespace cpu
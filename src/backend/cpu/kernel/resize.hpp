@@ -11,8 +11,11 @@
 #include <Param.hpp>
 #include <common/complex.hpp>
 #include <math.hpp>
+#include <thread_pool.hpp>
 #include <af/traits.hpp>
 
+#include <vector>
+
 namespace cpu {
 namespace kernel {
 
@@ -38,137 +41,98 @@ template<typename T>
 using vtype_t =
     typename conditional<common::is_complex<T>::value, T, wtype_t<T>>::type;
 
-template<typename T, af_interp_type method>
-struct resize_op {
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims,
-                    const af::dim4 &idims, const af::dim4 &ostrides,
-                    const af::dim4 &istrides, const dim_t x, const dim_t y) {
-        UNUSED(outPtr);
-        UNUSED(inPtr);
-        UNUSED(odims);
-        UNUSED(idims);
-        UNUSED(ostrides);
-        UNUSED(istrides);
-        UNUSED(x);
-        UNUSED(y);
-        return;
-    }
+/// Source taps and weights of one output coordinate along an axis.
+///
+/// resize is separable, so the source index and fractional weight of every
+/// output column and row are computed once per call instead of once per
+/// output element (and per channel). The arithmetic mirrors the per-element
+/// formulas exactly, so results are unchanged.
+struct resize_tap {
+    dim_t i1;
+    dim_t i2;
+    float w;
 };
 
-template<typename T>
-struct resize_op<T, AF_INTERP_NEAREST> {
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims,
-                    const af::dim4 &idims, const af::dim4 &ostrides,
-                    const af::dim4 &istrides, const dim_t x, const dim_t y) {
-        // Compute Indices
-        dim_t i_x = round2int((float)x / (odims[0] / (float)idims[0]));
-        dim_t i_y = round2int((float)y / (odims[1] / (float)idims[1]));
-
-        if (i_x >= idims[0]) i_x = idims[0] - 1;
-        if (i_y >= idims[1]) i_y = idims[1] - 1;
-
-        dim_t i_off = i_y * istrides[1] + i_x;
-        dim_t o_off = y * ostrides[1] + x;
-        // Copy values from all channels
-        for (dim_t w = 0; w < odims[3]; w++) {
-            dim_t wost = w * ostrides[3];
-            dim_t wist = w * istrides[3];
-            for (dim_t z = 0; z < odims[2]; z++) {
-                outPtr[o_off + z * ostrides[2] + wost] =
-                    inPtr[i_off + z * istrides[2] + wist];
-            }
+template<af_interp_type method>
+void resizeTaps(resize_tap *taps, const dim_t odim, const dim_t idim) {
+    const float scale = odim / (float)idim;
+    for (dim_t o = 0; o < odim; o++) {
+        resize_tap &t = taps[o];
+        switch (method) {
+            case AF_INTERP_NEAREST: t.i1 = round2int((float)o / scale); break;
+            case AF_INTERP_LOWER: t.i1 = floor((float)o / scale); break;
+            default: {
+                float f = (float)o / scale;
+                t.i1    = floor(f);
+                if (t.i1 >= idim) t.i1 = idim - 1;
+                t.w  = f - t.i1;
+                t.i2 = (t.i1 + 1 >= idim ? idim - 1 : t.i1 + 1);
+            } break;
         }
+        if (t.i1 >= idim) t.i1 = idim - 1;
+    }
+}
+
+template<typename T, af_interp_type method>
+struct resize_row {
+    void operator()(T *outPtr, const T *inPtr, const resize_tap *xt,
+                    const resize_tap &yt, const dim_t ow, const dim_t istride) {
+        // Nearest and lower: plain gather from a single source row
+        const T *row = inPtr + yt.i1 * istride;
+        for (dim_t x = 0; x < ow; x++) { outPtr[x] = row[xt[x].i1]; }
     }
 };
 
 template<typename T>
-struct resize_op<T, AF_INTERP_BILINEAR> {
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims,
-                    const af::dim4 &idims, const af::dim4 &ostrides,
-                    const af::dim4 &istrides, const dim_t x, const dim_t y) {
-        // Compute Indices
-        float f_x = (float)x / (odims[0] / (float)idims[0]);
-        float f_y = (float)y / (odims[1] / (float)idims[1]);
-
-        dim_t i1_x = floor(f_x);
-        dim_t i1_y = floor(f_y);
-
-        if (i1_x >= idims[0]) i1_x = idims[0] - 1;
-        if (i1_y >= idims[1]) i1_y = idims[1] - 1;
-
-        float b = f_x - i1_x;
-        float a = f_y - i1_y;
-
-        dim_t i2_x = (i1_x + 1 >= idims[0] ? idims[0] - 1 : i1_x + 1);
-        dim_t i2_y = (i1_y + 1 >= idims[1] ? idims[1] - 1 : i1_y + 1);
-
+struct resize_row<T, AF_INTERP_BILINEAR> {
+    void operator()(T *outPtr, const T *inPtr, const resize_tap *xt,
+                    const resize_tap &yt, const dim_t ow, const dim_t istride) {
         typedef typename af::dtype_traits<T>::base_type BT;
         typedef wtype_t<BT> WT;
         typedef vtype_t<T> VT;
 
-        dim_t o_off = y * ostrides[1] + x;
-        // Copy values from all channels
-        for (dim_t w = 0; w < odims[3]; w++) {
-            dim_t wst = w * istrides[3];
-            for (dim_t z = 0; z < odims[2]; z++) {
-                dim_t zst         = z * istrides[2];
-                dim_t channel_off = zst + wst;
-                VT p1 = inPtr[i1_y * istrides[1] + i1_x + channel_off];
-                VT p2 = inPtr[i2_y * istrides[1] + i1_x + channel_off];
-                VT p3 = inPtr[i1_y * istrides[1] + i2_x + channel_off];
-                VT p4 = inPtr[i2_y * istrides[1] + i2_x + channel_off];
-
-                outPtr[o_off + z * ostrides[2] + w * ostrides[3]] =
-                    scalar<WT>((1.0f - a) * (1.0f - b)) * p1 +
-                    scalar<WT>((a) * (1.0f - b)) * p2 +
-                    scalar<WT>((1.0f - a) * (b)) * p3 +
-                    scalar<WT>((a) * (b)) * p4;
-            }
-        }
-    }
-};
-
-template<typename T>
-struct resize_op<T, AF_INTERP_LOWER> {
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims,
-                    const af::dim4 &idims, const af::dim4 &ostrides,
-                    const af::dim4 &istrides, const dim_t x, const dim_t y) {
-        // Compute Indices
-        dim_t i_x = floor((float)x / (odims[0] / (float)idims[0]));
-        dim_t i_y = floor((float)y / (odims[1] / (float)idims[1]));
-
-        if (i_x >= idims[0]) i_x = idims[0] - 1;
-        if (i_y >= idims[1]) i_y = idims[1] - 1;
-
-        dim_t i_off = i_y * istrides[1] + i_x;
-        dim_t o_off = y * ostrides[1] + x;
-        // Copy values from all channels
-        for (dim_t w = 0; w < odims[3]; w++) {
-            dim_t wost = w * ostrides[3];
-            dim_t wist = w * istrides[3];
-            for (dim_t z = 0; z < odims[2]; z++) {
-                outPtr[o_off + z * ostrides[2] + wost] =
-                    inPtr[i_off + z * istrides[2] + wist];
-            }
+        const T *row1 = inPtr + yt.i1 * istride;
+        const T *row2 = inPtr + yt.i2 * istride;
+        const float a = yt.w;
+        for (dim_t x = 0; x < ow; x++) {
+            const resize_tap &t = xt[x];
+            const float b       = t.w;
+
+            VT p1 = row1[t.i1];
+            VT p2 = row2[t.i1];
+            VT p3 = row1[t.i2];
+            VT p4 = row2[t.i2];
+
+            outPtr[x] = scalar<WT>((1.0f - a) * (1.0f - b)) * p1 +
+                        scalar<WT>((a) * (1.0f - b)) * p2 +
+                        scalar<WT>((1.0f - a) * (b)) * p3 +
+                        scalar<WT>((a) * (b)) * p4;
         }
     }
 };
 
 template<typename T, af_interp_type method>
 void resize(Param<T> out, CParam<T> in) {
-    af::dim4 idims    = in.dims();
-    af::dim4 odims    = out.dims();
-    const T *inPtr    = in.get();
-    T *outPtr         = out.get();
-    af::dim4 ostrides = out.strides();
-    af::dim4 istrides = in.strides();
-
-    resize_op<T, method> op;
-    for (dim_t y = 0; y < odims[1]; y++) {
-        for (dim_t x = 0; x < odims[0]; x++) {
-            op(outPtr, inPtr, odims, idims, ostrides, istrides, x, y);
-        }
-    }
+    const af::dim4 idims    = in.dims();
+    const af::dim4 odims    = out.dims();
+    const T *inPtr          = in.get();
+    T *outPtr               = out.get();
+    const af::dim4 ostrides = out.strides();
+    const af::dim4 istrides = in.strides();
+
+    std::vector<resize_tap> xtaps(odims[0]), ytaps(odims[1]);
+    resizeTaps<method>(xtaps.data(), odims[0], idims[0]);
+    resizeTaps<method>(ytaps.data(), odims[1], idims[1]);
+
+    // Rows are independent, so they are spread over the pool
+    threadPool().parallel_for(
+        odims, grainSize(odims[0]), [&](dim_t y, dim_t z, dim_t w) {
+            resize_row<T, method> op;
+            const T *iptr = inPtr + z * istrides[2] + w * istrides[3];
+            T *optr = outPtr + y * ostrides[1] + z * ostrides[2] +
+                      w * ostrides[3];
+            op(optr, iptr, xtaps.data(), ytaps[y], odims[0], istrides[1]);
+        });
 }
 
 }  // namespace kernel
@@ -11,9 +11,12 @@
 #include <Param.hpp>
 #include <err_cpu.hpp>
 #include <math.hpp>
+#include <thread_pool.hpp>
 #include <af/traits.hpp>
 #include "interp.hpp"
 
+#include <vector>
+
 using af::dtype_traits;
 
 namespace cpu {
@@ -53,38 +56,52 @@ void rotate(Param<T> output, CParam<T> input, const float theta,
     int nimages = odims[2];
     T *out      = output.get();
 
-    for (int idw = 0; idw < (int)odims[3]; idw++) {
-        int out_offw = idw * ostrides[3];
-        int in_offw  = idw * istrides[3];
+    // The rotation is the same for every image, so the column terms are
+    // tabulated once and each row only adds its own offset
+    std::vector<float> colx(odims[0]), coly(odims[0]);
+    for (int idx = 0; idx < (int)odims[0]; idx++) {
+        colx[idx] = idx * tmat[0];
+        coly[idx] = idx * tmat[3];
+    }
+
+    // Every output row is independent; a row covers all images of its batch
+    const dim_t nrows = odims[1] * odims[3];
+    threadPool().parallel_for(
+        0, nrows, grainSize(odims[0] * nimages), [&](dim_t rb, dim_t re) {
+            for (dim_t r = rb; r < re; r++) {
+                const int idy = static_cast<int>(r % odims[1]);
+                const int idw = static_cast<int>(r / odims[1]);
+                int out_offw  = idw * ostrides[3];
+                int in_offw   = idw * istrides[3];
 
-        // Do transform for image
-        for (int idy = 0; idy < (int)odims[1]; idy++) {
-            for (int idx = 0; idx < (int)odims[0]; idx++) {
-                WT xidi = idx * tmat[0] + idy * tmat[1] + tmat[2];
-                WT yidi = idx * tmat[3] + idy * tmat[4] + tmat[5];
+                const float rowx = idy * tmat[1];
+                const float rowy = idy * tmat[4];
+                for (int idx = 0; idx < (int)odims[0]; idx++) {
+                    WT xidi = colx[idx] + rowx + tmat[2];
+                    WT yidi = coly[idx] + rowy + tmat[5];
 
-                // Special conditions to deal with boundaries for bilinear and
-                // bicubic
-                // FIXME: Ideally this condition should be removed or be present
-                // for all methods But tests are expecting a different behavior
-                // for bilinear and nearest
-                bool condX = xidi >= -0.0001 && xidi < idims[0];
-                bool condY = yidi >= -0.0001 && yidi < idims[1];
-                int ooff   = out_offw + idy * ostrides[1] + idx;
-                if (order == 1 || (condX && condY)) {
-                    // FIXME: Nearest and lower do not do clamping, but other
-                    // methods do Make it consistent
-                    bool clamp = order != 1;
-                    interp(output, ooff, input, in_offw, xidi, yidi, method,
-                           nimages, clamp);
-                } else {
-                    for (int n = 0; n < nimages; n++) {
-                        out[ooff + n * ostrides[2]] = scalar<T>(0);
+                    // Special conditions to deal with boundaries for bilinear
+                    // and bicubic
+                    // FIXME: Ideally this condition should be removed or be
+                    // present for all methods But tests are expecting a
+                    // different behavior for bilinear and nearest
+                    bool condX = xidi >= -0.0001 && xidi < idims[0];
+                    bool condY = yidi >= -0.0001 && yidi < idims[1];
+                    int ooff   = out_offw + idy * ostrides[1] + idx;
+                    if (order == 1 || (condX && condY)) {
+                        // FIXME: Nearest and lower do not do clamping, but
+                        // other methods do Make it consistent
+                        bool clamp = order != 1;
+                        interp(output, ooff, input, in_offw, xidi, yidi, method,
+                               nimages, clamp);
+                    } else {
+                        for (int n = 0; n < nimages; n++) {
+                            out[ooff + n * ostrides[2]] = scalar<T>(0);
+                        }
                     }
                 }
             }
-        }
-    }
+        });
 }
 
 }  // namespace kernel
@@ -14,12 +14,15 @@
 
 #pragma once
 
-#include <convolve.hpp>
 #include <math.hpp>
 #include <memory.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
 #include <resize.hpp>
 #include <sort_index.hpp>
+#include <thread_pool.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include <vector>
@@ -123,16 +126,82 @@ void gaussian1D(T* out, const int dim, double sigma = 0.0) {
 }
 
 template<typename T>
-Array<T> gauss_filter(float sigma) {
+std::vector<T> gauss_filter(float sigma) {
     // Using 6-sigma rule
     unsigned gauss_len = std::min((unsigned)round(sigma * 6 + 1) | 1, 31u);
 
-    Array<T> filter = createEmptyArray<T>(gauss_len);
-    gaussian1D((T*)getDevicePtr(filter), gauss_len, sigma);
+    std::vector<T> filter(gauss_len);
+    gaussian1D(filter.data(), gauss_len, sigma);
 
     return filter;
 }
 
+// Separable blur with zero padding, equivalent to convolve2(in, filter,
+// filter, false) for the symmetric Gaussian filters used here. Both passes
+// accumulate a whole row at a time so the inner loops run over contiguous
+// memory, and the intermediate image goes to the caller provided tmp buffer
+// which is reused for every layer of the pyramid. The rows of each pass are
+// split between the threads, each chunk accumulating in its own row.
+//
+// If dog is not null, it receives out - prev row by row while the blurred
+// row is still in cache.
+template<typename T, typename convAccT>
+void gaussBlur(T* out, T* dog, const T* prev, const T* in, T* tmp,
+               const af::dim4& idims, const std::vector<convAccT>& filter) {
+    const dim_t d0    = idims[0];
+    const dim_t d1    = idims[1];
+    const dim_t flen  = filter.size();
+    const dim_t half  = flen >> 1;
+    const dim_t grain = grainSize(d0 * flen);
+
+    // Convolve along the first (contiguous) dimension
+    threadPool().parallel_for(0, d1, grain, [&](dim_t begin, dim_t end) {
+        std::vector<convAccT> acc(d0);
+        for (dim_t j = begin; j < end; ++j) {
+            const T* irow = in + j * d0;
+            for (dim_t i = 0; i < d0; ++i) { acc[i] = scalar<convAccT>(0); }
+            for (dim_t f = 0; f < flen; ++f) {
+                const T fval    = filter[f];
+                const dim_t off = half - f;
+                const dim_t lo  = std::max<dim_t>(0, -off);
+                const dim_t hi  = std::min<dim_t>(d0, d0 - off);
+                for (dim_t i = lo; i < hi; ++i) {
+                    acc[i] += convAccT(irow[i + off] * fval);
+                }
+            }
+            T* trow = tmp + j * d0;
+            for (dim_t i = 0; i < d0; ++i) { trow[i] = T(acc[i]); }
+        }
+    });
+
+    // Convolve along the second dimension, one output row at a time
+    threadPool().parallel_for(0, d1, grain, [&](dim_t begin, dim_t end) {
+        std::vector<convAccT> acc(d0);
+        for (dim_t j = begin; j < end; ++j) {
+            for (dim_t i = 0; i < d0; ++i) { acc[i] = scalar<convAccT>(0); }
+            for (dim_t f = 0; f < flen; ++f) {
+                const dim_t jj = j + half - f;
+                if (jj < 0 || jj >= d1) { continue; }
+                const T fval  = filter[f];
+                const T* trow = tmp + jj * d0;
+                for (dim_t i = 0; i < d0; ++i) {
+                    acc[i] += convAccT(trow[i] * fval);
+                }
+            }
+            T* orow = out + j * d0;
+            for (dim_t i = 0; i < d0; ++i) { orow[i] = T(acc[i]); }
+
+            if (dog) {
+                const T* prow = prev + j * d0;
+                T* drow       = dog + j * d0;
+                for (dim_t i = 0; i < d0; ++i) {
+                    drow[i] = orow[i] - prow[i];
+                }
+            }
+        }
+    });
+}
+
 template<int N>
 void gaussianElimination(float* A, float* b, float* x) {
     // forward elimination
@@ -157,79 +226,94 @@ void gaussianElimination(float* A, float* b, float* x) {
     }
 }
 
-template<typename T>
-void sub(Array<T>& out, const Array<T>& in1, const Array<T>& in2) {
-    size_t nel       = in1.elements();
-    T* out_ptr       = out.get();
-    const T* in1_ptr = in1.get();
-    const T* in2_ptr = in2.get();
-
-    for (size_t i = 0; i < nel; i++) { out_ptr[i] = in1_ptr[i] - in2_ptr[i]; }
-}
+#define CPTR(Y, X) (center_ptr[(Y)*d0 + (X)])
+#define PPTR(Y, X) (prev_ptr[(Y)*d0 + (X)])
+#define NPTR(Y, X) (next_ptr[(Y)*d0 + (X)])
 
-#define CPTR(Y, X) (center_ptr[(Y)*idims[0] + (X)])
-#define PPTR(Y, X) (prev_ptr[(Y)*idims[0] + (X)])
-#define NPTR(Y, X) (next_ptr[(Y)*idims[0] + (X)])
-
-// Determines whether a pixel is a scale-space extremum by comparing it to its
-// 3x3x3 pixel neighborhood.
+// Finds the scale-space extrema of layers 1 to n_layers of an octave, the
+// pixels beyond threshold that are extremal in their 3x3x3 neighborhood. The
+// rows of all the layers are scanned in parallel and the extrema are gathered
+// by layer, then row, then column, keeping the first max_feat of them.
 template<typename T>
-void detectExtrema(float* x_out, float* y_out, unsigned* layer_out,
-                   unsigned* counter, const Array<T>& prev,
-                   const Array<T>& center, const Array<T>& next,
-                   const unsigned layer, const unsigned max_feat,
-                   const float threshold) {
-    const af::dim4 idims = center.dims();
-    const T* prev_ptr    = prev.get();
-    const T* center_ptr  = center.get();
-    const T* next_ptr    = next.get();
-
-    for (int y = ImgBorder; y < idims[1] - ImgBorder; y++) {
-        for (int x = ImgBorder; x < idims[0] - ImgBorder; x++) {
-            float p = center_ptr[y * idims[0] + x];
-
-            // Find extrema
-            if (abs((float)p) > threshold &&
-                ((p > 0 && p > CPTR(y - 1, x - 1) && p > CPTR(y - 1, x) &&
-                  p > CPTR(y - 1, x + 1) && p > CPTR(y, x - 1) &&
-                  p > CPTR(y, x + 1) && p > CPTR(y + 1, x - 1) &&
-                  p > CPTR(y + 1, x) && p > CPTR(y + 1, x + 1) &&
-                  p > PPTR(y - 1, x - 1) && p > PPTR(y - 1, x) &&
-                  p > PPTR(y - 1, x + 1) && p > PPTR(y, x - 1) &&
-                  p > PPTR(y, x) && p > PPTR(y, x + 1) &&
-                  p > PPTR(y + 1, x - 1) && p > PPTR(y + 1, x) &&
-                  p > PPTR(y + 1, x + 1) && p > NPTR(y - 1, x - 1) &&
-                  p > NPTR(y - 1, x) && p > NPTR(y - 1, x + 1) &&
-                  p > NPTR(y, x - 1) && p > NPTR(y, x) && p > NPTR(y, x + 1) &&
-                  p > NPTR(y + 1, x - 1) && p > NPTR(y + 1, x) &&
-                  p > NPTR(y + 1, x + 1)) ||
-                 (p < 0 && p < CPTR(y - 1, x - 1) && p < CPTR(y - 1, x) &&
-                  p < CPTR(y - 1, x + 1) && p < CPTR(y, x - 1) &&
-                  p < CPTR(y, x + 1) && p < CPTR(y + 1, x - 1) &&
-                  p < CPTR(y + 1, x) && p < CPTR(y + 1, x + 1) &&
-                  p < PPTR(y - 1, x - 1) && p < PPTR(y - 1, x) &&
-                  p < PPTR(y - 1, x + 1) && p < PPTR(y, x - 1) &&
-                  p < PPTR(y, x) && p < PPTR(y, x + 1) &&
-                  p < PPTR(y + 1, x - 1) && p < PPTR(y + 1, x) &&
-                  p < PPTR(y + 1, x + 1) && p < NPTR(y - 1, x - 1) &&
-                  p < NPTR(y - 1, x) && p < NPTR(y - 1, x + 1) &&
-                  p < NPTR(y, x - 1) && p < NPTR(y, x) && p < NPTR(y, x + 1) &&
-                  p < NPTR(y + 1, x - 1) && p < NPTR(y + 1, x) &&
-                  p < NPTR(y + 1, x + 1)))) {
-                if (*counter < max_feat) {
-                    x_out[*counter]     = (float)y;
-                    y_out[*counter]     = (float)x;
-                    layer_out[*counter] = layer;
-                    (*counter)++;
+unsigned detectExtrema(float* x_out, float* y_out, unsigned* layer_out,
+                       const std::vector<Array<T>>& dog_pyr,
+                       const unsigned octave, const unsigned n_layers,
+                       const unsigned max_feat, const float threshold) {
+    const unsigned base  = octave * (n_layers + 2);
+    const af::dim4 idims = dog_pyr[base].dims();
+    const dim_t d0       = idims[0];
+    const dim_t x_end    = d0 - ImgBorder;
+    const dim_t nrows    = idims[1] - 2 * ImgBorder;
+    if (nrows <= 0 || x_end <= ImgBorder) { return 0; }
+
+    std::vector<std::vector<int>> found(n_layers * nrows);
+    threadPool().parallel_for(
+        0, found.size(), grainSize(27 * (x_end - ImgBorder)),
+        [&](dim_t begin, dim_t end) {
+            for (dim_t r = begin; r < end; ++r) {
+                const unsigned layer = 1 + r / nrows;
+                const int y          = ImgBorder + r % nrows;
+                const T* prev_ptr    = dog_pyr[base + layer - 1].get();
+                const T* center_ptr  = dog_pyr[base + layer].get();
+                const T* next_ptr    = dog_pyr[base + layer + 1].get();
+
+                for (int x = ImgBorder; x < x_end; x++) {
+                    float p = center_ptr[y * d0 + x];
+
+                    // Find extrema
+                    if (abs((float)p) > threshold &&
+                        ((p > 0 && p > CPTR(y - 1, x - 1) &&
+                          p > CPTR(y - 1, x) && p > CPTR(y - 1, x + 1) &&
+                          p > CPTR(y, x - 1) && p > CPTR(y, x + 1) &&
+                          p > CPTR(y + 1, x - 1) && p > CPTR(y + 1, x) &&
+                          p > CPTR(y + 1, x + 1) && p > PPTR(y - 1, x - 1) &&
+                          p > PPTR(y - 1, x) && p > PPTR(y - 1, x + 1) &&
+                          p > PPTR(y, x - 1) && p > PPTR(y, x) &&
+                          p > PPTR(y, x + 1) && p > PPTR(y + 1, x - 1) &&
+                          p > PPTR(y + 1, x) && p > PPTR(y + 1, x + 1) &&
+                          p > NPTR(y - 1, x - 1) && p > NPTR(y - 1, x) &&
+                          p > NPTR(y - 1, x + 1) && p > NPTR(y, x - 1) &&
+                          p > NPTR(y, x) && p > NPTR(y, x + 1) &&
+                          p > NPTR(y + 1, x - 1) && p > NPTR(y + 1, x) &&
+                          p > NPTR(y + 1, x + 1)) ||
+                         (p < 0 && p < CPTR(y - 1, x - 1) &&
+                          p < CPTR(y - 1, x) && p < CPTR(y - 1, x + 1) &&
+                          p < CPTR(y, x - 1) && p < CPTR(y, x + 1) &&
+                          p < CPTR(y + 1, x - 1) && p < CPTR(y + 1, x) &&
+                          p < CPTR(y + 1, x + 1) && p < PPTR(y - 1, x - 1) &&
+                          p < PPTR(y - 1, x) && p < PPTR(y - 1, x + 1) &&
+                          p < PPTR(y, x - 1) && p < PPTR(y, x) &&
+                          p < PPTR(y, x + 1) && p < PPTR(y + 1, x - 1) &&
+                          p < PPTR(y + 1, x) && p < PPTR(y + 1, x + 1) &&
+                          p < NPTR(y - 1, x - 1) && p < NPTR(y - 1, x) &&
+                          p < NPTR(y - 1, x + 1) && p < NPTR(y, x - 1) &&
+                          p < NPTR(y, x) && p < NPTR(y, x + 1) &&
+                          p < NPTR(y + 1, x - 1) && p < NPTR(y + 1, x) &&
+                          p < NPTR(y + 1, x + 1)))) {
+                        found[r].push_back(x);
+                    }
                 }
             }
+        });
+
+    unsigned counter = 0;
+    for (dim_t r = 0; r < (dim_t)found.size(); ++r) {
+        for (int x : found[r]) {
+            if (counter == max_feat) { return counter; }
+            x_out[counter]     = (float)(ImgBorder + r % nrows);
+            y_out[counter]     = (float)x;
+            layer_out[counter] = 1 + r / nrows;
+            counter++;
         }
     }
+    return counter;
 }
 
 // Interpolates a scale-space extremum's location and scale to subpixel
 // accuracy to form an image feature. Rejects features with low contrast.
-// Based on Section 4 of Lowe's paper.
+// Based on Section 4 of Lowe's paper. The extrema are interpolated in
+// parallel, each writing its feature to its own index, and the accepted ones
+// are then packed in order.
 template<typename T>
 void interpolateExtrema(float* x_out, float* y_out, unsigned* layer_out,
                         float* response_out, float* size_out, unsigned* counter,
@@ -239,111 +323,134 @@ void interpolateExtrema(float* x_out, float* y_out, unsigned* layer_out,
                         const unsigned octave, const unsigned n_layers,
                         const float contrast_thr, const float edge_thr,
                         const float sigma, const float img_scale) {
-    for (int f = 0; f < (int)extrema_feat; f++) {
-        const float first_deriv_scale  = img_scale * 0.5f;
-        const float second_deriv_scale = img_scale;
-        const float cross_deriv_scale  = img_scale * 0.25f;
-
-        float xl = 0, xy = 0, xx = 0, contr = 0;
-        int i = 0;
-
-        unsigned x     = x_in[f];
-        unsigned y     = y_in[f];
-        unsigned layer = layer_in[f];
-
-        const T* prev_ptr = dog_pyr[octave * (n_layers + 2) + layer - 1].get();
-        const T* center_ptr = dog_pyr[octave * (n_layers + 2) + layer].get();
-        const T* next_ptr = dog_pyr[octave * (n_layers + 2) + layer + 1].get();
-
-        af::dim4 idims = dog_pyr[octave * (n_layers + 2)].dims();
+    const af::dim4 idims = dog_pyr[octave * (n_layers + 2)].dims();
+    const dim_t d0       = idims[0];
+    const dim_t d1       = idims[1];
+
+    const float first_deriv_scale  = img_scale * 0.5f;
+    const float second_deriv_scale = img_scale;
+    const float cross_deriv_scale  = img_scale * 0.25f;
+
+    std::vector<unsigned char> keep(extrema_feat, 0);
+    threadPool().parallel_for(0, extrema_feat, grainSize(256), [&](dim_t begin,
+                                                                    dim_t end) {
+        for (dim_t f = begin; f < end; f++) {
+            float xl = 0, xy = 0, xx = 0, contr = 0;
+            int i = 0;
+
+            unsigned x     = x_in[f];
+            unsigned y     = y_in[f];
+            unsigned layer = layer_in[f];
+
+            const unsigned base = octave * (n_layers + 2);
+            const T* prev_ptr   = dog_pyr[base + layer - 1].get();
+            const T* center_ptr = dog_pyr[base + layer].get();
+            const T* next_ptr   = dog_pyr[base + layer + 1].get();
+
+            bool converges = true;
+
+            for (i = 0; i < MaxInterpSteps; i++) {
+                float dD[3] = {(float)(CPTR(x + 1, y) - CPTR(x - 1, y)) *
+                                   first_deriv_scale,
+                               (float)(CPTR(x, y + 1) - CPTR(x, y - 1)) *
+                                   first_deriv_scale,
+                               (float)(NPTR(x, y) - PPTR(x, y)) *
+                                   first_deriv_scale};
+
+                float d2  = CPTR(x, y) * 2.f;
+                float dxx = (CPTR(x + 1, y) + CPTR(x - 1, y) - d2) *
+                            second_deriv_scale;
+                float dyy = (CPTR(x, y + 1) + CPTR(x, y - 1) - d2) *
+                            second_deriv_scale;
+                float dss =
+                    (NPTR(x, y) + PPTR(x, y) - d2) * second_deriv_scale;
+                float dxy = (CPTR(x + 1, y + 1) - CPTR(x - 1, y + 1) -
+                             CPTR(x + 1, y - 1) + CPTR(x - 1, y - 1)) *
+                            cross_deriv_scale;
+                float dxs = (NPTR(x + 1, y) - NPTR(x - 1, y) -
+                             PPTR(x + 1, y) + PPTR(x - 1, y)) *
+                            cross_deriv_scale;
+                float dys = (NPTR(x, y + 1) - NPTR(x - 1, y - 1) -
+                             PPTR(x, y - 1) + PPTR(x - 1, y - 1)) *
+                            cross_deriv_scale;
+
+                float H[9] = {dxx, dxy, dxs, dxy, dyy, dys, dxs, dys, dss};
+
+                float X[3];
+                gaussianElimination<3>(H, dD, X);
+
+                xl = -X[2];
+                xy = -X[1];
+                xx = -X[0];
+
+                if (fabs(xl) < 0.5f && fabs(xy) < 0.5f && fabs(xx) < 0.5f)
+                    break;
+
+                x += round(xx);
+                y += round(xy);
+                layer += round(xl);
+
+                if (layer < 1 || layer > n_layers || x < ImgBorder ||
+                    x >= d1 - ImgBorder || y < ImgBorder ||
+                    y >= d0 - ImgBorder) {
+                    converges = false;
+                    break;
+                }
+            }
 
-        bool converges = true;
+            // ensure convergence of interpolation
+            if (i >= MaxInterpSteps || !converges) continue;
 
-        for (i = 0; i < MaxInterpSteps; i++) {
             float dD[3] = {
                 (float)(CPTR(x + 1, y) - CPTR(x - 1, y)) * first_deriv_scale,
                 (float)(CPTR(x, y + 1) - CPTR(x, y - 1)) * first_deriv_scale,
                 (float)(NPTR(x, y) - PPTR(x, y)) * first_deriv_scale};
+            float X[3] = {xx, xy, xl};
+
+            float P = dD[0] * X[0] + dD[1] * X[1] + dD[2] * X[2];
+
+            contr = center_ptr[x * d0 + y] * img_scale + P * 0.5f;
+            if (abs(contr) < (contrast_thr / n_layers)) continue;
 
+            // principal curvatures are computed using the trace and det of
+            // Hessian
             float d2 = CPTR(x, y) * 2.f;
             float dxx =
                 (CPTR(x + 1, y) + CPTR(x - 1, y) - d2) * second_deriv_scale;
             float dyy =
                 (CPTR(x, y + 1) + CPTR(x, y - 1) - d2) * second_deriv_scale;
-            float dss = (NPTR(x, y) + PPTR(x, y) - d2) * second_deriv_scale;
             float dxy = (CPTR(x + 1, y + 1) - CPTR(x - 1, y + 1) -
                          CPTR(x + 1, y - 1) + CPTR(x - 1, y - 1)) *
                         cross_deriv_scale;
-            float dxs = (NPTR(x + 1, y) - NPTR(x - 1, y) - PPTR(x + 1, y) +
-                         PPTR(x - 1, y)) *
-                        cross_deriv_scale;
-            float dys = (NPTR(x, y + 1) - NPTR(x - 1, y - 1) - PPTR(x, y - 1) +
-                         PPTR(x - 1, y - 1)) *
-                        cross_deriv_scale;
-
-            float H[9] = {dxx, dxy, dxs, dxy, dyy, dys, dxs, dys, dss};
 
-            float X[3];
-            gaussianElimination<3>(H, dD, X);
+            float tr  = dxx + dyy;
+            float det = dxx * dyy - dxy * dxy;
 
-            xl = -X[2];
-            xy = -X[1];
-            xx = -X[0];
-
-            if (fabs(xl) < 0.5f && fabs(xy) < 0.5f && fabs(xx) < 0.5f) break;
-
-            x += round(xx);
-            y += round(xy);
-            layer += round(xl);
-
-            if (layer < 1 || layer > n_layers || x < ImgBorder ||
-                x >= idims[1] - ImgBorder || y < ImgBorder ||
-                y >= idims[0] - ImgBorder) {
-                converges = false;
-                break;
-            }
-        }
-
-        // ensure convergence of interpolation
-        if (i >= MaxInterpSteps || !converges) continue;
-
-        float dD[3] = {
-            (float)(CPTR(x + 1, y) - CPTR(x - 1, y)) * first_deriv_scale,
-            (float)(CPTR(x, y + 1) - CPTR(x, y - 1)) * first_deriv_scale,
-            (float)(NPTR(x, y) - PPTR(x, y)) * first_deriv_scale};
-        float X[3] = {xx, xy, xl};
-
-        float P = dD[0] * X[0] + dD[1] * X[1] + dD[2] * X[2];
-
-        contr = center_ptr[x * idims[0] + y] * img_scale + P * 0.5f;
-        if (abs(contr) < (contrast_thr / n_layers)) continue;
-
-        // principal curvatures are computed using the trace and det of Hessian
-        float d2  = CPTR(x, y) * 2.f;
-        float dxx = (CPTR(x + 1, y) + CPTR(x - 1, y) - d2) * second_deriv_scale;
-        float dyy = (CPTR(x, y + 1) + CPTR(x, y - 1) - d2) * second_deriv_scale;
-        float dxy = (CPTR(x + 1, y + 1) - CPTR(x - 1, y + 1) -
-                     CPTR(x + 1, y - 1) + CPTR(x - 1, y - 1)) *
-                    cross_deriv_scale;
-
-        float tr  = dxx + dyy;
-        float det = dxx * dyy - dxy * dxy;
-
-        // add FLT_EPSILON for double-precision compatibility
-        if (det <= 0 ||
-            tr * tr * edge_thr >= (edge_thr + 1) * (edge_thr + 1) * det +
-                                      std::numeric_limits<float>::epsilon())
-            continue;
+            // add FLT_EPSILON for double-precision compatibility
+            if (det <= 0 ||
+                tr * tr * edge_thr >=
+                    (edge_thr + 1) * (edge_thr + 1) * det +
+                        std::numeric_limits<float>::epsilon())
+                continue;
 
-        if (*counter < max_feat) {
-            x_out[*counter]        = (x + xx) * (1 << octave);
-            y_out[*counter]        = (y + xy) * (1 << octave);
-            layer_out[*counter]    = layer;
-            response_out[*counter] = abs(contr);
-            size_out[*counter] =
+            x_out[f]        = (x + xx) * (1 << octave);
+            y_out[f]        = (y + xy) * (1 << octave);
+            layer_out[f]    = layer;
+            response_out[f] = abs(contr);
+            size_out[f] =
                 sigma * pow(2.f, octave + (layer + xl) / n_layers) * 2.f;
-            (*counter)++;
+            keep[f] = 1;
         }
+    });
+
+    for (unsigned f = 0; f < extrema_feat && *counter < max_feat; f++) {
+        if (!keep[f]) { continue; }
+        x_out[*counter]        = x_out[f];
+        y_out[*counter]        = y_out[f];
+        layer_out[*counter]    = layer_out[f];
+        response_out[*counter] = response_out[f];
+        size_out[*counter]     = size_out[f];
+        (*counter)++;
     }
 }
 
@@ -382,11 +489,13 @@ void removeDuplicates(float* x_out, float* y_out, unsigned* layer_out,
     }
 }
 
-#define IPTR(Y, X) (img_ptr[(Y)*idims[0] + (X)])
+#define IPTR(Y, X) (img_ptr[(Y)*d0 + (X)])
 
 // Computes a canonical orientation for each image feature in an array.  Based
 // on Section 5 of Lowe's paper.  This function adds features to the array when
 // there is more than one dominant orientation at a given feature location.
+// The histograms of the features are built in parallel, and their peaks are
+// then written out in feature order.
 template<typename T>
 void calcOrientation(float* x_out, float* y_out, unsigned* layer_out,
                      float* response_out, float* size_out, float* ori_out,
@@ -398,103 +507,105 @@ void calcOrientation(float* x_out, float* y_out, unsigned* layer_out,
                      const unsigned n_layers, const bool double_input) {
     const int n = OriHistBins;
 
-    float hist[OriHistBins];
-    float temphist[OriHistBins];
+    // A peak is above both of its neighbors, so there are at most n / 2
+    const int max_peaks = OriHistBins / 2;
+    std::vector<float> peaks(total_feat * max_peaks);
+    std::vector<unsigned char> npeaks(total_feat, 0);
 
-    for (unsigned f = 0; f < total_feat; f++) {
-        // Load keypoint information
-        const float real_x   = x_in[f];
-        const float real_y   = y_in[f];
-        const unsigned layer = layer_in[f];
-        const float response = response_in[f];
-        const float size     = size_in[f];
-
-        const int pt_x = (int)round(real_x / (1 << octave));
-        const int pt_y = (int)round(real_y / (1 << octave));
-
-        // Calculate auxiliary parameters
-        const float scl_octv  = size * 0.5f / (1 << octave);
-        const int radius      = (int)round(OriRadius * scl_octv);
-        const float sigma     = OriSigFctr * scl_octv;
-        const int len         = (radius * 2 + 1);
-        const float exp_denom = 2.f * sigma * sigma;
-
-        // Points img to correct Gaussian pyramid layer
-        const Array<T> img = gauss_pyr[octave * (n_layers + 3) + layer];
-        const T* img_ptr   = img.get();
-
-        for (int i = 0; i < OriHistBins; i++) hist[i] = 0.f;
-
-        af::dim4 idims = img.dims();
-
-        // Calculate orientation histogram
-        for (int l = 0; l < len * len; l++) {
-            int i = l / len - radius;
-            int j = l % len - radius;
-
-            int y = pt_y + i;
-            int x = pt_x + j;
-            if (y < 1 || y >= idims[0] - 1 || x < 1 || x >= idims[1] - 1)
-                continue;
+    threadPool().parallel_for(0, total_feat, grainSize(1024), [&](dim_t begin,
+                                                                   dim_t end) {
+        float hist[OriHistBins];
+        float temphist[OriHistBins];
 
-            float dx = (float)(IPTR(x + 1, y) - IPTR(x - 1, y));
-            float dy = (float)(IPTR(x, y - 1) - IPTR(x, y + 1));
+        for (dim_t f = begin; f < end; f++) {
+            // Load keypoint information
+            const float real_x   = x_in[f];
+            const float real_y   = y_in[f];
+            const unsigned layer = layer_in[f];
+            const float size     = size_in[f];
 
-            float mag = sqrt(dx * dx + dy * dy);
-            float ori = atan2(dy, dx);
-            float w   = exp(-(i * i + j * j) / exp_denom);
+            const int pt_x = (int)round(real_x / (1 << octave));
+            const int pt_y = (int)round(real_y / (1 << octave));
 
-            int bin = round(n * (ori + PI_VAL) / (2.f * PI_VAL));
-            bin     = bin < n ? bin : 0;
+            // Calculate auxiliary parameters
+            const float scl_octv  = size * 0.5f / (1 << octave);
+            const int radius      = (int)round(OriRadius * scl_octv);
+            const float sigma     = OriSigFctr * scl_octv;
+            const int len         = (radius * 2 + 1);
+            const float exp_denom = 2.f * sigma * sigma;
 
-            hist[bin] += w * mag;
-        }
+            // Points img to correct Gaussian pyramid layer
+            const Array<T>& img = gauss_pyr[octave * (n_layers + 3) + layer];
+            const T* img_ptr    = img.get();
 
-        for (int i = 0; i < SmoothOriPasses; i++) {
-            for (int j = 0; j < n; j++) { temphist[j] = hist[j]; }
-            for (int j = 0; j < n; j++) {
-                float prev = (j == 0) ? temphist[n - 1] : temphist[j - 1];
-                float next = (j + 1 == n) ? temphist[0] : temphist[j + 1];
-                hist[j]    = 0.25f * prev + 0.5f * temphist[j] + 0.25f * next;
+            for (int i = 0; i < OriHistBins; i++) hist[i] = 0.f;
+
+            const af::dim4 idims = img.dims();
+            const dim_t d0       = idims[0];
+            const dim_t d1       = idims[1];
+
+            // Calculate orientation histogram
+            for (int l = 0; l < len * len; l++) {
+                int i = l / len - radius;
+                int j = l % len - radius;
+
+                int y = pt_y + i;
+                int x = pt_x + j;
+                if (y < 1 || y >= d0 - 1 || x < 1 || x >= d1 - 1) continue;
+
+                float dx = (float)(IPTR(x + 1, y) - IPTR(x - 1, y));
+                float dy = (float)(IPTR(x, y - 1) - IPTR(x, y + 1));
+
+                float mag = sqrt(dx * dx + dy * dy);
+                float ori = atan2(dy, dx);
+                float w   = exp(-(i * i + j * j) / exp_denom);
+
+                int bin = round(n * (ori + PI_VAL) / (2.f * PI_VAL));
+                bin     = bin < n ? bin : 0;
+
+                hist[bin] += w * mag;
             }
-        }
 
-        float omax = hist[0];
-        for (int i = 1; i < n; i++) omax = max(omax, hist[i]);
+            for (int i = 0; i < SmoothOriPasses; i++) {
+                for (int j = 0; j < n; j++) { temphist[j] = hist[j]; }
+                for (int j = 0; j < n; j++) {
+                    float prev = (j == 0) ? temphist[n - 1] : temphist[j - 1];
+                    float next = (j + 1 == n) ? temphist[0] : temphist[j + 1];
+                    hist[j] = 0.25f * prev + 0.5f * temphist[j] + 0.25f * next;
+                }
+            }
+
+            float omax = hist[0];
+            for (int i = 1; i < n; i++) omax = max(omax, hist[i]);
 
-        float mag_thr = (float)(omax * OriPeakRatio);
-        int l, r;
-        for (int j = 0; j < n; j++) {
-            l = (j == 0) ? n - 1 : j - 1;
-            r = (j + 1) % n;
-            if (hist[j] > hist[l] && hist[j] > hist[r] && hist[j] >= mag_thr) {
-                if (*counter < max_feat) {
+            float mag_thr = (float)(omax * OriPeakRatio);
+            float* fpeaks = peaks.data() + f * max_peaks;
+            int l, r;
+            for (int j = 0; j < n; j++) {
+                l = (j == 0) ? n - 1 : j - 1;
+                r = (j + 1) % n;
+                if (hist[j] > hist[l] && hist[j] > hist[r] &&
+                    hist[j] >= mag_thr) {
                     float bin = j + 0.5f * (hist[l] - hist[r]) /
                                         (hist[l] - 2.0f * hist[j] + hist[r]);
                     bin = (bin < 0.0f) ? bin + n : (bin >= n) ? bin - n : bin;
-                    float ori = 360.f - ((360.f / n) * bin);
-
-                    float new_real_x = real_x;
-                    float new_real_y = real_y;
-                    float new_size   = size;
-
-                    if (double_input) {
-                        float scale = 0.5f;
-                        new_real_x *= scale;
-                        new_real_y *= scale;
-                        new_size *= scale;
-                    }
-
-                    x_out[*counter]        = new_real_x;
-                    y_out[*counter]        = new_real_y;
-                    layer_out[*counter]    = layer;
-                    response_out[*counter] = response;
-                    size_out[*counter]     = new_size;
-                    ori_out[*counter]      = ori;
-                    (*counter)++;
+                    fpeaks[npeaks[f]++] = 360.f - ((360.f / n) * bin);
                 }
             }
         }
+    });
+
+    const float scale = double_input ? 0.5f : 1.f;
+    for (unsigned f = 0; f < total_feat; f++) {
+        for (int p = 0; p < npeaks[f] && *counter < max_feat; p++) {
+            x_out[*counter]        = x_in[f] * scale;
+            y_out[*counter]        = y_in[f] * scale;
+            layer_out[*counter]    = layer_in[f];
+            response_out[*counter] = response_in[f];
+            size_out[*counter]     = size_in[f] * scale;
+            ori_out[*counter]      = peaks[f * max_peaks + p];
+            (*counter)++;
+        }
     }
 }
 
@@ -520,101 +631,108 @@ void computeDescriptor(float* desc_out, const unsigned desc_len,
                        const int n, const float scale, const unsigned octave,
                        const unsigned n_layers) {
     UNUSED(response_in);
-    float desc[128];
-
-    for (unsigned f = 0; f < total_feat; f++) {
-        const unsigned layer = layer_in[f];
-        float ori            = (360.f - ori_in[f]) * PI_VAL / 180.f;
-        ori                  = (ori > PI_VAL) ? ori - PI_VAL * 2 : ori;
-        const float size     = size_in[f];
-        const int fx         = round(x_in[f] * scale);
-        const int fy         = round(y_in[f] * scale);
-
-        // Points img to correct Gaussian pyramid layer
-        Array<T> img     = gauss_pyr[octave * (n_layers + 3) + layer];
-        const T* img_ptr = img.get();
-        af::dim4 idims   = img.dims();
-
-        float cos_t        = cos(ori);
-        float sin_t        = sin(ori);
-        float bins_per_rad = n / (PI_VAL * 2.f);
-        float exp_denom    = d * d * 0.5f;
-        float hist_width   = DescrSclFctr * size * scale * 0.5f;
-        int radius         = hist_width * sqrt(2.f) * (d + 1.f) * 0.5f + 0.5f;
-
-        int len = radius * 2 + 1;
-
-        for (int i = 0; i < (int)desc_len; i++) desc[i] = 0.f;
-
-        // Calculate orientation histogram
-        for (int l = 0; l < len * len; l++) {
-            int i = l / len - radius;
-            int j = l % len - radius;
-
-            int y = fy + i;
-            int x = fx + j;
-
-            float x_rot = (j * cos_t - i * sin_t) / hist_width;
-            float y_rot = (j * sin_t + i * cos_t) / hist_width;
-            float xbin  = x_rot + d / 2 - 0.5f;
-            float ybin  = y_rot + d / 2 - 0.5f;
-
-            if (ybin > -1.0f && ybin < d && xbin > -1.0f && xbin < d && y > 0 &&
-                y < idims[0] - 1 && x > 0 && x < idims[1] - 1) {
-                float dx = (float)(IPTR(x + 1, y) - IPTR(x - 1, y));
-                float dy = (float)(IPTR(x, y - 1) - IPTR(x, y + 1));
-
-                float grad_mag = sqrt(dx * dx + dy * dy);
-                float grad_ori = atan2(dy, dx) - ori;
-                while (grad_ori < 0.0f) grad_ori += PI_VAL * 2;
-                while (grad_ori >= PI_VAL * 2) grad_ori -= PI_VAL * 2;
-
-                float w    = exp(-(x_rot * x_rot + y_rot * y_rot) / exp_denom);
-                float obin = grad_ori * bins_per_rad;
-                float mag  = grad_mag * w;
-
-                int x0 = floor(xbin);
-                int y0 = floor(ybin);
-                int o0 = floor(obin);
-                xbin -= x0;
-                ybin -= y0;
-                obin -= o0;
-
-                for (int yl = 0; yl <= 1; yl++) {
-                    int yb = y0 + yl;
-                    if (yb >= 0 && yb < d) {
-                        float v_y = mag * ((yl == 0) ? 1.0f - ybin : ybin);
-                        for (int xl = 0; xl <= 1; xl++) {
-                            int xb = x0 + xl;
-                            if (xb >= 0 && xb < d) {
-                                float v_x =
-                                    v_y * ((xl == 0) ? 1.0f - xbin : xbin);
-                                for (int ol = 0; ol <= 1; ol++) {
-                                    int ob = (o0 + ol) % n;
-                                    float v_o =
-                                        v_x * ((ol == 0) ? 1.0f - obin : obin);
-                                    desc[(yb * d + xb) * n + ob] += v_o;
+    threadPool().parallel_for(0, total_feat, grainSize(4096), [&](dim_t begin,
+                                                                   dim_t end) {
+        float desc[128];
+
+        for (dim_t f = begin; f < end; f++) {
+            const unsigned layer = layer_in[f];
+            float ori            = (360.f - ori_in[f]) * PI_VAL / 180.f;
+            ori                  = (ori > PI_VAL) ? ori - PI_VAL * 2 : ori;
+            const float size     = size_in[f];
+            const int fx         = round(x_in[f] * scale);
+            const int fy         = round(y_in[f] * scale);
+
+            // Points img to correct Gaussian pyramid layer
+            const Array<T>& img  = gauss_pyr[octave * (n_layers + 3) + layer];
+            const T* img_ptr     = img.get();
+            const af::dim4 idims = img.dims();
+            const dim_t d0       = idims[0];
+            const dim_t d1       = idims[1];
+
+            float cos_t        = cos(ori);
+            float sin_t        = sin(ori);
+            float bins_per_rad = n / (PI_VAL * 2.f);
+            float exp_denom    = d * d * 0.5f;
+            float hist_width   = DescrSclFctr * size * scale * 0.5f;
+            int radius = hist_width * sqrt(2.f) * (d + 1.f) * 0.5f + 0.5f;
+
+            int len = radius * 2 + 1;
+
+            for (int i = 0; i < (int)desc_len; i++) desc[i] = 0.f;
+
+            // Calculate orientation histogram
+            for (int l = 0; l < len * len; l++) {
+                int i = l / len - radius;
+                int j = l % len - radius;
+
+                int y = fy + i;
+                int x = fx + j;
+
+                float x_rot = (j * cos_t - i * sin_t) / hist_width;
+                float y_rot = (j * sin_t + i * cos_t) / hist_width;
+                float xbin  = x_rot + d / 2 - 0.5f;
+                float ybin  = y_rot + d / 2 - 0.5f;
+
+                if (ybin > -1.0f && ybin < d && xbin > -1.0f && xbin < d &&
+                    y > 0 && y < d0 - 1 && x > 0 && x < d1 - 1) {
+                    float dx = (float)(IPTR(x + 1, y) - IPTR(x - 1, y));
+                    float dy = (float)(IPTR(x, y - 1) - IPTR(x, y + 1));
+
+                    float grad_mag = sqrt(dx * dx + dy * dy);
+                    float grad_ori = atan2(dy, dx) - ori;
+                    while (grad_ori < 0.0f) grad_ori += PI_VAL * 2;
+                    while (grad_ori >= PI_VAL * 2) grad_ori -= PI_VAL * 2;
+
+                    float w =
+                        exp(-(x_rot * x_rot + y_rot * y_rot) / exp_denom);
+                    float obin = grad_ori * bins_per_rad;
+                    float mag  = grad_mag * w;
+
+                    int x0 = floor(xbin);
+                    int y0 = floor(ybin);
+                    int o0 = floor(obin);
+                    xbin -= x0;
+                    ybin -= y0;
+                    obin -= o0;
+
+                    for (int yl = 0; yl <= 1; yl++) {
+                        int yb = y0 + yl;
+                        if (yb >= 0 && yb < d) {
+                            float v_y = mag * ((yl == 0) ? 1.0f - ybin : ybin);
+                            for (int xl = 0; xl <= 1; xl++) {
+                                int xb = x0 + xl;
+                                if (xb >= 0 && xb < d) {
+                                    float v_x =
+                                        v_y * ((xl == 0) ? 1.0f - xbin : xbin);
+                                    for (int ol = 0; ol <= 1; ol++) {
+                                        int ob = (o0 + ol) % n;
+                                        float v_o = v_x * ((ol == 0)
+                                                               ? 1.0f - obin
+                                                               : obin);
+                                        desc[(yb * d + xb) * n + ob] += v_o;
+                                    }
                                 }
                             }
                         }
                     }
                 }
             }
-        }
 
-        normalizeDesc(desc, desc_len);
+            normalizeDesc(desc, desc_len);
 
-        for (int i = 0; i < (int)desc_len; i++)
-            desc[i] = min(desc[i], DescrMagThr);
+            for (int i = 0; i < (int)desc_len; i++)
+                desc[i] = min(desc[i], DescrMagThr);
 
-        normalizeDesc(desc, desc_len);
+            normalizeDesc(desc, desc_len);
 
-        // Calculate final descriptor values
-        for (int k = 0; k < (int)desc_len; k++) {
-            desc_out[f * desc_len + k] =
-                round(min(255.f, desc[k] * IntDescrFctr));
+            // Calculate final descriptor values
+            for (int k = 0; k < (int)desc_len; k++) {
+                desc_out[f * desc_len + k] =
+                    round(min(255.f, desc[k] * IntDescrFctr));
+            }
         }
-    }
+    });
 }
 
 // Computes GLOH feature descriptors for features in an array. Based on Section
@@ -630,128 +748,136 @@ void computeGLOHDescriptor(float* desc_out, const unsigned desc_len,
                            const unsigned hb, const float scale,
                            const unsigned octave, const unsigned n_layers) {
     UNUSED(response_in);
-    float desc[272];
-
-    for (unsigned f = 0; f < total_feat; f++) {
-        const unsigned layer = layer_in[f];
-        float ori            = (360.f - ori_in[f]) * PI_VAL / 180.f;
-        ori                  = (ori > PI_VAL) ? ori - PI_VAL * 2 : ori;
-        const float size     = size_in[f];
-        const int fx         = round(x_in[f] * scale);
-        const int fy         = round(y_in[f] * scale);
-
-        // Points img to correct Gaussian pyramid layer
-        Array<T> img     = gauss_pyr[octave * (n_layers + 3) + layer];
-        const T* img_ptr = img.get();
-        af::dim4 idims   = img.dims();
-
-        float cos_t              = cos(ori);
-        float sin_t              = sin(ori);
-        float hist_bins_per_rad  = hb / (PI_VAL * 2.f);
-        float polar_bins_per_rad = ab / (PI_VAL * 2.f);
-        float exp_denom          = GLOHRadii[rb - 1] * 0.5f;
-
-        float hist_width = DescrSclFctr * size * scale * 0.5f;
-
-        // Keep same descriptor radius used for SIFT
-        int radius = hist_width * sqrt(2.f) * (d + 1.f) * 0.5f + 0.5f;
-
-        // Alternative radius size calculation, changing the radius weight
-        // (rw) in the range of 0.25f-0.75f gives different results,
-        // increasing it tends to show a better recall rate but with a
-        // smaller amount of correct matches
-        // float rw = 0.5f;
-        // int radius = hist_width * GLOHRadii[rb-1] * rw + 0.5f;
-
-        int len = radius * 2 + 1;
-
-        for (int i = 0; i < (int)desc_len; i++) desc[i] = 0.f;
-
-        // Calculate orientation histogram
-        for (int l = 0; l < len * len; l++) {
-            int i = l / len - radius;
-            int j = l % len - radius;
-
-            int y = fy + i;
-            int x = fx + j;
-
-            float x_rot = (j * cos_t - i * sin_t);
-            float y_rot = (j * sin_t + i * cos_t);
-
-            float r = sqrt(x_rot * x_rot + y_rot * y_rot) / radius *
-                      GLOHRadii[rb - 1];
-            float theta = atan2(y_rot, x_rot);
-            while (theta < 0.0f) theta += PI_VAL * 2;
-            while (theta >= PI_VAL * 2) theta -= PI_VAL * 2;
-
-            float tbin = theta * polar_bins_per_rad;
-            float rbin =
-                (r < GLOHRadii[0])
-                    ? r / GLOHRadii[0]
-                    : ((r < GLOHRadii[1])
-                           ? 1 + (r - GLOHRadii[0]) /
-                                     (float)(GLOHRadii[1] - GLOHRadii[0])
-                           : min(2 + (r - GLOHRadii[1]) /
-                                         (float)(GLOHRadii[2] - GLOHRadii[1]),
-                                 3.f - std::numeric_limits<float>::epsilon()));
-
-            if (r <= GLOHRadii[rb - 1] && y > 0 && y < idims[0] - 1 && x > 0 &&
-                x < idims[1] - 1) {
-                float dx = (float)(IPTR(x + 1, y) - IPTR(x - 1, y));
-                float dy = (float)(IPTR(x, y - 1) - IPTR(x, y + 1));
-
-                float grad_mag = sqrt(dx * dx + dy * dy);
-                float grad_ori = atan2(dy, dx) - ori;
-                while (grad_ori < 0.0f) grad_ori += PI_VAL * 2;
-                while (grad_ori >= PI_VAL * 2) grad_ori -= PI_VAL * 2;
-
-                float w    = exp(-r / exp_denom);
-                float obin = grad_ori * hist_bins_per_rad;
-                float mag  = grad_mag * w;
-
-                int t0 = floor(tbin);
-                int r0 = floor(rbin);
-                int o0 = floor(obin);
-                tbin -= t0;
-                rbin -= r0;
-                obin -= o0;
-
-                for (int rl = 0; rl <= 1; rl++) {
-                    int rb    = (rbin > 0.5f) ? (r0 + rl) : (r0 - rl);
-                    float v_r = mag * ((rl == 0) ? 1.0f - rbin : rbin);
-                    if (rb >= 0 && rb <= 2) {
-                        for (int tl = 0; tl <= 1; tl++) {
-                            int tb    = (t0 + tl) % ab;
-                            float v_t = v_r * ((tl == 0) ? 1.0f - tbin : tbin);
-                            for (int ol = 0; ol <= 1; ol++) {
-                                int ob = (o0 + ol) % hb;
-                                float v_o =
-                                    v_t * ((ol == 0) ? 1.0f - obin : obin);
-                                unsigned idx =
-                                    (rb > 0) *
-                                        (hb + ((rb - 1) * ab + tb) * hb) +
-                                    ob;
-                                desc[idx] += v_o;
+    const float ring1_width = GLOHRadii[1] - GLOHRadii[0];
+    const float ring2_width = GLOHRadii[2] - GLOHRadii[1];
+    const float max_rbin    = 3.f - std::numeric_limits<float>::epsilon();
+
+    threadPool().parallel_for(0, total_feat, grainSize(4096), [&](dim_t begin,
+                                                                   dim_t end) {
+        float desc[272];
+
+        for (dim_t f = begin; f < end; f++) {
+            const unsigned layer = layer_in[f];
+            float ori            = (360.f - ori_in[f]) * PI_VAL / 180.f;
+            ori                  = (ori > PI_VAL) ? ori - PI_VAL * 2 : ori;
+            const float size     = size_in[f];
+            const int fx         = round(x_in[f] * scale);
+            const int fy         = round(y_in[f] * scale);
+
+            // Points img to correct Gaussian pyramid layer
+            const Array<T>& img  = gauss_pyr[octave * (n_layers + 3) + layer];
+            const T* img_ptr     = img.get();
+            const af::dim4 idims = img.dims();
+            const dim_t d0       = idims[0];
+            const dim_t d1       = idims[1];
+
+            float cos_t              = cos(ori);
+            float sin_t              = sin(ori);
+            float hist_bins_per_rad  = hb / (PI_VAL * 2.f);
+            float polar_bins_per_rad = ab / (PI_VAL * 2.f);
+            float exp_denom          = GLOHRadii[rb - 1] * 0.5f;
+
+            float hist_width = DescrSclFctr * size * scale * 0.5f;
+
+            // Keep same descriptor radius used for SIFT
+            int radius = hist_width * sqrt(2.f) * (d + 1.f) * 0.5f + 0.5f;
+
+            // Alternative radius size calculation, changing the radius weight
+            // (rw) in the range of 0.25f-0.75f gives different results,
+            // increasing it tends to show a better recall rate but with a
+            // smaller amount of correct matches
+            // float rw = 0.5f;
+            // int radius = hist_width * GLOHRadii[rb-1] * rw + 0.5f;
+
+            int len = radius * 2 + 1;
+
+            for (int i = 0; i < (int)desc_len; i++) desc[i] = 0.f;
+
+            // Calculate orientation histogram
+            for (int l = 0; l < len * len; l++) {
+                int i = l / len - radius;
+                int j = l % len - radius;
+
+                int y = fy + i;
+                int x = fx + j;
+
+                float x_rot = (j * cos_t - i * sin_t);
+                float y_rot = (j * sin_t + i * cos_t);
+
+                float r = sqrt(x_rot * x_rot + y_rot * y_rot) / radius *
+                          GLOHRadii[rb - 1];
+                float theta = atan2(y_rot, x_rot);
+                while (theta < 0.0f) theta += PI_VAL * 2;
+                while (theta >= PI_VAL * 2) theta -= PI_VAL * 2;
+
+                float tbin = theta * polar_bins_per_rad;
+                float rbin =
+                    (r < GLOHRadii[0])
+                        ? r / GLOHRadii[0]
+                        : ((r < GLOHRadii[1])
+                               ? 1 + (r - GLOHRadii[0]) / ring1_width
+                               : min(2 + (r - GLOHRadii[1]) / ring2_width,
+                                     max_rbin));
+
+                if (r <= GLOHRadii[rb - 1] && y > 0 && y < d0 - 1 && x > 0 &&
+                    x < d1 - 1) {
+                    float dx = (float)(IPTR(x + 1, y) - IPTR(x - 1, y));
+                    float dy = (float)(IPTR(x, y - 1) - IPTR(x, y + 1));
+
+                    float grad_mag = sqrt(dx * dx + dy * dy);
+                    float grad_ori = atan2(dy, dx) - ori;
+                    while (grad_ori < 0.0f) grad_ori += PI_VAL * 2;
+                    while (grad_ori >= PI_VAL * 2) grad_ori -= PI_VAL * 2;
+
+                    float w    = exp(-r / exp_denom);
+                    float obin = grad_ori * hist_bins_per_rad;
+                    float mag  = grad_mag * w;
+
+                    int t0 = floor(tbin);
+                    int r0 = floor(rbin);
+                    int o0 = floor(obin);
+                    tbin -= t0;
+                    rbin -= r0;
+                    obin -= o0;
+
+                    for (int rl = 0; rl <= 1; rl++) {
+                        int rb    = (rbin > 0.5f) ? (r0 + rl) : (r0 - rl);
+                        float v_r = mag * ((rl == 0) ? 1.0f - rbin : rbin);
+                        if (rb >= 0 && rb <= 2) {
+                            for (int tl = 0; tl <= 1; tl++) {
+                                int tb    = (t0 + tl) % ab;
+                                float v_t =
+                                    v_r * ((tl == 0) ? 1.0f - tbin : tbin);
+                                for (int ol = 0; ol <= 1; ol++) {
+                                    int ob = (o0 + ol) % hb;
+                                    float v_o =
+                                        v_t * ((ol == 0) ? 1.0f - obin : obin);
+                                    unsigned idx =
+                                        (rb > 0) *
+                                            (hb + ((rb - 1) * ab + tb) * hb) +
+                                        ob;
+                                    desc[idx] += v_o;
+                                }
                             }
                         }
                     }
                 }
             }
-        }
 
-        normalizeDesc(desc, desc_len);
+            normalizeDesc(desc, desc_len);
 
-        for (int i = 0; i < (int)desc_len; i++)
-            desc[i] = min(desc[i], DescrMagThr);
+            for (int i = 0; i < (int)desc_len; i++)
+                desc[i] = min(desc[i], DescrMagThr);
 
-        normalizeDesc(desc, desc_len);
+            normalizeDesc(desc, desc_len);
 
-        // Calculate final descriptor values
-        for (int k = 0; k < (int)desc_len; k++) {
-            desc_out[f * desc_len + k] =
-                round(min(255.f, desc[k] * IntDescrFctr));
+            // Calculate final descriptor values
+            for (int k = 0; k < (int)desc_len; k++) {
+                desc_out[f * desc_len + k] =
+                    round(min(255.f, desc[k] * IntDescrFctr));
+            }
         }
-    }
+    });
 }
 
 #undef IPTR
@@ -761,8 +887,6 @@ Array<T> createInitialImage(const Array<T>& img, const float init_sigma,
                             const bool double_input) {
     af::dim4 idims = img.dims();
 
-    Array<T> init_img = createEmptyArray<T>(af::dim4());
-
     float s = (double_input) ? std::max((float)sqrt(init_sigma * init_sigma -
                                                     InitSigma * InitSigma * 4),
                                         0.1f)
@@ -770,82 +894,75 @@ Array<T> createInitialImage(const Array<T>& img, const float init_sigma,
                                                     InitSigma * InitSigma),
                                         0.1f);
 
-    Array<T> filter = gauss_filter<T>(s);
+    const std::vector<convAccT> filter = gauss_filter<convAccT>(s);
 
-    if (double_input) {
-        Array<T> double_img =
-            resize<T>(img, idims[0] * 2, idims[1] * 2, AF_INTERP_BILINEAR);
-        init_img = convolve2<T, convAccT>(double_img, filter, filter, false);
-    } else {
-        init_img = convolve2<T, convAccT>(img, filter, filter, false);
-    }
+    Array<T> src = double_input ? resize<T>(img, idims[0] * 2, idims[1] * 2,
+                                            AF_INTERP_BILINEAR)
+                                : img;
+    // The source may still be in flight on the queue
+    getQueue().sync();
+
+    const af::dim4 sdims = src.dims();
+    Array<T> init_img    = createEmptyArray<T>(sdims);
+
+    auto tmp = memAlloc<T>(sdims.elements());
+    gaussBlur<T, convAccT>(init_img.get(), nullptr, nullptr, src.get(),
+                           tmp.get(), sdims, filter);
 
     return init_img;
 }
 
+// Builds the Gaussian and Difference of Gaussians pyramids. Each DoG layer is
+// produced in the same sweep as the Gaussian layer it depends on, and a
+// single scratch image sized for the first octave serves every blur.
 template<typename T, typename convAccT>
-std::vector<Array<T>> buildGaussPyr(const Array<T>& init_img,
-                                    const unsigned n_octaves,
-                                    const unsigned n_layers,
-                                    const float init_sigma) {
+void buildPyramids(std::vector<Array<T>>& gauss_pyr,
+                   std::vector<Array<T>>& dog_pyr, const Array<T>& init_img,
+                   const unsigned n_octaves, const unsigned n_layers,
+                   const float init_sigma) {
     // Precompute Gaussian sigmas using the following formula:
     // \sigma_{total}^2 = \sigma_{i}^2 + \sigma_{i-1}^2
-    std::vector<float> sig_layers(n_layers + 3);
-    sig_layers[0] = init_sigma;
-    float k       = std::pow(2.0f, 1.0f / n_layers);
+    std::vector<std::vector<convAccT>> filters(n_layers + 3);
+    float k = std::pow(2.0f, 1.0f / n_layers);
     for (unsigned i = 1; i < n_layers + 3; i++) {
         float sig_prev  = std::pow(k, i - 1) * init_sigma;
         float sig_total = sig_prev * k;
-        sig_layers[i] = std::sqrt(sig_total * sig_total - sig_prev * sig_prev);
+        filters[i]      = gauss_filter<convAccT>(
+            std::sqrt(sig_total * sig_total - sig_prev * sig_prev));
     }
 
-    // Gaussian Pyramid
-    std::vector<Array<T>> gauss_pyr(n_octaves * (n_layers + 3),
-                                    createEmptyArray<T>(af::dim4()));
-    for (unsigned o = 0; o < n_octaves; o++) {
-        for (unsigned l = 0; l < n_layers + 3; l++) {
-            unsigned src_idx = (l == 0) ? (o - 1) * (n_layers + 3) + n_layers
-                                        : o * (n_layers + 3) + l - 1;
-            unsigned idx     = o * (n_layers + 3) + l;
-
-            if (o == 0 && l == 0) {
-                gauss_pyr[idx] = init_img;
-            } else if (l == 0) {
-                af::dim4 sdims = gauss_pyr[src_idx].dims();
-                gauss_pyr[idx] = resize<T>(gauss_pyr[src_idx], sdims[0] / 2,
-                                           sdims[1] / 2, AF_INTERP_BILINEAR);
-            } else {
-                Array<T> filter = gauss_filter<T>(sig_layers[l]);
-
-                gauss_pyr[idx] = convolve2<T, convAccT>(gauss_pyr[src_idx],
-                                                        filter, filter, false);
-            }
-        }
-    }
+    gauss_pyr.assign(n_octaves * (n_layers + 3),
+                     createEmptyArray<T>(af::dim4()));
+    dog_pyr.assign(n_octaves * (n_layers + 2), createEmptyArray<T>(af::dim4()));
 
-    return gauss_pyr;
-}
+    const af::dim4 idims = init_img.dims();
+    auto tmp             = memAlloc<T>(idims.elements());
 
-template<typename T>
-std::vector<Array<T>> buildDoGPyr(std::vector<Array<T>>& gauss_pyr,
-                                  const unsigned n_octaves,
-                                  const unsigned n_layers) {
-    // DoG Pyramid
-    std::vector<Array<T>> dog_pyr(n_octaves * (n_layers + 2),
-                                  createEmptyArray<T>(af::dim4()));
     for (unsigned o = 0; o < n_octaves; o++) {
-        for (unsigned l = 0; l < n_layers + 2; l++) {
-            unsigned idx    = o * (n_layers + 2) + l;
-            unsigned bottom = o * (n_layers + 3) + l;
-            unsigned top    = o * (n_layers + 3) + l + 1;
+        const unsigned base = o * (n_layers + 3);
+        if (o == 0) {
+            gauss_pyr[base] = init_img;
+        } else {
+            const unsigned src_idx = (o - 1) * (n_layers + 3) + n_layers;
+            af::dim4 sdims         = gauss_pyr[src_idx].dims();
+            gauss_pyr[base] = resize<T>(gauss_pyr[src_idx], sdims[0] / 2,
+                                        sdims[1] / 2, AF_INTERP_BILINEAR);
+            getQueue().sync();
+        }
+
+        const af::dim4 odims = gauss_pyr[base].dims();
+        for (unsigned l = 1; l < n_layers + 3; l++) {
+            const unsigned idx = base + l;
+            const unsigned dog = o * (n_layers + 2) + l - 1;
 
-            dog_pyr[idx] = createEmptyArray<T>(gauss_pyr[bottom].dims());
+            gauss_pyr[idx] = createEmptyArray<T>(odims);
+            dog_pyr[dog]   = createEmptyArray<T>(odims);
 
-            sub<T>(dog_pyr[idx], gauss_pyr[top], gauss_pyr[bottom]);
+            const T* prev = gauss_pyr[idx - 1].get();
+            gaussBlur<T, convAccT>(gauss_pyr[idx].get(), dog_pyr[dog].get(),
+                                   prev, prev, tmp.get(), odims, filters[l]);
         }
     }
-
-    return dog_pyr;
 }
 
 template<typename T, typename convAccT>
@@ -869,11 +986,10 @@ unsigned sift_impl(Array<float>& x, Array<float>& y, Array<float>& score,
     Array<T> init_img =
         createInitialImage<T, convAccT>(in, init_sigma, double_input);
 
-    std::vector<Array<T>> gauss_pyr =
-        buildGaussPyr<T, convAccT>(init_img, n_octaves, n_layers, init_sigma);
-
-    std::vector<Array<T>> dog_pyr =
-        buildDoGPyr<T>(gauss_pyr, n_octaves, n_layers);
+    std::vector<Array<T>> gauss_pyr;
+    std::vector<Array<T>> dog_pyr;
+    buildPyramids<T, convAccT>(gauss_pyr, dog_pyr, init_img, n_octaves,
+                               n_layers, init_sigma);
 
     vector<uptr<float>> x_pyr(n_octaves);
     vector<uptr<float>> y_pyr(n_octaves);
@@ -900,26 +1016,15 @@ unsigned sift_impl(Array<float>& x, Array<float>& y, Array<float>& score,
         const unsigned imel     = ddims[0] * ddims[1];
         const unsigned max_feat = ceil(imel * feature_ratio);
 
-        auto extrema_x        = memAlloc<float>(max_feat);
-        auto extrema_y        = memAlloc<float>(max_feat);
-        auto extrema_layer    = memAlloc<unsigned>(max_feat);
-        unsigned extrema_feat = 0;
-
-        for (unsigned j = 1; j <= n_layers; j++) {
-            unsigned prev   = i * (n_layers + 2) + j - 1;
-            unsigned center = i * (n_layers + 2) + j;
-            unsigned next   = i * (n_layers + 2) + j + 1;
+        auto extrema_x     = memAlloc<float>(max_feat);
+        auto extrema_y     = memAlloc<float>(max_feat);
+        auto extrema_layer = memAlloc<unsigned>(max_feat);
 
-            unsigned layer = j;
-
-            float extrema_thr = 0.5f * contrast_thr / n_layers;
+        const float extrema_thr = 0.5f * contrast_thr / n_layers;
+        const unsigned extrema_feat =
             detectExtrema<T>(extrema_x.get(), extrema_y.get(),
-                             extrema_layer.get(), &extrema_feat, dog_pyr[prev],
-                             dog_pyr[center], dog_pyr[next], layer, max_feat,
-                             extrema_thr);
-        }
-
-        extrema_feat = min(extrema_feat, max_feat);
+                             extrema_layer.get(), dog_pyr, i, n_layers,
+                             max_feat, extrema_thr);
 
         if (extrema_feat == 0) { continue; }
 
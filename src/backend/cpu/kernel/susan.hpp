@@ -9,87 +9,142 @@
 
 #pragma once
 #include <Param.hpp>
+#include <kernel/corners.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
+/// Weight of a pixel differing by \p diff from the nucleus in the USAN.
+/// Beyond a ratio of 2.2 to \p t the power is above 113 and the weight
+/// underflows to zero, which skips the transcendentals for most pixels
+/// outside the USAN.
+template<typename D>
+float usanWeight(const D diff, const float t) {
+    const auto ratio = diff / t;
+    if (std::abs(ratio) > 2.2f) { return 0.f; }
+    const float exp_pow = std::pow(ratio, 6.0);
+    return std::exp(-exp_pow);
+}
+
+/// Differences of 8 and 16 bit pixels are looked up in a table of their
+/// weights instead of being evaluated
 template<typename T>
-void susan_responses(Param<T> output, CParam<T> input, const dim_t idim0,
-                     const dim_t idim1, const int radius, const float t,
-                     const float g, const unsigned border_len) {
-    T* resp_out = output.get();
-    const T* in = input.get();
+using susan_lut =
+    std::integral_constant<bool, std::is_integral<T>::value &&
+                                     sizeof(T) <= sizeof(short)>;
 
-    const unsigned r = border_len;
-    const int rSqrd  = radius * radius;
+/// Offset of a pixel of the circular mask from the nucleus
+struct usan_offset {
+    int d0, d1;
+};
 
-    for (dim_t y = r; y < idim1 - r; ++y) {
-        for (dim_t x = r; x < idim0 - r; ++x) {
-            const dim_t idx = y * idim0 + x;
-            T m_0           = in[idx];
-            float nM        = 0.0f;
+/// SUSAN responses of the columns of a d0 x d1 image, written to the rows
+/// [border, d0 - border). The USAN of every pixel is summed one mask offset
+/// at a time over the whole column, in the order of the offsets, which is
+/// the order the area of one pixel is summed in.
+template<typename T>
+class usan_response {
+   public:
+    usan_response(CParam<T> in, const std::vector<usan_offset>& mask,
+                  const float* lut, const int lutZero, const float t,
+                  const float g, const dim_t border)
+        : in(in.get())
+        , stride1(in.strides()[1])
+        , mask(mask)
+        , lut(lut)
+        , lutZero(lutZero)
+        , t(t)
+        , g(g)
+        , begin(border)
+        , end(in.dims()[0] - border)
+        , area(in.dims()[0]) {}
 
-            for (int i = -radius; i <= radius; ++i) {
-                for (int j = -radius; j <= radius; ++j) {
-                    if (i * i + j * j < rSqrd) {
-                        int p         = x + i;
-                        int q         = y + j;
-                        T m           = in[p + idim0 * q];
-                        float exp_pow = std::pow((m - m_0) / t, 6.0);
-                        float cM      = std::exp(-exp_pow);
-                        nM += cM;
-                    }
+    void operator()(T* out, const dim_t c) {
+        const T* nucleus = in + c * stride1;
+        std::fill(area.begin() + begin, area.begin() + end, 0.f);
+        for (const usan_offset& o : mask) {
+            const T* m = in + (c + o.d1) * stride1 + o.d0;
+            if (lut) {
+                for (dim_t x = begin; x < end; ++x) {
+                    area[x] += lut[lutZero + int(m[x]) - int(nucleus[x])];
+                }
+            } else {
+                for (dim_t x = begin; x < end; ++x) {
+                    area[x] += usanWeight(m[x] - nucleus[x], t);
                 }
             }
-
-            resp_out[idx] = nM < g ? g - nM : T(0);
+        }
+        for (dim_t x = begin; x < end; ++x) {
+            const float nM = area[x];
+            out[x]         = nM < g ? static_cast<T>(g - nM) : T(0);
         }
     }
-}
 
-template<typename T>
-void non_maximal(Param<float> xcoords, Param<float> ycoords,
-                 Param<float> response, shared_ptr<unsigned> counter,
-                 const dim_t idim0, const dim_t idim1, CParam<T> input,
-                 const unsigned border_len, const unsigned max_corners) {
-    float* x_out     = xcoords.get();
-    float* y_out     = ycoords.get();
-    float* resp_out  = response.get();
-    unsigned* count  = counter.get();
-    const T* resp_in = input.get();
+   private:
+    const T* in;
+    const dim_t stride1;
+    const std::vector<usan_offset>& mask;
+    const float* lut;
+    const int lutZero;
+    const float t, g;
+    const dim_t begin, end;
+    std::vector<float> area;
+};
 
-    // Responses on the border don't have 8-neighbors to compare, discard them
-    const unsigned r = border_len + 1;
-
-    for (dim_t y = r; y < idim1 - r; y++) {
-        for (dim_t x = r; x < idim0 - r; x++) {
-            const T v = resp_in[y * idim0 + x];
+/// Finds the SUSAN corners of \p in, the local maxima of the response at
+/// least \p edge + 1 pixels away from the border. At most \p cornerLimit
+/// corners are kept, in column major order.
+template<typename T>
+void susanCorners(corner_list corners, CParam<T> in, const int radius,
+                  const float t, const float g, const unsigned edge,
+                  const unsigned cornerLimit) {
+    const af::dim4 dims = in.dims();
+    const dim_t border  = edge;
+    if (dims[0] <= 2 * border + 2 || dims[1] <= 2 * border + 2) { return; }
 
-            // Find maximum neighborhood response
-            T max_v;
-            max_v = std::max(resp_in[(y - 1) * idim0 + x - 1],
-                             resp_in[y * idim0 + x - 1]);
-            max_v = std::max(max_v, resp_in[(y + 1) * idim0 + x - 1]);
-            max_v = std::max(max_v, resp_in[(y - 1) * idim0 + x]);
-            max_v = std::max(max_v, resp_in[(y + 1) * idim0 + x]);
-            max_v = std::max(max_v, resp_in[(y - 1) * idim0 + x + 1]);
-            max_v = std::max(max_v, resp_in[(y)*idim0 + x + 1]);
-            max_v = std::max(max_v, resp_in[(y + 1) * idim0 + x + 1]);
+    std::vector<usan_offset> mask;
+    for (int i = -radius; i <= radius; ++i) {
+        for (int j = -radius; j <= radius; ++j) {
+            if (i * i + j * j < radius * radius) { mask.push_back({i, j}); }
+        }
+    }
 
-            // Stores corner to {x,y,resp}_out if it's response is maximum
-            // compared to its 8-neighborhood and greater or equal minimum
-            // response
-            if (v > max_v) {
-                const dim_t idx = *count;
-                *count += 1;
-                if (idx < max_corners) {
-                    x_out[idx]    = (float)x;
-                    y_out[idx]    = (float)y;
-                    resp_out[idx] = (float)v;
-                }
+    // The table covers the differences of the pixel values in the image
+    std::vector<float> lut;
+    int lutZero = 0;
+    if (susan_lut<T>::value) {
+        const dim_t stride1 = in.strides()[1];
+        int lo = std::numeric_limits<int>::max();
+        int hi = std::numeric_limits<int>::min();
+        for (dim_t c = 0; c < dims[1]; ++c) {
+            const T* col = in.get() + c * stride1;
+            for (dim_t x = 0; x < dims[0]; ++x) {
+                lo = std::min(lo, int(col[x]));
+                hi = std::max(hi, int(col[x]));
             }
         }
+        lutZero = hi - lo;
+        lut.resize(2 * lutZero + 1);
+        for (int d = -lutZero; d <= lutZero; ++d) {
+            lut[lutZero + d] = usanWeight(d, t);
+        }
     }
+
+    const float* table = lut.empty() ? nullptr : lut.data();
+    *corners           = localMaxima<T>(
+        dims[0], dims[1], border, std::numeric_limits<T>::lowest(),
+        dim_t(mask.size()), [&] {
+            return usan_response<T>(in, mask, table, lutZero, t, g, border);
+        });
+
+    if (corners->size() > cornerLimit) { corners->resize(cornerLimit); }
 }
 
 }  // namespace kernel
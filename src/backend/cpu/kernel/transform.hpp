@@ -10,8 +10,10 @@
 #pragma once
 #include <Param.hpp>
 #include <err_cpu.hpp>
+#include <thread_pool.hpp>
 #include <af/traits.hpp>
 #include <type_traits>
+#include <vector>
 #include "interp.hpp"
 
 namespace cpu {
@@ -89,6 +91,9 @@ void transform(Param<T> output, CParam<T> input, CParam<float> transform,
     int batch_size = 1;
     if (idims[2] != tdims[2]) batch_size = idims[2];
 
+    std::vector<float> colx(odims[0]), coly(odims[0]);
+    std::vector<float> colw(perspective ? odims[0] : 0);
+
     Interp2<T, WT, order> interp;
     for (int idw = 0; idw < (int)odims[3]; idw++) {
         dim_t out_offw = idw * ostrides[3];
@@ -106,34 +111,53 @@ void transform(Param<T> output, CParam<T> input, CParam<float> transform,
             calc_transform_inverse(tmat, tptr, inverse, perspective,
                                    perspective ? 9 : 6);
 
-            for (int idy = 0; idy < (int)odims[1]; idy++) {
-                for (int idx = 0; idx < (int)odims[0]; idx++) {
-                    WT xidi = idx * tmat[0] + idy * tmat[1] + tmat[2];
-                    WT yidi = idx * tmat[3] + idy * tmat[4] + tmat[5];
-
-                    if (perspective) {
-                        WT W = idx * tmat[6] + idy * tmat[7] + tmat[8];
-                        xidi /= W;
-                        yidi /= W;
-                    }
+            // Column terms of the coordinate transform are shared by every
+            // row, so step along rows using a per-column table instead of
+            // redoing the full matrix product per pixel. Terms are summed in
+            // the same order as before, keeping the results unchanged.
+            for (int idx = 0; idx < (int)odims[0]; idx++) {
+                colx[idx] = idx * tmat[0];
+                coly[idx] = idx * tmat[3];
+                if (perspective) colw[idx] = idx * tmat[6];
+            }
 
-                    // FIXME: Nearest and lower do not do clamping, but other
-                    // methods do Make it consistent
-                    bool clamp = order != 1;
-                    bool condX = xidi >= -0.0001 && xidi < idims[0];
-                    bool condY = yidi >= -0.0001 && yidi < idims[1];
-
-                    int ooff = out_offzw + idy * ostrides[1] + idx;
-                    if (condX && condY) {
-                        interp(output, ooff, input, in_offzw, xidi, yidi,
-                               method, batch_size, clamp);
-                    } else {
-                        for (int n = 0; n < batch_size; n++) {
-                            out[ooff + n * ostrides[2]] = scalar<T>(0);
+            // Rows only share the tables above, so they run on the pool
+            threadPool().parallel_for(
+                0, odims[1], grainSize(odims[0] * batch_size),
+                [&](dim_t yb, dim_t ye) {
+                    for (int idy = (int)yb; idy < (int)ye; idy++) {
+                        const float rowx = idy * tmat[1];
+                        const float rowy = idy * tmat[4];
+                        const float roww = perspective ? idy * tmat[7] : 0.f;
+                        for (int idx = 0; idx < (int)odims[0]; idx++) {
+                            WT xidi = colx[idx] + rowx + tmat[2];
+                            WT yidi = coly[idx] + rowy + tmat[5];
+
+                            if (perspective) {
+                                WT W = colw[idx] + roww + tmat[8];
+                                xidi /= W;
+                                yidi /= W;
+                            }
+
+                            // FIXME: Nearest and lower do not do clamping,
+                            // but other methods do Make it consistent
+                            bool clamp = order != 1;
+                            bool condX = xidi >= -0.0001 && xidi < idims[0];
+                            bool condY = yidi >= -0.0001 && yidi < idims[1];
+
+                            int ooff = out_offzw + idy * ostrides[1] + idx;
+                            if (condX && condY) {
+                                interp(output, ooff, input, in_offzw, xidi,
+                                       yidi, method, batch_size, clamp);
+                            } else {
+                                for (int n = 0; n < batch_size; n++) {
+                                    out[ooff + n * ostrides[2]] =
+                                        scalar<T>(0);
+                                }
+                            }
                         }
                     }
-                }
-            }
+                });
         }
     }
 }
@@ -11,10 +11,71 @@
 #include <Param.hpp>
 #include <err_cpu.hpp>
 #include <math.hpp>
+#include <thread_pool.hpp>
+
+#include <algorithm>
+#include <utility>
 
 namespace cpu {
 namespace kernel {
 
+/// Range [first, last) of the i in [0, count) for which start + i * step
+/// lies in [0, size), \p step being positive
+inline std::pair<dim_t, dim_t> insideRange(const dim_t start, const dim_t step,
+                                           const dim_t count,
+                                           const dim_t size) {
+    if (start >= 0 && start + (count - 1) * step < size) { return {0, count}; }
+    const dim_t first = start >= 0 ? 0 : (step - 1 - start) / step;
+    const dim_t last  = start >= size ? 0 : (size - start + step - 1) / step;
+    const dim_t lo    = std::min(first, count);
+    return {lo, std::max(lo, std::min(last, count))};
+}
+
+/// Copies \p n elements \p step apart in \p src to the contiguous \p dst
+template<typename T>
+void copyStrided(T *dst, const T *src, const dim_t n, const dim_t step) {
+    if (step == 1) {
+        std::copy(src, src + n, dst);
+    } else {
+        for (dim_t i = 0; i < n; ++i) { dst[i] = src[i * step]; }
+    }
+}
+
+/// Copies the wx x wy window of \p in whose first element is at (spx, spy),
+/// its elements dx and dy apart, to the contiguous \p dst. Element (x, y)
+/// of the window goes to y * wx + x; the ones outside the image are zero.
+/// \p idims and \p istrides point to the dimensions and strides of the
+/// image. The rows of a window are short, so they are copied in plain
+/// loops.
+template<typename T>
+void unwrapPatch(T *dst, const T *in, const dim_t *idims,
+                 const dim_t *istrides, const dim_t wx, const dim_t wy,
+                 const dim_t spx, const dim_t spy, const dim_t dx,
+                 const dim_t dy) {
+    const T zero      = scalar<T>(0.0);
+    const auto xs     = insideRange(spx, dx, wx, idims[0]);
+    const dim_t xstep = dx * istrides[0];
+    for (dim_t y = 0; y < wy; ++y) {
+        T *row           = dst + y * wx;
+        const dim_t ypad = spy + y * dy;
+        if (ypad < 0 || ypad >= idims[1]) {
+            for (dim_t x = 0; x < wx; ++x) { row[x] = zero; }
+            continue;
+        }
+        const T *src =
+            in + ypad * istrides[1] + (spx + xs.first * dx) * istrides[0];
+        for (dim_t x = 0; x < xs.first; ++x) { row[x] = zero; }
+        for (dim_t x = xs.first; x < xs.second; ++x) {
+            row[x] = src[(x - xs.first) * xstep];
+        }
+        for (dim_t x = xs.second; x < wx; ++x) { row[x] = zero; }
+    }
+}
+
+/// Writes the windows of \p in to the columns of \p out for d == 1, or to
+/// its rows for d == 0. A column of the output is written by one thread:
+/// a whole window for d == 1, and for d == 0 one element of every window,
+/// which reads the rows of the image in order.
 template<typename T>
 void unwrap_dim(Param<T> out, CParam<T> in, const dim_t wx, const dim_t wy,
                 const dim_t sx, const dim_t sy, const dim_t px, const dim_t py,
@@ -29,53 +90,62 @@ void unwrap_dim(Param<T> out, CParam<T> in, const dim_t wx, const dim_t wy,
 
     dim_t nx = 1 + (idims[0] + 2 * px - (((wx - 1) * dx) + 1)) / sx;
 
-    for (dim_t w = 0; w < odims[3]; w++) {
-        for (dim_t z = 0; z < odims[2]; z++) {
-            dim_t cOut    = w * ostrides[3] + z * ostrides[2];
-            dim_t cIn     = w * istrides[3] + z * istrides[2];
-            const T *iptr = inPtr + cIn;
-            T *optr_      = outPtr + cOut;
+    auto image = [&](const dim_t z, const dim_t w) {
+        return inPtr + w * istrides[3] + z * istrides[2];
+    };
 
-            for (dim_t col = 0; col < odims[d]; col++) {
-                // Offset output ptr
-                T *optr = optr_ + col * ostrides[d];
-
-                // Calculate input window index
-                dim_t winy = (col / nx);
-                dim_t winx = (col % nx);
-
-                dim_t startx = winx * sx;
-                dim_t starty = winy * sy;
-
-                dim_t spx = startx - px;
-                dim_t spy = starty - py;
-
-                // Short cut condition ensuring all values within input
-                // dimensions
-                bool cond = (spx >= 0 && spx + (wx * dx) < idims[0] &&
-                             spy >= 0 && spy + (wy * dy) < idims[1]);
-
-                for (dim_t y = 0; y < wy; y++) {
-                    dim_t ypad = spy + y * dy;
-                    for (dim_t x = 0; x < wx; x++) {
-                        dim_t xpad = spx + x * dx;
-
-                        dim_t oloc = (y * wx + x);
-                        if (d == 0) oloc *= ostrides[1];
-
-                        if (cond || (xpad >= 0 && xpad < idims[0] &&
-                                     ypad >= 0 && ypad < idims[1])) {
-                            dim_t iloc =
-                                (ypad * istrides[1] + xpad * istrides[0]);
-                            optr[oloc] = iptr[iloc];
-                        } else {
-                            optr[oloc] = scalar<T>(0.0);
+    if (d == 1) {
+        for (dim_t w = 0; w < odims[3]; w++) {
+            for (dim_t z = 0; z < odims[2]; z++) {
+                T *optr           = outPtr + w * ostrides[3] + z * ostrides[2];
+                const T *iptr     = image(z, w);
+                const dim_t ostep = ostrides[1];
+                threadPool().parallel_for(
+                    0, odims[1], grainSize(wx * wy),
+                    [&](dim_t begin, dim_t end) {
+                        dim_t winx = begin % nx;
+                        dim_t winy = begin / nx;
+                        for (dim_t col = begin; col < end; ++col) {
+                            unwrapPatch(optr + col * ostep, iptr, idims.get(),
+                                        istrides.get(), wx, wy,
+                                        winx * sx - px, winy * sy - py, dx,
+                                        dy);
+                            if (++winx == nx) {
+                                winx = 0;
+                                ++winy;
+                            }
                         }
-                    }
-                }
+                    });
             }
         }
+        return;
     }
+
+    const dim_t ny = odims[0] / nx;
+    threadPool().parallel_for(
+        odims, grainSize(odims[0]), [&](dim_t k, dim_t z, dim_t w) {
+            T *optr =
+                outPtr + w * ostrides[3] + z * ostrides[2] + k * ostrides[1];
+            const T *iptr = image(z, w);
+
+            dim_t xoff    = (k % wx) * dx - px;
+            dim_t yoff    = (k / wx) * dy - py;
+            const auto xs = insideRange(xoff, sx, nx, idims[0]);
+            for (dim_t winy = 0; winy < ny; ++winy) {
+                T *row     = optr + winy * nx;
+                dim_t ypad = winy * sy + yoff;
+                if (ypad < 0 || ypad >= idims[1]) {
+                    std::fill(row, row + nx, scalar<T>(0.0));
+                    continue;
+                }
+                dim_t first =
+                    ypad * istrides[1] + (xoff + xs.first * sx) * istrides[0];
+                std::fill(row, row + xs.first, scalar<T>(0.0));
+                copyStrided(row + xs.first, iptr + first,
+                            xs.second - xs.first, sx * istrides[0]);
+                std::fill(row + xs.second, row + nx, scalar<T>(0.0));
+            }
+        });
 }
 
 }  // namespace kernel
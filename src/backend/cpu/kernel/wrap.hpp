@@ -11,15 +11,57 @@
 #include <Param.hpp>
 #include <err_cpu.hpp>
 #include <math.hpp>
+#include <thread_pool.hpp>
 
 #include <algorithm>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
-template<typename T, int d>
-void wrap_dim(Param<T> out, CParam<T> in, const dim_t wx, const dim_t wy,
-              const dim_t sx, const dim_t sy, const dim_t px, const dim_t py) {
+/// The windows along one dimension covering each of its n elements: for
+/// element o, the pairs (win, elem) with o == win * s - p + elem * d for
+/// elem in [0, w) and win in [0, count), in increasing order of win.
+class window_cover {
+   public:
+    struct entry {
+        dim_t win, elem;
+    };
+
+    window_cover(const dim_t n, const dim_t w, const dim_t s, const dim_t p,
+                 const dim_t d, const dim_t count)
+        : offsets(n + 1) {
+        for (dim_t o = 0; o < n; ++o) {
+            offsets[o] = entries.size();
+            for (dim_t elem = w - 1; elem >= 0; --elem) {
+                const dim_t t = o + p - elem * d;
+                if (t < 0 || t % s != 0 || t / s >= count) { continue; }
+                entries.push_back({t / s, elem});
+            }
+        }
+        offsets[n] = entries.size();
+    }
+
+    const entry *begin(const dim_t o) const {
+        return entries.data() + offsets[o];
+    }
+    const entry *end(const dim_t o) const {
+        return entries.data() + offsets[o + 1];
+    }
+
+   private:
+    std::vector<size_t> offsets;
+    std::vector<entry> entries;
+};
+
+/// Adds the windows in the columns (d == 1) or rows (d == 0) of \p in to
+/// \p out. Every output element gathers the window elements landing on it,
+/// in the order of the windows, so the output columns are split between
+/// the threads without any two of them writing the same element.
+template<typename T>
+void wrap_gather(Param<T> out, CParam<T> in, const dim_t wx, const dim_t wy,
+                 const dim_t sx, const dim_t sy, const dim_t px,
+                 const dim_t py, const dim_t dx, const dim_t dy, const int d) {
     const T *inPtr = in.get();
     T *outPtr      = out.get();
 
@@ -28,54 +70,47 @@ void wrap_dim(Param<T> out, CParam<T> in, const dim_t wx, const dim_t wy,
     af::dim4 istrides = in.strides();
     af::dim4 ostrides = out.strides();
 
-    dim_t nx = (odims[0] + 2 * px - wx) / sx + 1;
-
-    for (dim_t w = 0; w < idims[3]; w++) {
-        for (dim_t z = 0; z < idims[2]; z++) {
-            dim_t cIn      = w * istrides[3] + z * istrides[2];
-            dim_t cOut     = w * ostrides[3] + z * ostrides[2];
-            const T *iptr_ = inPtr + cIn;
-            T *optr        = outPtr + cOut;
-
-            for (dim_t col = 0; col < idims[d]; col++) {
-                // Offset output ptr
-                const T *iptr = iptr_ + col * istrides[d];
-
-                // Calculate input window index
-                dim_t winy = (col / nx);
-                dim_t winx = (col % nx);
-
-                dim_t startx = winx * sx;
-                dim_t starty = winy * sy;
-
-                dim_t spx = startx - px;
-                dim_t spy = starty - py;
-
-                // Short cut condition ensuring all values within input
-                // dimensions
-                bool cond = (spx >= 0 && spx + wx < odims[0] && spy >= 0 &&
-                             spy + wy < odims[1]);
-
-                for (dim_t y = 0; y < wy; y++) {
-                    for (dim_t x = 0; x < wx; x++) {
-                        dim_t xpad = spx + x;
-                        dim_t ypad = spy + y;
-
-                        dim_t iloc = (y * wx + x);
-                        if (d == 0) iloc *= istrides[1];
-
-                        if (cond || (xpad >= 0 && xpad < odims[0] &&
-                                     ypad >= 0 && ypad < odims[1])) {
-                            dim_t oloc =
-                                (ypad * ostrides[1] + xpad * ostrides[0]);
-                            // FIXME: When using threads, atomize this
-                            optr[oloc] += iptr[iloc];
-                        }
+    const dim_t nx    = 1 + (odims[0] + 2 * px - (((wx - 1) * dx) + 1)) / sx;
+    const dim_t ncols = idims[d];
+    const dim_t ny    = (ncols + nx - 1) / nx;
+
+    const window_cover xcover(odims[0], wx, sx, px, dx, nx);
+    const window_cover ycover(odims[1], wy, sy, py, dy, ny);
+
+    const dim_t od0   = odims[0];
+    const dim_t ostep = ostrides[0];
+    const dim_t istep = istrides[1];
+    threadPool().parallel_for(
+        odims, grainSize(od0 * wx * wy), [&](dim_t oy, dim_t z, dim_t w) {
+            const data_t<T> *iptr =
+                inPtr + w * istrides[3] + z * istrides[2];
+            data_t<T> *optr =
+                outPtr + w * ostrides[3] + z * ostrides[2] + oy * ostrides[1];
+
+            for (dim_t ox = 0; ox < od0; ++ox) {
+                data_t<T> acc = optr[ox * ostep];
+                for (auto ey = ycover.begin(oy); ey != ycover.end(oy); ++ey) {
+                    for (auto ex = xcover.begin(ox); ex != xcover.end(ox);
+                         ++ex) {
+                        dim_t col = ey->win * nx + ex->win;
+                        if (col >= ncols) { break; }
+
+                        dim_t iloc = ey->elem * wx + ex->elem;
+                        dim_t loc  = d == 1 ? col * istep + iloc
+                                            : col + iloc * istep;
+                        acc = static_cast<compute_t<T>>(acc) +
+                              static_cast<compute_t<T>>(iptr[loc]);
                     }
                 }
+                optr[ox * ostep] = acc;
             }
-        }
-    }
+        });
+}
+
+template<typename T, int d>
+void wrap_dim(Param<T> out, CParam<T> in, const dim_t wx, const dim_t wy,
+              const dim_t sx, const dim_t sy, const dim_t px, const dim_t py) {
+    wrap_gather(out, in, wx, wy, sx, sy, px, py, 1, 1, d);
 }
 
 template<typename T>
@@ -83,63 +118,7 @@ void wrap_dim_dilated(Param<T> out, CParam<T> in, const dim_t wx,
                       const dim_t wy, const dim_t sx, const dim_t sy,
                       const dim_t px, const dim_t py, const dim_t dx,
                       const dim_t dy, const int d) {
-    const T *inPtr = in.get();
-    T *outPtr      = out.get();
-
-    af::dim4 idims    = in.dims();
-    af::dim4 odims    = out.dims();
-    af::dim4 istrides = in.strides();
-    af::dim4 ostrides = out.strides();
-
-    dim_t nx = 1 + (odims[0] + 2 * px - (((wx - 1) * dx) + 1)) / sx;
-
-    for (dim_t w = 0; w < idims[3]; w++) {
-        for (dim_t z = 0; z < idims[2]; z++) {
-            dim_t cIn              = w * istrides[3] + z * istrides[2];
-            dim_t cOut             = w * ostrides[3] + z * ostrides[2];
-            const data_t<T> *iptr_ = inPtr + cIn;
-            data_t<T> *optr        = outPtr + cOut;
-
-            for (dim_t col = 0; col < idims[d]; col++) {
-                // Offset output ptr
-                const data_t<T> *iptr = iptr_ + col * istrides[d];
-
-                // Calculate input window index
-                dim_t winy = (col / nx);
-                dim_t winx = (col % nx);
-
-                dim_t startx = winx * sx;
-                dim_t starty = winy * sy;
-
-                dim_t spx = startx - px;
-                dim_t spy = starty - py;
-
-                // Short cut condition ensuring all values within input
-                // dimensions
-                bool cond = (spx >= 0 && spx + (wx * dx) < odims[0] &&
-                             spy >= 0 && spy + (wy * dy) < odims[1]);
-
-                for (dim_t y = 0; y < wy; y++) {
-                    dim_t ypad = spy + y * dy;
-                    for (dim_t x = 0; x < wx; x++) {
-                        dim_t xpad = spx + x * dx;
-
-                        dim_t iloc = (y * wx + x);
-                        if (d == 0) iloc *= istrides[1];
-
-                        if (cond || (xpad >= 0 && xpad < odims[0] &&
-                                     ypad >= 0 && ypad < odims[1])) {
-                            dim_t oloc =
-                                (ypad * ostrides[1] + xpad * ostrides[0]);
-                            // FIXME: When using threads, atomize this
-                            optr[oloc] = static_cast<compute_t<T>>(optr[oloc]) +
-                                         static_cast<compute_t<T>>(iptr[iloc]);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    wrap_gather(out, in, wx, wy, sx, sy, px, py, dx, dy, d);
 }
 
 }  // namespace kernel
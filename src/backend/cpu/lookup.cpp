@@ -6,13 +6,15 @@
  * The complete license agreement can be obtained at:
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
-#include <kernel/lookup.hpp>
 #include <lookup.hpp>
 
 #include <common/half.hpp>
-#include <platform.hpp>
-#include <queue.hpp>
+#include <common/moddims.hpp>
+#include <jit/BufferNode.hpp>
+#include <jit/GatherNode.hpp>
+
 #include <cstdlib>
+#include <memory>
 
 using common::half;
 
@@ -27,10 +29,19 @@ Array<in_t> lookup(const Array<in_t> &input, const Array<idx_t> &indices,
         oDims[d] = (d == int(dim) ? indices.elements() : iDims[d]);
     }
 
-    Array<in_t> out = createEmptyArray<in_t>(oDims);
-    getQueue().enqueue(kernel::lookup<in_t, idx_t>, out, input, indices, dim);
+    // Lay the indices along dim, so that evaluating them over the output
+    // broadcasts each index across the other dimensions
+    dim4 idxDims(1);
+    idxDims[dim] = indices.elements();
+    Array<idx_t> idx = common::modDims(indices, idxDims);
 
-    return out;
+    // The gather is a JIT node, so lookup(a, idx) * b + c is a single pass
+    input.eval();
+    auto buffer =
+        std::static_pointer_cast<jit::BufferNode<in_t>>(input.getNode());
+    return createNodeArray<in_t>(
+        oDims, std::make_shared<jit::GatherNode<in_t, idx_t>>(
+                   buffer, idx.getNode(), static_cast<int>(dim)));
 }
 
 #define INSTANTIATE(T)                                                         \
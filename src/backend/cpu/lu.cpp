@@ -12,6 +12,7 @@
 
 #if defined(WITH_LINEAR_ALGEBRA)
 #include <handle.hpp>
+#include <kernel/batched_linalg.hpp>
 #include <kernel/lu.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
@@ -55,8 +56,8 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot,
     pivot            = lu_inplace(in_copy);
 
     // SPLIT into lower and upper
-    dim4 ldims(M, min(M, N));
-    dim4 udims(min(M, N), N);
+    dim4 ldims(M, min(M, N), iDims[2], iDims[3]);
+    dim4 udims(min(M, N), N, iDims[2], iDims[3]);
     lower = createEmptyArray<T>(ldims);
     upper = createEmptyArray<T>(udims);
 
@@ -66,18 +67,31 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot,
 template<typename T>
 Array<int> lu_inplace(Array<T> &in, const bool convert_pivot) {
     dim4 iDims = in.dims();
-    Array<int> pivot =
-        createEmptyArray<int>(af::dim4(min(iDims[0], iDims[1]), 1, 1, 1));
+    dim4 pDims(min(iDims[0], iDims[1]), 1, iDims[2], iDims[3]);
+    Array<int> pivot = createEmptyArray<int>(pDims);
 
-    auto func = [=](Param<T> in, Param<int> pivot) {
-        dim4 iDims = in.dims();
-        getrf_func<T>()(AF_LAPACK_COL_MAJOR, iDims[0], iDims[1], in.get(),
-                        in.strides(1), pivot.get());
-    };
-    getQueue().enqueue(func, in, pivot);
+    if (kernel::batched::useBatched(iDims)) {
+        getQueue().enqueue(kernel::batched::getrf<T>, in, pivot);
+    } else {
+        auto func = [=](Param<T> in, Param<int> pivot) {
+            dim4 iDims    = in.dims();
+            dim4 iStrides = in.strides();
+            dim4 pStrides = pivot.strides();
+            for (dim_t w = 0; w < iDims[3]; ++w) {
+                for (dim_t z = 0; z < iDims[2]; ++z) {
+                    getrf_func<T>()(
+                        AF_LAPACK_COL_MAJOR, iDims[0], iDims[1],
+                        in.get() + z * iStrides[2] + w * iStrides[3],
+                        iStrides[1],
+                        pivot.get() + z * pStrides[2] + w * pStrides[3]);
+                }
+            }
+        };
+        getQueue().enqueue(func, in, pivot);
+    }
 
     if (convert_pivot) {
-        Array<int> p = range<int>(dim4(iDims[0]), 0);
+        Array<int> p = range<int>(dim4(iDims[0], 1, pDims[2], pDims[3]), 0);
         getQueue().enqueue(kernel::convertPivot, p, pivot);
         return p;
     } else {
@@ -9,11 +9,14 @@
 
 #include <match_template.hpp>
 
+#include <common/cast.hpp>
+#include <fftconvolve.hpp>
 #include <kernel/match_template.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <af/dim4.hpp>
 
+#include <cmath>
 #include <functional>
 
 using af::dim4;
@@ -23,10 +26,55 @@ namespace cpu {
 template<typename To, typename Ti>
 using matchFunc = std::function<void(Param<To>, CParam<Ti>, CParam<Ti>)>;
 
+template<typename To, typename Ti>
+using correlatedFunc =
+    std::function<void(Param<To>, CParam<Ti>, CParam<Ti>, CParam<To>)>;
+
+/// Whether the cross correlation of the squared difference measures is
+/// cheaper through FFTs than by visiting every template pixel at every
+/// offset. The direct cost is a multiply-add per template pixel and output,
+/// and the FFTs cost about 15 N log2(N) for the N padded elements.
+static bool useFFT(const af::matchType mType, const dim4 &sDims,
+                   const dim4 &tDims) {
+    if (mType != AF_SSD && mType != AF_ZSSD && mType != AF_LSSD) {
+        return false;
+    }
+    const double batch  = static_cast<double>(sDims[2] * sDims[3]);
+    const double direct = static_cast<double>(sDims[0] * sDims[1]) *
+                          static_cast<double>(tDims.elements()) * batch;
+    const double padded =
+        static_cast<double>((sDims[0] + tDims[0]) * (sDims[1] + tDims[1])) *
+        batch;
+    return direct > 15.0 * padded * std::log2(padded);
+}
+
 template<typename inType, typename outType>
 Array<outType> match_template(const Array<inType> &sImg,
                               const Array<inType> &tImg,
                               const af::matchType mType) {
+    Array<outType> out = createEmptyArray<outType>(sImg.dims());
+
+    if (useFFT(mType, sImg.dims(), tImg.dims())) {
+        static const correlatedFunc<outType, inType> funcs[3] = {
+            kernel::matchTemplateCorrelated<outType, inType, AF_SSD>,
+            kernel::matchTemplateCorrelated<outType, inType, AF_ZSSD>,
+            kernel::matchTemplateCorrelated<outType, inType, AF_LSSD>,
+        };
+
+        Array<outType> flipped = createEmptyArray<outType>(tImg.dims());
+        getQueue().enqueue(kernel::flipTemplate<outType, inType>, flipped,
+                           tImg);
+
+        const bool batched = sImg.dims()[2] * sImg.dims()[3] > 1;
+        Array<outType> corr =
+            fftconvolve(common::cast<outType, inType>(sImg), flipped, true,
+                        batched ? AF_BATCH_LHS : AF_BATCH_NONE, 2);
+
+        getQueue().enqueue(funcs[static_cast<int>(mType) - AF_SSD], out, sImg,
+                           tImg, corr);
+        return out;
+    }
+
     static const matchFunc<outType, inType> funcs[6] = {
         kernel::matchTemplate<outType, inType, AF_SAD>,
         kernel::matchTemplate<outType, inType, AF_ZSAD>,
@@ -36,7 +84,6 @@ Array<outType> match_template(const Array<inType> &sImg,
         kernel::matchTemplate<outType, inType, AF_LSSD>,
     };
 
-    Array<outType> out = createEmptyArray<outType>(sImg.dims());
     getQueue().enqueue(funcs[static_cast<int>(mType)], out, sImg, tImg);
     return out;
 }
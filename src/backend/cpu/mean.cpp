@@ -27,11 +27,25 @@ template<typename Ti, typename Tw, typename To>
 using mean_dim_func = std::function<void(
     Param<To>, const dim_t, const CParam<Ti>, const dim_t, const int)>;
 
+template<typename Ti, typename Tw, typename To>
+using mean_node_func =
+    std::function<void(Param<To>, common::Node_ptr, const dim4, const int)>;
+
 template<typename Ti, typename Tw, typename To>
 Array<To> mean(const Array<Ti> &in, const int dim) {
     dim4 odims    = in.dims();
     odims[dim]    = 1;
     Array<To> out = createEmptyArray<To>(odims);
+
+    // Evaluate a pending JIT tree inside the kernel instead of writing it to a
+    // temporary first
+    if (!in.isReady()) {
+        static const mean_node_func<Ti, Tw, To> mean_node =
+            kernel::mean_dim_node<Ti, Tw, To>();
+        getQueue().enqueue(mean_node, out, in.getNode(), in.dims(), dim);
+        return out;
+    }
+
     static const mean_dim_func<Ti, Tw, To> mean_funcs[] = {
         kernel::mean_dim<Ti, Tw, To, 1>(), kernel::mean_dim<Ti, Tw, To, 2>(),
         kernel::mean_dim<Ti, Tw, To, 3>(), kernel::mean_dim<Ti, Tw, To, 4>()};
@@ -99,15 +113,27 @@ T mean(const Array<T> &in, const Array<Tw> &wt) {
 template<typename Ti, typename Tw, typename To>
 To mean(const Array<Ti> &in) {
     using MeanOpT = kernel::MeanOp<compute_t<Ti>, compute_t<To>, compute_t<Tw>>;
-    in.eval();
+    MeanOpT Op(0, 0);
+
+    if (!in.isReady()) {
+        // Average the JIT tree as it is evaluated rather than materialising it
+        getQueue().sync();
+        auto accumulate = [&Op](const compute_t<Ti> *vals, int lim, int, int,
+                                int, int) {
+            for (int i = 0; i < lim; i++) {
+                Op(compute_t<Ti>(data_t<Ti>(vals[i])), 1);
+            }
+        };
+        kernel::evalNodeColumns<Ti>(in.getNode(), in.dims(), accumulate);
+        return To(Op.runningMean);
+    }
+
     getQueue().sync();
 
     af::dim4 dims    = in.dims();
     af::dim4 strides = in.strides();
     const Ti *inPtr  = in.get();
 
-    MeanOpT Op(0, 0);
-
     for (dim_t l = 0; l < dims[3]; l++) {
         dim_t off3 = l * strides[3];
 
@@ -19,13 +19,18 @@
 #include <types.hpp>
 #include <af/dim4.hpp>
 
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 
 using af::dim4;
 using common::bytesToString;
 using common::half;
 using std::function;
+using std::lock_guard;
 using std::move;
+using std::mutex;
+using std::unordered_map;
 using std::unique_ptr;
 
 namespace cpu {
@@ -52,12 +57,89 @@ void printMemInfo(const char *msg, const int device) {
     memoryManager().printInfo(msg, device);
 }
 
+namespace {
+/// The queues that may still reference a buffer. The owner is the queue that
+/// last wrote or read it through a kernel, the user is the queue active on
+/// the thread that released it.
+struct BufferStreams {
+    int owner;
+    int user;
+};
+
+mutex bufferMutex;
+unordered_map<const void *, BufferStreams> bufferStreams;
+
+/// Syncs \p id unless it is the active queue or has been destroyed. A
+/// queue's own workers never wait for it, which would deadlock.
+void syncStream(int id) {
+    if (id == getActiveStreamId()) { return; }
+    queue *q = getStream(id);
+    if (q && !q->is_worker()) { q->sync(); }
+}
+
+/// Hands a buffer returned by the memory manager to the active queue. A
+/// recycled buffer may still be in use on the queue that released it.
+void claimBuffer(const void *ptr) {
+    if (!ptr || !streamsInUse()) { return; }
+    const int active = getActiveStreamId();
+    BufferStreams prev{active, active};
+    {
+        lock_guard<mutex> lock(bufferMutex);
+        auto it = bufferStreams.find(ptr);
+        if (it != bufferStreams.end()) { prev = it->second; }
+        bufferStreams[ptr] = {active, active};
+    }
+    syncStream(prev.owner);
+    if (prev.user != prev.owner) { syncStream(prev.user); }
+}
+
+void releaseBuffer(const void *ptr) {
+    if (!ptr || !streamsInUse()) { return; }
+    lock_guard<mutex> lock(bufferMutex);
+    auto it = bufferStreams.find(ptr);
+    if (it != bufferStreams.end()) { it->second.user = getActiveStreamId(); }
+}
+}  // namespace
+
+void waitForBufferStream(queue &q, const void *ptr) {
+    if (!ptr) { return; }
+    int owner = q.id();
+    {
+        lock_guard<mutex> lock(bufferMutex);
+        // Buffers allocated before any other queue existed were produced on
+        // the default queue
+        auto it = bufferStreams.find(ptr);
+        if (it == bufferStreams.end()) {
+            it = bufferStreams.emplace(ptr, BufferStreams{0, 0}).first;
+        }
+        std::swap(owner, it->second.owner);
+    }
+    if (owner != q.id()) {
+        queue *prev = getStream(owner);
+        if (prev && !prev->is_worker()) { prev->sync(); }
+    }
+}
+
+void syncBufferStreams(const void *ptr) {
+    if (!ptr || !streamsInUse()) { return; }
+    BufferStreams streams{};
+    {
+        lock_guard<mutex> lock(bufferMutex);
+        auto it = bufferStreams.find(ptr);
+        if (it == bufferStreams.end()) { return; }
+        streams = it->second;
+    }
+    syncStream(streams.owner);
+    if (streams.user != streams.owner) { syncStream(streams.user); }
+}
+
 template<typename T>
 unique_ptr<T[], function<void(T *)>> memAlloc(const size_t &elements) {
     // TODO: make memAlloc aware of array shapes
     dim4 dims(elements);
     T *ptr = static_cast<T *>(
         memoryManager().alloc(false, 1, dims.get(), sizeof(T)));
+    claimBuffer(ptr);
     return unique_ptr<T[], function<void(T *)>>(ptr, memFree<T>);
 }
 
@@ -69,6 +151,7 @@ void *memAllocUser(const size_t &bytes) {
 
 template<typename T>
 void memFree(T *ptr) {
+    releaseBuffer(ptr);
     return memoryManager().unlock(static_cast<void *>(ptr), false);
 }
 
@@ -153,6 +236,11 @@ void Allocator::nativeFree(void *ptr) {
     // Make sure this pointer is not being used on the queue before freeing the
     // memory.
     getQueue().sync();
+    if (streamsInUse()) {
+        syncBufferStreams(ptr);
+        lock_guard<mutex> lock(bufferMutex);
+        bufferStreams.erase(ptr);
+    }
     free(ptr);  // NOLINT(hicpp-no-malloc)
 }
 }  // namespace cpu
@@ -15,6 +15,8 @@
 #include <memory>
 
 namespace cpu {
+class queue;
+
 template<typename T>
 using uptr = std::unique_ptr<T[], std::function<void(T[])>>;
 
@@ -52,6 +54,13 @@ bool jitTreeExceedsMemoryPressure(size_t bytes);
 void setMemStepSize(size_t step_bytes);
 size_t getMemStepSize(void);
 
+/// Makes \p q wait until the queue that last used the buffer \p ptr is done
+/// with it and records \p q as its new user.
+void waitForBufferStream(queue &q, const void *ptr);
+
+/// Blocks until every queue other than the active one is done with \p ptr
+void syncBufferStreams(const void *ptr);
+
 class Allocator final : public common::memory::AllocatorInterface {
    public:
     Allocator();
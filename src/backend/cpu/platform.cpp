@@ -8,21 +8,29 @@
  ********************************************************/
 
 #include <common/MemoryManagerBase.hpp>
+#include <common/err_common.hpp>
 #include <common/defines.hpp>
 #include <common/host_memory.hpp>
 #include <device_manager.hpp>
 #include <platform.hpp>
 #include <version.hpp>
+#include <af/cpu.h>
 #include <af/version.h>
 
+#include <atomic>
 #include <cctype>
 #include <cstdio>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 
 using common::memory::MemoryManagerBase;
 using std::endl;
+using std::lock_guard;
+using std::make_unique;
+using std::move;
+using std::mutex;
 using std::ostringstream;
 using std::stoi;
 using std::string;
@@ -140,12 +148,158 @@ int setDevice(int device) {
     return 0;
 }
 
+namespace {
+/// Set once a queue other than the default one exists
+std::atomic<bool> multipleStreams{false};
+
+/// The queue work from this thread goes to; nullptr means the default queue
+thread_local queue* activeStream = nullptr;
+
+bool perThreadQueues() {
+    static const bool enabled = getEnvVar("AF_CPU_PER_THREAD_QUEUE") == "1";
+    return enabled;
+}
+
+/// Streams used by a host thread. The thread counts as a user of the stream
+/// it selected, which keeps other threads from destroying it. When
+/// AF_CPU_PER_THREAD_QUEUE is set the thread gets a stream of its own,
+/// which is drained and destroyed when the thread exits.
+struct ThreadStream {
+    /// Stream selected on this thread; 0 for the default queue
+    int selected = 0;
+    /// Stream created for this thread under AF_CPU_PER_THREAD_QUEUE
+    int own = 0;
+    /// Whether the thread selected the default queue over its own stream
+    bool chooseDefault = false;
+
+    ~ThreadStream() {
+        try {
+            releaseStream(selected);
+            if (own != 0 && getStream(own)) { destroyStream(own); }
+        } catch (...) {}  // NOLINT(bugprone-empty-catch)
+    }
+};
+thread_local ThreadStream threadStream;
+
+/// Makes \p id the stream of the calling thread
+void selectStream(int id) {
+    queue* q = id == 0 ? nullptr : acquireStream(id);
+    if (id != 0 && !q) { AF_ERROR("Invalid stream", AF_ERR_ARG); }
+    releaseStream(threadStream.selected);
+    threadStream.selected = id;
+    activeStream          = q;
+}
+}  // namespace
+
+bool streamsInUse() noexcept { return multipleStreams; }
+
+queue* selectedStream() noexcept { return activeStream; }
+
+queue* exchangeSelectedStream(queue* q) noexcept {
+    queue* prev  = activeStream;
+    activeStream = q;
+    return prev;
+}
+
 queue& getQueue(int device) {
+    if (activeStream) { return *activeStream; }
+    if (perThreadQueues() && !threadStream.chooseDefault) {
+        // The thread's stream is created once, and again only if it was
+        // destroyed
+        if (threadStream.own == 0 || !getStream(threadStream.own)) {
+            threadStream.own = createStream();
+        }
+        selectStream(threadStream.own);
+        return *activeStream;
+    }
     return DeviceManager::getInstance().queues[device];
 }
 
 void sync(int device) { getQueue(device).sync(); }
 
+int getActiveStreamId() { return getQueue().id(); }
+
+int createStream() {
+    DeviceManager& inst = DeviceManager::getInstance();
+    lock_guard<mutex> lock(inst.streamMutex);
+    const int id = inst.nextStreamId++;
+    inst.streams.emplace(id, make_unique<queue>(id));
+    multipleStreams = true;
+    return id;
+}
+
+void setActiveStream(int id) {
+    selectStream(id);
+    threadStream.chooseDefault = id == 0;
+}
+
+void destroyStream(int id) {
+    if (id == 0) {
+        AF_ERROR("The default queue cannot be destroyed", AF_ERR_ARG);
+    }
+    DeviceManager& inst = DeviceManager::getInstance();
+    unique_ptr<queue> q;
+    {
+        lock_guard<mutex> lock(inst.streamMutex);
+        auto it = inst.streams.find(id);
+        if (it == inst.streams.end()) {
+            AF_ERROR("Invalid stream", AF_ERR_ARG);
+        }
+        const int self = threadStream.selected == id ? 1 : 0;
+        auto users     = inst.streamUsers.find(id);
+        if (users != inst.streamUsers.end() && users->second > self) {
+            AF_ERROR("The stream is active on another thread", AF_ERR_ARG);
+        }
+        if (users != inst.streamUsers.end()) { inst.streamUsers.erase(users); }
+        q = move(it->second);
+        inst.streams.erase(it);
+    }
+    q->sync();
+    if (threadStream.selected == id) {
+        threadStream.selected = 0;
+        activeStream          = nullptr;
+    }
+}
+
+queue* acquireStream(int id) {
+    DeviceManager& inst = DeviceManager::getInstance();
+    lock_guard<mutex> lock(inst.streamMutex);
+    auto it = inst.streams.find(id);
+    if (it == inst.streams.end()) { return nullptr; }
+    ++inst.streamUsers[id];
+    return it->second.get();
+}
+
+void releaseStream(int id) {
+    if (id == 0) { return; }
+    DeviceManager& inst = DeviceManager::getInstance();
+    lock_guard<mutex> lock(inst.streamMutex);
+    auto it = inst.streamUsers.find(id);
+    if (it != inst.streamUsers.end() && --it->second == 0) {
+        inst.streamUsers.erase(it);
+    }
+}
+
+queue* getStream(int id) {
+    DeviceManager& inst = DeviceManager::getInstance();
+    if (id == 0) { return &inst.queues[0]; }
+    lock_guard<mutex> lock(inst.streamMutex);
+    auto it = inst.streams.find(id);
+    return it == inst.streams.end() ? nullptr : it->second.get();
+}
+
+ThreadPool& threadPool() { return *(DeviceManager::getInstance().pool); }
+
+void setNumThreads(int num_threads) {
+    if (num_threads <= 0) {
+        AF_ERROR("The number of threads must be positive", AF_ERR_ARG);
+    }
+    DeviceManager::getInstance().setNumThreads(
+        static_cast<unsigned>(num_threads));
+}
+
+int getNumThreads() { return static_cast<int>(threadPool().size()); }
+
 bool& evalFlag() {
     thread_local bool flag = true;
     return flag;
@@ -177,3 +331,37 @@ graphics::ForgeManager& forgeManager() {
 }
 
 }  // namespace cpu
+
+af_err afcpu_create_stream(int* stream) {
+    try {
+        ARG_ASSERT(0, stream != nullptr);
+        *stream = cpu::createStream();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err afcpu_set_stream(int stream) {
+    try {
+        cpu::setActiveStream(stream);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err afcpu_get_stream(int* stream) {
+    try {
+        ARG_ASSERT(0, stream != nullptr);
+        *stream = cpu::getActiveStreamId();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err afcpu_destroy_stream(int stream) {
+    try {
+        cpu::destroyStream(stream);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <queue.hpp>
+#include <thread_pool.hpp>
 #include <string>
 
 namespace graphics {
@@ -50,10 +51,48 @@ size_t getHostMemorySize();
 
 int setDevice(int device);
 
+/// Returns the queue work from the calling thread is enqueued on. This is the
+/// stream selected with setActiveStream, otherwise the default queue of the
+/// device. When AF_CPU_PER_THREAD_QUEUE=1 each host thread gets a queue of
+/// its own instead of sharing the default one.
 queue& getQueue(int device = 0);
 
 void sync(int device);
 
+/// Identifier of the queue returned by getQueue on the calling thread
+int getActiveStreamId();
+
+/// Creates a new queue and returns its stream identifier
+int createStream();
+
+/// Makes \p id the queue used by the calling thread. 0 selects the default
+/// queue of the device, also when AF_CPU_PER_THREAD_QUEUE=1.
+void setActiveStream(int id);
+
+/// Waits for the work on stream \p id and destroys it. The calling thread
+/// falls back to the default queue if \p id was active on it. Fails if
+/// \p id is active on another thread.
+void destroyStream(int id);
+
+/// Returns the queue of stream \p id or nullptr if it does not exist
+queue* getStream(int id);
+
+/// Returns the queue of stream \p id, or nullptr if it does not exist, and
+/// counts the calling thread as one of its users until releaseStream
+queue* acquireStream(int id);
+
+/// Stops counting the calling thread as a user of stream \p id
+void releaseStream(int id);
+
+/// Pool the kernels parallelise on
+ThreadPool& threadPool();
+
+/// Sets the number of threads used by the kernels and by BLAS. Waits for all
+/// queued work first.
+void setNumThreads(int num_threads);
+
+int getNumThreads();
+
 bool& evalFlag();
 
 MemoryManagerBase& memoryManager();
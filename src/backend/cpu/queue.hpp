@@ -9,10 +9,20 @@
 #pragma once
 
 #include <Param.hpp>
+#include <common/Profiler.hpp>
+#include <common/defines.hpp>
+#include <common/traits.hpp>
 #include <common/util.hpp>
 #include <memory.hpp>
+#include <task_graph.hpp>
+#include <traits.hpp>
 
 #include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 // FIXME: Is there a better way to check for std::future not being supported ?
 #if defined(AF_DISABLE_CPU_ASYNC) || \
@@ -50,27 +60,149 @@ using event_impl = threads::event;
 
 namespace cpu {
 
+class queue;
+
+/// True once a queue other than the default one has been created. Until then
+/// every buffer is produced and consumed in order on the same queue and none
+/// of the cross queue bookkeeping is needed.
+bool streamsInUse() noexcept;
+
+/// The queue selected on the calling thread, nullptr if it uses the default
+/// queue or has not picked one yet
+queue *selectedStream() noexcept;
+
+/// Selects \p q on the calling thread and returns the previous selection
+queue *exchangeSelectedStream(queue *q) noexcept;
+
+/// Selects \p q on the calling thread for the lifetime of the scope. Queued
+/// tasks run in one for their own queue, so whatever a task allocates or
+/// looks up through getQueue belongs to that queue and not to whichever
+/// stream the worker thread would pick by default.
+class stream_scope {
+   public:
+    explicit stream_scope(queue *q) noexcept
+        : prev_(exchangeSelectedStream(q)) {}
+    ~stream_scope() { exchangeSelectedStream(prev_); }
+
+    stream_scope(const stream_scope &)            = delete;
+    stream_scope &operator=(const stream_scope &) = delete;
+
+   private:
+    queue *prev_;
+};
+
+/// Orders \p q after the queue that last used \p val. Only Array<T>
+/// arguments own a buffer; everything else is ignored.
+template<typename T>
+void orderAfterOwner(queue &q, const T &val) noexcept {
+    UNUSED(q);
+    UNUSED(val);
+}
+
+template<typename T>
+void orderAfterOwner(queue &q, const Array<T> &val) {
+    waitForBufferStream(q, val.getData().get());
+}
+
+/// Arguments of the profiler event of a queued task: the shape and type of
+/// its first output and the bytes of all the buffers it reads and writes
+struct task_profile {
+    std::string dims;
+    const char *dtype = nullptr;
+    size_t bytes      = 0;
+};
+
+template<typename T>
+void profileArg(task_profile &p, Param<T> param) {
+    if (!p.dtype) {
+        p.dims  = common::profiler::dimsToJson(param.dims());
+        p.dtype = getName(static_cast<af_dtype>(dtype_traits<T>::af_type));
+    }
+    p.bytes += param.dims().elements() * sizeof(T);
+}
+
+template<typename T>
+void profileArg(task_profile &p, const CParam<T> &param) {
+    p.bytes += param.dims().elements() * sizeof(T);
+}
+
+template<typename T>
+void profileArg(task_profile &p, const std::vector<Param<T>> &params) {
+    for (const auto &param : params) { profileArg(p, param); }
+}
+
+template<typename T>
+void profileArg(task_profile &p, const std::vector<CParam<T>> &params) {
+    for (const auto &param : params) { profileArg(p, param); }
+}
+
+template<typename T>
+void profileArg(task_profile &, const T &) {}
+
+template<typename... Args>
+std::string profileTask(const Args &...args) {
+    task_profile p;
+    int expand[] = {0, (profileArg(p, args), 0)...};
+    UNUSED(expand);
+    std::string out = "\"bytes\":" + std::to_string(p.bytes);
+    if (p.dtype) {
+        out += ",\"dims\":" + p.dims + ",\"dtype\":\"" + p.dtype + "\"";
+    }
+    return out;
+}
+
 /// Wraps the async_queue class
 class queue {
    public:
-    queue()
+    /// \param[in] id The stream identifier of this queue. The default queue
+    ///               of the device is stream 0.
+    explicit queue(int id = 0)
         : count(0)
+        , id_(id)
         , sync_calls(__SYNCHRONOUS_ARCH == 1 ||
-                     getEnvVar("AF_SYNCHRONOUS_CALLS") == "1") {}
+                     getEnvVar("AF_SYNCHRONOUS_CALLS") == "1") {
+        // Opt-in dependency tracking scheduler. Kernels only wait for the
+        // kernels whose buffers they share, so the periodic sync below is
+        // not needed to bound the amount of queued work. The kernels run on
+        // the thread pool, so a few workers per queue are enough to overlap
+        // the independent ones.
+        if (!sync_calls && getEnvVar("AF_CPU_TASK_GRAPH") == "1") {
+            graph.reset(new task_graph(maxGraphWorkers));
+        }
+    }
 
     template<typename F, typename... Args>
     void enqueue(const F func, Args &&...args) {
+        if (streamsInUse()) {
+            // Arrays may have been produced on a different queue
+            int order[] = {0, (orderAfterOwner(*this, args), 0)...};
+            UNUSED(order);
+        }
         count++;
+
+        // Tasks are recorded by the profiler under the name of the C API
+        // function that queued them. While it is off this costs one relaxed
+        // load per task.
+        const char *name = common::profiler::currentApi();
+        auto task        = [func, name, this](auto &&...params) {
+            stream_scope stream(this);
+            common::profiler::Scope profile("queue", name ? name : "task");
+            if (profile.active()) { profile.setArgs(profileTask(params...)); }
+            func(std::forward<decltype(params)>(params)...);
+        };
+
         if (sync_calls) {
-            func(toParam(std::forward<Args>(args))...);
+            task(toParam(std::forward<Args>(args))...);
+        } else if (graph) {
+            graph->enqueue(task, toParam(std::forward<Args>(args))...);
         } else {
-            aQueue.enqueue(func, toParam(std::forward<Args>(args))...);
+            aQueue.enqueue(task, toParam(std::forward<Args>(args))...);
         }
 #ifndef NDEBUG
         sync();
 #else
         if (getMemoryPressure() >= getMemoryPressureThreshold() ||
-            count >= 25) {
+            (!graph && count >= 25)) {
             sync();
         }
 #endif
@@ -78,19 +210,31 @@ class queue {
 
     void sync() {
         count = 0;
-        if (!sync_calls) aQueue.sync();
+        if (sync_calls) { return; }
+        if (graph) {
+            graph->sync();
+        } else {
+            aQueue.sync();
+        }
     }
 
     bool is_worker() const {
-        return (!sync_calls) ? aQueue.is_worker() : false;
+        if (sync_calls) { return false; }
+        return graph ? graph->is_worker() : aQueue.is_worker();
     }
 
+    int id() const noexcept { return id_; }
+
     friend class queue_event;
 
    private:
+    static constexpr unsigned maxGraphWorkers = 4;
+
     int count;
+    const int id_;
     const bool sync_calls;
     queue_impl aQueue;
+    std::unique_ptr<task_graph> graph;
 };
 
 class queue_event {
@@ -102,8 +246,16 @@ class queue_event {
 
     int create() { return event_.create(); }
 
-    int mark(queue &q) { return event_.mark(q.aQueue); }
-    int wait(queue &q) { return event_.wait(q.aQueue); }
+    // Events are tracked by the async_queue. With the task graph enabled the
+    // graph is drained before marking, and waits block the host.
+    int mark(queue &q) {
+        if (q.graph) { q.graph->sync(); }
+        return event_.mark(q.aQueue);
+    }
+    int wait(queue &q) {
+        if (q.graph) { return event_.sync(); }
+        return event_.wait(q.aQueue);
+    }
     int sync() noexcept { return event_.sync(); }
     operator bool() const noexcept { return event_; }
 };
@@ -45,6 +45,11 @@ template<af_op_t op, typename Ti, typename To>
 using reduce_dim_func = std::function<void(
     Param<To>, const dim_t, CParam<Ti>, const dim_t, const int, bool, double)>;
 
+template<af_op_t op, typename Ti, typename To>
+using reduce_node_func =
+    std::function<void(Param<To>, common::Node_ptr, const dim4, const int,
+                       bool, double)>;
+
 template<af_op_t op, typename Ti, typename To>
 Array<To> reduce(const Array<Ti> &in, const int dim, bool change_nan,
                  double nanval) {
@@ -52,6 +57,17 @@ Array<To> reduce(const Array<Ti> &in, const int dim, bool change_nan,
     odims[dim] = 1;
 
     Array<To> out = createEmptyArray<To>(odims);
+
+    // Evaluate a pending JIT tree inside the reduction instead of writing it
+    // to a temporary first
+    if (!in.isReady()) {
+        static const reduce_node_func<op, Ti, To> reduce_node =
+            kernel::reduce_dim_node<op, Ti, To>();
+        getQueue().enqueue(reduce_node, out, in.getNode(), in.dims(), dim,
+                           change_nan, nanval);
+        return out;
+    }
+
     static const reduce_dim_func<op, Ti, To> reduce_funcs[4] = {
         kernel::reduce_dim<op, Ti, To, 1>(),
         kernel::reduce_dim<op, Ti, To, 2>(),
@@ -112,13 +128,22 @@ using reduce_all_func =
     std::function<void(Param<To>, CParam<Ti>, bool, double)>;
 
 template<af_op_t op, typename Ti, typename To>
-Array<To> reduce_all(const Array<Ti> &in, bool change_nan, double nanval) {
-    in.eval();
+using reduce_all_node_func = std::function<void(Param<To>, common::Node_ptr,
+                                                const dim4, bool, double)>;
 
+template<af_op_t op, typename Ti, typename To>
+Array<To> reduce_all(const Array<Ti> &in, bool change_nan, double nanval) {
     Array<To> out = createEmptyArray<To>(1);
-    static const reduce_all_func<op, Ti, To> reduce_all_kernel =
-        kernel::reduce_all<op, Ti, To>();
-    getQueue().enqueue(reduce_all_kernel, out, in, change_nan, nanval);
+    if (in.isReady()) {
+        static const reduce_all_func<op, Ti, To> reduce_all_kernel =
+            kernel::reduce_all<op, Ti, To>();
+        getQueue().enqueue(reduce_all_kernel, out, in, change_nan, nanval);
+    } else {
+        static const reduce_all_node_func<op, Ti, To> reduce_all_node =
+            kernel::reduce_all_node<op, Ti, To>();
+        getQueue().enqueue(reduce_all_node, out, in.getNode(), in.dims(),
+                           change_nan, nanval);
+    }
     getQueue().sync();
     return out;
 }
@@ -6,13 +6,11 @@
  * The complete license agreement can be obtained at:
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
-#include <kernel/reorder.hpp>
 #include <reorder.hpp>
 
 #include <Array.hpp>
 #include <common/half.hpp>
-#include <platform.hpp>
-#include <queue.hpp>
+#include <jit/ViewNode.hpp>
 
 using common::half;
 
@@ -24,9 +22,8 @@ Array<T> reorder(const Array<T> &in, const af::dim4 &rdims) {
     af::dim4 oDims(0);
     for (int i = 0; i < 4; i++) { oDims[i] = iDims[rdims[i]]; }
 
-    Array<T> out = createEmptyArray<T>(oDims);
-    getQueue().enqueue(kernel::reorder<T>, out, in, oDims, rdims);
-    return out;
+    // Permute the view's dimensions rather than the data
+    return createNodeArray<T>(oDims, createViewNode(in)->reorder(rdims));
 }
 
 #define INSTANTIATE(T) \
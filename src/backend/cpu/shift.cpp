@@ -8,21 +8,20 @@
  ********************************************************/
 
 #include <Array.hpp>
-#include <kernel/shift.hpp>
-#include <platform.hpp>
-#include <queue.hpp>
+#include <jit/ViewNode.hpp>
 #include <shift.hpp>
 
 namespace cpu {
 
 template<typename T>
 Array<T> shift(const Array<T> &in, const int sdims[4]) {
-    Array<T> out = createEmptyArray<T>(in.dims());
-    const af::dim4 temp(sdims[0], sdims[1], sdims[2], sdims[3]);
-
-    getQueue().enqueue(kernel::shift<T>, out, in, temp);
-
-    return out;
+    // Rotate the view's starting point rather than the data
+    auto view = createViewNode(in)->shift(sdims, in.dims());
+    if (!view) {
+        in.eval();
+        view = createViewNode(in)->shift(sdims, in.dims());
+    }
+    return createNodeArray<T>(in.dims(), view);
 }
 
 #define INSTANTIATE(T) \
@@ -13,6 +13,7 @@
 
 #if defined(WITH_LINEAR_ALGEBRA)
 #include <copy.hpp>
+#include <kernel/batched_linalg.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
 #if USE_MKL
@@ -188,6 +189,14 @@ template<typename T>
 Array<T> triangleSolve(const Array<T> &A, const Array<T> &b,
                        const af_mat_prop options) {
     Array<T> B = copyArray<T>(b);
+
+    if (kernel::batched::useBatched(A.dims())) {
+        getQueue().enqueue(kernel::batched::trtrs<T>, B, A,
+                           bool(options & AF_MAT_UPPER),
+                           bool(options & AF_MAT_DIAG_UNIT));
+        return B;
+    }
+
     int N      = B.dims()[0];
     int NRHS   = B.dims()[1];
 
@@ -264,6 +273,12 @@ Array<T> solve(const Array<T> &a, const Array<T> &b,
         return triangleSolve<T>(a, b, options);
     }
 
+    if (kernel::batched::useBatched(a.dims())) {
+        Array<T> B = copyArray<T>(b);
+        getQueue().enqueue(kernel::batched::gesv<T>, B, a);
+        return B;
+    }
+
 #ifdef AF_USE_MKL_BATCH
     if (a.dims()[2] > 1 || a.dims()[3] > 1) {
         return generalSolveBatched(a, b, options);
@@ -13,11 +13,10 @@
 #include <platform.hpp>
 #include <queue.hpp>
 #include <af/features.h>
-#include <cmath>
 #include <memory>
+#include <vector>
 
 using af::features;
-using std::shared_ptr;
 
 namespace cpu {
 
@@ -26,39 +25,28 @@ unsigned susan(Array<float> &x_out, Array<float> &y_out, Array<float> &resp_out,
                const Array<T> &in, const unsigned radius, const float diff_thr,
                const float geom_thr, const float feature_ratio,
                const unsigned edge) {
-    dim4 idims                = in.dims();
     const unsigned corner_lim = in.elements() * feature_ratio;
 
-    auto x_corners     = createEmptyArray<float>(dim4(corner_lim));
-    auto y_corners     = createEmptyArray<float>(dim4(corner_lim));
-    auto resp_corners  = createEmptyArray<float>(dim4(corner_lim));
-    auto response      = createEmptyArray<T>(dim4(in.elements()));
-    auto corners_found = std::shared_ptr<unsigned>(
-        memAlloc<unsigned>(1).release(), memFree<unsigned>);
-    corners_found.get()[0] = 0;
-
-    getQueue().enqueue(kernel::susan_responses<T>, response, in, idims[0],
-                       idims[1], radius, diff_thr, geom_thr, edge);
-    getQueue().enqueue(kernel::non_maximal<T>, x_corners, y_corners,
-                       resp_corners, corners_found, idims[0], idims[1],
-                       response, edge, corner_lim);
+    auto corners = std::make_shared<std::vector<kernel::corner_point>>();
+    getQueue().enqueue(kernel::susanCorners<T>, corners, in,
+                       static_cast<int>(radius), diff_thr, geom_thr, edge,
+                       corner_lim);
     getQueue().sync();
 
-    const unsigned corners_out = min((corners_found.get())[0], corner_lim);
+    const unsigned corners_out = static_cast<unsigned>(corners->size());
     if (corners_out == 0) {
         x_out    = createEmptyArray<float>(dim4());
         y_out    = createEmptyArray<float>(dim4());
         resp_out = createEmptyArray<float>(dim4());
         return 0;
-    } else {
-        x_out    = x_corners;
-        y_out    = y_corners;
-        resp_out = resp_corners;
-        x_out.resetDims(dim4(corners_out));
-        y_out.resetDims(dim4(corners_out));
-        resp_out.resetDims(dim4(corners_out));
-        return corners_out;
     }
+
+    x_out    = createEmptyArray<float>(dim4(corners_out));
+    y_out    = createEmptyArray<float>(dim4(corners_out));
+    resp_out = createEmptyArray<float>(dim4(corners_out));
+    getQueue().enqueue(kernel::writeCorners, x_out, y_out, resp_out, corners,
+                       false);
+    return corners_out;
 }
 
 #define INSTANTIATE(T)                                                        \
@@ -0,0 +1,183 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <task_graph.hpp>
+
+#include <common/ArrayInfo.hpp>
+#include <common/half.hpp>
+#include <jit/BufferNode.hpp>
+#include <jit/Node.hpp>
+
+#include <algorithm>
+#include <unordered_set>
+
+using common::half;
+using common::Node;
+using common::Node_ptr;
+using std::condition_variable;
+using std::exception_ptr;
+using std::function;
+using std::lock_guard;
+using std::mutex;
+using std::unique_lock;
+using std::unique_ptr;
+using std::unordered_set;
+using std::vector;
+
+namespace cpu {
+
+namespace {
+thread_local const task_graph *current_graph = nullptr;
+
+template<typename T>
+void addBufferRead(task_accesses &acc, const Node &node) {
+    const jit::BufferNode<T> *buffer =
+        static_cast<const TNode<T> &>(node).getBuffer();
+    if (!buffer) { return; }
+    addAccess(acc, buffer->getPtr(), af::dim4(4, buffer->getDims()),
+              af::dim4(4, buffer->getStrides()), false);
+}
+
+void addNodeRead(task_accesses &acc, const Node &node) {
+    switch (node.getType()) {
+        case f32: addBufferRead<float>(acc, node); break;
+        case c32: addBufferRead<cfloat>(acc, node); break;
+        case f64: addBufferRead<double>(acc, node); break;
+        case c64: addBufferRead<cdouble>(acc, node); break;
+        case b8: addBufferRead<char>(acc, node); break;
+        case s32: addBufferRead<int>(acc, node); break;
+        case u32: addBufferRead<uint>(acc, node); break;
+        case u8: addBufferRead<uchar>(acc, node); break;
+        case s64: addBufferRead<intl>(acc, node); break;
+        case u64: addBufferRead<uintl>(acc, node); break;
+        case s16: addBufferRead<short>(acc, node); break;
+        case u16: addBufferRead<ushort>(acc, node); break;
+        case f16: addBufferRead<half>(acc, node); break;
+        default: acc.barrier = true;
+    }
+}
+
+bool conflicts(const task_accesses &a, const task_accesses &b) {
+    if (a.barrier || b.barrier) { return true; }
+    for (const task_access &x : a.ranges) {
+        for (const task_access &y : b.ranges) {
+            if ((x.write || y.write) && x.begin < y.end && y.begin < x.end) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+}  // namespace
+
+void collectAccess(task_accesses &acc, const vector<Node_ptr> &nodes) {
+    // Trees share subexpressions, so every node is visited once
+    unordered_set<const Node *> visited;
+    vector<const Node *> stack;
+    for (const Node_ptr &n : nodes) { stack.push_back(n.get()); }
+    while (!stack.empty()) {
+        const Node *n = stack.back();
+        stack.pop_back();
+        if (!n || !visited.insert(n).second) { continue; }
+        addNodeRead(acc, *n);
+        for (const Node_ptr &child : n->getChildren()) {
+            stack.push_back(child.get());
+        }
+    }
+}
+
+task_graph::task_graph(unsigned max_workers)
+    : max_workers_(std::max(1U, max_workers)) {}
+
+task_graph::~task_graph() {
+    try {
+        sync();
+    } catch (...) {}  // NOLINT(bugprone-empty-catch)
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = true;
+    }
+    ready_cv_.notify_all();
+    for (auto &w : workers_) { w.join(); }
+}
+
+void task_graph::submit(function<void()> fn, task_accesses acc) {
+    unique_ptr<node> n(new node());
+    n->fn  = std::move(fn);
+    n->acc = std::move(acc);
+
+    lock_guard<mutex> lock(mutex_);
+    for (auto &prev : in_flight_) {
+        if (conflicts(prev->acc, n->acc)) {
+            prev->dependents.push_back(n.get());
+            n->pending++;
+        }
+    }
+    node *raw = n.get();
+    raw->self = in_flight_.insert(in_flight_.end(), std::move(n));
+    if (raw->pending == 0) { makeReady(raw); }
+}
+
+void task_graph::makeReady(node *n) {
+    ready_.push_back(n);
+    if (ready_.size() > idle_ && workers_.size() < max_workers_) {
+        idle_++;
+        workers_.emplace_back([this] { work(); });
+    } else {
+        ready_cv_.notify_one();
+    }
+}
+
+void task_graph::work() {
+    current_graph = this;
+    unique_lock<mutex> lock(mutex_);
+    while (true) {
+        ready_cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+        if (ready_.empty()) { return; }
+
+        node *n = ready_.front();
+        ready_.pop_front();
+        idle_--;
+        lock.unlock();
+
+        exception_ptr err;
+        try {
+            n->fn();
+        } catch (...) { err = std::current_exception(); }
+        // Release whatever the task captured as soon as it has run
+        n->fn = nullptr;
+
+        lock.lock();
+        if (err && !error_) { error_ = err; }
+        idle_++;
+        finish(n);
+    }
+}
+
+void task_graph::finish(node *n) {
+    for (node *d : n->dependents) {
+        if (--d->pending == 0) { makeReady(d); }
+    }
+    in_flight_.erase(n->self);
+    if (in_flight_.empty()) { idle_cv_.notify_all(); }
+}
+
+void task_graph::sync() {
+    unique_lock<mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return in_flight_.empty(); });
+    if (error_) {
+        exception_ptr err = error_;
+        error_            = nullptr;
+        std::rethrow_exception(err);
+    }
+}
+
+bool task_graph::is_worker() const { return current_graph == this; }
+
+}  // namespace cpu
@@ -0,0 +1,184 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <Param.hpp>
+#include <common/defines.hpp>
+#include <af/dim4.hpp>
+#include <af/seq.h>
+
+#include <array>
+#include <complex>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace common {
+class half;
+class Node;
+}  // namespace common
+
+namespace cpu {
+
+/// A memory range read or written by a task
+struct task_access {
+    const char *begin;
+    const char *end;
+    bool write;
+};
+
+/// Describes the memory touched by a task. A task whose arguments cannot be
+/// described (e.g. raw pointers) is a barrier: it waits for everything
+/// before it and everything after it waits for it.
+struct task_accesses {
+    std::vector<task_access> ranges;
+    bool barrier = false;
+};
+
+template<typename T>
+void addAccess(task_accesses &acc, const T *ptr, const af::dim4 &dims,
+               const af::dim4 &strides, bool write) {
+    if (!ptr || dims.elements() == 0) { return; }
+    dim_t last = 0;
+    for (int i = 0; i < 4; i++) { last += (dims[i] - 1) * strides[i]; }
+    const char *begin = reinterpret_cast<const char *>(ptr);
+    acc.ranges.push_back({begin, begin + (last + 1) * sizeof(T), write});
+}
+
+template<typename T>
+void collectAccess(task_accesses &acc, Param<T> p) {
+    addAccess(acc, p.get(), p.dims(), p.strides(), true);
+}
+
+template<typename T>
+void collectAccess(task_accesses &acc, const CParam<T> &p) {
+    addAccess(acc, p.get(), p.dims(), p.strides(), false);
+}
+
+template<typename T>
+void collectAccess(task_accesses &acc, const std::vector<Param<T>> &ps) {
+    for (const auto &p : ps) { collectAccess(acc, p); }
+}
+
+template<typename T>
+void collectAccess(task_accesses &acc, const std::vector<CParam<T>> &ps) {
+    for (const auto &p : ps) { collectAccess(acc, p); }
+}
+
+/// Adds the buffers read by the JIT trees in \p nodes. The outputs of the
+/// trees are passed separately as Params.
+void collectAccess(task_accesses &acc,
+                   const std::vector<std::shared_ptr<common::Node>> &nodes);
+
+/// True for values copied into the task which cannot point to a buffer
+template<typename T>
+struct is_plain_value
+    : std::integral_constant<bool, std::is_arithmetic<T>::value ||
+                                       std::is_enum<T>::value> {};
+
+template<>
+struct is_plain_value<af::dim4> : std::true_type {};
+
+template<>
+struct is_plain_value<af_seq> : std::true_type {};
+
+template<>
+struct is_plain_value<common::half> : std::true_type {};
+
+template<>
+struct is_plain_value<std::string> : std::true_type {};
+
+template<typename T>
+struct is_plain_value<std::complex<T>> : is_plain_value<T> {};
+
+template<typename T>
+struct is_plain_value<std::vector<T>> : is_plain_value<T> {};
+
+template<typename T, size_t N>
+struct is_plain_value<std::array<T, N>> : is_plain_value<T> {};
+
+/// Plain values carry no memory; anything else (raw pointers, functions,
+/// containers of them) may alias buffers and turns the task into a barrier.
+template<typename T>
+void collectAccess(task_accesses &acc, const T &) {
+    if (!is_plain_value<T>::value) { acc.barrier = true; }
+}
+
+/// Dependency tracking scheduler used by cpu::queue when AF_CPU_TASK_GRAPH=1.
+///
+/// Every submitted task records the memory ranges it reads (CParam) and
+/// writes (Param). A task only waits for earlier tasks it conflicts with:
+/// read after write, write after read and write after write on overlapping
+/// ranges. Independent tasks run concurrently on the graph's workers, and
+/// the host only blocks in sync().
+///
+/// Workers are started when a task becomes ready and none is idle, up to
+/// \p max_workers. The kernels themselves run on the thread pool, so a few
+/// workers are enough to overlap independent kernels, and a queue that
+/// never has two ready tasks keeps a single thread.
+class task_graph {
+   public:
+    explicit task_graph(unsigned max_workers);
+    ~task_graph();
+
+    task_graph(const task_graph &)            = delete;
+    task_graph &operator=(const task_graph &) = delete;
+
+    template<typename F, typename... Args>
+    void enqueue(const F func, Args... args) {
+        task_accesses acc;
+        int expand[] = {0, (collectAccess(acc, args), 0)...};
+        UNUSED(expand);
+        submit([=]() { func(args...); }, std::move(acc));
+    }
+
+    /// Blocks until every submitted task has finished. Rethrows the first
+    /// exception raised by a task since the last sync.
+    void sync();
+
+    /// True when called from one of the graph's workers
+    bool is_worker() const;
+
+   private:
+    struct node {
+        std::function<void()> fn;
+        task_accesses acc;
+        std::vector<node *> dependents;
+        /// Position in in_flight_, so a finished task is removed in O(1)
+        std::list<std::unique_ptr<node>>::iterator self;
+        int pending = 0;
+    };
+
+    void submit(std::function<void()> fn, task_accesses acc);
+    void makeReady(node *n);
+    void work();
+    void finish(node *n);
+
+    std::mutex mutex_;
+    std::condition_variable ready_cv_;
+    std::condition_variable idle_cv_;
+    /// Tasks submitted and not finished yet, in submission order
+    std::list<std::unique_ptr<node>> in_flight_;
+    std::deque<node *> ready_;
+    std::exception_ptr error_;
+    std::vector<std::thread> workers_;
+    const unsigned max_workers_;
+    unsigned idle_ = 0;
+    bool stop_     = false;
+};
+
+}  // namespace cpu
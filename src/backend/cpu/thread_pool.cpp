@@ -0,0 +1,197 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <thread_pool.hpp>
+
+#include <common/defines.hpp>
+#include <queue.hpp>
+
+#if defined(OS_LNX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using std::function;
+using std::lock_guard;
+using std::mutex;
+using std::shared_lock;
+using std::shared_timed_mutex;
+using std::thread;
+using std::unique_lock;
+using std::unique_ptr;
+
+namespace cpu {
+
+namespace {
+/// Set while a thread executes a chunk; nested parallel_for calls run inline
+thread_local bool in_chunk = false;
+
+void pinToCpu(thread &t, unsigned cpu) {
+#if defined(OS_LNX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % std::max(1U, thread::hardware_concurrency()), &set);
+    pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+#else
+    UNUSED(t);
+    UNUSED(cpu);
+#endif
+}
+}  // namespace
+
+ThreadPool::ThreadPool(unsigned num_threads, bool pin) : pin_(pin) {
+    start(num_threads);
+}
+
+ThreadPool::~ThreadPool() { stop(); }
+
+unsigned ThreadPool::size() const noexcept { return size_; }
+
+void ThreadPool::resize(unsigned num_threads) {
+    unique_lock<shared_timed_mutex> lock(resize_mutex_);
+    if (std::max(1U, num_threads) == size()) { return; }
+    stop();
+    start(num_threads);
+}
+
+void ThreadPool::start(unsigned num_threads) {
+    const unsigned nworkers = std::max(1U, num_threads) - 1;
+    stop_                   = false;
+    queues_.clear();
+    for (unsigned i = 0; i < nworkers; i++) {
+        queues_.emplace_back(new worker_queue());
+    }
+    for (unsigned i = 0; i < nworkers; i++) {
+        workers_.emplace_back([this, i] { work(i); });
+        if (pin_) { pinToCpu(workers_.back(), i + 1); }
+    }
+    size_ = nworkers + 1;
+}
+
+void ThreadPool::stop() {
+    {
+        lock_guard<mutex> lock(sleep_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &w : workers_) { w.join(); }
+    workers_.clear();
+}
+
+bool ThreadPool::pop(unsigned id, task &t) {
+    worker_queue &q = *queues_[id];
+    lock_guard<mutex> lock(q.mutex);
+    if (q.tasks.empty()) { return false; }
+    t = q.tasks.back();
+    q.tasks.pop_back();
+    queued_--;
+    return true;
+}
+
+bool ThreadPool::steal(unsigned id, task &t) {
+    const unsigned n = static_cast<unsigned>(queues_.size());
+    for (unsigned i = 1; i <= n; i++) {
+        worker_queue &q = *queues_[(id + i) % n];
+        lock_guard<mutex> lock(q.mutex);
+        if (q.tasks.empty()) { continue; }
+        t = q.tasks.front();
+        q.tasks.pop_front();
+        queued_--;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::execute(const task &t) {
+    job &j = *t.owner;
+    in_chunk = true;
+    try {
+        stream_scope stream(j.stream);
+        (*j.fn)(t.begin, t.end);
+    } catch (...) {
+        lock_guard<mutex> lock(j.mutex);
+        if (!j.error) { j.error = std::current_exception(); }
+    }
+    in_chunk = false;
+    // The caller may return as soon as remaining hits zero, so the job must
+    // not be touched once the lock is released
+    lock_guard<mutex> lock(j.mutex);
+    if (--j.remaining == 0) { j.done.notify_all(); }
+}
+
+void ThreadPool::work(unsigned id) {
+    task t{};
+    while (true) {
+        if (pop(id, t) || steal(id, t)) {
+            execute(t);
+            continue;
+        }
+        unique_lock<mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this] { return stop_ || queued_ > 0; });
+        if (stop_ && queued_ == 0) { return; }
+    }
+}
+
+void ThreadPool::run(dim_t begin, dim_t end, dim_t grain,
+                     const function<void(dim_t, dim_t)> &fn) {
+    if (end <= begin) { return; }
+    const dim_t nchunks = (end - begin + grain - 1) / grain;
+
+    auto inline_run = [&] {
+        for (dim_t b = begin; b < end; b += grain) {
+            fn(b, std::min(end, b + grain));
+        }
+    };
+    // Nested calls run inline without the lock: the outer call holds it and
+    // a pending resize would block them
+    if (nchunks == 1 || in_chunk) {
+        inline_run();
+        return;
+    }
+
+    shared_lock<shared_timed_mutex> resize_lock(resize_mutex_);
+    if (workers_.empty()) {
+        inline_run();
+        return;
+    }
+
+    job j;
+    j.fn        = &fn;
+    j.stream    = selectedStream();
+    j.remaining = nchunks;
+
+    // Deal contiguous runs of chunks to the workers so neighbouring chunks
+    // start on the same thread; idle threads steal from the other end.
+    const dim_t nqueues = static_cast<dim_t>(queues_.size());
+    for (dim_t w = 0; w < nqueues; w++) {
+        const dim_t cb  = nchunks * w / nqueues;
+        const dim_t ce  = nchunks * (w + 1) / nqueues;
+        worker_queue &q = *queues_[w];
+        lock_guard<mutex> lock(q.mutex);
+        for (dim_t c = ce; c-- > cb;) {
+            const dim_t b = begin + c * grain;
+            q.tasks.push_back({&j, b, std::min(end, b + grain)});
+        }
+        queued_ += ce - cb;
+    }
+    {
+        lock_guard<mutex> lock(sleep_mutex_);
+    }
+    wake_.notify_all();
+
+    // The caller helps until nothing is left to steal
+    task t{};
+    while (j.remaining > 0 && steal(0, t)) { execute(t); }
+
+    unique_lock<mutex> lock(j.mutex);
+    j.done.wait(lock, [&j] { return j.remaining == 0; });
+    if (j.error) { std::rethrow_exception(j.error); }
+}
+
+}  // namespace cpu
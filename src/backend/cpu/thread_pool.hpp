@@ -0,0 +1,158 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <af/defines.h>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cpu {
+
+class queue;
+
+/// Work-stealing pool used by the CPU kernels to parallelise internally.
+///
+/// A parallel_for splits its range into chunks of \p grain iterations and
+/// deals contiguous runs of chunks onto the workers' deques. Each worker
+/// drains its own deque from the back and steals from the front of the
+/// others once it runs dry; the calling thread steals as well, so a pool of
+/// size N runs on N - 1 workers plus the caller. Calls made from inside a
+/// chunk run inline, which keeps nested kernels from deadlocking the pool.
+/// Chunks run with the caller's queue selected, so memory they allocate is
+/// attributed to the queue that launched the work.
+///
+/// The pool is owned by DeviceManager and retrieved with threadPool().
+class ThreadPool {
+   public:
+    /// \param[in] num_threads Threads taking part in a parallel_for,
+    ///                        including the caller
+    /// \param[in] pin         Pin each worker to one logical CPU
+    explicit ThreadPool(unsigned num_threads, bool pin = false);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &)            = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// Number of threads taking part in a parallel_for, including the caller
+    unsigned size() const noexcept;
+
+    /// Replaces the workers. Waits for the parallel_for calls in flight to
+    /// finish first; calls made meanwhile wait for the new workers. Must
+    /// not be called from inside a chunk.
+    void resize(unsigned num_threads);
+
+    /// Calls \p fn(b, e) on disjoint sub ranges covering [begin, end), each
+    /// at most \p grain long.
+    template<typename F>
+    void parallel_for(dim_t begin, dim_t end, dim_t grain, F &&fn) {
+        grain = std::max<dim_t>(grain, 1);
+        std::function<void(dim_t, dim_t)> chunk(std::forward<F>(fn));
+        run(begin, end, grain, chunk);
+    }
+
+    /// Calls \p fn(j, k, l) for every column of \p range, i.e. every index
+    /// of dimensions 1 to 3; dimension 0 is left to the callee. \p grain is
+    /// the number of columns per chunk.
+    template<typename F>
+    void parallel_for(const af::dim4 &range, dim_t grain, F &&fn) {
+        const dim_t d1    = range[1], d2 = range[2];
+        const dim_t ncols = d1 * d2 * range[3];
+        parallel_for(0, ncols, grain, [&](dim_t b, dim_t e) {
+            for (dim_t c = b; c < e; ++c) {
+                fn(c % d1, (c / d1) % d2, c / (d1 * d2));
+            }
+        });
+    }
+
+    /// Reduces [begin, end) with \p map(b, e) over chunks of \p grain and
+    /// folds the partial results with \p reduce. The partials are combined
+    /// in chunk order, so the result depends on \p grain but not on the
+    /// number of threads.
+    template<typename T, typename Map, typename Reduce>
+    T parallel_reduce(dim_t begin, dim_t end, dim_t grain, T init, Map &&map,
+                      Reduce &&reduce) {
+        grain = std::max<dim_t>(grain, 1);
+        if (end <= begin) { return init; }
+        const dim_t nchunks = (end - begin + grain - 1) / grain;
+        std::vector<T> partial(nchunks, init);
+        parallel_for(begin, end, grain, [&](dim_t b, dim_t e) {
+            partial[(b - begin) / grain] = map(b, e);
+        });
+        T result = init;
+        for (const T &p : partial) { result = reduce(result, p); }
+        return result;
+    }
+
+   private:
+    struct job {
+        const std::function<void(dim_t, dim_t)> *fn;
+        queue *stream;
+        std::atomic<dim_t> remaining;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    struct task {
+        job *owner;
+        dim_t begin;
+        dim_t end;
+    };
+
+    struct worker_queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    void run(dim_t begin, dim_t end, dim_t grain,
+             const std::function<void(dim_t, dim_t)> &fn);
+    void start(unsigned num_threads);
+    void stop();
+    void work(unsigned id);
+    bool pop(unsigned id, task &t);
+    bool steal(unsigned id, task &t);
+    void execute(const task &t);
+
+    /// Held shared by every parallel_for dealing chunks to the workers and
+    /// exclusively by resize while it replaces them
+    std::shared_timed_mutex resize_mutex_;
+    std::vector<std::unique_ptr<worker_queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<unsigned> size_{1};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<dim_t> queued_{0};
+    bool stop_ = false;
+    const bool pin_;
+};
+
+/// Returns the shared CPU thread pool
+ThreadPool &threadPool();
+
+/// Number of items of \p item_cost elements each that make a chunk worth
+/// handing to another thread
+constexpr dim_t grainSize(dim_t item_cost) {
+    return item_cost >= (dim_t(1) << 14)
+               ? 1
+               : (dim_t(1) << 14) / (item_cost > 0 ? item_cost : 1);
+}
+
+}  // namespace cpu
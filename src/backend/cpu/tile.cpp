@@ -7,12 +7,11 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
-#include <kernel/tile.hpp>
 #include <tile.hpp>
 
 #include <Array.hpp>
 #include <common/half.hpp>
-#include <platform.hpp>
+#include <jit/ViewNode.hpp>
 
 using common::half;
 
@@ -28,11 +27,14 @@ Array<T> tile(const Array<T> &in, const af::dim4 &tileDims) {
         throw std::runtime_error("Elements are 0");
     }
 
-    Array<T> out = createEmptyArray<T>(oDims);
-
-    getQueue().enqueue(kernel::tile<T>, out, in);
-
-    return out;
+    // The tiles are read through a JIT view, which wraps around the input, so
+    // they are only written to memory if the output is evaluated on its own
+    auto view = createViewNode(in);
+    if (!view->isPeriodic(iDims)) {
+        in.eval();
+        view = createViewNode(in);
+    }
+    return createNodeArray<T>(oDims, view);
 }
 
 #define INSTANTIATE(T) \
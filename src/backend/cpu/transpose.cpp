@@ -10,7 +10,10 @@
 #include <transpose.hpp>
 
 #include <Array.hpp>
+#include <common/complex.hpp>
 #include <common/half.hpp>
+#include <complex.hpp>
+#include <jit/ViewNode.hpp>
 #include <platform.hpp>
 #include <af/dim4.hpp>
 
@@ -22,16 +25,26 @@ using common::half;
 
 namespace cpu {
 
+template<typename T>
+static common::if_complex<T, Array<T>> conjugated(const Array<T> &in) {
+    return conj(in);
+}
+
+template<typename T>
+static common::if_real<T, Array<T>> conjugated(const Array<T> &in) {
+    return in;
+}
+
 template<typename T>
 Array<T> transpose(const Array<T> &in, const bool conjugate) {
     const dim4 &inDims = in.dims();
     const dim4 outDims = dim4(inDims[1], inDims[0], inDims[2], inDims[3]);
-    // create an array with first two dimensions swapped
-    Array<T> out = createEmptyArray<T>(outDims);
-
-    getQueue().enqueue(kernel::transpose<T>, out, in, conjugate);
 
-    return out;
+    // A view with the first two dimensions swapped; the data is only moved
+    // when the result is evaluated
+    Array<T> out = createNodeArray<T>(
+        outDims, createViewNode(in)->reorder(dim4(1, 0, 2, 3)));
+    return conjugate ? conjugated(out) : out;
 }
 
 template<typename T>
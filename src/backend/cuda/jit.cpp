@@ -9,10 +9,12 @@
 
 #include <Array.hpp>
 #include <Kernel.hpp>
+#include <common/Profiler.hpp>
 #include <common/half.hpp>
 #include <common/jit/ModdimNode.hpp>
 #include <common/jit/Node.hpp>
 #include <common/jit/NodeIterator.hpp>
+#include <common/jit/Optimizer.hpp>
 #include <common/kernel_cache.hpp>
 #include <common/util.hpp>
 #include <copy.hpp>
@@ -301,8 +303,9 @@ static CUfunction getKernel(const vector<Node*>& output_nodes,
                             const bool is_linear, const bool loop0,
                             const bool loop1, const bool loop2,
                             const bool loop3) {
-    const string funcName{getFuncName(output_nodes, full_nodes, full_ids,
-                                      is_linear, loop0, loop1, loop2, loop3)};
+    const string funcName{getFuncName(output_nodes, output_ids, full_nodes,
+                                      full_ids, is_linear, loop0, loop1, loop2,
+                                      loop3)};
     // A forward lookup in module cache helps avoid recompiling
     // the JIT source generated from identical JIT-trees.
     const auto entry{
@@ -350,6 +353,8 @@ void evalNodes(vector<Param<T>>& outputs, const vector<Node*>& output_nodes) {
     }
     if (numOutElems == 0) { return; }
 
+    common::profiler::Scope profile("jit", "evalNodes");
+
     // Use thread local to reuse the memory every time you are
     // here.
     thread_local Node_map_t nodes;
@@ -374,6 +379,14 @@ void evalNodes(vector<Param<T>>& outputs, const vector<Node*>& output_nodes) {
         const int id = node->getNodesMap(nodes, full_nodes, full_ids);
         output_ids.push_back(id);
     }
+    if (profile.active()) {
+        profile.setArgs(common::profiler::jitEvalArgs(
+            full_nodes.size(), nrOutputs, af::dim4(AF_MAX_DIMS, outDims)));
+    }
+
+    // Owns the nodes created by the optimizer until the kernel is launched
+    vector<Node_ptr> optimized_nodes;
+    common::optimizeNodes(full_nodes, full_ids, output_ids, optimized_nodes);
 
     size_t inputSize{0};
     unsigned nrInputs{0};
@@ -8,10 +8,12 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <common/Profiler.hpp>
 #include <common/compile_module.hpp>
 #include <common/jit/ModdimNode.hpp>
 #include <common/jit/Node.hpp>
 #include <common/jit/NodeIterator.hpp>
+#include <common/jit/Optimizer.hpp>
 #include <common/kernel_cache.hpp>
 #include <common/util.hpp>
 #include <copy.hpp>
@@ -253,8 +255,9 @@ cl::Kernel getKernel(const vector<Node*>& output_nodes,
                      const vector<Node*>& full_nodes,
                      const vector<Node_ids>& full_ids, const bool is_linear,
                      const bool loop0, const bool loop1, const bool loop3) {
-    const string funcName{getFuncName(output_nodes, full_nodes, full_ids,
-                                      is_linear, loop0, loop1, false, loop3)};
+    const string funcName{getFuncName(output_nodes, output_ids, full_nodes,
+                                      full_ids, is_linear, loop0, loop1, false,
+                                      loop3)};
     // A forward lookup in module cache helps avoid recompiling the JIT
     // source generated from identical JIT-trees.
     const auto entry{
@@ -312,6 +315,8 @@ void evalNodes(vector<Param>& outputs, const vector<Node*>& output_nodes) {
     }
     if (numOutElems == 0) { return; }
 
+    common::profiler::Scope profile("jit", "evalNodes");
+
     // Use thread local to reuse the memory every time you are here.
     thread_local Node_map_t nodes;
     thread_local vector<Node*> full_nodes;
@@ -334,6 +339,14 @@ void evalNodes(vector<Param>& outputs, const vector<Node*>& output_nodes) {
         const int id{node->getNodesMap(nodes, full_nodes, full_ids)};
         output_ids.push_back(id);
     }
+    if (profile.active()) {
+        profile.setArgs(common::profiler::jitEvalArgs(
+            full_nodes.size(), nrOutputs, af::dim4(AF_MAX_DIMS, outDims)));
+    }
+
+    // Owns the nodes created by the optimizer until the kernel is launched
+    vector<Node_ptr> optimized_nodes;
+    common::optimizeNodes(full_nodes, full_ids, output_ids, optimized_nodes);
 
     const size_t outputSize{numOutElems * outputSizeofType * nrOutputs};
     size_t inputSize{0};
@@ -10,6 +10,7 @@
 #include <select.hpp>
 
 #include <Array.hpp>
+#include <common/Profiler.hpp>
 #include <common/half.hpp>
 #include <common/jit/NaryNode.hpp>
 #include <err_opencl.hpp>
@@ -42,7 +43,9 @@ Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
         NaryNode(static_cast<af::dtype>(dtype_traits<T>::af_type), "__select",
                  3, {{cond_node, a_node, b_node}}, af_select_t, height));
     std::array<common::Node *, 1> nodes{node.get()};
-    if (detail::passesJitHeuristics<T>(nodes) != kJITHeuristics::Pass) {
+    const kJITHeuristics heuristic = detail::passesJitHeuristics<T>(nodes);
+    if (heuristic != kJITHeuristics::Pass) {
+        common::profiler::EvalReason reason(getHeuristicName(heuristic));
         if (a_height > max(b_height, cond_height)) {
             a.eval();
         } else if (b_height > cond_height) {
@@ -73,7 +76,9 @@ Array<T> createSelectNode(const Array<char> &cond, const Array<T> &a,
         (flip ? af_not_select_t : af_select_t), height));
 
     std::array<common::Node *, 1> nodes{node.get()};
-    if (detail::passesJitHeuristics<T>(nodes) != kJITHeuristics::Pass) {
+    const kJITHeuristics heuristic = detail::passesJitHeuristics<T>(nodes);
+    if (heuristic != kJITHeuristics::Pass) {
+        common::profiler::EvalReason reason(getHeuristicName(heuristic));
         if (a_height > max(b_height, cond_height)) {
             a.eval();
         } else if (b_height > cond_height) {
@@ -23,6 +23,7 @@ using af::max;
 using af::min;
 using af::randu;
 using std::abs;
+using std::exp;
 using std::string;
 using std::vector;
 
@@ -187,3 +188,72 @@ TEST(AnisotropicDiffusion, CurvatureInvalidInputArray) {
         array out = anisotropicDiffusion(randu(100), 0.125f, 0.2f, 10);
     } catch (exception &exp) { ASSERT_EQ(AF_ERR_SIZE, exp.err()); }
 }
+
+// A noisy step: both equations smooth the flat halves and keep the edge
+TEST(AnisotropicDiffusion, SmoothsNoiseKeepsEdge) {
+    const int n = 64;
+    array step  = af::constant(0.2f, n, n);
+    step(af::span, af::seq(n / 2, n - 1)) = 0.8f;
+    array noisy = step + 0.05f * (randu(n, n) - 0.5f);
+
+    af::seq rows(4, n - 5);
+    af::seq lo(4, n / 2 - 5), hi(n / 2 + 4, n - 5);
+    for (af::diffusionEq eq : {AF_DIFFUSION_GRAD, AF_DIFFUSION_MCDE}) {
+        array out = anisotropicDiffusion(noisy, 0.125f, 1.0f, 20,
+                                         AF_FLUX_EXPONENTIAL, eq);
+
+        float before = af::stdev<float>(noisy(rows, lo));
+        float after  = af::stdev<float>(out(rows, lo));
+        EXPECT_LT(3 * after, before) << "eq: " << eq;
+
+        before = af::stdev<float>(noisy(rows, hi));
+        after  = af::stdev<float>(out(rows, hi));
+        EXPECT_LT(3 * after, before) << "eq: " << eq;
+
+        float height =
+            af::mean<float>(out(rows, hi)) - af::mean<float>(out(rows, lo));
+        EXPECT_NEAR(0.6f, height, 0.01f) << "eq: " << eq;
+    }
+}
+
+// One step of the gradient equation computed on the host: every pixel is
+// updated from the values of its neighbours before the step
+TEST(AnisotropicDiffusion, GradientStepIsExplicit) {
+    const int d0   = 24, d1 = 16;
+    const float dt = 0.125f, K = 1.0f;
+    array in       = randu(d0, d1);
+
+    array g0, g1;
+    af::grad(g0, g1, in);
+    const float avg = af::sum<float>(g0 * g0 + g1 * g1);
+    const float mct = 1.0f / (-2.0f * K * K / (d0 * d1) * avg);
+
+    vector<float> img(d0 * d1);
+    in.host(img.data());
+    vector<float> gold(img);
+    auto P    = [&](int i, int j) { return img[j * d0 + i]; };
+    auto flux = [&](float diff, float across) {
+        return exp((diff * diff + 0.25f * across * across) * mct) * diff;
+    };
+    for (int j = 1; j < d1 - 1; ++j) {
+        for (int i = 1; i < d0 - 1; ++i) {
+            const float C  = P(i, j);
+            const float dx = 0.5f * (P(i + 1, j) - P(i - 1, j));
+            const float dy = 0.5f * (P(i, j + 1) - P(i, j - 1));
+            const float delta =
+                flux(P(i + 1, j) - C,
+                     dy + 0.5f * (P(i + 1, j + 1) - P(i + 1, j - 1))) -
+                flux(C - P(i - 1, j),
+                     dy + 0.5f * (P(i - 1, j + 1) - P(i - 1, j - 1))) +
+                flux(P(i, j + 1) - C,
+                     dx + 0.5f * (P(i + 1, j + 1) - P(i - 1, j + 1))) -
+                flux(C - P(i, j - 1),
+                     dx + 0.5f * (P(i + 1, j - 1) - P(i - 1, j - 1)));
+            gold[j * d0 + i] = C + delta * dt;
+        }
+    }
+
+    array out = anisotropicDiffusion(in, dt, K, 1, AF_FLUX_EXPONENTIAL,
+                                     AF_DIFFUSION_GRAD);
+    ASSERT_VEC_ARRAY_NEAR(gold, af::dim4(d0, d1), out, 1e-4);
+}
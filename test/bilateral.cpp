@@ -16,8 +16,17 @@
 #include <string>
 #include <vector>
 
+using af::array;
+using af::bilateral;
+using af::constant;
 using af::dim4;
 using af::dtype_traits;
+using af::getActiveBackend;
+using af::iota;
+using af::max;
+using af::mean;
+using af::seq;
+using af::span;
 using std::abs;
 using std::string;
 using std::vector;
@@ -147,9 +156,6 @@ TYPED_TEST(BilateralOnData, InvalidArgs) {
 
 // C++ unit tests
 
-using af::array;
-using af::bilateral;
-
 TEST(Bilateral, CPP) {
     vector<dim4> numDims;
     vector<vector<float> > in;
@@ -174,12 +180,6 @@ TEST(Bilateral, CPP) {
     }
 }
 
-using af::constant;
-using af::iota;
-using af::max;
-using af::seq;
-using af::span;
-
 TEST(bilateral, GFOR) {
     dim4 dims = dim4(10, 10, 3);
     array A   = iota(dims);
@@ -193,3 +193,53 @@ TEST(bilateral, GFOR) {
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+/// 128x96 image of two smooth gradients separated by a vertical edge
+static array gradientsWithEdge() {
+    array x = iota(dim4(128, 1), dim4(1, 96));
+    array y = iota(dim4(1, 96), dim4(128, 1));
+    return (y < 48).as(f32) * 160.f + 40.f * af::sin(x / 20.f) + 0.5f * y;
+}
+
+TEST(BilateralMode, DefaultModeIsExact) {
+    array a = gradientsWithEdge();
+    ASSERT_ARRAYS_EQ(bilateral(a, 4.f, 20.f, false),
+                     bilateral(a, 4.f, 20.f, false, AF_BILATERAL_DEFAULT));
+    ASSERT_ARRAYS_EQ(bilateral(a, 4.f, 20.f, false),
+                     bilateral(a, 4.f, 20.f, false, AF_BILATERAL_EXACT));
+}
+
+TEST(BilateralMode, GridCloseToExact) {
+    array a = gradientsWithEdge();
+    if (getActiveBackend() != AF_BACKEND_CPU) {
+        af_array out = 0;
+        ASSERT_EQ(AF_ERR_NOT_SUPPORTED,
+                  af_bilateral_v2(&out, a.get(), 4.f, 20.f, false,
+                                  AF_BILATERAL_GRID));
+        return;
+    }
+
+    array exact  = bilateral(a, 4.f, 20.f, false, AF_BILATERAL_EXACT);
+    array approx = bilateral(a, 4.f, 20.f, false, AF_BILATERAL_GRID);
+    array diff   = exact - approx;
+
+    ASSERT_EQ(a.dims(), approx.dims());
+    ASSERT_LT(std::sqrt(mean<float>(diff * diff)), 1.5f);
+}
+
+TEST(BilateralMode, GridKeepsEdges) {
+    if (getActiveBackend() != AF_BACKEND_CPU) { return; }
+
+    // Far wider than the spatial window the exact mode supports
+    array a   = (iota(dim4(1, 96), dim4(128, 1)) < 48).as(f32) * 200.f;
+    array out = bilateral(a, 40.f, 10.f, false, AF_BILATERAL_GRID);
+
+    ASSERT_LT(max<float>(abs(out - a)), 1.f);
+}
+
+TEST(BilateralMode, InvalidMode) {
+    array a      = gradientsWithEdge();
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_bilateral_v2(&out, a.get(), 4.f, 20.f, false,
+                                          (af_bilateral_mode)7));
+}
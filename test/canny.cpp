@@ -262,3 +262,37 @@ TEST(CannyEdgeDetector, BatchofImagesUsingCPPAPI) {
     cannyImageOtsuBatchTest<float>(
         string(TEST_DIR "/CannyEdgeDetector/gray.test"), 3);
 }
+
+TEST(CannyEdgeDetector, DiskOutline) {
+    using af::array;
+
+    array x    = af::range(dim4(64, 48), 0) - 31.5f;
+    array y    = af::range(dim4(64, 48), 1) - 23.5f;
+    array r    = af::sqrt(x * x + y * y);
+    array disk = (r < 14).as(f32) * 200.f;
+
+    // The edges are a closed curve along the rim of the disk
+    array edges = af::canny(disk, AF_CANNY_THRESHOLD_MANUAL, 0.1f, 0.3f);
+    ASSERT_EQ(0, af::count<int>(edges && r < 10));
+    ASSERT_EQ(0, af::count<int>(edges && r > 18));
+    ASSERT_LT(70, af::count<int>(edges));
+}
+
+TEST(CannyEdgeDetector, BatchMatchesImage) {
+    using af::array;
+    using af::span;
+
+    af::setSeed(7);
+    array img = af::randu(48, 40) * 40.f;
+    img(af::seq(10, 30), af::seq(12, 36)) += 150.f;
+
+    const af::cannyThreshold modes[] = {AF_CANNY_THRESHOLD_MANUAL,
+                                        AF_CANNY_THRESHOLD_AUTO_OTSU};
+    for (af::cannyThreshold ct : modes) {
+        array single  = af::canny(img, ct, 0.3f, 0.7f);
+        array batched = af::canny(af::tile(img, 1, 1, 3), ct, 0.3f, 0.7f);
+        for (int b = 0; b < 3; ++b) {
+            ASSERT_ARRAYS_EQ(single, batched(span, span, b));
+        }
+    }
+}
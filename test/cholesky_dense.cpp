@@ -25,7 +25,12 @@ using af::dtype;
 using af::dtype_traits;
 using af::identity;
 using af::matmul;
+using af::anyTrue;
+using af::constant;
+using af::isNaN;
 using af::max;
+using af::span;
+using af::tile;
 using std::abs;
 using std::endl;
 using std::string;
@@ -74,6 +79,63 @@ void choleskyTester(const int n, double eps, bool is_upper) {
                 eps);
 }
 
+/// Factorizes a batch of positive definite matrices along dims 2 and 3,
+/// which the CPU backend accepts
+template<typename T>
+void choleskyBatchTester(const dim4 dims, double eps, bool is_upper) {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    dtype ty      = (dtype)dtype_traits<T>::af_type;
+    const dim_t n = dims[0];
+
+    array a  = cpu_randu<T>(dims);
+    array b  = 10 * n * identity(n, n, ty);
+    array in = constant(0, dims, ty);
+    for (int w = 0; w < (int)dims[3]; ++w) {
+        for (int z = 0; z < (int)dims[2]; ++z) {
+            array az             = a(span, span, z, w);
+            in(span, span, z, w) = matmul(az.H(), az) + b;
+        }
+    }
+
+    array out;
+    ASSERT_EQ(0, cholesky(out, in, is_upper));
+    ASSERT_EQ(dims, out.dims());
+
+    for (int w = 0; w < (int)dims[3]; ++w) {
+        for (int z = 0; z < (int)dims[2]; ++z) {
+            array f  = out(span, span, z, w);
+            array re = is_upper ? matmul(f.H(), f) : matmul(f, f.H());
+            array iz = in(span, span, z, w);
+            ASSERT_NEAR(
+                0, max<typename dtype_traits<T>::base_type>(abs(real(iz - re))),
+                eps);
+            ASSERT_NEAR(
+                0, max<typename dtype_traits<T>::base_type>(abs(imag(iz - re))),
+                eps);
+        }
+    }
+}
+
+/// A batch whose third matrix has a negative pivot in column 4 reports that
+/// column, as LAPACK does, and leaves no NaN in the factors
+template<typename T>
+void choleskyBatchFailTester(const int n, bool is_upper) {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    dtype ty    = (dtype)dtype_traits<T>::af_type;
+    array in    = tile(identity(n, n, ty), 1, 1, 5);
+    in(3, 3, 2) = -1;
+
+    array out;
+    ASSERT_EQ(4, cholesky(out, in, is_upper));
+    ASSERT_FALSE(anyTrue<bool>(isNaN(abs(out))));
+}
+
 template<typename T>
 class Cholesky : public ::testing::Test {};
 
@@ -103,6 +165,14 @@ double eps<cdouble>() {
     return 1e-8;
 }
 
+TYPED_TEST(Cholesky, UpperSmall) {
+    choleskyTester<TypeParam>(6, eps<TypeParam>(), true);
+}
+
+TYPED_TEST(Cholesky, LowerSmall) {
+    choleskyTester<TypeParam>(6, eps<TypeParam>(), false);
+}
+
 TYPED_TEST(Cholesky, Upper) {
     choleskyTester<TypeParam>(500, eps<TypeParam>(), true);
 }
@@ -134,3 +204,22 @@ TYPED_TEST(Cholesky, LowerMultipleOfTwo) {
 TYPED_TEST(Cholesky, LowerMultipleOfTwoLarge) {
     choleskyTester<TypeParam>(1024, eps<TypeParam>(), false);
 }
+
+TYPED_TEST(Cholesky, UpperSmallBatch3D) {
+    choleskyBatchTester<TypeParam>(dim4(6, 6, 9), eps<TypeParam>(), true);
+}
+
+TYPED_TEST(Cholesky, LowerBatch4D) {
+    choleskyBatchTester<TypeParam>(dim4(100, 100, 2, 2), eps<TypeParam>(),
+                                   false);
+}
+
+TYPED_TEST(Cholesky, SmallBatchNotPositiveDefinite) {
+    choleskyBatchFailTester<TypeParam>(6, true);
+    choleskyBatchFailTester<TypeParam>(6, false);
+}
+
+TYPED_TEST(Cholesky, BatchNotPositiveDefinite) {
+    choleskyBatchFailTester<TypeParam>(80, true);
+    choleskyBatchFailTester<TypeParam>(80, false);
+}
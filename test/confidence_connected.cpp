@@ -198,3 +198,38 @@ INSTANTIATE_TEST_CASE_P(
            << info.param.iterations << "_replace_" << info.param.replace;
         return ss.str();
     });
+
+/// Fills the rectangle [x0, x1) x [y0, y1) of the column major \p image
+static void fillRect(vector<uchar> &image, const dim4 &dims, int x0, int x1,
+                     int y0, int y1, uchar value) {
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) { image[y * dims[0] + x] = value; }
+    }
+}
+
+TEST(ConfidenceConnected, DiagonalNeighboursAndSeparateRegions) {
+    const dim4 dims(300, 200);
+    vector<uchar> in(dims.elements(), 10);
+    fillRect(in, dims, 20, 60, 20, 50, 200);
+    // Meets the first rectangle at its bottom right corner only
+    fillRect(in, dims, 60, 80, 50, 70, 200);
+    fillRect(in, dims, 100, 150, 30, 90, 200);
+
+    af::array image(dims, in.data());
+
+    vector<uchar> gold(dims.elements(), 0);
+    fillRect(gold, dims, 20, 60, 20, 50, 255);
+    fillRect(gold, dims, 60, 80, 50, 70, 255);
+
+    const unsigned seed[] = {30, 30, 120, 60};
+    af::array one = af::confidenceCC(image, af::array(1, seed),
+                                     af::array(1, seed + 1), 1, 2, 3, 255);
+    ASSERT_VEC_ARRAY_EQ(gold, dims, one);
+
+    fillRect(gold, dims, 100, 150, 30, 90, 255);
+    const unsigned seedx[] = {30, 120};
+    const unsigned seedy[] = {30, 60};
+    af::array both = af::confidenceCC(image, af::array(2, seedx),
+                                      af::array(2, seedy), 1, 2, 3, 255);
+    ASSERT_VEC_ARRAY_EQ(gold, dims, both);
+}
@@ -1177,3 +1177,21 @@ TEST(ConvolveNN, ZeroPadding_Issue2817) {
     ASSERT_EQ(sum<float>(abs(signal(seq(1, 3), seq(1, 3)) - convolved)) < 1E-5,
               true);
 }
+
+TEST(ConvolveNN, MultiChannelMatchesConvolve2) {
+    // More output positions than fit one tile of unwrapped windows
+    array signal = af::randu(96, 80, 3, 2);
+    array filter = af::randu(3, 3, 3, 4);
+    dim4 strides(1, 1), padding(1, 1), dilation(1, 1);
+
+    array convolved = convolve2NN(signal, filter, strides, padding, dilation);
+    ASSERT_EQ(dim4(96, 80, 4, 2), convolved.dims());
+    for (int n = 0; n < 2; ++n) {
+        for (int f = 0; f < 4; ++f) {
+            array gold = sum(convolve2(signal(span, span, span, n),
+                                       filter(span, span, span, f)),
+                             2);
+            ASSERT_ARRAYS_NEAR(gold, convolved(span, span, f, n), 1E-4);
+        }
+    }
+}
@@ -0,0 +1,241 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <gtest/gtest.h>
+#include <testHelpers.hpp>
+#include <af/cpu.h>
+
+#include <cstdlib>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using af::array;
+using af::constant;
+using af::event;
+using af::fft;
+using af::randu;
+using af::sort;
+using af::sum;
+using std::promise;
+using std::string;
+using std::thread;
+using std::vector;
+
+namespace {
+bool perThreadQueues() {
+    const char *env = std::getenv("AF_CPU_PER_THREAD_QUEUE");
+    return env && string(env) == "1";
+}
+}  // namespace
+
+TEST(CPUStream, CreateSetDestroy) {
+    int stream = -1;
+    ASSERT_SUCCESS(afcpu_get_stream(&stream));
+    ASSERT_EQ(0, stream);
+
+    int created = 0;
+    ASSERT_SUCCESS(afcpu_create_stream(&created));
+    ASSERT_NE(0, created);
+    ASSERT_SUCCESS(afcpu_set_stream(created));
+    ASSERT_SUCCESS(afcpu_get_stream(&stream));
+    ASSERT_EQ(created, stream);
+
+    ASSERT_SUCCESS(afcpu_destroy_stream(created));
+    ASSERT_SUCCESS(afcpu_get_stream(&stream));
+    ASSERT_EQ(0, stream);
+}
+
+TEST(CPUStream, InvalidStream) {
+    ASSERT_EQ(AF_ERR_ARG, afcpu_set_stream(12345));
+    ASSERT_EQ(AF_ERR_ARG, afcpu_destroy_stream(0));
+}
+
+TEST(CPUStream, ArrayAcrossStreams) {
+    int s1 = afcpu::createStream();
+    int s2 = afcpu::createStream();
+
+    afcpu::setStream(s1);
+    array a = randu(1000, 100);
+    array b = a * 2;
+    b.eval();
+
+    afcpu::setStream(s2);
+    array c = b - a;
+    vector<float> ha(a.elements()), hc(c.elements());
+    a.host(ha.data());
+    c.host(hc.data());
+
+    afcpu::setStream(0);
+    afcpu::destroyStream(s1);
+    afcpu::destroyStream(s2);
+
+    ASSERT_VEC_ARRAY_EQ(ha, a.dims(), c);
+}
+
+TEST(CPUStream, ThreadsWithOwnStreams) {
+    const int nthreads = 4;
+    vector<float> results(nthreads, 0.f);
+    vector<thread> threads;
+    for (int t = 0; t < nthreads; t++) {
+        threads.emplace_back([t, &results] {
+            int stream = afcpu::createStream();
+            afcpu::setStream(stream);
+            array x = constant(t + 1, 100, 100);
+            for (int i = 0; i < 50; i++) { x = x + 1; }
+            results[t] = sum<float>(x);
+            afcpu::setStream(0);
+            afcpu::destroyStream(stream);
+        });
+    }
+    for (auto &th : threads) { th.join(); }
+
+    for (int t = 0; t < nthreads; t++) {
+        ASSERT_FLOAT_EQ((t + 51) * 10000.f, results[t]);
+    }
+}
+
+// sort and fft allocate their temporaries while they run on the queue of the
+// stream, so they must not wait on that queue or pick a different one
+TEST(CPUStream, AllocatingKernelsOnCreatedStream) {
+    array in = randu(4096, 64);
+    in.eval();
+    array sorted = sort(in);
+    array freq   = fft(in);
+    sorted.eval();
+    freq.eval();
+
+    int stream = afcpu::createStream();
+    afcpu::setStream(stream);
+    array sortedOnStream = sort(in);
+    array freqOnStream   = fft(in);
+    sortedOnStream.eval();
+    freqOnStream.eval();
+    af::sync();
+    afcpu::setStream(0);
+    afcpu::destroyStream(stream);
+
+    ASSERT_ARRAYS_EQ(sorted, sortedOnStream);
+    ASSERT_ARRAYS_EQ(freq, freqOnStream);
+}
+
+// Run under AF_CPU_PER_THREAD_QUEUE=1 as well, where every thread gets its
+// own stream without selecting one
+TEST(CPUStream, AllocatingKernelsOnThreads) {
+    array in = randu(4096, 64);
+    in.eval();
+    array sorted = sort(in);
+    array freq   = fft(in);
+    sorted.eval();
+    freq.eval();
+
+    const int nthreads = 4;
+    vector<array> sortedOnThread(nthreads), freqOnThread(nthreads);
+    vector<thread> threads;
+    for (int t = 0; t < nthreads; t++) {
+        threads.emplace_back([t, &in, &sortedOnThread, &freqOnThread] {
+            sortedOnThread[t] = sort(in);
+            freqOnThread[t]   = fft(in);
+            sortedOnThread[t].eval();
+            freqOnThread[t].eval();
+            af::sync();
+        });
+    }
+    for (auto &th : threads) { th.join(); }
+
+    for (int t = 0; t < nthreads; t++) {
+        ASSERT_ARRAYS_EQ(sorted, sortedOnThread[t]);
+        ASSERT_ARRAYS_EQ(freq, freqOnThread[t]);
+    }
+}
+
+TEST(CPUStream, DestroyStreamActiveElsewhere) {
+    int stream = afcpu::createStream();
+
+    promise<void> selected, release;
+    thread user([&] {
+        afcpu::setStream(stream);
+        selected.set_value();
+        release.get_future().wait();
+        afcpu::setStream(0);
+    });
+    selected.get_future().wait();
+    ASSERT_EQ(AF_ERR_ARG, afcpu_destroy_stream(stream));
+    release.set_value();
+    user.join();
+    ASSERT_SUCCESS(afcpu_destroy_stream(stream));
+
+    // A thread that exits stops using the stream it selected
+    stream = afcpu::createStream();
+    thread([stream] { afcpu::setStream(stream); }).join();
+    ASSERT_SUCCESS(afcpu_destroy_stream(stream));
+}
+
+TEST(CPUStream, EventsAcrossStreams) {
+    int s1 = afcpu::createStream();
+    int s2 = afcpu::createStream();
+
+    afcpu::setStream(s1);
+    array a = randu(1000, 100);
+    array b = a;
+    for (int i = 0; i < 20; i++) { b = b * 2 - a; }
+    b.eval();
+    event produced;
+    produced.mark();
+
+    afcpu::setStream(s2);
+    produced.enqueue();
+    array c = b + 1;
+    c.eval();
+    event consumed;
+    consumed.mark();
+
+    afcpu::setStream(s1);
+    consumed.enqueue();
+    array d = c - 1;
+    d.eval();
+    event done;
+    done.mark();
+    done.block();
+
+    vector<float> ha(a.elements()), hd(d.elements());
+    a.host(ha.data());
+    d.host(hd.data());
+
+    afcpu::setStream(0);
+    afcpu::destroyStream(s1);
+    afcpu::destroyStream(s2);
+
+    ASSERT_VEC_ARRAY_NEAR(ha, a.dims(), d, 1e-5);
+}
+
+// Run under AF_CPU_PER_THREAD_QUEUE=1: selecting stream 0 uses the default
+// queue, and the thread keeps its stream for when it selects it again
+TEST(CPUStream, PerThreadDefaultStream) {
+    if (!perThreadQueues()) { return; }
+
+    thread([] {
+        array x = constant(1, 10);
+        x.eval();
+        int own = afcpu::getStream();
+        ASSERT_NE(0, own);
+
+        afcpu::setStream(0);
+        ASSERT_EQ(0, afcpu::getStream());
+        array y = x + 1;
+        y.eval();
+        ASSERT_EQ(0, afcpu::getStream());
+
+        afcpu::setStream(own);
+        ASSERT_EQ(own, afcpu::getStream());
+        ASSERT_FLOAT_EQ(20.f, sum<float>(y));
+    }).join();
+}
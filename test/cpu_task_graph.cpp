@@ -0,0 +1,126 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <gtest/gtest.h>
+#include <testHelpers.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using af::array;
+using af::randu;
+using af::startTrace;
+using af::stopTrace;
+using std::string;
+using std::vector;
+
+namespace {
+bool taskGraphEnabled() {
+    const char *env = std::getenv("AF_CPU_TASK_GRAPH");
+    return env && string(env) == "1";
+}
+
+struct span {
+    int tid;
+    double begin, end;
+};
+
+/// The queued tasks recorded in \p filename
+vector<span> queueSpans(const char *filename) {
+    std::ifstream file(filename);
+    vector<span> spans;
+    string line;
+    while (std::getline(file, line)) {
+        if (line.find("\"cat\":\"queue\"") == string::npos) { continue; }
+        size_t tid = line.find("\"tid\":");
+        size_t ts  = line.find("\"ts\":");
+        size_t dur = line.find("\"dur\":");
+        if (tid == string::npos || ts == string::npos || dur == string::npos) {
+            continue;
+        }
+        span s;
+        s.tid   = std::atoi(line.c_str() + tid + 6);
+        s.begin = std::atof(line.c_str() + ts + 5);
+        s.end   = s.begin + std::atof(line.c_str() + dur + 6);
+        spans.push_back(s);
+    }
+    return spans;
+}
+}  // namespace
+
+// Run with AF_CPU_TASK_GRAPH=1. The two chains share no buffers, so the
+// kernels of one do not wait for the other and run on different workers at
+// the same time.
+TEST(CPUTaskGraph, IndependentChainsOverlap) {
+    if (!taskGraphEnabled()) { return; }
+
+    const char *filename = "cpu_task_graph_overlap.json";
+    std::remove(filename);
+
+    array a = randu(2048, 2048);
+    array b = randu(2048, 2048);
+    a.eval();
+    b.eval();
+    af::sync();
+    vector<float> ha(a.elements()), hb(b.elements());
+    a.host(ha.data());
+    b.host(hb.data());
+
+    startTrace(filename);
+    for (int i = 0; i < 4; i++) {
+        a = a * 0.5f + 1.0f;
+        b = b * 0.25f - 1.0f;
+        a.eval();
+        b.eval();
+    }
+    af::sync();
+    stopTrace();
+
+    vector<span> spans = queueSpans(filename);
+    std::remove(filename);
+
+    bool overlap = false;
+    for (size_t i = 0; i < spans.size() && !overlap; i++) {
+        for (size_t j = i + 1; j < spans.size(); j++) {
+            if (spans[i].tid != spans[j].tid &&
+                spans[i].begin < spans[j].end &&
+                spans[j].begin < spans[i].end) {
+                overlap = true;
+                break;
+            }
+        }
+    }
+    EXPECT_TRUE(overlap);
+
+    for (size_t i = 0; i < ha.size(); i++) {
+        for (int it = 0; it < 4; it++) {
+            ha[i] = ha[i] * 0.5f + 1.0f;
+            hb[i] = hb[i] * 0.25f - 1.0f;
+        }
+    }
+    ASSERT_VEC_ARRAY_NEAR(ha, a.dims(), a, 1e-5);
+    ASSERT_VEC_ARRAY_NEAR(hb, b.dims(), b, 1e-5);
+}
+
+// A chain reading the result of the other has to wait for it
+TEST(CPUTaskGraph, DependentChainsInOrder) {
+    array a = randu(512, 512);
+    array b = a * 2.0f;
+    b.eval();
+    array c = b + a;
+    c.eval();
+    array d = c - b;
+    ASSERT_ARRAYS_NEAR(a, d, 1e-5);
+}
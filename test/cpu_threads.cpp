@@ -0,0 +1,87 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <gtest/gtest.h>
+#include <testHelpers.hpp>
+
+#include <thread>
+
+using af::array;
+using af::getNumThreads;
+using af::randu;
+using af::resize;
+using af::rotate;
+using af::setNumThreads;
+using af::sort;
+using std::thread;
+
+TEST(CPUThreads, SetGet) {
+    int original = 0;
+    ASSERT_SUCCESS(af_get_num_threads(&original));
+    ASSERT_GT(original, 0);
+
+    ASSERT_SUCCESS(af_set_num_threads(3));
+    int current = 0;
+    ASSERT_SUCCESS(af_get_num_threads(&current));
+    ASSERT_EQ(3, current);
+
+    ASSERT_SUCCESS(af_set_num_threads(original));
+    ASSERT_EQ(original, getNumThreads());
+}
+
+TEST(CPUThreads, InvalidCount) {
+    ASSERT_EQ(AF_ERR_ARG, af_set_num_threads(0));
+    ASSERT_EQ(AF_ERR_ARG, af_set_num_threads(-2));
+    ASSERT_EQ(AF_ERR_ARG, af_get_num_threads(NULL));
+}
+
+TEST(CPUThreads, ResultsIndependentOfThreadCount) {
+    const int original = getNumThreads();
+    array in           = randu(301, 257, 3);
+
+    setNumThreads(1);
+    array resized1 = resize(in, 517, 413, AF_INTERP_BILINEAR);
+    array rotated1 = rotate(in, 0.7f, false, AF_INTERP_BICUBIC);
+    resized1.eval();
+    rotated1.eval();
+
+    setNumThreads(4);
+    array resized4 = resize(in, 517, 413, AF_INTERP_BILINEAR);
+    array rotated4 = rotate(in, 0.7f, false, AF_INTERP_BICUBIC);
+
+    ASSERT_ARRAYS_EQ(resized1, resized4);
+    ASSERT_ARRAYS_EQ(rotated1, rotated4);
+
+    setNumThreads(original);
+}
+
+// Resizing waits for the kernels of other host threads that are running on
+// the pool
+TEST(CPUThreads, ResizeWhileBusy) {
+    const int original = getNumThreads();
+    array in           = randu(20000);
+    array expected     = sort(in);
+    expected.eval();
+    af::sync();
+
+    bool matches = true;
+    thread worker([&] {
+        for (int i = 0; i < 20; i++) {
+            array out = sort(in);
+            af::sync();
+            matches &= af::allTrue<bool>(out == expected);
+        }
+    });
+    for (int i = 0; i < 20; i++) { setNumThreads(1 + i % 4); }
+    worker.join();
+
+    setNumThreads(original);
+    ASSERT_TRUE(matches);
+}
@@ -236,3 +236,90 @@ TEST(FloatFAST, CPP) {
     delete[] outOrientation;
     delete[] outSize;
 }
+
+// Plain segment test on a 16 pixel circle, returns the corners sorted by
+// (x, y) with their scores
+static vector<feat_t> fastReference(const vector<float> &img, int d0, int d1,
+                                    float thr, int arc, int edge) {
+    const int cy[16] = {-3, -3, -2, -1, 0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3};
+    const int cx[16] = {0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3, -3, -3, -2, -1};
+
+    vector<feat_t> feat;
+    for (int x = edge; x < d1 - edge; x++) {
+        for (int y = edge; y < d0 - edge; y++) {
+            float p = img[x * d0 + y];
+            int sign[16];
+            float s_bright = 0.f, s_dark = 0.f;
+            for (int i = 0; i < 16; i++) {
+                float v = img[(x + cx[i]) * d0 + y + cy[i]];
+                sign[i] = (v > p + thr) - (v < p - thr);
+                if (sign[i] > 0) s_bright += fabs(v - p) - thr;
+                if (sign[i] < 0) s_dark += fabs(p - v) - thr;
+            }
+            bool corner = false;
+            for (int s = 0; s < 16 && !corner; s++) {
+                int bright = 0, dark = 0;
+                for (int k = 0; k < arc; k++) {
+                    bright += sign[(s + k) % 16] > 0;
+                    dark += sign[(s + k) % 16] < 0;
+                }
+                corner = bright == arc || dark == arc;
+            }
+            if (corner) {
+                feat_t f = {{(float)x, (float)y,
+                             std::max(s_bright, s_dark), 0.f, 1.f}};
+                feat.push_back(f);
+            }
+        }
+    }
+    return feat;
+}
+
+TEST(FAST, ArcLengthsMatchReference) {
+    // Noise with bright rectangles, whose corners have arcs of up to 12
+    // pixels, and single dark pixels, which are surrounded by 16
+    const int d0 = 67, d1 = 53;
+    vector<float> h_img(d0 * d1);
+    unsigned seed = 1;
+    for (size_t i = 0; i < h_img.size(); i++) {
+        seed     = seed * 1664525u + 1013904223u;
+        h_img[i] = static_cast<float>(100 + (seed >> 24) % 20);
+    }
+    for (int r = 0; r < 12; r++) {
+        int y0 = (r * 37) % (d0 - 10), x0 = (r * 23) % (d1 - 10);
+        for (int x = x0; x < x0 + 8 + r % 3; x++) {
+            for (int y = y0; y < y0 + 6 + r % 4; y++) h_img[x * d0 + y] = 200.f;
+        }
+    }
+    for (int p = 0; p < 10; p++) {
+        h_img[(5 + p * 4) * d0 + 7 + (p * 13) % (d0 - 14)] = 0.f;
+    }
+    af::array img(d0, d1, &h_img.front());
+
+    for (int arc = 9; arc <= 16; arc++) {
+        af::features out = af::fast(img, 20.f, arc, false, 1.f, 3);
+
+        vector<feat_t> gold = fastReference(h_img, d0, d1, 20.f, arc, 3);
+        ASSERT_EQ(gold.size(), out.getNumFeatures()) << "arc: " << arc;
+        if (gold.empty()) { continue; }
+
+        vector<float> x(gold.size()), y(gold.size()), score(gold.size());
+        out.getX().host(&x.front());
+        out.getY().host(&y.front());
+        out.getScore().host(&score.front());
+
+        vector<feat_t> feat(gold.size());
+        for (size_t i = 0; i < feat.size(); i++) {
+            feat_t f = {{x[i], y[i], score[i], 0.f, 1.f}};
+            feat[i]  = f;
+        }
+        std::sort(feat.begin(), feat.end(), feat_cmp);
+        std::sort(gold.begin(), gold.end(), feat_cmp);
+
+        for (size_t i = 0; i < gold.size(); i++) {
+            ASSERT_EQ(gold[i].f[0], feat[i].f[0]) << "arc: " << arc;
+            ASSERT_EQ(gold[i].f[1], feat[i].f[1]) << "arc: " << arc;
+            ASSERT_NEAR(gold[i].f[2], feat[i].f[2], 1e-3) << "arc: " << arc;
+        }
+    }
+}
@@ -9,6 +9,8 @@
 
 #include <arrayfire.h>
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
@@ -17,6 +19,7 @@
 
 using af::array;
 using af::constant;
+using af::dim4;
 using af::half;
 using std::vector;
 
@@ -138,3 +141,62 @@ TEST(Half, isZero) {
 
     ASSERT_ARRAYS_EQ(gold, res);
 }
+
+TEST(Half, ConvertAllValues) {
+    SUPPORTED_TYPE_CHECK(af_half);
+    // An odd length also exercises the remainder of the vectorised loops
+    const int num = 65535;
+    vector<half_float::half> input(num);
+    for (int i = 0; i < num; i++) {
+        unsigned short bits = static_cast<unsigned short>(i);
+        memcpy(&input[i], &bits, sizeof(bits));
+    }
+
+    array in(num, &input.front());
+    array as_float = in.as(f32);
+    vector<float> out(num);
+    as_float.host(&out.front());
+
+    vector<half_float::half> back(num);
+    as_float.as(f16).host(&back.front());
+
+    for (int i = 0; i < num; i++) {
+        float gold = static_cast<float>(input[i]);
+        if (std::isnan(gold)) {
+            ASSERT_TRUE(std::isnan(out[i])) << "at index: " << i;
+            ASSERT_TRUE(half_float::isnan(back[i])) << "at index: " << i;
+            continue;
+        }
+        ASSERT_EQ(gold, out[i]) << "at index: " << i;
+        unsigned short bits;
+        memcpy(&bits, &back[i], sizeof(bits));
+        ASSERT_EQ(i, bits) << "at index: " << i;
+    }
+}
+
+TEST(Half, RoundTiesToEven) {
+    SUPPORTED_TYPE_CHECK(af_half);
+    // Values half way between two f16 numbers round to the even one
+    vector<float> ties = {1.f + std::ldexp(1.f, -11),
+                          1.f + 3.f * std::ldexp(1.f, -11),
+                          std::ldexp(1.f, -25), 3.f * std::ldexp(1.f, -25)};
+    vector<float> rounded = {1.f, 1.f + std::ldexp(1.f, -9), 0.f,
+                             std::ldexp(1.f, -23)};
+
+    array in(ties.size(), &ties.front());
+    ASSERT_VEC_ARRAY_EQ(rounded, dim4(ties.size()), in.as(f16).as(f32));
+}
+
+// Constants are converted to f16 on the host, on every backend
+TEST(Half, ConstantRoundsTiesToEven) {
+    SUPPORTED_TYPE_CHECK(af_half);
+    const double ties[]   = {1.0 + std::ldexp(1.0, -11),
+                             1.0 + 3.0 * std::ldexp(1.0, -11),
+                             std::ldexp(1.0, -25), 3.0 * std::ldexp(1.0, -25)};
+    const float rounded[] = {1.f, 1.f + std::ldexp(1.f, -9), 0.f,
+                             std::ldexp(1.f, -23)};
+    for (int i = 0; i < 4; i++) {
+        array c = constant(ties[i], 1, f16);
+        ASSERT_EQ(rounded[i], c.as(f32).scalar<float>()) << "at index: " << i;
+    }
+}
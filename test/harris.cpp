@@ -13,7 +13,9 @@
 #include <af/compatible.h>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
 #include <cmath>
+#include <functional>
 #include <string>
 #include <typeinfo>
 #include <vector>
@@ -218,3 +220,23 @@ TEST(FloatHarris, CPP) {
             << "at: " << elIter << endl;
     }
 }
+
+TEST(FloatHarris, MaxCornersKeepsStrongest) {
+    af::setSeed(3);
+    array in = af::round(af::randu(96, 80) * 4.f) * 64.f;
+
+    features all       = harris(in, 0, 1.0f, 1.0f, 0, 0.04f);
+    features strongest = harris(in, 20, 1.0f, 1.0f, 0, 0.04f);
+    ASSERT_LT(20u, all.getNumFeatures());
+    ASSERT_EQ(20u, strongest.getNumFeatures());
+
+    vector<float> allScores(all.getNumFeatures());
+    vector<float> topScores(strongest.getNumFeatures());
+    all.getScore().host(allScores.data());
+    strongest.getScore().host(topScores.data());
+
+    std::sort(allScores.begin(), allScores.end(), std::greater<float>());
+    for (size_t i = 0; i < topScores.size(); ++i) {
+        ASSERT_EQ(allScores[i], topScores[i]) << "at: " << i;
+    }
+}
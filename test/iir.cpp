@@ -158,3 +158,33 @@ TYPED_TEST(filter, iirVecMat) {
 TYPED_TEST(filter, iirMatMat) {
     iirTest<TypeParam>(TEST_DIR "/iir/iir_mm.test");
 }
+
+TYPED_TEST(filter, iirSosMatchesDirectForm) {
+    SUPPORTED_TYPE_CHECK(TypeParam);
+    try {
+        dtype ty = (dtype)dtype_traits<TypeParam>::af_type;
+
+        // Two stable sections: [b0 b1 b2 a0 a1 a2] per column
+        float hsos[] = {0.2f, 0.3f, 0.1f, 1.0f, -0.5f, 0.2f,
+                        0.5f, 0.1f, 0.4f, 1.0f, 0.3f,  0.1f};
+        array sos    = array(6, 2, hsos).as(ty);
+        array x      = randu(1000, 12, ty);
+
+        array b = convolve1(sos(af::seq(0, 2), 0), sos(af::seq(0, 2), 1),
+                            AF_CONV_EXPAND);
+        array a = convolve1(sos(af::seq(3, 5), 0), sos(af::seq(3, 5), 1),
+                            AF_CONV_EXPAND);
+
+        array y    = af::iirSos(sos, x);
+        array gold = iir(b, a, x);
+
+        vector<TypeParam> hy(y.elements()), hgold(gold.elements());
+        ASSERT_EQ(hgold.size(), hy.size());
+        y.host(&hy[0]);
+        gold.host(&hgold[0]);
+
+        for (size_t i = 0; i < hy.size(); i++) {
+            ASSERT_NEAR(real(hy[i]), real(hgold[i]), 0.01) << "at: " << i;
+        }
+    } catch (exception &ex) { FAIL() << ex.what(); }
+}
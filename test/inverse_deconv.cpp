@@ -135,3 +135,16 @@ TYPED_TEST(InverseDeconvolution, DISABLED_WienerOnGrayscale) {
         AF_INVERSE_DECONV_DEFAULT);
     // TODO(pradeep) change to wiener enum value
 }
+
+// With a PSF that does not blur, Tikhonov deconvolution divides the input
+// by 1 + gamma
+TEST(InverseDeconvolution, IdentityKernelKeepsScale) {
+    array x   = range(dim4(48, 40), 0);
+    array y   = range(dim4(48, 40), 1);
+    array in  = 0.5f + 0.25f * sin(x / 5) * cos(y / 7);
+    array ker = constant(0, 3, 3);
+    ker(1, 1) = 1;
+
+    array out = inverseDeconv(in, ker, 0.1f, AF_INVERSE_DECONV_TIKHONOV);
+    ASSERT_ARRAYS_NEAR(in / 1.1f, out, 1e-4);
+}
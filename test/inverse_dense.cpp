@@ -29,6 +29,7 @@ using af::dtype_traits;
 using af::identity;
 using af::matmul;
 using af::max;
+using af::span;
 using std::abs;
 
 template<typename T>
@@ -54,6 +55,32 @@ void inverseTester(const int m, const int n, double eps) {
                 eps);
 }
 
+/// Inverts every matrix of a batch along dims 2 and 3, which the CPU backend
+/// accepts
+template<typename T>
+void inverseBatchTester(const dim4 dims, double eps) {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    array A  = cpu_randu<T>(dims);
+    array IA = inverse(A);
+    ASSERT_EQ(dims, IA.dims());
+
+    array I2 = identity(dims[0], dims[1], (dtype)dtype_traits<T>::af_type);
+    for (int w = 0; w < (int)dims[3]; ++w) {
+        for (int z = 0; z < (int)dims[2]; ++z) {
+            array I = matmul(A(span, span, z, w), IA(span, span, z, w));
+            ASSERT_NEAR(
+                0, max<typename dtype_traits<T>::base_type>(abs(real(I - I2))),
+                eps);
+            ASSERT_NEAR(
+                0, max<typename dtype_traits<T>::base_type>(abs(imag(I - I2))),
+                eps);
+        }
+    }
+}
+
 template<typename T>
 class Inverse : public ::testing::Test {};
 
@@ -83,6 +110,10 @@ double eps<cdouble>() {
 typedef ::testing::Types<float, cfloat, double, cdouble> TestTypes;
 TYPED_TEST_CASE(Inverse, TestTypes);
 
+TYPED_TEST(Inverse, SquareSmall) {
+    inverseTester<TypeParam>(4, 4, eps<TypeParam>());
+}
+
 TYPED_TEST(Inverse, Square) {
     inverseTester<TypeParam>(1000, 1000, eps<TypeParam>());
 }
@@ -90,3 +121,11 @@ TYPED_TEST(Inverse, Square) {
 TYPED_TEST(Inverse, SquareMultiplePowerOfTwo) {
     inverseTester<TypeParam>(2048, 2048, eps<TypeParam>());
 }
+
+TYPED_TEST(Inverse, SquareSmallBatch3D) {
+    inverseBatchTester<TypeParam>(dim4(5, 5, 11), eps<TypeParam>());
+}
+
+TYPED_TEST(Inverse, SquareBatch4D) {
+    inverseBatchTester<TypeParam>(dim4(100, 100, 2, 2), eps<TypeParam>());
+}
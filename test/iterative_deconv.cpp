@@ -135,3 +135,47 @@ TYPED_TEST(IterativeDeconvolution, RichardsonLucyOnGrayscale) {
         string(TEST_DIR "/iterative_deconv/gray_100_50_lucy.test"), 100, 0.05,
         AF_ITERATIVE_DECONV_RICHARDSONLUCY);
 }
+
+TEST(IterativeDeconvolution, ToleranceStopsEarly) {
+    array x   = range(dim4(64, 64), 0);
+    array y   = range(dim4(64, 64), 1);
+    array img = 128 + 64 * sin(x / 5) * cos(y / 7);
+    array ker = gaussianKernel(5, 5);
+    array in  = convolve(img, ker);
+
+    const iterativeDeconvAlgo algos[] = {AF_ITERATIVE_DECONV_LANDWEBER,
+                                         AF_ITERATIVE_DECONV_RICHARDSONLUCY};
+    for (iterativeDeconvAlgo algo : algos) {
+        // A zero tolerance runs all the iterations
+        array full = iterativeDeconv(in, ker, 20, 0.05f, algo);
+        ASSERT_ARRAYS_EQ(full, iterativeDeconv(in, ker, 20, 0.05f, algo, 0));
+
+        // The first iteration changes the blurred image by far less than
+        // half its norm, so a tolerance of one half stops right after it
+        array once = iterativeDeconv(in, ker, 1, 0.05f, algo);
+        ASSERT_ARRAYS_NEAR(once,
+                           iterativeDeconv(in, ker, 20, 0.05f, algo, 0.5f),
+                           1e-3);
+    }
+
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG,
+              af_iterative_deconv_v2(&out, in.get(), ker.get(), 20, 0.05f,
+                                     AF_ITERATIVE_DECONV_LANDWEBER, -1.f));
+}
+
+// A PSF that does not blur leaves the input as it is, on its own scale
+TEST(IterativeDeconvolution, IdentityKernelKeepsScale) {
+    array x   = range(dim4(48, 40), 0);
+    array y   = range(dim4(48, 40), 1);
+    array in  = 0.5f + 0.25f * sin(x / 5) * cos(y / 7);
+    array ker = constant(0, 3, 3);
+    ker(1, 1) = 1;
+
+    const iterativeDeconvAlgo algos[] = {AF_ITERATIVE_DECONV_LANDWEBER,
+                                         AF_ITERATIVE_DECONV_RICHARDSONLUCY};
+    for (iterativeDeconvAlgo algo : algos) {
+        ASSERT_ARRAYS_NEAR(in, iterativeDeconv(in, ker, 10, 0.05f, algo),
+                           1e-4);
+    }
+}
@@ -12,12 +12,18 @@
 #include <af/algorithm.h>
 #include <af/arith.h>
 #include <af/array.h>
+#include <af/backend.h>
+#include <af/blas.h>
 #include <af/data.h>
 #include <af/device.h>
 #include <af/gfor.h>
 #include <af/random.h>
 
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <numeric>
+#include <string>
 #include <tuple>
 
 using af::array;
@@ -29,7 +35,9 @@ using af::gforSet;
 using af::randn;
 using af::randu;
 using af::seq;
+using af::span;
 using std::get;
+using std::string;
 using std::to_string;
 using std::tuple;
 using std::vector;
@@ -773,6 +781,249 @@ TEST(JIT, IndexingRow) {
     ASSERT_VEC_ARRAY_EQ(gold, dim4(1, 512), c);
 }
 
+namespace {
+/// Rewrites reported by the JIT optimizer while a trace was recorded
+struct jit_rewrites {
+    int merged     = 0;
+    int folded     = 0;
+    int identities = 0;
+    int powers     = 0;
+};
+
+int traceArg(const string &event, const char *key) {
+    size_t pos = event.find(string("\"") + key + "\":");
+    if (pos == string::npos) { return 0; }
+    return std::atoi(event.c_str() + pos + strlen(key) + 3);
+}
+
+/// Waits for the queued work, stops the trace started on \p filename and
+/// sums the counts of its optimizeNodes events
+jit_rewrites stopAndReadRewrites(const char *filename) {
+    af::sync();
+    af::stopTrace();
+
+    jit_rewrites total;
+    std::ifstream file(filename);
+    string line;
+    while (std::getline(file, line)) {
+        if (line.find("\"name\":\"optimizeNodes\"") == string::npos) {
+            continue;
+        }
+        total.merged += traceArg(line, "merged");
+        total.folded += traceArg(line, "folded");
+        total.identities += traceArg(line, "identities");
+        total.powers += traceArg(line, "powers");
+    }
+    file.close();
+    std::remove(filename);
+    return total;
+}
+}  // namespace
+
+TEST(JIT, CommonSubexpressions) {
+    const int num = 1000;
+    array a       = randu(num);
+    array b       = randu(num);
+    a.eval();
+    b.eval();
+    af::sync();
+
+    const char *filename = "jit_common_subexpressions.json";
+    af::startTrace(filename);
+    array c = exp(a * b) + sin(a * b) * (a * b);
+    c.eval();
+    jit_rewrites rewrites = stopAndReadRewrites(filename);
+
+    // The three a * b nodes become one
+    EXPECT_GE(rewrites.merged, 2);
+
+    vector<float> ha(num), hb(num);
+    a.host(&ha.front());
+    b.host(&hb.front());
+
+    vector<float> gold(num);
+    for (int i = 0; i < num; i++) {
+        float ab = ha[i] * hb[i];
+        gold[i]  = exp(ab) + sin(ab) * ab;
+    }
+    ASSERT_VEC_ARRAY_NEAR(gold, dim4(num), c, 1e-5);
+}
+
+TEST(JIT, AlgebraicIdentities) {
+    const int num = 1000;
+    array a       = randu(num);
+    a.eval();
+
+    af::sync();
+
+    const char *filename = "jit_algebraic_identities.json";
+    af::startTrace(filename);
+    array x = a * 1;
+    array y = (a - 0) / 1;
+    array z = pow(a, 2);
+    array w = (constant(2, num) + 3) * a;
+    eval(x, y, z, w);
+    jit_rewrites rewrites = stopAndReadRewrites(filename);
+
+    // a * 1, a - 0 and / 1 are dropped, 2 + 3 is folded and pow(a, 2)
+    // becomes a * a
+    EXPECT_GE(rewrites.identities, 3);
+    EXPECT_GE(rewrites.folded, 1);
+    EXPECT_GE(rewrites.powers, 1);
+
+    vector<float> ha(num);
+    a.host(&ha.front());
+
+    vector<float> goldz(num), goldw(num);
+    for (int i = 0; i < num; i++) {
+        goldz[i] = ha[i] * ha[i];
+        goldw[i] = 5.0f * ha[i];
+    }
+    ASSERT_VEC_ARRAY_EQ(ha, dim4(num), x);
+    ASSERT_VEC_ARRAY_EQ(ha, dim4(num), y);
+    ASSERT_VEC_ARRAY_NEAR(goldz, dim4(num), z, 1e-6);
+    ASSERT_VEC_ARRAY_EQ(goldw, dim4(num), w);
+}
+
+TEST(JIT, IdenticalOutputs) {
+    array a = constant(1, 512, 32);
+    array b = constant(2, 512, 32);
+    a.eval();
+    b.eval();
+
+    af::sync();
+
+    const char *filename = "jit_identical_outputs.json";
+    af::startTrace(filename);
+    array c = a + b;
+    array d = a + b;
+    array e = (a + b) * 1;
+    eval(c, d, e);
+    jit_rewrites rewrites = stopAndReadRewrites(filename);
+
+    // All three outputs are the same node
+    EXPECT_GE(rewrites.merged, 2);
+    EXPECT_GE(rewrites.identities, 1);
+
+    vector<float> gold(512 * 32, 3.0f);
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(512, 32), c);
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(512, 32), d);
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(512, 32), e);
+}
+
+TEST(JIT, IndexedReadsInExpression) {
+    array a   = randu(40, 30);
+    array b   = randu(20, 10);
+    array c   = randu(20, 10);
+    array idx = (randu(10) * 30).as(s32);
+    a.eval();
+    b.eval();
+    c.eval();
+    idx.eval();
+
+    array strided  = a(seq(0, 39, 2), seq(29, 0, -3)) * b + c;
+    array gathered = lookup(a(seq(0, 19), span), idx, 1) * b + c;
+    array tiled    = tile(b, 2, 3) + 1;
+
+    vector<float> ha(a.elements()), hb(b.elements()), hc(c.elements());
+    vector<int> hidx(idx.elements());
+    a.host(&ha.front());
+    b.host(&hb.front());
+    c.host(&hc.front());
+    idx.host(&hidx.front());
+
+    vector<float> gold_strided(200), gold_gathered(200), gold_tiled(1200);
+    for (int j = 0; j < 10; j++) {
+        for (int i = 0; i < 20; i++) {
+            int o            = j * 20 + i;
+            gold_strided[o]  = ha[(29 - 3 * j) * 40 + 2 * i] * hb[o] + hc[o];
+            gold_gathered[o] = ha[hidx[j] * 40 + i] * hb[o] + hc[o];
+        }
+    }
+    for (int j = 0; j < 30; j++) {
+        for (int i = 0; i < 40; i++) {
+            gold_tiled[j * 40 + i] = hb[(j % 10) * 20 + i % 20] + 1;
+        }
+    }
+    ASSERT_VEC_ARRAY_EQ(gold_strided, dim4(20, 10), strided);
+    ASSERT_VEC_ARRAY_EQ(gold_gathered, dim4(20, 10), gathered);
+    ASSERT_VEC_ARRAY_EQ(gold_tiled, dim4(40, 30), tiled);
+}
+
+TEST(JIT, ViewChains) {
+    array a = randu(30, 20, 4);
+    a.eval();
+
+    array b = shift(flip(transpose(reorder(a, 0, 2, 1)), 1), 3, -5) * 2 + 1;
+    array c = tile(flip(a, 0), 2, 1, 1) - shift(tile(a, 2), 7);
+
+    vector<float> ha(a.elements());
+    a.host(&ha.front());
+    auto at = [&](int x, int y, int z) { return ha[z * 600 + y * 30 + x]; };
+
+    // reorder gives (30, 4, 20), transpose (4, 30, 20)
+    vector<float> gold_b(4 * 30 * 20), gold_c(60 * 20 * 4);
+    for (int k = 0; k < 20; k++) {
+        for (int j = 0; j < 30; j++) {
+            for (int i = 0; i < 4; i++) {
+                int si = (i - 3 + 4) % 4;
+                int sj = 29 - (j + 5) % 30;
+                gold_b[(k * 30 + j) * 4 + i] = at(sj, k, si) * 2 + 1;
+            }
+        }
+    }
+    for (int k = 0; k < 4; k++) {
+        for (int j = 0; j < 20; j++) {
+            for (int i = 0; i < 60; i++) {
+                int si = (i - 7 + 60) % 60;
+                gold_c[(k * 20 + j) * 60 + i] =
+                    at(29 - i % 30, j, k) - at(si % 30, j, k);
+            }
+        }
+    }
+    ASSERT_VEC_ARRAY_EQ(gold_b, dim4(4, 30, 20), b);
+    ASSERT_VEC_ARRAY_EQ(gold_c, dim4(60, 20, 4), c);
+}
+
+// Flipping a shifted or tiled view reverses the view, so neither the view
+// nor the flip is written to memory before the result is
+TEST(JIT, FlipShiftedAndTiledViews) {
+    if (af::getActiveBackend() != AF_BACKEND_CPU) { return; }
+    array a = randu(30, 20);
+    a.eval();
+    af::sync();
+
+    size_t alloc_bytes, alloc_buffers, lock_bytes, lock_buffers;
+    size_t alloc_bytes2, alloc_buffers2, lock_bytes2, lock_buffers2;
+    af::deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    array b = flip(shift(a, 7, -3), 0);
+    array c = flip(flip(tile(a, 2, 3), 1), 0);
+    af::deviceMemInfo(&alloc_bytes2, &alloc_buffers2, &lock_bytes2,
+                      &lock_buffers2);
+    ASSERT_EQ(alloc_buffers, alloc_buffers2)
+        << "flip evaluated the shifted or tiled view";
+    ASSERT_EQ(lock_buffers, lock_buffers2)
+        << "flip evaluated the shifted or tiled view";
+
+    vector<float> ha(a.elements());
+    a.host(&ha.front());
+    auto at = [&](int x, int y) { return ha[y * 30 + x]; };
+
+    vector<float> gold_b(30 * 20), gold_c(60 * 60);
+    for (int j = 0; j < 20; j++) {
+        for (int i = 0; i < 30; i++) {
+            gold_b[j * 30 + i] = at((29 - i - 7 + 30) % 30, (j + 3) % 20);
+        }
+    }
+    for (int j = 0; j < 60; j++) {
+        for (int i = 0; i < 60; i++) {
+            gold_c[j * 60 + i] = at((59 - i) % 30, (59 - j) % 20);
+        }
+    }
+    ASSERT_VEC_ARRAY_EQ(gold_b, dim4(30, 20), b);
+    ASSERT_VEC_ARRAY_EQ(gold_c, dim4(60, 60), c);
+}
+
 TEST(JIT, DISABLED_ManyConstants) {
     array res  = constant(1, 1);
     array res2 = tile(res, 1, 10);
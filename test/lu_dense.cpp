@@ -185,6 +185,37 @@ void luTester(const int m, const int n, double eps) {
         eps);
 }
 
+/// Factorizes every matrix of a batch along dims 2 and 3, which the CPU
+/// backend accepts, and checks each one as luTester does
+template<typename T>
+void luBatchTester(const dim4 dims, double eps) {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    array a_orig = cpu_randu<T>(dims);
+    array l, u, pivot;
+    lu(l, u, pivot, a_orig);
+
+    for (int w = 0; w < (int)dims[3]; ++w) {
+        for (int z = 0; z < (int)dims[2]; ++z) {
+            array a_recon = matmul(l(span, span, z, w), u(span, span, z, w));
+            array a       = a_orig(span, span, z, w);
+            array p       = pivot(span, 0, z, w);
+            array a_perm  = a(p, span);
+
+            ASSERT_NEAR(0,
+                        max<typename dtype_traits<T>::base_type>(
+                            abs(real(a_recon - a_perm))),
+                        eps);
+            ASSERT_NEAR(0,
+                        max<typename dtype_traits<T>::base_type>(
+                            abs(imag(a_recon - a_perm))),
+                        eps);
+        }
+    }
+}
+
 template<typename T>
 double eps();
 
@@ -236,6 +267,18 @@ TYPED_TEST(LU, RectangularMultipleOfTwoLarge1) {
     luTester<TypeParam>(512, 1024, eps<TypeParam>());
 }
 
+TYPED_TEST(LU, SquareSmallBatch3D) {
+    luBatchTester<TypeParam>(dim4(6, 6, 9), eps<TypeParam>());
+}
+
+TYPED_TEST(LU, SquareBatch4D) {
+    luBatchTester<TypeParam>(dim4(100, 100, 2, 2), eps<TypeParam>());
+}
+
+TYPED_TEST(LU, RectangularBatch3D) {
+    luBatchTester<TypeParam>(dim4(40, 25, 3), eps<TypeParam>());
+}
+
 TEST(LU, NullLowerOutput) {
     if (noLAPACKTests()) return;
     dim4 dims(3, 3);
@@ -12,6 +12,7 @@
 #include <testHelpers.hpp>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -140,3 +141,76 @@ TEST(MatchTemplate, CPP) {
         cout << "Invalid Match test: " << e.what() << endl;
     }
 }
+
+/// Squared difference measures computed directly in double, with the window
+/// zero outside the image like af_match_template
+static vector<double> squaredDifferences(const vector<float> &s, dim4 sDims,
+                                         const vector<float> &t, dim4 tDims,
+                                         af_match_type type) {
+    double tMean = 0;
+    for (float v : t) { tMean += v; }
+    tMean /= t.size();
+
+    vector<double> out(s.size());
+    for (dim_t sj = 0; sj < sDims[1]; ++sj) {
+        for (dim_t si = 0; si < sDims[0]; ++si) {
+            vector<double> win(t.size(), 0.0);
+            double wMean = 0;
+            for (dim_t tj = 0; tj < tDims[1]; ++tj) {
+                for (dim_t ti = 0; ti < tDims[0]; ++ti) {
+                    dim_t i = si + ti, j = sj + tj;
+                    if (i < sDims[0] && j < sDims[1]) {
+                        win[tj * tDims[0] + ti] = s[j * sDims[0] + i];
+                    }
+                    wMean += win[tj * tDims[0] + ti];
+                }
+            }
+            wMean /= t.size();
+
+            double disparity = 0;
+            for (size_t k = 0; k < t.size(); ++k) {
+                double d = win[k] - t[k];
+                if (type == AF_ZSSD) { d = win[k] - wMean - t[k] + tMean; }
+                if (type == AF_LSSD) { d = win[k] - wMean / tMean * t[k]; }
+                disparity += d * d;
+            }
+            out[sj * sDims[0] + si] = disparity;
+        }
+    }
+    return out;
+}
+
+// Templates this large relative to the image take the FFT path on the CPU
+// backend
+class MatchTemplateLarge : public ::testing::TestWithParam<af_match_type> {};
+
+TEST_P(MatchTemplateLarge, SquaredDifferences) {
+    const dim4 sDims(96, 80);
+    const dim4 tDims(24, 20);
+
+    vector<float> s(sDims.elements());
+    for (size_t k = 0; k < s.size(); ++k) { s[k] = float((k * k) % 23 % 10); }
+
+    // The template is cut from the image at (30, 25)
+    vector<float> t(tDims.elements());
+    for (dim_t j = 0; j < tDims[1]; ++j) {
+        for (dim_t i = 0; i < tDims[0]; ++i) {
+            t[j * tDims[0] + i] = s[(j + 25) * sDims[0] + i + 30];
+        }
+    }
+
+    array out = matchTemplate(array(sDims, s.data()), array(tDims, t.data()),
+                              GetParam());
+    vector<float> result(sDims.elements());
+    out.host(result.data());
+
+    vector<double> gold = squaredDifferences(s, sDims, t, tDims, GetParam());
+    const double tol    = 1e-4 * *std::max_element(gold.begin(), gold.end());
+    for (size_t k = 0; k < gold.size(); ++k) {
+        ASSERT_NEAR(gold[k], result[k], tol) << "at " << k;
+    }
+    ASSERT_NEAR(0.0, result[25 * sDims[0] + 30], tol);
+}
+
+INSTANTIATE_TEST_CASE_P(MatchTemplate, MatchTemplateLarge,
+                        ::testing::Values(AF_SSD, AF_ZSSD, AF_LSSD));
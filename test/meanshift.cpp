@@ -172,3 +172,13 @@ TEST(Meanshift, GFOR) {
         ASSERT_LT(max<double>(abs(c_ii - b_ii)), 1E-5);
     }
 }
+
+TEST(Meanshift, ColorBatchMatchesImage) {
+    af::setSeed(11);
+    array img     = af::round(af::randu(64, 48, 3) * 4.f) * 40.f;
+    array batched = meanShift(af::tile(img, 1, 1, 1, 2), 3.5f, 30.f, 5, true);
+    array single  = meanShift(img, 3.5f, 30.f, 5, true);
+
+    ASSERT_ARRAYS_EQ(single, batched(span, span, span, 0));
+    ASSERT_ARRAYS_EQ(single, batched(span, span, span, 1));
+}
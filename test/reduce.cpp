@@ -201,6 +201,7 @@ using af::constant;
 using af::count;
 using af::iota;
 using af::max;
+using af::mean;
 using af::min;
 using af::NaN;
 using af::product;
@@ -2314,3 +2315,24 @@ TEST(Reduce, nanval_issue_3255) {
     }
     ASSERT_SUCCESS(af_release_array(ikeys));
 }
+
+TEST(Reduce, JITInputMatchesEvaluatedInput) {
+    array a = randu(97, 33, 3, 2);
+    array b = randu(97, 33, 3, 2);
+    a.eval();
+    b.eval();
+
+    // The reductions below receive the unevaluated tree a * b + exp(a)
+    array evaluated = a * b + exp(a);
+    evaluated.eval();
+
+    for (int dim = 0; dim < 4; dim++) {
+        ASSERT_ARRAYS_EQ(sum(evaluated, dim), sum(a * b + exp(a), dim));
+        ASSERT_ARRAYS_EQ(max(evaluated, dim), max(a * b + exp(a), dim));
+        ASSERT_ARRAYS_EQ(count(evaluated > 2, dim),
+                         count(a * b + exp(a) > 2, dim));
+        ASSERT_ARRAYS_EQ(mean(evaluated, dim), mean(a * b + exp(a), dim));
+    }
+    ASSERT_EQ(sum<float>(evaluated), sum<float>(a * b + exp(a)));
+    ASSERT_EQ(mean<float>(evaluated), mean<float>(a * b + exp(a)));
+}
@@ -231,6 +231,14 @@ TYPED_TEST(Solve, SquareMultipleOfTwoLargeBatch) {
     solveTester<TypeParam>(2048, 2048, 32, 10, eps<TypeParam>());
 }
 
+TYPED_TEST(Solve, SquareSmallBatch) {
+    solveTester<TypeParam>(3, 3, 2, 1000, eps<TypeParam>());
+}
+
+TYPED_TEST(Solve, SquareMediumBatch) {
+    solveTester<TypeParam>(32, 32, 4, 100, eps<TypeParam>());
+}
+
 TYPED_TEST(Solve, LeastSquaresUnderDetermined) {
     solveTester<TypeParam>(80, 100, 20, 1, eps<TypeParam>());
 }
@@ -0,0 +1,97 @@
+/*******************************************************
+ * Copyright (c) 2024, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arrayfire.h>
+#include <gtest/gtest.h>
+#include <testHelpers.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using af::array;
+using af::randu;
+using af::startTrace;
+using af::stopTrace;
+using af::sum;
+using std::string;
+
+namespace {
+string readFile(const char *filename) {
+    std::ifstream file(filename);
+    return string(std::istreambuf_iterator<char>(file),
+                  std::istreambuf_iterator<char>());
+}
+}  // namespace
+
+TEST(Trace, RecordsApiAndJIT) {
+    const char *filename = "trace_records_api_and_jit.json";
+    std::remove(filename);
+
+    startTrace(filename);
+    array a = randu(100, 100);
+    array b = a * 2.0f + 1.0f;
+    b.eval();
+    array c = sum(b);
+    c.eval();
+    af::sync();
+    stopTrace();
+
+    string trace = readFile(filename);
+    std::remove(filename);
+
+    ASSERT_FALSE(trace.empty());
+    EXPECT_NE(string::npos, trace.find("\"traceEvents\""));
+    EXPECT_NE(string::npos, trace.find("\"cat\":\"api\""));
+    EXPECT_NE(string::npos, trace.find("\"name\":\"af_randu\""));
+    EXPECT_NE(string::npos, trace.find("\"name\":\"af_sum\""));
+
+    // The elementwise expression is evaluated as a JIT kernel
+    const bool jit =
+        trace.find("\"cat\":\"jit\",\"name\":\"evalMultiple\"") !=
+            string::npos ||
+        trace.find("\"cat\":\"jit\",\"name\":\"evalNodes\"") !=
+            string::npos;
+    EXPECT_TRUE(jit);
+    EXPECT_NE(string::npos, trace.find("\"nodes\":"));
+}
+
+// Recordings longer than the per thread buffers are written in chunks
+TEST(Trace, LongRecording) {
+    const char *filename = "trace_long_recording.json";
+    std::remove(filename);
+
+    const int num = 8000;
+    array a       = randu(10);
+    a.eval();
+    startTrace(filename);
+    for (int i = 0; i < num; i++) {
+        array b = a + i;
+        b.eval();
+    }
+    af::sync();
+    stopTrace();
+
+    string trace = readFile(filename);
+    std::remove(filename);
+
+    int evals  = 0;
+    size_t pos = trace.find("\"name\":\"af_eval\"");
+    while (pos != string::npos) {
+        evals++;
+        pos = trace.find("\"name\":\"af_eval\"", pos + 1);
+    }
+    EXPECT_EQ(num, evals);
+    EXPECT_EQ(trace.size() - 4, trace.rfind("\n]}\n"));
+}
+
+TEST(Trace, StopWithoutStart) { ASSERT_SUCCESS(af_stop_trace()); }
+
+TEST(Trace, NullFilename) { ASSERT_EQ(AF_ERR_ARG, af_start_trace(NULL)); }
@@ -248,6 +248,25 @@ TEST(Wrap, DocSnippet) {
     ASSERT_ARRAYS_EQ(gold_B_wrapped, B_wrapped);
 }
 
+TEST(Wrap, OverlappingWindowsAddEveryCopy) {
+    const unsigned wx = 5;
+    const unsigned wy = 4;
+    const unsigned sx = 2;
+    const unsigned sy = 3;
+    const unsigned px = 2;
+    const unsigned py = 1;
+
+    array input = range(dim4(37, 29, 2, 2), 0, s32) + 1;
+    array ones  = af::constant(1, input.dims(), s32);
+    for (bool is_column : {true, false}) {
+        array output = wrap(unwrap(input, wx, wy, sx, sy, px, py, is_column),
+                            37, 29, wx, wy, sx, sy, px, py, is_column);
+        array copies = wrap(unwrap(ones, wx, wy, sx, sy, px, py, is_column),
+                            37, 29, wx, wy, sx, sy, px, py, is_column);
+        ASSERT_ARRAYS_EQ(input * copies, output);
+    }
+}
+
 static void getInput(af_array *data, const dim_t *dims) {
     float h_data[16] = {10, 20, 20, 30, 30, 40, 40, 50,
                         30, 40, 40, 50, 50, 60, 60, 70};